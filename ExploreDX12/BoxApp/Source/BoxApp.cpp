@@ -15,7 +15,7 @@ void BoxApp::OnWindowResize()
 {
     Application::OnWindowResize();
 
-    // Quand la fentre est resize, on doit mettre  jour l'aspect ratio et recalculer la matrice de projection.
+    // Quand la fenêtre est resize, on doit mettre à jour l'aspect ratio et recalculer la matrice de projection.
     XMMATRIX P = XMMatrixPerspectiveFovLH(0.25f * DirectXMathUtils::Pi, WindowManager::AspectRatio(), 1.0f, 1000.0f);
     XMStoreFloat4x4(&mProj, P);
 }
@@ -84,7 +84,7 @@ void BoxApp::Update()
     XMMATRIX proj = XMLoadFloat4x4(&mProj);
     XMMATRIX worldViewProj = world * view * proj;
 
-    // On met  jour le buffer constant avec la dernire matrice WorldViewProj 
+    // On met à jour le buffer constant avec la dernière matrice WorldViewProj 
     ObjectConstants objConstants;
     XMStoreFloat4x4(&objConstants.WorldViewProj, XMMatrixTranspose(worldViewProj));
     mObjectCB->CopyData(0, objConstants);
@@ -94,16 +94,16 @@ void BoxApp::Draw()
 {
     Application::Draw();
 
-    // On rutilise la mmoire associe  l'enregistrement des commandes.
+    // On réutilise la mémoire associée à l'enregistrement des commandes.
     ThrowIfFailed(DirectX12::CommandListAllocator->Reset());
 
-    // Une liste de commande peut tre reset aprs qu'elle a t ajout  la file de commande avec via ExecuteCommandList, ce qui nous permet de rutiliser la mmoire de la liste de commande.
+    // Une liste de commande peut être reset après qu'elle a été ajouté à la file de commande avec via ExecuteCommandList, ce qui nous permet de réutiliser la mémoire de la liste de commande.
     ThrowIfFailed(DirectX12::CommandList->Reset(DirectX12::CommandListAllocator.Get(), mPSO.Get()));
 
     DirectX12::CommandList->RSSetViewports(1, &DirectX12::ScreenViewport);
     DirectX12::CommandList->RSSetScissorRects(1, &DirectX12::ScissorRect);
 
-    // On indique une transition d'tat sur l'utilisation de la ressource.
+    // On indique une transition d'état sur l'utilisation de la ressource.
     CD3DX12_RESOURCE_BARRIER resourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(DirectX12::CurrentBackBuffer(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
     DirectX12::CommandList->ResourceBarrier(1, &resourceBarrier);
 
@@ -112,7 +112,7 @@ void BoxApp::Draw()
     // On clear le back buffer et le depth buffer.
     DirectX12::CommandList->ClearRenderTargetView(bbv, Colors::LightSteelBlue, 0, nullptr);
     DirectX12::CommandList->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
-    // On prcise les buffers sur lesquels on va dessiner.
+    // On précise les buffers sur lesquels on va dessiner.
     DirectX12::CommandList->OMSetRenderTargets(1, &bbv, true, &dsv);
 
     ID3D12DescriptorHeap* descriptorHeaps[] = { mCbvHeap.Get() };
@@ -135,7 +135,7 @@ void BoxApp::Draw()
 
     // Ici, on a fini d'enregistrer les commandes.
     ThrowIfFailed(DirectX12::CommandList->Close());
-    // On ajoute la liste de commande  la file pour qu'elle s'excute.
+    // On ajoute la liste de commande à la file pour qu'elle s'exécute.
     ID3D12CommandList* cmdsLists[] = { DirectX12::CommandList.Get() };
     DirectX12::CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
@@ -143,7 +143,7 @@ void BoxApp::Draw()
     ThrowIfFailed(DirectX12::SwapChain->Present(0, 0));
     DirectX12::CurrentBackBufferIndex = (DirectX12::CurrentBackBufferIndex + 1) % DirectX12::SwapChainBufferCount;
 
-    // On attend que les commandes soient finies. Cette manire de faire n'est pas efficace mais est faite par soucis de simplicit.
+    // On attend que les commandes soient finies. Cette manière de faire n'est pas efficace mais est faite par soucis de simplicité.
     DirectX12::FlushCommandQueue();
 }
 
@@ -10,6 +10,8 @@ int RunApplication(HINSTANCE hInstance)
     _CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 #endif
 
+    DirectX12::ParseCommandLine(__argc, __argv);
+
     try
     {
         T app{ hInstance };
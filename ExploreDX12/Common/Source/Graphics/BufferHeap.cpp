@@ -0,0 +1,110 @@
+#include "Graphics/BufferHeap.h"
+
+#include <cassert>
+
+BufferHeap::BufferHeap(ID3D12Device* device, UINT64 heapByteSize)
+    : mDevice(device)
+{
+    constexpr UINT64 alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+    mHeapByteSize = (heapByteSize + alignment - 1) & ~(alignment - 1);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> BufferHeap::CreateBuffer(UINT64 byteSize)
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> buffer;
+    CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(byteSize);
+
+    if (byteSize > mHeapByteSize)
+    {
+        CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_DEFAULT);
+        ThrowIfFailed(mDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&buffer)));
+        mCommittedBuffers.insert(buffer.Get());
+        return buffer;
+    }
+
+    Placement placement;
+    TlsfAllocator::Allocation allocation;
+    for (UINT i = 0; i < mHeaps.size() && !allocation.IsValid(); i++)
+    {
+        allocation = mHeaps[i].Allocator->Allocate(byteSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+        placement.HeapIndex = i;
+    }
+
+    if (!allocation.IsValid())
+    {
+        Heap heap;
+        CD3DX12_HEAP_DESC heapDesc(mHeapByteSize, D3D12_HEAP_TYPE_DEFAULT, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+        ThrowIfFailed(mDevice->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap.Resource)));
+        heap.Allocator = std::make_unique<TlsfAllocator>(mHeapByteSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+        mHeaps.push_back(std::move(heap));
+
+        placement.HeapIndex = static_cast<UINT>(mHeaps.size() - 1);
+        allocation = mHeaps.back().Allocator->Allocate(byteSize, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+    }
+
+    placement.Handle = allocation.Handle;
+    ThrowIfFailed(mDevice->CreatePlacedResource(mHeaps[placement.HeapIndex].Resource.Get(), allocation.Offset, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&buffer)));
+    mPlacements[buffer.Get()] = placement;
+    return buffer;
+}
+
+void BufferHeap::Free(ID3D12Resource* buffer)
+{
+    const auto placement = mPlacements.find(buffer);
+    if (placement == mPlacements.end())
+    {
+        // Buffer committed : sa mémoire part avec la dernière référence. Un buffer inconnu ne change rien, pour ne pas fausser les statistiques.
+        const size_t erasedCount = mCommittedBuffers.erase(buffer);
+        assert(erasedCount == 1 && "Free d'un buffer inconnu ou déjà rendu");
+        return;
+    }
+
+    mHeaps[placement->second.HeapIndex].Allocator->Free(placement->second.Handle);
+    mPlacements.erase(placement);
+}
+
+UINT BufferHeap::Defragment(const RelocateFunction& relocate)
+{
+    UINT movedCount = 0;
+    for (UINT heapIndex = 0; heapIndex < mHeaps.size(); heapIndex++)
+    {
+        // TlsfAllocator::Defragment ne donne que la poignée de chaque allocation déplacée.
+        std::unordered_map<std::uint32_t, ID3D12Resource*> buffers;
+        for (const auto& [buffer, placement] : mPlacements)
+        {
+            if (placement.HeapIndex == heapIndex)
+                buffers[placement.Handle] = buffer;
+        }
+
+        movedCount += mHeaps[heapIndex].Allocator->Defragment([&](std::uint32_t handle, std::uint64_t, std::uint64_t newOffset, std::uint64_t)
+        {
+            ID3D12Resource* oldBuffer = buffers[handle];
+            const D3D12_RESOURCE_DESC resourceDesc = oldBuffer->GetDesc();
+            mPlacements.erase(oldBuffer);
+
+            Microsoft::WRL::ComPtr<ID3D12Resource> newBuffer;
+            ThrowIfFailed(mDevice->CreatePlacedResource(mHeaps[heapIndex].Resource.Get(), newOffset, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&newBuffer)));
+            mPlacements[newBuffer.Get()] = { heapIndex, handle };
+            buffers[handle] = newBuffer.Get();
+
+            relocate(oldBuffer, std::move(newBuffer));
+        });
+    }
+    return movedCount;
+}
+
+BufferHeap::Stats BufferHeap::GetStats() const
+{
+    Stats stats;
+    stats.HeapCount = static_cast<UINT>(mHeaps.size());
+    stats.BufferCount = mPlacements.size() + mCommittedBuffers.size();
+    stats.CommittedBufferCount = mCommittedBuffers.size();
+    for (const Heap& heap : mHeaps)
+    {
+        const TlsfAllocator::Stats heapStats = heap.Allocator->GetStats();
+        stats.HeapBytes += heapStats.Capacity;
+        stats.UsedBytes += heapStats.UsedBytes;
+        stats.Fragmentation = DirectXMathUtils::Max(stats.Fragmentation, heapStats.Fragmentation);
+    }
+    return stats;
+}
\ No newline at end of file
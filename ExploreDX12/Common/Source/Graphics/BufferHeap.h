@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Graphics/DirectXUtils.h"
+#include "Utils/TlsfAllocator.h"
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Buffers du heap par défaut placés dans quelques grands ID3D12Heap, découpés par TlsfAllocator, au lieu d'un CreateCommittedResource
+// (donc d'un heap implicite) par buffer : créer des milliers de meshes ne crée que quelques heaps.
+// Un buffer placé est aligné sur D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT (64 Ko) : un petit buffer occupe tout de même 64 Ko.
+// Les buffers plus grands qu'un heap restent des ressources committed. À utiliser depuis un seul thread.
+class BufferHeap
+{
+public:
+    struct Stats
+    {
+        UINT HeapCount = 0;
+        UINT64 HeapBytes = 0;
+        UINT64 UsedBytes = 0;
+        UINT64 BufferCount = 0;
+        UINT64 CommittedBufferCount = 0;
+        // Pire fragmentation parmi les heaps, voir TlsfAllocator::Stats.
+        float Fragmentation = 0.0f;
+    };
+
+    // heapByteSize est arrondi à 64 Ko.
+    BufferHeap(ID3D12Device* device, UINT64 heapByteSize);
+    BufferHeap(const BufferHeap& rhs) = delete;
+    BufferHeap& operator=(const BufferHeap& rhs) = delete;
+    ~BufferHeap() = default;
+
+    // Buffer de byteSize octets dans l'état COMMON, placé dans le premier heap qui a la place (un nouveau heap est créé sinon).
+    Microsoft::WRL::ComPtr<ID3D12Resource> CreateBuffer(UINT64 byteSize);
+    // Rend la place du buffer, à appeler avant d'en relâcher la dernière référence. Le GPU ne doit plus l'utiliser : la mémoire peut être
+    // donnée au buffer suivant. buffer doit venir de CreateBuffer et ne pas avoir déjà été rendu.
+    void Free(ID3D12Resource* buffer);
+
+    // Appelée par Defragment pour chaque buffer déplacé, avec l'ancien buffer et celui qui le remplace au nouveau décalage du même heap.
+    using RelocateFunction = std::function<void(ID3D12Resource* oldBuffer, Microsoft::WRL::ComPtr<ID3D12Resource> newBuffer)>;
+    // Tasse les buffers placés vers le début de leur heap (voir TlsfAllocator::Defragment). Un buffer placé ne peut pas changer de décalage :
+    // pour chaque buffer déplacé, un nouveau buffer est créé à sa nouvelle place et relocate(ancien, nouveau) est appelé avant le déplacement suivant.
+    // L'appelant copie les données (les deux zones peuvent se chevaucher, la copie doit passer par un buffer intermédiaire), remplace ses références
+    // et ses vues, puis relâche l'ancien buffer sans le rendre à Free. Le GPU ne doit utiliser aucun buffer du heap pendant l'appel.
+    // Renvoie le nombre de buffers déplacés.
+    UINT Defragment(const RelocateFunction& relocate);
+
+    Stats GetStats() const;
+
+private:
+    struct Heap
+    {
+        Microsoft::WRL::ComPtr<ID3D12Heap> Resource;
+        std::unique_ptr<TlsfAllocator> Allocator;
+    };
+
+    struct Placement
+    {
+        UINT HeapIndex = 0;
+        std::uint32_t Handle = TlsfAllocator::InvalidHandle;
+    };
+
+    ID3D12Device* mDevice = nullptr;
+    UINT64 mHeapByteSize = 0;
+    std::vector<Heap> mHeaps;
+    std::unordered_map<ID3D12Resource*, Placement> mPlacements;
+    // Buffers plus grands qu'un heap : rien à rendre, mais Free doit les reconnaître.
+    std::unordered_set<ID3D12Resource*> mCommittedBuffers;
+};
\ No newline at end of file
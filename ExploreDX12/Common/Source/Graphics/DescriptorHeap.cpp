@@ -0,0 +1,49 @@
+#include "Graphics/DescriptorHeap.h"
+
+DescriptorHeap::DescriptorHeap(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT persistentCount, UINT transientCount)
+    : mAllocator(persistentCount, transientCount)
+{
+    D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
+    heapDesc.NumDescriptors = persistentCount + transientCount;
+    heapDesc.Type = type;
+    heapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    heapDesc.NodeMask = 0;
+    ThrowIfFailed(device->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&mHeap)));
+
+    mCpuStart = mHeap->GetCPUDescriptorHandleForHeapStart();
+    mGpuStart = mHeap->GetGPUDescriptorHandleForHeapStart();
+    mDescriptorSize = device->GetDescriptorHandleIncrementSize(type);
+}
+
+DescriptorHeap::Handle DescriptorHeap::AllocatePersistent()
+{
+    const UINT index = mAllocator.AllocatePersistent();
+    if (index == DescriptorAllocator::InvalidIndex)
+    {
+        Logs::Error("DescriptorHeap : les {} descripteurs persistants sont utilisés", mAllocator.PersistentCount());
+        throw DxException(E_OUTOFMEMORY, L"DescriptorHeap::AllocatePersistent", AnsiToWString(__FILE__), __LINE__);
+    }
+    return MakeHandle(index, 1);
+}
+
+DescriptorHeap::Handle DescriptorHeap::AllocateTransient(UINT count)
+{
+    const UINT index = mAllocator.AllocateTransient(count);
+    if (index == DescriptorAllocator::InvalidIndex)
+    {
+        Logs::Error("DescriptorHeap : anneau transitoire plein, {} descripteurs demandés, {} utilisés sur {}", count, mAllocator.Transient().UsedBytes(), mAllocator.TransientCount());
+        throw DxException(E_OUTOFMEMORY, L"DescriptorHeap::AllocateTransient", AnsiToWString(__FILE__), __LINE__);
+    }
+    return MakeHandle(index, count);
+}
+
+DescriptorHeap::Handle DescriptorHeap::MakeHandle(UINT index, UINT count) const
+{
+    Handle handle;
+    handle.mCpuStart = mCpuStart;
+    handle.mGpuStart = mGpuStart;
+    handle.mDescriptorSize = mDescriptorSize;
+    handle.mIndex = index;
+    handle.mCount = count;
+    return handle;
+}
\ No newline at end of file
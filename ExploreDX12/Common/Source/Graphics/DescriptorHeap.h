@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Graphics/DirectXUtils.h"
+#include "Utils/DescriptorAllocator.h"
+
+// Heap de descripteurs visible par les shaders, découpé par DescriptorAllocator : des descripteurs persistants pris dans une liste libre,
+// et un anneau de descripteurs transitoires réutilisés quand la fence de leur frame est atteinte. Assez grand pour toute l'application,
+// il n'est jamais recréé quand des objets apparaissent ou disparaissent. Les règles de thread sont celles de DescriptorAllocator.
+class DescriptorHeap
+{
+public:
+    // Un ou plusieurs descripteurs consécutifs : CpuHandle(i) pour les écrire, GpuHandle() pour SetGraphicsRootDescriptorTable.
+    class Handle
+    {
+    public:
+        Handle() = default;
+
+        bool IsValid() const { return mCount > 0; }
+        UINT Index() const { return mIndex; }
+        UINT Count() const { return mCount; }
+
+        D3D12_CPU_DESCRIPTOR_HANDLE CpuHandle(UINT i = 0) const { return { mCpuStart.ptr + static_cast<SIZE_T>(mIndex + i) * mDescriptorSize }; }
+        D3D12_GPU_DESCRIPTOR_HANDLE GpuHandle(UINT i = 0) const { return { mGpuStart.ptr + static_cast<UINT64>(mIndex + i) * mDescriptorSize }; }
+
+    private:
+        friend class DescriptorHeap;
+
+        D3D12_CPU_DESCRIPTOR_HANDLE mCpuStart = {};
+        D3D12_GPU_DESCRIPTOR_HANDLE mGpuStart = {};
+        UINT mDescriptorSize = 0;
+        UINT mIndex = 0;
+        UINT mCount = 0;
+    };
+
+    DescriptorHeap(ID3D12Device* device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT persistentCount, UINT transientCount);
+    DescriptorHeap(const DescriptorHeap& rhs) = delete;
+    DescriptorHeap& operator=(const DescriptorHeap& rhs) = delete;
+    ~DescriptorHeap() = default;
+
+    // Lancent une DxException (E_OUTOFMEMORY) quand la partie correspondante du heap est pleine.
+    Handle AllocatePersistent();
+    Handle AllocateTransient(UINT count = 1);
+
+    // Le GPU n'utilise plus le descripteur.
+    void Free(const Handle& handle) { mAllocator.FreePersistent(handle.Index()); }
+    // Les frames soumises jusqu'à fenceValue peuvent encore utiliser le descripteur.
+    void FreeAfter(const Handle& handle, UINT64 fenceValue) { mAllocator.FreePersistentAfter(handle.Index(), fenceValue); }
+
+    void FinishFrame(UINT64 fenceValue) { mAllocator.FinishFrame(fenceValue); }
+    void Retire(UINT64 completedFenceValue) { mAllocator.Retire(completedFenceValue); }
+
+    ID3D12DescriptorHeap* Resource() const { return mHeap.Get(); }
+    const DescriptorAllocator& Allocator() const { return mAllocator; }
+
+private:
+    Handle MakeHandle(UINT index, UINT count) const;
+
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mHeap;
+    D3D12_CPU_DESCRIPTOR_HANDLE mCpuStart = {};
+    D3D12_GPU_DESCRIPTOR_HANDLE mGpuStart = {};
+    UINT mDescriptorSize = 0;
+    DescriptorAllocator mAllocator;
+};
\ No newline at end of file
@@ -4,6 +4,9 @@
 
 #include <dxgidebug.h>
 
+#include <cstdlib>
+#include <string>
+
 namespace DirectX12
 {
     void CreateDevice();
@@ -13,6 +16,7 @@ namespace DirectX12
     void CreateRtvAndDsvDescriptorHeaps();
 
     bool mIsInit = false;
+    HANDLE mFenceEvent = nullptr;
 }
 
 bool DirectX12::Initialize(HINSTANCE hInstance)
@@ -46,6 +50,11 @@ void DirectX12::Dispose()
     CommandQueue.Reset();
 
     Fence.Reset();
+    if (mFenceEvent != nullptr)
+    {
+        CloseHandle(mFenceEvent);
+        mFenceEvent = nullptr;
+    }
     D3DDevice.Reset();
     DxgiFactory.Reset();
 
@@ -79,6 +88,11 @@ void DirectX12::CreateDevice()
     }
 
     ThrowIfFailed(D3DDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&Fence)));
+
+    // Un seul événement pour toutes les attentes sur la fence, au lieu d'en créer et d'en détruire un à chaque attente.
+    mFenceEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+    if (mFenceEvent == nullptr)
+        ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
 }
 
 void DirectX12::GetDescriptorsSize()
@@ -215,24 +229,39 @@ void DirectX12::OnWindowResize()
 
 void DirectX12::FlushCommandQueue()
 {
-    // Permet "d'avancer" la barrire pour marquer les commandes jusqu' ce point.
+    // Permet "d'avancer" la barrière pour marquer les commandes jusqu'à ce point.
     CurrentFence++;
 
-    // Ajoute une instruction  la commande queue qui permet de dfinir un nouveau "marquage" de barrire.
-    // Permet de dire au GPU de mettre  jour la valeur de la barrire  "CurrentFence".
-    // Ne sera pas fait tant que le GPU n'aura pas fini de traiter toutes les commandes prcdente  ce "Signal"
+    // Ajoute une instruction à la commande queue qui permet de définir un nouveau "marquage" de barrière.
+    // Permet de dire au GPU de mettre à jour la valeur de la barrière à "CurrentFence".
+    // Ne sera pas fait tant que le GPU n'aura pas fini de traiter toutes les commandes précédente à ce "Signal"
     ThrowIfFailed(CommandQueue->Signal(Fence.Get(), CurrentFence));
 
-    // Attendre jusqu' ce que le GPU ait complt les commandes jusqu' ce point de barrire.
-    if (Fence->GetCompletedValue() < CurrentFence)
+    // Attendre jusqu'à ce que le GPU ait complété les commandes jusqu'à ce point de barrière.
+    WaitForFence(CurrentFence);
+}
+
+void DirectX12::WaitForFence(UINT64 fenceValue)
+{
+    if (Fence->GetCompletedValue() >= fenceValue)
+        return;
+
+    // Permet d'associer l'événement quand le GPU a atteint la valeur de fence à ce handle.
+    // L'événement est à réinitialisation automatique : il repasse à l'état non signalé dès que WaitForSingleObject le consomme.
+    ThrowIfFailed(Fence->SetEventOnCompletion(fenceValue, mFenceEvent));
+    // Permet de bloquer complétement le thread CPU jusqu'à ce que l'event soit signalé
+    WaitForSingleObject(mFenceEvent, INFINITE);
+}
+
+void DirectX12::ParseCommandLine(int argc, char** argv)
+{
+    for (int i = 1; i + 1 < argc; i++)
     {
-        // Cration d'un event handle.
-        HANDLE eventHandle = CreateEventEx(nullptr, nullptr, false, EVENT_ALL_ACCESS);
-        // Permet d'associer l'vnement quand le GPU a atteint la valeur de fence  ce handle.
-        ThrowIfFailed(Fence->SetEventOnCompletion(CurrentFence, eventHandle));
-        // Permet de bloquer compltement le thread CPU jusqu' ce que l'event soit signal
-        WaitForSingleObject(eventHandle, INFINITE);
-        CloseHandle(eventHandle);
+        const std::string name = argv[i];
+        if (name == "--frames-in-flight")
+            NumberOfFrameResources = DirectXMathUtils::Clamp(std::atoi(argv[++i]), 1, MaxFrameResources);
+        else if (name == "--latency-target")
+            TargetLatencyMilliseconds = DirectXMathUtils::Max(static_cast<float>(std::atof(argv[++i])), 0.0f);
     }
 }
 
@@ -258,11 +287,11 @@ void DirectX12::ResetCommandList()
 
 void DirectX12::ExecuteCommandsAndWait()
 {
-    // Permet d'excuter les commandes d'initialisation.
+    // Permet d'exécuter les commandes d'initialisation.
     ThrowIfFailed(CommandList->Close());
     ID3D12CommandList* cmdsLists[] = { CommandList.Get() };
     CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-    // On attend jusqu' ce que l'initialisation soit finie.
+    // On attend jusqu'à ce que l'initialisation soit finie.
     FlushCommandQueue();
 }
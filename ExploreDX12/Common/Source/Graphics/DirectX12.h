@@ -28,7 +28,11 @@ namespace DirectX12
     inline constexpr int SwapChainBufferCount = 2;
     inline DXGI_FORMAT BackBufferFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
     inline int CurrentBackBufferIndex = 0;
-    inline constexpr int NumberOfFrameResources = 3;
+    // Nombre de FrameResource des applications, donc nombre maximum de frames en vol. Réglable avec --frames-in-flight, avant la création de l'application.
+    inline int NumberOfFrameResources = 3;
+    inline constexpr int MaxFrameResources = 8;
+    // Latence visée par le FramePacer des applications qui en ont un, en millisecondes (--latency-target). 0 : toujours NumberOfFrameResources frames en vol.
+    inline float TargetLatencyMilliseconds = 0.0f;
     
     inline Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> RtvHeap = nullptr;
     inline Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> DsvHeap = nullptr;
@@ -44,6 +48,11 @@ namespace DirectX12
     void Dispose();
     void OnWindowResize();
     void FlushCommandQueue();
+    // Bloque jusqu'à ce que le GPU atteigne fenceValue sur Fence. L'événement Win32 utilisé est créé une seule fois avec le device :
+    // à n'appeler que depuis le thread qui soumet les frames.
+    void WaitForFence(UINT64 fenceValue);
+    // Options communes à toutes les applications, lues sur la ligne de commande avant leur création.
+    void ParseCommandLine(int argc, char** argv);
 
     ID3D12Resource* CurrentBackBuffer();
     D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView();
@@ -2,7 +2,8 @@
 
 #include <DirectXMath.h>
 #include <DirectXColors.h>
-#include <random>
+
+#include "Utils/Random.h"
 
 using namespace DirectX;
 
@@ -21,6 +22,18 @@ namespace DirectXMathUtils
         return I;
     }
 
+    template<typename T>
+    inline T Min(const T& a, const T& b)
+    {
+        return a < b ? a : b;
+    }
+
+    template<typename T>
+    inline T Max(const T& a, const T& b)
+    {
+        return a > b ? a : b;
+    }
+
     template<typename T>
     inline T Clamp(const T& x, const T& low, const T& high)
     {
@@ -37,18 +50,15 @@ namespace DirectXMathUtils
         );
     }
 
-    inline std::random_device rd;
-    inline std::mt19937 gen(rd());
-
+    // Tirages non reproductibles sur le flux du thread appelant, utilisables depuis plusieurs threads.
+    // Pour des résultats reproductibles, utiliser directement RandomUtils::Xoshiro ou RandomUtils::Philox avec une graine.
     inline float Randf(float a, float b)
     {
-        std::uniform_real_distribution<float> dis(a, b);
-        return dis(gen);
+        return RandomUtils::ThreadStream().Randf(a, b);
     }
 
     inline int Rand(int a, int b)
     {
-        std::uniform_int_distribution<int> dis(a, b);
-        return dis(gen);
+        return RandomUtils::ThreadStream().Rand(a, b);
     }
 }
\ No newline at end of file
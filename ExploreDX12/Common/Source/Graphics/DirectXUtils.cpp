@@ -1,5 +1,50 @@
 #include "Graphics/DirectXUtils.h"
 
+#include "Graphics/ShaderCache.h"
+
+#include <atomic>
+
+namespace
+{
+    // Blob qui garde le bytecode du cache projeté en mémoire, pour le passer aux PSO sans le recopier.
+    class CachedShaderBlob : public ID3DBlob
+    {
+    public:
+        explicit CachedShaderBlob(std::shared_ptr<const ShaderCache::Bytecode> byteCode) : mByteCode(std::move(byteCode)) {}
+
+        HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+        {
+            if (object == nullptr)
+                return E_POINTER;
+            if (riid != __uuidof(IUnknown) && riid != __uuidof(ID3DBlob))
+            {
+                *object = nullptr;
+                return E_NOINTERFACE;
+            }
+            AddRef();
+            *object = static_cast<ID3DBlob*>(this);
+            return S_OK;
+        }
+
+        ULONG STDMETHODCALLTYPE AddRef() override { return ++mRefCount; }
+
+        ULONG STDMETHODCALLTYPE Release() override
+        {
+            const ULONG refCount = --mRefCount;
+            if (refCount == 0)
+                delete this;
+            return refCount;
+        }
+
+        LPVOID STDMETHODCALLTYPE GetBufferPointer() override { return const_cast<std::uint8_t*>(mByteCode->Data()); }
+        SIZE_T STDMETHODCALLTYPE GetBufferSize() override { return mByteCode->Size(); }
+
+    private:
+        std::atomic<ULONG> mRefCount = 1;
+        std::shared_ptr<const ShaderCache::Bytecode> mByteCode;
+    };
+}
+
 Microsoft::WRL::ComPtr<ID3DBlob> DirectXUtils::CompileShader(const std::wstring& filename, const D3D_SHADER_MACRO* defines, const std::string& entrypoint, const std::string& target)
 {
     INT compileFlags = 0;
@@ -7,16 +52,40 @@ Microsoft::WRL::ComPtr<ID3DBlob> DirectXUtils::CompileShader(const std::wstring&
     compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
 #endif
 
+    // Dans le dossier de travail de l'application, à côté du dossier Shaders.
+    static ShaderCache shaderCache("ShaderCache", "d3dcompiler_" + std::to_string(D3D_COMPILER_VERSION));
+
+    ShaderCache::Request request;
+    request.SourcePath = filename;
+    request.EntryPoint = entrypoint;
+    request.Target = target;
+    request.Flags = static_cast<std::uint32_t>(compileFlags);
+    for (const D3D_SHADER_MACRO* define = defines; define != nullptr && define->Name != nullptr; define++)
+        request.Defines.push_back({ define->Name, define->Definition != nullptr ? define->Definition : "" });
+
     HRESULT hr = S_OK;
-    Microsoft::WRL::ComPtr<ID3DBlob> byteCode = nullptr;
-    Microsoft::WRL::ComPtr<ID3DBlob> errors;
-    hr = D3DCompileFromFile(filename.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, entrypoint.c_str(), target.c_str(), compileFlags, 0, &byteCode, &errors);
+    std::shared_ptr<const ShaderCache::Bytecode> cached = shaderCache.Load(request, [&](const ShaderCache::Request&, std::vector<std::uint8_t>& output)
+    {
+        Microsoft::WRL::ComPtr<ID3DBlob> byteCode = nullptr;
+        Microsoft::WRL::ComPtr<ID3DBlob> errors;
+        hr = D3DCompileFromFile(filename.c_str(), defines, D3D_COMPILE_STANDARD_FILE_INCLUDE, entrypoint.c_str(), target.c_str(), compileFlags, 0, &byteCode, &errors);
+
+        if (errors != nullptr)
+            OutputDebugStringA((char*)errors->GetBufferPointer());
+        if (FAILED(hr))
+            return false;
 
-    if (errors != nullptr)
-        OutputDebugStringA((char*)errors->GetBufferPointer());
+        const std::uint8_t* data = static_cast<const std::uint8_t*>(byteCode->GetBufferPointer());
+        output.assign(data, data + byteCode->GetBufferSize());
+        return true;
+    });
 
     ThrowIfFailed(hr);
+    if (cached == nullptr)
+        ThrowIfFailed(E_FAIL);
 
+    Microsoft::WRL::ComPtr<ID3DBlob> byteCode;
+    byteCode.Attach(new CachedShaderBlob(std::move(cached)));
     return byteCode;
 }
 
@@ -58,7 +58,9 @@ namespace DirectXUtils
         return (byteSize + 255) & ~255;
     }
 
+    // Passe par le ShaderCache du dossier ShaderCache : seuls les shaders dont une source a changé depuis le dernier lancement sont recompilés.
     Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(const std::wstring& filename, const D3D_SHADER_MACRO* defines, const std::string& entrypoint, const std::string& target);
 
+    // Un buffer d'upload par ressource, à garder jusqu'à l'exécution de cmdList. Pour plusieurs ressources, UploadManager regroupe les copies sur une file de copie.
     Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(ID3D12Device* device, ID3D12GraphicsCommandList* cmdList, const void* initData, UINT64 byteSize, Microsoft::WRL::ComPtr<ID3D12Resource>& uploadBuffer);
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+// Vue sur des éléments de type T rangés avec un pas fixe dans une mémoire mappée (256 octets pour un constant buffer).
+// Permet de construire les éléments en place plutôt que dans une copie temporaire. La mémoire d'upload est write-combined :
+// on y écrit chaque élément une fois, entièrement, et on ne la relit jamais.
+// N'utilise aucun en-tête D3D12, pour que le code qui remplit les constantes tourne aussi sur NullDevice.
+template<typename T>
+class ElementSpan
+{
+public:
+    ElementSpan(std::uint8_t* data, std::uint32_t elementByteSize, std::uint32_t elementCount)
+        : mData(data), mElementByteSize(elementByteSize), mElementCount(elementCount)
+    {
+    }
+
+    T& operator[](std::uint32_t elementIndex) const
+    {
+        assert(elementIndex < mElementCount);
+        return *reinterpret_cast<T*>(mData + static_cast<size_t>(elementIndex) * mElementByteSize);
+    }
+
+    std::uint32_t Size() const { return mElementCount; }
+    std::uint32_t Stride() const { return mElementByteSize; }
+
+private:
+    std::uint8_t* mData = nullptr;
+    std::uint32_t mElementByteSize = 0;
+    std::uint32_t mElementCount = 0;
+};
\ No newline at end of file
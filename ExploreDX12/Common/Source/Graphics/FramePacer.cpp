@@ -0,0 +1,79 @@
+#include "Graphics/FramePacer.h"
+
+#include <cassert>
+
+FramePacer::FramePacer(int maxFramesInFlight, float targetLatencyMilliseconds)
+    : mMaxFramesInFlight(maxFramesInFlight), mTargetLatencyMilliseconds(targetLatencyMilliseconds), mFramesInFlight(maxFramesInFlight)
+{
+    assert(maxFramesInFlight >= 1);
+}
+
+std::uint64_t FramePacer::FenceValueToWait(std::uint64_t lastSignaledFenceValue) const
+{
+    const std::uint64_t framesInFlight = static_cast<std::uint64_t>(mFramesInFlight);
+    return lastSignaledFenceValue + 1 > framesInFlight ? lastSignaledFenceValue + 1 - framesInFlight : 0;
+}
+
+void FramePacer::BeginFrame(Clock::duration waitTime, std::uint64_t completedFenceValue)
+{
+    const Clock::time_point now = Clock::now();
+    if (mHasFrameStarted)
+    {
+        mFrameSeconds += std::chrono::duration<double>(now - mFrameStart).count();
+        mFrameCount++;
+    }
+    mWaitSeconds += std::chrono::duration<double>(waitTime).count();
+
+    // La fin d'une frame n'est observée qu'ici : sa latence est comptée jusqu'au début de la première frame qui la voit terminée.
+    while (!mPendingFrames.empty() && mPendingFrames.front().FenceValue <= completedFenceValue)
+    {
+        mLatencySeconds += std::chrono::duration<double>(now - mPendingFrames.front().Start).count();
+        mLatencyCount++;
+        mPendingFrames.pop_front();
+    }
+
+    mFrameStart = now;
+    mHasFrameStarted = true;
+
+    if (mFrameCount >= AdaptationInterval)
+    {
+        mLastStats.FrameMilliseconds = static_cast<float>(mFrameSeconds * 1e3 / mFrameCount);
+        mLastStats.CpuMilliseconds = static_cast<float>(mCpuSeconds * 1e3 / mFrameCount);
+        mLastStats.WaitMilliseconds = static_cast<float>(mWaitSeconds * 1e3 / mFrameCount);
+        mLastStats.LatencyMilliseconds = mLatencyCount > 0 ? static_cast<float>(mLatencySeconds * 1e3 / mLatencyCount) : 0.0f;
+        mLastStats.FramesInFlight = mFramesInFlight;
+
+        if (mLatencyCount > 0)
+            Adapt();
+
+        mFrameCount = 0;
+        mLatencyCount = 0;
+        mFrameSeconds = 0.0;
+        mCpuSeconds = 0.0;
+        mWaitSeconds = 0.0;
+        mLatencySeconds = 0.0;
+    }
+}
+
+void FramePacer::EndFrame(std::uint64_t fenceValue)
+{
+    assert(mHasFrameStarted && "EndFrame sans BeginFrame");
+    mCpuSeconds += std::chrono::duration<double>(Clock::now() - mFrameStart).count();
+    mPendingFrames.push_back({ fenceValue, mFrameStart });
+}
+
+void FramePacer::Adapt()
+{
+    if (mTargetLatencyMilliseconds <= 0.0f)
+        return;
+
+    // Au-dessus de la cible, une frame de moins dans la file retire environ une frame de latence.
+    // En dessous, on n'ajoute une frame que si le CPU attend le GPU (sinon elle ne sert à rien) et si la latence, augmentée d'une frame, reste sous la cible :
+    // c'est ce qui évite d'osciller entre deux profondeurs.
+    const Stats& stats = mLastStats;
+    if (stats.LatencyMilliseconds > mTargetLatencyMilliseconds && mFramesInFlight > 1)
+        mFramesInFlight--;
+    else if (mFramesInFlight < mMaxFramesInFlight && stats.WaitMilliseconds > 0.1f * stats.FrameMilliseconds &&
+        stats.LatencyMilliseconds + stats.FrameMilliseconds <= mTargetLatencyMilliseconds)
+        mFramesInFlight++;
+}
\ No newline at end of file
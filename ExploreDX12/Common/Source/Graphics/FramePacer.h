@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+// Régule le nombre de frames que le CPU peut enregistrer d'avance sur le GPU.
+// Plus de frames en vol laissent le CPU et le GPU travailler en même temps et absorbent les variations de durée des frames,
+// mais chaque frame en attente dans la file ajoute une frame de latence entre l'entrée utilisateur et l'image affichée.
+// Avec une latence cible, le pacer mesure la latence réelle (du début d'une frame côté CPU à la fin de son exécution par le GPU)
+// et l'attente du CPU sur le GPU, et ajuste la profondeur entre 1 et maxFramesInFlight. Sans cible, la profondeur reste au maximum.
+// N'utilise aucun en-tête D3D12, pour être utilisable avec NullDevice. Toutes les fonctions sont appelées par le thread qui soumet les frames.
+class FramePacer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Moyennes sur la dernière fenêtre de mesure, en millisecondes.
+    struct Stats
+    {
+        // Intervalle entre deux débuts de frame.
+        float FrameMilliseconds = 0.0f;
+        // Travail du CPU pour une frame, de BeginFrame à EndFrame.
+        float CpuMilliseconds = 0.0f;
+        // CPU bloqué sur une fence avant BeginFrame. La part de la frame où le CPU travaille pendant que le GPU exécute les frames précédentes
+        // est FrameMilliseconds - WaitMilliseconds - (temps GPU) : avec une seule frame en vol, elle est nulle et l'attente vaut le temps GPU.
+        float WaitMilliseconds = 0.0f;
+        // Du début d'une frame à l'observation de sa fence atteinte, donc arrondie par excès d'au plus une frame.
+        float LatencyMilliseconds = 0.0f;
+        int FramesInFlight = 0;
+    };
+
+    // Nombre de frames entre deux ajustements de la profondeur : assez pour lisser les mesures, et pour que la latence se stabilise après un changement.
+    static constexpr int AdaptationInterval = 30;
+
+    // targetLatencyMilliseconds <= 0 : pas de régulation, maxFramesInFlight frames en vol.
+    FramePacer(int maxFramesInFlight, float targetLatencyMilliseconds);
+
+    // Valeur de fence à attendre avant de commencer une frame, pour qu'il n'y ait pas plus de FramesInFlight() frames en vol après sa soumission.
+    // lastSignaledFenceValue est la dernière valeur signalée sur la file. Ne remplace pas l'attente de la frame resource réutilisée.
+    std::uint64_t FenceValueToWait(std::uint64_t lastSignaledFenceValue) const;
+
+    // Début d'une frame, juste après l'attente sur la fence. completedFenceValue permet de mesurer la latence des frames terminées.
+    void BeginFrame(Clock::duration waitTime, std::uint64_t completedFenceValue);
+    // Fin de l'enregistrement de la frame, soumise avec fenceValue.
+    void EndFrame(std::uint64_t fenceValue);
+
+    int FramesInFlight() const { return mFramesInFlight; }
+    int MaxFramesInFlight() const { return mMaxFramesInFlight; }
+    float TargetLatencyMilliseconds() const { return mTargetLatencyMilliseconds; }
+    const Stats& LastStats() const { return mLastStats; }
+
+private:
+    struct PendingFrame
+    {
+        std::uint64_t FenceValue = 0;
+        Clock::time_point Start;
+    };
+
+    void Adapt();
+
+    const int mMaxFramesInFlight;
+    const float mTargetLatencyMilliseconds;
+    int mFramesInFlight;
+
+    std::deque<PendingFrame> mPendingFrames;
+    Clock::time_point mFrameStart;
+    bool mHasFrameStarted = false;
+
+    // Sommes sur la fenêtre de mesure en cours.
+    int mFrameCount = 0;
+    int mLatencyCount = 0;
+    double mFrameSeconds = 0.0;
+    double mCpuSeconds = 0.0;
+    double mWaitSeconds = 0.0;
+    double mLatencySeconds = 0.0;
+    Stats mLastStats;
+};
\ No newline at end of file
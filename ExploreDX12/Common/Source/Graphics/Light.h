@@ -6,7 +6,7 @@ constexpr int MaxLights = 16;
 
 struct Light
 {
-    XMFLOAT3 Strength;  // Couleur de la lumire
+    XMFLOAT3 Strength;  // Couleur de la lumière
     float FalloffStart; // Uniquement point lumineux et projecteurs
     XMFLOAT3 Direction; // Uniquement directionnelle et projecteurs
     float FalloffEnd;   // Uniquement point lumineux et projecteurs
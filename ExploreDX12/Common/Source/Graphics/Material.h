@@ -1,6 +1,8 @@
 #pragma once
 
-#include "Graphics/DirectX12.h"
+#include "Graphics/DirectXMathUtils.h"
+
+#include <string>
 
 struct MaterialConstants
 {
@@ -20,21 +22,18 @@ struct Material
     Material(std::string name, int matCBIndex, XMFLOAT4 diffuseAlbedo, XMFLOAT3 fresnelR0, float roughness)
         : Name(name), MatCBIndex(matCBIndex), DiffuseAlbedo(diffuseAlbedo), FresnelR0(fresnelR0), Roughness(roughness) { }
 
-    // Nom unique du matriau pour la recherche.
+    // Nom unique du matériau pour la recherche.
     std::string Name;
 
-    // Indice dans le buffer constant correspondant  ce matriau.
+    // Indice dans le buffer constant correspondant à ce matériau.
     int MatCBIndex = -1;
 
     // Index dans le tas SRV pour la texture diffuse.
     int DiffuseSrvHeapIndex = -1;
 
-    // Flag indiquant si le matriau a chang et qu'on doit mettre  jour le buffer constant. 
-    // Parce qu'on a un buffer constant de matriau pour chaque FrameResource, on doit appliquer la mise  jour  chaque FrameResource.
-    // Donc, quand on modifie un matriau, on doit dfinir NumFramesDirty = gNumFrameResources pour que chaque FrameResource reoive la mise  jour.
-    int NumFramesDirty = DirectX12::NumberOfFrameResources;
-
-    // Donnes du buffer constant de matriau utilises pour le shading.
+    // Données du buffer constant de matériau utilisées pour le shading.
+    // Parce qu'on a un buffer constant de matériau pour chaque FrameResource, une modification doit être appliquée à chaque FrameResource :
+    // l'application qui modifie un matériau le signale à son DirtyTracker.
     XMFLOAT4 DiffuseAlbedo = { 1.0f, 1.0f, 1.0f, 1.0f };
     XMFLOAT3 FresnelR0 = { 0.01f, 0.01f, 0.01f };
     float Roughness = 0.25f;
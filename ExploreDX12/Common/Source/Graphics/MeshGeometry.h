@@ -24,6 +24,7 @@ struct MeshGeometry
 	Microsoft::WRL::ComPtr<ID3DBlob> IndexBufferCPU = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferGPU = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferGPU = nullptr;
+	// Uploaders de DirectXUtils::CreateDefaultBuffer. Inutiles avec UploadManager, qui réutilise son staging dès la fin des copies.
 	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
 
@@ -0,0 +1,369 @@
+#include "Graphics/NullDevice.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace
+{
+    // Plages d'adresses des buffers vivants, indexées par leur fin pour retrouver le buffer d'une adresse avec upper_bound.
+    struct AddressRange
+    {
+        NullDevice::GpuVirtualAddress Begin = 0;
+        std::uint8_t* Data = nullptr;
+    };
+
+    std::mutex RegistryMutex;
+    std::map<NullDevice::GpuVirtualAddress, AddressRange> Registry;
+    // Les adresses commencent loin de 0 pour qu'une adresse nulle ne corresponde jamais à un buffer, et ne sont jamais réutilisées.
+    NullDevice::GpuVirtualAddress NextAddress = 1ull << 32;
+
+    constexpr size_t BufferAlignment = 256;
+    // Alignement des ressources placées dans un heap D3D12.
+    constexpr NullDevice::GpuVirtualAddress AddressAlignment = 64 * 1024;
+
+    // Empreinte 64 bits rapide, lue par mots de 8 octets, suffisante pour détecter une écriture.
+    std::uint64_t HashRange(const std::uint8_t* data, size_t byteSize)
+    {
+        std::uint64_t hash = 14695981039346656037ull ^ byteSize;
+        size_t i = 0;
+        for (; i + 8 <= byteSize; i += 8)
+        {
+            std::uint64_t word;
+            memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * 0x100000001B3ull;
+            hash ^= hash >> 29;
+        }
+        for (; i < byteSize; i++)
+            hash = (hash ^ data[i]) * 0x100000001B3ull;
+        return hash;
+    }
+}
+
+NullDevice::Buffer::Buffer(size_t byteSize)
+    : mStorage(new std::uint8_t[byteSize + BufferAlignment]()), mByteSize(byteSize)
+{
+    const std::uintptr_t storage = reinterpret_cast<std::uintptr_t>(mStorage.get());
+    mData = mStorage.get() + ((BufferAlignment - (storage & (BufferAlignment - 1))) & (BufferAlignment - 1));
+
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    mAddress = NextAddress;
+    NextAddress += (byteSize + AddressAlignment) & ~(AddressAlignment - 1);
+    Registry[mAddress + byteSize] = { mAddress, mData };
+}
+
+NullDevice::Buffer::~Buffer()
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    Registry.erase(mAddress + mByteSize);
+}
+
+std::uint8_t* NullDevice::Buffer::Resolve(GpuVirtualAddress address, size_t& byteSize)
+{
+    std::lock_guard<std::mutex> lock(RegistryMutex);
+    const auto range = Registry.upper_bound(address);
+    if (range == Registry.end() || address < range->second.Begin)
+        return nullptr;
+
+    const size_t remaining = static_cast<size_t>(range->first - address);
+    if (byteSize > remaining)
+        byteSize = remaining;
+    return range->second.Data + (address - range->second.Begin);
+}
+
+const char* NullDevice::CommandName(CommandType type)
+{
+    static const char* const names[] =
+    {
+        "SetPipelineState",
+        "SetGraphicsRootSignature",
+        "SetGraphicsRootConstantBufferView",
+        "SetGraphicsRootShaderResourceView",
+        "SetGraphicsRoot32BitConstants",
+        "IASetVertexBuffers",
+        "IASetIndexBuffer",
+        "IASetPrimitiveTopology",
+        "ResourceBarrier",
+        "ClearRenderTargetView",
+        "ClearDepthStencilView",
+        "DrawIndexedInstanced",
+        "CopyBufferRegion",
+    };
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<size_t>(CommandType::Count), "Un nom par type de commande");
+    return type < CommandType::Count ? names[static_cast<size_t>(type)] : "?";
+}
+
+void NullDevice::CommandList::Reset()
+{
+    mCommands.clear();
+    mConstants.clear();
+    mIsClosed = false;
+}
+
+void NullDevice::CommandList::Close()
+{
+    assert(!mIsClosed && "Close sur une command list déjà fermée");
+    mIsClosed = true;
+}
+
+void NullDevice::CommandList::Record(const Command& command)
+{
+    assert(!mIsClosed && "Enregistrement dans une command list fermée, Reset manquant");
+    mCommands.push_back(command);
+}
+
+void NullDevice::CommandList::SetPipelineState(std::uint64_t pipelineState)
+{
+    Command command;
+    command.Type = CommandType::SetPipelineState;
+    command.Address = pipelineState;
+    Record(command);
+}
+
+void NullDevice::CommandList::SetGraphicsRootSignature(std::uint64_t rootSignature)
+{
+    Command command;
+    command.Type = CommandType::SetGraphicsRootSignature;
+    command.Address = rootSignature;
+    Record(command);
+}
+
+void NullDevice::CommandList::SetGraphicsRootConstantBufferView(std::uint32_t rootParameterIndex, GpuVirtualAddress address, std::uint32_t byteSize)
+{
+    Command command;
+    command.Type = CommandType::SetGraphicsRootConstantBufferView;
+    command.Slot = rootParameterIndex;
+    command.Address = address;
+    command.Arguments[0] = byteSize;
+    Record(command);
+}
+
+void NullDevice::CommandList::SetGraphicsRootShaderResourceView(std::uint32_t rootParameterIndex, GpuVirtualAddress address, std::uint32_t byteSize)
+{
+    Command command;
+    command.Type = CommandType::SetGraphicsRootShaderResourceView;
+    command.Slot = rootParameterIndex;
+    command.Address = address;
+    command.Arguments[0] = byteSize;
+    Record(command);
+}
+
+void NullDevice::CommandList::SetGraphicsRoot32BitConstants(std::uint32_t rootParameterIndex, std::uint32_t count, const void* data, std::uint32_t destOffset)
+{
+    Command command;
+    command.Type = CommandType::SetGraphicsRoot32BitConstants;
+    command.Slot = rootParameterIndex;
+    command.Arguments[0] = count;
+    command.Arguments[1] = destOffset;
+    command.Arguments[2] = static_cast<std::uint32_t>(mConstants.size());
+    Record(command);
+
+    mConstants.resize(mConstants.size() + count);
+    memcpy(mConstants.data() + command.Arguments[2], data, count * sizeof(std::uint32_t));
+}
+
+void NullDevice::CommandList::SetGraphicsRoot32BitConstant(std::uint32_t rootParameterIndex, std::uint32_t data, std::uint32_t destOffset)
+{
+    SetGraphicsRoot32BitConstants(rootParameterIndex, 1, &data, destOffset);
+}
+
+void NullDevice::CommandList::IASetVertexBuffer(GpuVirtualAddress address, std::uint32_t byteSize, std::uint32_t strideInBytes)
+{
+    Command command;
+    command.Type = CommandType::SetVertexBuffer;
+    command.Address = address;
+    command.Arguments[0] = byteSize;
+    command.Arguments[1] = strideInBytes;
+    Record(command);
+}
+
+void NullDevice::CommandList::IASetIndexBuffer(GpuVirtualAddress address, std::uint32_t byteSize, std::uint32_t indexByteSize)
+{
+    Command command;
+    command.Type = CommandType::SetIndexBuffer;
+    command.Address = address;
+    command.Arguments[0] = byteSize;
+    command.Arguments[1] = indexByteSize;
+    Record(command);
+}
+
+void NullDevice::CommandList::IASetPrimitiveTopology(std::uint32_t topology)
+{
+    Command command;
+    command.Type = CommandType::SetPrimitiveTopology;
+    command.Arguments[0] = topology;
+    Record(command);
+}
+
+void NullDevice::CommandList::ResourceBarrier(std::uint64_t resource, std::uint32_t stateBefore, std::uint32_t stateAfter)
+{
+    Command command;
+    command.Type = CommandType::ResourceBarrier;
+    command.Address = resource;
+    command.Arguments[0] = stateBefore;
+    command.Arguments[1] = stateAfter;
+    Record(command);
+}
+
+void NullDevice::CommandList::ClearRenderTargetView(std::uint64_t renderTarget)
+{
+    Command command;
+    command.Type = CommandType::ClearRenderTarget;
+    command.Address = renderTarget;
+    Record(command);
+}
+
+void NullDevice::CommandList::ClearDepthStencilView(std::uint64_t depthStencil)
+{
+    Command command;
+    command.Type = CommandType::ClearDepthStencil;
+    command.Address = depthStencil;
+    Record(command);
+}
+
+void NullDevice::CommandList::DrawIndexedInstanced(std::uint32_t indexCountPerInstance, std::uint32_t instanceCount, std::uint32_t startIndexLocation, std::int32_t baseVertexLocation, std::uint32_t startInstanceLocation)
+{
+    Command command;
+    command.Type = CommandType::DrawIndexedInstanced;
+    command.Slot = startInstanceLocation;
+    command.Arguments[0] = indexCountPerInstance;
+    command.Arguments[1] = instanceCount;
+    command.Arguments[2] = startIndexLocation;
+    command.Arguments[3] = static_cast<std::uint32_t>(baseVertexLocation);
+    Record(command);
+}
+
+void NullDevice::CommandList::CopyBufferRegion(GpuVirtualAddress destination, GpuVirtualAddress source, std::uint32_t byteSize)
+{
+    Command command;
+    command.Type = CommandType::CopyBufferRegion;
+    command.Address = source;
+    command.Arguments[0] = byteSize;
+    command.Arguments[1] = static_cast<std::uint32_t>(destination);
+    command.Arguments[2] = static_cast<std::uint32_t>(destination >> 32);
+    Record(command);
+}
+
+size_t NullDevice::CommandList::CountOf(CommandType type) const
+{
+    size_t count = 0;
+    for (const Command& command : mCommands)
+        count += command.Type == type;
+    return count;
+}
+
+std::uint64_t NullDevice::Fence::GetCompletedValue()
+{
+    const Clock::time_point now = Clock::now();
+    while (!mPendingSignals.empty() && mPendingSignals.front().CompletionTime <= now)
+    {
+        Complete(mPendingSignals.front());
+        mPendingSignals.pop_front();
+    }
+    return mCompletedValue;
+}
+
+void NullDevice::Fence::Wait(std::uint64_t value)
+{
+    while (GetCompletedValue() < value)
+    {
+        // Une valeur jamais signalée bloquerait indéfiniment, comme avec une vraie fence.
+        assert(!mPendingSignals.empty() && "Attente d'une valeur de fence qui n'a pas été signalée");
+        std::this_thread::sleep_until(mPendingSignals.front().CompletionTime);
+    }
+}
+
+void NullDevice::Fence::Signal(std::uint64_t value, Clock::time_point completionTime, std::vector<Range>&& ranges)
+{
+    PendingSignal signal;
+    signal.Value = value;
+    signal.CompletionTime = completionTime;
+    signal.Ranges = std::move(ranges);
+
+    if (completionTime <= Clock::now() && mPendingSignals.empty())
+        Complete(signal);
+    else
+        mPendingSignals.push_back(std::move(signal));
+}
+
+void NullDevice::Fence::Complete(const PendingSignal& signal)
+{
+    // Le "GPU" lit les plages au moment où la fence est atteinte : elles doivent être restées telles qu'à la soumission.
+    for (const Range& range : signal.Ranges)
+    {
+        size_t byteSize = range.ByteSize;
+        const std::uint8_t* data = Buffer::Resolve(range.Address, byteSize);
+        if (data == nullptr || byteSize != range.ByteSize || HashRange(data, byteSize) != range.Hash)
+            mConflictCount++;
+    }
+
+    if (signal.Value > mCompletedValue)
+        mCompletedValue = signal.Value;
+}
+
+void NullDevice::CommandQueue::ExecuteCommandList(const CommandList& commandList)
+{
+    assert(commandList.IsClosed() && "ExecuteCommandList sur une command list qui n'a pas été fermée");
+
+    mStats.CommandListCount++;
+    mStats.CommandCount += commandList.Commands().size();
+    for (const Command& command : commandList.Commands())
+    {
+        if (command.Type == CommandType::DrawIndexedInstanced)
+        {
+            mStats.DrawCount++;
+            mStats.IndexCount += static_cast<std::uint64_t>(command.Arguments[0]) * command.Arguments[1];
+            continue;
+        }
+
+        if (command.Type == CommandType::CopyBufferRegion)
+        {
+            const GpuVirtualAddress destinationAddress = command.Arguments[1] | static_cast<GpuVirtualAddress>(command.Arguments[2]) << 32;
+            size_t sourceByteSize = command.Arguments[0];
+            size_t destinationByteSize = command.Arguments[0];
+            const std::uint8_t* source = Buffer::Resolve(command.Address, sourceByteSize);
+            std::uint8_t* destination = Buffer::Resolve(destinationAddress, destinationByteSize);
+            assert(source != nullptr && destination != nullptr && sourceByteSize == command.Arguments[0] && destinationByteSize == command.Arguments[0] &&
+                "CopyBufferRegion en dehors des buffers");
+            if (source != nullptr && destination != nullptr)
+                memmove(destination, source, std::min(sourceByteSize, destinationByteSize));
+            mStats.CopyCount++;
+            mStats.CopyByteCount += command.Arguments[0];
+        }
+
+        if (mValidation && command.Address != 0 && command.Arguments[0] != 0 &&
+            (command.Type == CommandType::SetGraphicsRootConstantBufferView || command.Type == CommandType::SetGraphicsRootShaderResourceView ||
+            command.Type == CommandType::SetVertexBuffer || command.Type == CommandType::SetIndexBuffer || command.Type == CommandType::CopyBufferRegion))
+        {
+            size_t byteSize = command.Arguments[0];
+            const std::uint8_t* data = Buffer::Resolve(command.Address, byteSize);
+            assert(data != nullptr && "Adresse GPU qui ne correspond à aucun buffer");
+            if (data != nullptr)
+                mUnsignaledRanges.push_back({ command.Address, byteSize, HashRange(data, byteSize) });
+        }
+    }
+
+    const Clock::time_point now = Clock::now();
+    mTimeline = (mTimeline > now ? mTimeline : now) + mExecutionTime;
+}
+
+void NullDevice::CommandQueue::Signal(Fence& fence, std::uint64_t value)
+{
+    fence.Signal(value, mTimeline + mLatency, std::move(mUnsignaledRanges));
+    mUnsignaledRanges.clear();
+}
+
+std::uint64_t NullDevice::Device::CreateGraphicsPipelineState()
+{
+    if (mPipelineCreationTime > Clock::duration::zero())
+        std::this_thread::sleep_for(mPipelineCreationTime);
+    return mPipelineStateCount.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+std::uint64_t NullDevice::Device::CreateRootSignature()
+{
+    return mRootSignatureCount.fetch_add(1, std::memory_order_relaxed) + 1;
+}
\ No newline at end of file
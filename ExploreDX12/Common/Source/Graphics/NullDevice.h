@@ -0,0 +1,208 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+// Périphérique graphique factice, sans fenêtre ni GPU, pour faire tourner le code CPU d'une frame (par exemple sur une machine d'intégration continue sous Linux).
+// Les buffers sont de la mémoire hôte, les fences se complètent immédiatement ou après une durée d'exécution simulée,
+// et les command lists enregistrent les commandes dans un flux que l'on peut inspecter.
+// Les fonctions reprennent les noms de D3D12 pour que le code qui enregistre une frame se lise de la même façon dans les deux cas.
+// N'utilise aucun en-tête Windows ou D3D12. Comme pour une command list D3D12, chaque objet ne doit être utilisé que par un thread à la fois.
+namespace NullDevice
+{
+    using Clock = std::chrono::steady_clock;
+    using GpuVirtualAddress = std::uint64_t;
+
+    // Mémoire hôte alignée sur 256 octets comme un constant buffer, avec sa propre plage d'adresses "GPU" factices.
+    class Buffer
+    {
+    public:
+        explicit Buffer(size_t byteSize);
+        Buffer(const Buffer& rhs) = delete;
+        Buffer& operator=(const Buffer& rhs) = delete;
+        ~Buffer();
+
+        std::uint8_t* MappedData() const { return mData; }
+        size_t ByteSize() const { return mByteSize; }
+        GpuVirtualAddress GetGPUVirtualAddress() const { return mAddress; }
+
+        // Mémoire hôte correspondant à une adresse GPU factice, nullptr si aucun buffer vivant ne la contient.
+        // byteSize est ramené à ce qui reste dans le buffer à partir de l'adresse.
+        static std::uint8_t* Resolve(GpuVirtualAddress address, size_t& byteSize);
+
+    private:
+        std::unique_ptr<std::uint8_t[]> mStorage;
+        std::uint8_t* mData = nullptr;
+        size_t mByteSize = 0;
+        GpuVirtualAddress mAddress = 0;
+    };
+
+    enum class CommandType : std::uint8_t
+    {
+        SetPipelineState,
+        SetGraphicsRootSignature,
+        SetGraphicsRootConstantBufferView,
+        SetGraphicsRootShaderResourceView,
+        SetGraphicsRoot32BitConstants,
+        SetVertexBuffer,
+        SetIndexBuffer,
+        SetPrimitiveTopology,
+        ResourceBarrier,
+        ClearRenderTarget,
+        ClearDepthStencil,
+        DrawIndexedInstanced,
+        CopyBufferRegion,
+        Count
+    };
+
+    const char* CommandName(CommandType type);
+
+    // Une commande enregistrée. Address est une adresse GPU factice, ou l'identifiant de l'objet (PSO, root signature, ressource).
+    // Le sens de Slot et Arguments dépend du type, voir les fonctions de CommandList.
+    struct Command
+    {
+        CommandType Type = CommandType::Count;
+        std::uint32_t Slot = 0;
+        GpuVirtualAddress Address = 0;
+        std::uint32_t Arguments[4] = {};
+    };
+
+    class CommandList
+    {
+    public:
+        // Vide le flux. Comme en D3D12, on ne peut enregistrer qu'entre Reset et Close.
+        void Reset();
+        void Close();
+        bool IsClosed() const { return mIsClosed; }
+
+        void SetPipelineState(std::uint64_t pipelineState);
+        void SetGraphicsRootSignature(std::uint64_t rootSignature);
+        // Une vue racine n'a pas de taille en D3D12 : byteSize ne sert qu'à la validation de CommandQueue, 256 octets par défaut.
+        void SetGraphicsRootConstantBufferView(std::uint32_t rootParameterIndex, GpuVirtualAddress address, std::uint32_t byteSize = 256);
+        void SetGraphicsRootShaderResourceView(std::uint32_t rootParameterIndex, GpuVirtualAddress address, std::uint32_t byteSize = 256);
+        // Arguments : { nombre de valeurs, décalage de destination, index de la première valeur dans Constants() }.
+        void SetGraphicsRoot32BitConstants(std::uint32_t rootParameterIndex, std::uint32_t count, const void* data, std::uint32_t destOffset);
+        void SetGraphicsRoot32BitConstant(std::uint32_t rootParameterIndex, std::uint32_t data, std::uint32_t destOffset);
+        // Arguments : { taille en octets, pas entre deux sommets } ou { taille en octets, taille d'un index }.
+        void IASetVertexBuffer(GpuVirtualAddress address, std::uint32_t byteSize, std::uint32_t strideInBytes);
+        void IASetIndexBuffer(GpuVirtualAddress address, std::uint32_t byteSize, std::uint32_t indexByteSize);
+        void IASetPrimitiveTopology(std::uint32_t topology);
+        // Arguments : { état avant, état après }.
+        void ResourceBarrier(std::uint64_t resource, std::uint32_t stateBefore, std::uint32_t stateAfter);
+        void ClearRenderTargetView(std::uint64_t renderTarget);
+        void ClearDepthStencilView(std::uint64_t depthStencil);
+        // Arguments : { nombre d'index, nombre d'instances, premier index, premier sommet }, Slot : première instance.
+        void DrawIndexedInstanced(std::uint32_t indexCountPerInstance, std::uint32_t instanceCount, std::uint32_t startIndexLocation, std::int32_t baseVertexLocation, std::uint32_t startInstanceLocation);
+        // Address : source. Arguments : { taille en octets, 32 bits bas puis hauts de l'adresse de destination }.
+        // Les octets sont copiés par CommandQueue::ExecuteCommandList, la validation vérifie que la source ne change pas avant la fence.
+        void CopyBufferRegion(GpuVirtualAddress destination, GpuVirtualAddress source, std::uint32_t byteSize);
+
+        const std::vector<Command>& Commands() const { return mCommands; }
+        const std::vector<std::uint32_t>& Constants() const { return mConstants; }
+        size_t CountOf(CommandType type) const;
+
+    private:
+        void Record(const Command& command);
+
+        std::vector<Command> mCommands;
+        std::vector<std::uint32_t> mConstants;
+        bool mIsClosed = true;
+    };
+
+    class Fence
+    {
+    public:
+        std::uint64_t GetCompletedValue();
+        // Bloque le thread jusqu'à ce que la valeur soit atteinte, comme SetEventOnCompletion suivi de WaitForSingleObject.
+        void Wait(std::uint64_t value);
+
+        // Nombre de plages de buffers que le CPU a modifiées pendant que le "GPU" les utilisait encore (voir CommandQueue::SetValidation).
+        std::uint64_t ConflictCount() const { return mConflictCount; }
+
+    private:
+        friend class CommandQueue;
+
+        struct Range
+        {
+            GpuVirtualAddress Address = 0;
+            size_t ByteSize = 0;
+            std::uint64_t Hash = 0;
+        };
+
+        struct PendingSignal
+        {
+            std::uint64_t Value = 0;
+            Clock::time_point CompletionTime;
+            std::vector<Range> Ranges;
+        };
+
+        void Signal(std::uint64_t value, Clock::time_point completionTime, std::vector<Range>&& ranges);
+        void Complete(const PendingSignal& signal);
+
+        std::deque<PendingSignal> mPendingSignals;
+        std::uint64_t mCompletedValue = 0;
+        std::uint64_t mConflictCount = 0;
+    };
+
+    struct QueueStats
+    {
+        std::uint64_t CommandListCount = 0;
+        std::uint64_t CommandCount = 0;
+        std::uint64_t DrawCount = 0;
+        std::uint64_t IndexCount = 0;
+        std::uint64_t CopyCount = 0;
+        std::uint64_t CopyByteCount = 0;
+    };
+
+    class CommandQueue
+    {
+    public:
+        // Durée simulée de l'exécution de chaque command list par le "GPU", qui les traite l'une après l'autre.
+        // Avec 0 (par défaut), une fence est atteinte dès son Signal.
+        void SetExecutionTime(Clock::duration executionTime) { mExecutionTime = executionTime; }
+        // Délai fixe ajouté entre la fin de l'exécution et le moment où la fence est atteinte, sans occuper la file :
+        // simule un GPU dont le pipeline est profond, où il faut plusieurs frames en vol pour ne pas le laisser inactif.
+        void SetLatency(Clock::duration latency) { mLatency = latency; }
+
+        // Mémorise une empreinte des plages de buffers référencées par chaque command list, et la compare quand la fence suivante est atteinte :
+        // une différence veut dire que le CPU a écrit dans une ressource encore utilisée, par exemple une FrameResource réutilisée trop tôt.
+        void SetValidation(bool enabled) { mValidation = enabled; }
+
+        void ExecuteCommandList(const CommandList& commandList);
+        void Signal(Fence& fence, std::uint64_t value);
+
+        const QueueStats& Stats() const { return mStats; }
+
+    private:
+        Clock::duration mExecutionTime = Clock::duration::zero();
+        Clock::duration mLatency = Clock::duration::zero();
+        Clock::time_point mTimeline;
+        bool mValidation = false;
+        std::vector<Fence::Range> mUnsignaledRanges;
+        QueueStats mStats;
+    };
+
+    // Création des objets qui ne dépendent d'aucune file. Contrairement aux autres objets, peut être utilisé par plusieurs threads à la fois,
+    // comme ID3D12Device.
+    class Device
+    {
+    public:
+        // Durée simulée de la compilation d'un PSO par le pilote.
+        void SetPipelineCreationTime(Clock::duration creationTime) { mPipelineCreationTime = creationTime; }
+
+        // Nouvel identifiant de PSO à chaque appel, après la durée de compilation simulée.
+        std::uint64_t CreateGraphicsPipelineState();
+        std::uint64_t PipelineStateCount() const { return mPipelineStateCount.load(std::memory_order_relaxed); }
+        // Nouvel identifiant de root signature à chaque appel.
+        std::uint64_t CreateRootSignature();
+
+    private:
+        Clock::duration mPipelineCreationTime = Clock::duration::zero();
+        std::atomic<std::uint64_t> mPipelineStateCount { 0 };
+        std::atomic<std::uint64_t> mRootSignatureCount { 0 };
+    };
+}
\ No newline at end of file
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Pipelines créés à l'avance par des threads de travail, une seule fois par clé. La clé est une empreinte de tout ce qui définit le pipeline
+// (voir PipelineStateCache, qui l'utilise avec des ID3D12PipelineState) : deux demandes identiques n'en créent qu'un.
+// Les demandes sont traitées dans l'ordre, pendant que le thread principal continue de s'initialiser ; Get n'attend que si le pipeline n'est pas encore prêt,
+// et crée lui-même un pipeline qu'aucun thread n'a encore commencé plutôt que d'attendre la fin de la file.
+// N'utilise aucun en-tête D3D12 : Pipeline est n'importe quel type, ce qui permet de tester le cache avec NullDevice.
+// Toutes les fonctions peuvent être appelées depuis plusieurs threads.
+template<typename Pipeline>
+class PipelineCache
+{
+public:
+    using Key = std::uint64_t;
+    using Creator = std::function<Pipeline()>;
+
+    struct Stats
+    {
+        std::uint32_t RequestCount = 0;
+        // Demandes d'une clé déjà demandée, qui n'ont rien créé.
+        std::uint32_t DuplicateCount = 0;
+        std::uint32_t CreatedCount = 0;
+        // Pipelines créés par Get sur le thread appelant, parce qu'ils étaient demandés trop tard : chacun est un à-coup possible.
+        std::uint32_t InlineCount = 0;
+    };
+
+    // threadCount <= 0 : un thread par cœur, moins le thread principal.
+    explicit PipelineCache(int threadCount = 0)
+    {
+        if (threadCount <= 0)
+            threadCount = static_cast<int>(std::thread::hardware_concurrency()) - 1;
+        if (threadCount < 1)
+            threadCount = 1;
+
+        for (int i = 0; i < threadCount; i++)
+            mThreads.emplace_back([this] { WorkerLoop(); });
+    }
+
+    PipelineCache(const PipelineCache& rhs) = delete;
+    PipelineCache& operator=(const PipelineCache& rhs) = delete;
+
+    // Les créateurs utilisent souvent des données de l'appelant (bytecode, input layout) : les demandes en cours sont terminées avant de rendre la main.
+    ~PipelineCache()
+    {
+        WaitAll();
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        mQueueChanged.notify_all();
+        for (std::thread& thread : mThreads)
+            thread.join();
+    }
+
+    // Demande la création du pipeline de la clé. Renvoie false si la clé a déjà été demandée, creator n'est alors pas appelé.
+    bool Request(Key key, Creator creator)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStats.RequestCount++;
+            std::unique_ptr<Entry>& entry = mEntries[key];
+            if (entry != nullptr)
+            {
+                mStats.DuplicateCount++;
+                return false;
+            }
+
+            entry = std::make_unique<Entry>();
+            entry->Create = std::move(creator);
+            mQueue.push_back(entry.get());
+            mPendingCount++;
+        }
+        mQueueChanged.notify_one();
+        return true;
+    }
+
+    // Pipeline de la clé, qui doit avoir été demandée. Attend la fin de sa création si nécessaire, et relance l'exception du créateur s'il a échoué.
+    const Pipeline& Get(Key key)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        const auto found = mEntries.find(key);
+        assert(found != mEntries.end() && "Pipeline jamais demandé");
+        Entry& entry = *found->second;
+
+        if (entry.State == EntryState::Queued)
+        {
+            // Retiré de la file par le thread de travail qui le trouvera déjà commencé.
+            entry.State = EntryState::Creating;
+            mStats.InlineCount++;
+            lock.unlock();
+            Create(entry);
+            lock.lock();
+        }
+        mCreated.wait(lock, [&] { return entry.State == EntryState::Ready; });
+
+        if (entry.Error != nullptr)
+            std::rethrow_exception(entry.Error);
+        return entry.Value;
+    }
+
+    bool IsReady(Key key) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto found = mEntries.find(key);
+        return found != mEntries.end() && found->second->State == EntryState::Ready;
+    }
+
+    // Attend que toutes les demandes faites jusqu'ici soient créées.
+    void WaitAll()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mCreated.wait(lock, [&] { return mPendingCount == 0; });
+    }
+
+    // Appelle function(clé, pipeline) pour chaque pipeline créé sans erreur.
+    template<typename Function>
+    void ForEachReady(Function&& function) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto& [key, entry] : mEntries)
+        {
+            if (entry->State == EntryState::Ready && entry->Error == nullptr)
+                function(key, entry->Value);
+        }
+    }
+
+    Stats GetStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+private:
+    enum class EntryState : std::uint8_t
+    {
+        Queued,
+        Creating,
+        Ready,
+    };
+
+    struct Entry
+    {
+        Creator Create;
+        EntryState State = EntryState::Queued;
+        Pipeline Value {};
+        std::exception_ptr Error;
+    };
+
+    // Appelée sans le verrou, par le seul thread qui a fait passer l'entrée à Creating.
+    void Create(Entry& entry)
+    {
+        try
+        {
+            entry.Value = entry.Create();
+        }
+        catch (...)
+        {
+            entry.Error = std::current_exception();
+        }
+        entry.Create = nullptr;
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            entry.State = EntryState::Ready;
+            mStats.CreatedCount++;
+            mPendingCount--;
+        }
+        mCreated.notify_all();
+    }
+
+    void WorkerLoop()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mQueueChanged.wait(lock, [&] { return mStopping || !mQueue.empty(); });
+            if (mQueue.empty())
+                return;
+
+            Entry* entry = mQueue.front();
+            mQueue.pop_front();
+            if (entry->State != EntryState::Queued)
+                continue;
+
+            entry->State = EntryState::Creating;
+            lock.unlock();
+            Create(*entry);
+            lock.lock();
+        }
+    }
+
+    mutable std::mutex mMutex;
+    std::condition_variable mQueueChanged;
+    std::condition_variable mCreated;
+    // Les entrées ne sont jamais retirées : les références rendues par Get restent valides aussi longtemps que le cache.
+    std::unordered_map<Key, std::unique_ptr<Entry>> mEntries;
+    std::deque<Entry*> mQueue;
+    int mPendingCount = 0;
+    bool mStopping = false;
+    Stats mStats;
+    std::vector<std::thread> mThreads;
+};
\ No newline at end of file
@@ -0,0 +1,285 @@
+#include "Graphics/PipelineStateCache.h"
+
+#include "Utils/Hasher.h"
+
+#include <cwchar>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    void AddValue(Hasher& hasher, std::uint64_t value)
+    {
+        hasher.Add(value);
+    }
+
+    void AddFloat(Hasher& hasher, float value)
+    {
+        hasher.Add(&value, sizeof(value));
+    }
+
+    void AddString(Hasher& hasher, const char* text)
+    {
+        hasher.Add(std::string(text != nullptr ? text : ""));
+    }
+
+    void AddShader(Hasher& hasher, const D3D12_SHADER_BYTECODE& shader)
+    {
+        AddValue(hasher, shader.BytecodeLength);
+        if (shader.pShaderBytecode != nullptr)
+            hasher.Add(shader.pShaderBytecode, shader.BytecodeLength);
+    }
+
+    void AddStencilFace(Hasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& face)
+    {
+        AddValue(hasher, face.StencilFailOp);
+        AddValue(hasher, face.StencilDepthFailOp);
+        AddValue(hasher, face.StencilPassOp);
+        AddValue(hasher, face.StencilFunc);
+    }
+
+    // Nom du PSO dans la library.
+    std::wstring LibraryName(PipelineStateCache::Key key)
+    {
+        wchar_t name[17];
+        std::swprintf(name, 17, L"%016llx", static_cast<unsigned long long>(key));
+        return name;
+    }
+}
+
+PipelineStateCache::PipelineStateCache(ID3D12Device* device, std::filesystem::path libraryPath, int threadCount)
+    : mDevice(device), mLibraryPath(std::move(libraryPath)), mPipelines(threadCount)
+{
+    Microsoft::WRL::ComPtr<ID3D12Device1> device1;
+    if (FAILED(mDevice.As(&device1)))
+    {
+        Logs::Message("ID3D12Device1 non disponible : les PSO ne seront pas gardés d'un lancement à l'autre");
+        return;
+    }
+
+    std::ifstream stream(mLibraryPath, std::ios::binary);
+    if (stream)
+        mLibraryData.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+    // Une library écrite par un autre pilote ou un autre adaptateur est refusée (D3D12_ERROR_DRIVER_VERSION_MISMATCH, D3D12_ERROR_ADAPTER_NOT_FOUND) :
+    // on repart d'une library vide, qui remplacera l'ancienne.
+    HRESULT hr = E_FAIL;
+    if (!mLibraryData.empty())
+        hr = device1->CreatePipelineLibrary(mLibraryData.data(), mLibraryData.size(), IID_PPV_ARGS(&mLibrary));
+    if (FAILED(hr))
+    {
+        mLibraryData.clear();
+        mLibrary.Reset();
+        // Un pilote peut ne pas gérer les libraries (DXGI_ERROR_UNSUPPORTED).
+        if (FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&mLibrary))))
+            Logs::Message("Pipeline library non disponible : les PSO ne seront pas gardés d'un lancement à l'autre");
+    }
+}
+
+PipelineStateCache::~PipelineStateCache()
+{
+    Save();
+}
+
+void PipelineStateCache::RegisterRootSignature(ID3D12RootSignature* rootSignature, const void* serializedData, size_t serializedByteSize)
+{
+    Hasher hasher;
+    hasher.Add(serializedData, serializedByteSize);
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRootSignatureHashes[rootSignature] = hasher.Finish();
+}
+
+PipelineStateCache::Key PipelineStateCache::Request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    const Key key = Hash(desc);
+    mPipelines.Request(key, [this, key, desc] { return Create(key, desc); });
+    return key;
+}
+
+ID3D12PipelineState* PipelineStateCache::Get(Key key)
+{
+    return mPipelines.Get(key).Get();
+}
+
+std::uint64_t PipelineStateCache::Hash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) const
+{
+    Hasher hasher;
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        const auto rootSignature = mRootSignatureHashes.find(desc.pRootSignature);
+        assert((desc.pRootSignature == nullptr || rootSignature != mRootSignatureHashes.end()) && "Root signature non enregistré");
+        AddValue(hasher, rootSignature != mRootSignatureHashes.end() ? rootSignature->second : 0);
+    }
+
+    AddShader(hasher, desc.VS);
+    AddShader(hasher, desc.PS);
+    AddShader(hasher, desc.DS);
+    AddShader(hasher, desc.HS);
+    AddShader(hasher, desc.GS);
+
+    AddValue(hasher, desc.StreamOutput.NumEntries);
+    for (UINT i = 0; i < desc.StreamOutput.NumEntries; i++)
+    {
+        const D3D12_SO_DECLARATION_ENTRY& entry = desc.StreamOutput.pSODeclaration[i];
+        AddValue(hasher, entry.Stream);
+        AddString(hasher, entry.SemanticName);
+        AddValue(hasher, entry.SemanticIndex);
+        AddValue(hasher, entry.StartComponent);
+        AddValue(hasher, entry.ComponentCount);
+        AddValue(hasher, entry.OutputSlot);
+    }
+    AddValue(hasher, desc.StreamOutput.NumStrides);
+    for (UINT i = 0; i < desc.StreamOutput.NumStrides; i++)
+        AddValue(hasher, desc.StreamOutput.pBufferStrides[i]);
+    AddValue(hasher, desc.StreamOutput.RasterizedStream);
+
+    // Sans IndependentBlendEnable, seul le premier render target est lu.
+    AddValue(hasher, desc.BlendState.AlphaToCoverageEnable);
+    AddValue(hasher, desc.BlendState.IndependentBlendEnable);
+    const UINT blendCount = desc.BlendState.IndependentBlendEnable ? 8 : 1;
+    for (UINT i = 0; i < blendCount; i++)
+    {
+        const D3D12_RENDER_TARGET_BLEND_DESC& blend = desc.BlendState.RenderTarget[i];
+        AddValue(hasher, blend.BlendEnable);
+        AddValue(hasher, blend.LogicOpEnable);
+        AddValue(hasher, blend.SrcBlend);
+        AddValue(hasher, blend.DestBlend);
+        AddValue(hasher, blend.BlendOp);
+        AddValue(hasher, blend.SrcBlendAlpha);
+        AddValue(hasher, blend.DestBlendAlpha);
+        AddValue(hasher, blend.BlendOpAlpha);
+        AddValue(hasher, blend.LogicOp);
+        AddValue(hasher, blend.RenderTargetWriteMask);
+    }
+    AddValue(hasher, desc.SampleMask);
+
+    const D3D12_RASTERIZER_DESC& rasterizer = desc.RasterizerState;
+    AddValue(hasher, rasterizer.FillMode);
+    AddValue(hasher, rasterizer.CullMode);
+    AddValue(hasher, rasterizer.FrontCounterClockwise);
+    AddValue(hasher, static_cast<std::uint32_t>(rasterizer.DepthBias));
+    AddFloat(hasher, rasterizer.DepthBiasClamp);
+    AddFloat(hasher, rasterizer.SlopeScaledDepthBias);
+    AddValue(hasher, rasterizer.DepthClipEnable);
+    AddValue(hasher, rasterizer.MultisampleEnable);
+    AddValue(hasher, rasterizer.AntialiasedLineEnable);
+    AddValue(hasher, rasterizer.ForcedSampleCount);
+    AddValue(hasher, rasterizer.ConservativeRaster);
+
+    const D3D12_DEPTH_STENCIL_DESC& depthStencil = desc.DepthStencilState;
+    AddValue(hasher, depthStencil.DepthEnable);
+    AddValue(hasher, depthStencil.DepthWriteMask);
+    AddValue(hasher, depthStencil.DepthFunc);
+    AddValue(hasher, depthStencil.StencilEnable);
+    if (depthStencil.StencilEnable)
+    {
+        AddValue(hasher, depthStencil.StencilReadMask);
+        AddValue(hasher, depthStencil.StencilWriteMask);
+        AddStencilFace(hasher, depthStencil.FrontFace);
+        AddStencilFace(hasher, depthStencil.BackFace);
+    }
+
+    AddValue(hasher, desc.InputLayout.NumElements);
+    for (UINT i = 0; i < desc.InputLayout.NumElements; i++)
+    {
+        const D3D12_INPUT_ELEMENT_DESC& element = desc.InputLayout.pInputElementDescs[i];
+        AddString(hasher, element.SemanticName);
+        AddValue(hasher, element.SemanticIndex);
+        AddValue(hasher, element.Format);
+        AddValue(hasher, element.InputSlot);
+        AddValue(hasher, element.AlignedByteOffset);
+        AddValue(hasher, element.InputSlotClass);
+        AddValue(hasher, element.InstanceDataStepRate);
+    }
+
+    AddValue(hasher, desc.IBStripCutValue);
+    AddValue(hasher, desc.PrimitiveTopologyType);
+    AddValue(hasher, desc.NumRenderTargets);
+    for (UINT i = 0; i < desc.NumRenderTargets && i < 8; i++)
+        AddValue(hasher, desc.RTVFormats[i]);
+    AddValue(hasher, desc.DSVFormat);
+    AddValue(hasher, desc.SampleDesc.Count);
+    AddValue(hasher, desc.SampleDesc.Quality);
+    AddValue(hasher, desc.NodeMask);
+    // CachedPSO n'est qu'une aide à la création, le PSO obtenu est le même.
+    AddValue(hasher, desc.Flags);
+
+    return hasher.Finish();
+}
+
+PipelineStateCache::Stats PipelineStateCache::GetStats() const
+{
+    Stats stats;
+    stats.Pipelines = mPipelines.GetStats();
+    std::lock_guard<std::mutex> lock(mMutex);
+    stats.LoadedCount = mLoadedCount;
+    return stats;
+}
+
+void PipelineStateCache::Save()
+{
+    mPipelines.WaitAll();
+
+    std::vector<std::uint8_t> data;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mLibrary == nullptr || !mLibraryChanged)
+            return;
+
+        // Appelé depuis le destructeur : une erreur est signalée sans exception.
+        data.resize(mLibrary->GetSerializedSize());
+        if (FAILED(mLibrary->Serialize(data.data(), data.size())))
+        {
+            Logs::Error("Impossible de sérialiser la pipeline library {}", mLibraryPath.string());
+            return;
+        }
+        mLibraryChanged = false;
+    }
+
+    // Écrite sous un autre nom puis renommée, comme les entrées du ShaderCache : une library incomplète serait refusée au lancement suivant.
+    std::error_code error;
+    std::filesystem::create_directories(mLibraryPath.parent_path(), error);
+    const std::filesystem::path temporaryPath = mLibraryPath.string() + ".tmp";
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!stream)
+        {
+            Logs::Error("Impossible d'écrire la pipeline library {}", mLibraryPath.string());
+            return;
+        }
+    }
+    std::filesystem::rename(temporaryPath, mLibraryPath, error);
+    if (error)
+        Logs::Error("Impossible d'écrire la pipeline library {}", mLibraryPath.string());
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineStateCache::Create(Key key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc)
+{
+    const std::wstring name = LibraryName(key);
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState;
+
+    // La library est protégée par le verrou, mais pas la compilation : plusieurs PSO se compilent en même temps.
+    if (mLibrary != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // E_INVALIDARG si le nom est absent ou si la description ne correspond pas à celle du PSO enregistré.
+        if (SUCCEEDED(mLibrary->LoadGraphicsPipeline(name.c_str(), &desc, IID_PPV_ARGS(&pipelineState))))
+        {
+            mLoadedCount++;
+            return pipelineState;
+        }
+    }
+
+    ThrowIfFailed(mDevice->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&pipelineState)));
+
+    if (mLibrary != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (SUCCEEDED(mLibrary->StorePipeline(name.c_str(), pipelineState.Get())))
+            mLibraryChanged = true;
+    }
+    return pipelineState;
+}
\ No newline at end of file
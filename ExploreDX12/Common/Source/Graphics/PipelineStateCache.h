@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Graphics/DirectXUtils.h"
+#include "Graphics/PipelineCache.h"
+
+#include <filesystem>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// PSO créés sur des threads de travail dès qu'ils sont demandés, une seule fois par description (PipelineCache), et conservés d'un lancement à l'autre
+// dans un ID3D12PipelineLibrary : au lancement suivant, un PSO déjà compilé par le pilote est relu au lieu d'être recompilé.
+// La clé d'un PSO est une empreinte canonique de sa description : le contenu du bytecode des shaders, de l'input layout et du root signature
+// plutôt que leurs adresses, et seulement les champs que D3D12 lit (pas de blend par render target sans IndependentBlendEnable, pas de formats
+// au-delà de NumRenderTargets, pas de faces de stencil sans StencilEnable). Elle est donc stable d'un lancement à l'autre et sert de nom dans la library.
+// Toutes les fonctions peuvent être appelées depuis plusieurs threads.
+class PipelineStateCache
+{
+public:
+    using Key = PipelineCache<Microsoft::WRL::ComPtr<ID3D12PipelineState>>::Key;
+
+    // La library est relue depuis libraryPath, puis réécrite à la destruction si de nouveaux PSO y ont été ajoutés.
+    PipelineStateCache(ID3D12Device* device, std::filesystem::path libraryPath, int threadCount = 0);
+    PipelineStateCache(const PipelineStateCache& rhs) = delete;
+    PipelineStateCache& operator=(const PipelineStateCache& rhs) = delete;
+    ~PipelineStateCache();
+
+    // Le root signature entre dans la clé par son contenu sérialisé (celui passé à CreateRootSignature), son adresse changeant à chaque lancement.
+    void RegisterRootSignature(ID3D12RootSignature* rootSignature, const void* serializedData, size_t serializedByteSize);
+
+    // Demande la création du PSO, sur un thread de travail. Le bytecode, l'input layout et le root signature de desc doivent rester valides
+    // jusqu'à ce que le PSO soit prêt (Get, ou destruction du cache).
+    Key Request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+    // PSO de la clé, en attendant la fin de sa création si nécessaire.
+    ID3D12PipelineState* Get(Key key);
+
+    // Empreinte canonique de la description, celle utilisée comme clé.
+    std::uint64_t Hash(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc) const;
+
+    struct Stats
+    {
+        PipelineCache<Microsoft::WRL::ComPtr<ID3D12PipelineState>>::Stats Pipelines;
+        // PSO relus depuis la library plutôt que compilés.
+        std::uint32_t LoadedCount = 0;
+    };
+    Stats GetStats() const;
+
+    // Écrit la library si de nouveaux PSO y ont été ajoutés. Appelé à la destruction.
+    void Save();
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> Create(Key key, const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc);
+
+    Microsoft::WRL::ComPtr<ID3D12Device> mDevice;
+    std::filesystem::path mLibraryPath;
+    // Le contenu relu doit rester en mémoire aussi longtemps que la library qui le référence.
+    std::vector<std::uint8_t> mLibraryData;
+    // nullptr si le runtime ne connaît pas ID3D12Device1 : les PSO sont alors seulement créés.
+    Microsoft::WRL::ComPtr<ID3D12PipelineLibrary> mLibrary;
+    mutable std::mutex mMutex;
+    std::unordered_map<ID3D12RootSignature*, std::uint64_t> mRootSignatureHashes;
+    bool mLibraryChanged = false;
+    std::uint32_t mLoadedCount = 0;
+    // Déclaré en dernier : détruit en premier, il termine les créations en cours pendant que le reste est encore valide.
+    PipelineCache<Microsoft::WRL::ComPtr<ID3D12PipelineState>> mPipelines;
+};
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "Graphics/ShaderCache.h"
+
+#include "Utils/Hasher.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <unordered_set>
+
+namespace
+{
+    std::string ToHex(std::uint64_t value)
+    {
+        char text[17];
+        std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value));
+        return text;
+    }
+
+    std::string PathKey(const std::filesystem::path& path)
+    {
+        return path.lexically_normal().generic_string();
+    }
+
+    // Noms des fichiers des lignes #include "..." ou #include <...>. Les inclusions des blocs #if désactivés sont gardées aussi :
+    // une dépendance de trop ne coûte qu'une recompilation inutile.
+    std::vector<std::string> ParseIncludes(const std::string& source)
+    {
+        std::vector<std::string> includes;
+        size_t position = 0;
+        while (position < source.size())
+        {
+            size_t lineEnd = source.find('\n', position);
+            if (lineEnd == std::string::npos)
+                lineEnd = source.size();
+
+            size_t i = source.find_first_not_of(" \t", position);
+            if (i < lineEnd && source[i] == '#')
+            {
+                i = source.find_first_not_of(" \t", i + 1);
+                if (i < lineEnd && source.compare(i, 7, "include") == 0)
+                {
+                    i = source.find_first_not_of(" \t", i + 7);
+                    if (i < lineEnd && (source[i] == '"' || source[i] == '<'))
+                    {
+                        const char closing = source[i] == '"' ? '"' : '>';
+                        const size_t nameEnd = source.find(closing, i + 1);
+                        if (nameEnd < lineEnd)
+                            includes.push_back(source.substr(i + 1, nameEnd - i - 1));
+                    }
+                }
+            }
+            position = lineEnd + 1;
+        }
+        return includes;
+    }
+}
+
+ShaderCache::ShaderCache(std::filesystem::path directory, std::string compilerVersion)
+    : mDirectory(std::move(directory)), mCompilerVersion(std::move(compilerVersion))
+{
+    std::error_code error;
+    std::filesystem::create_directories(mDirectory, error);
+}
+
+std::shared_ptr<const ShaderCache::Bytecode> ShaderCache::Load(const Request& request, const Compiler& compiler)
+{
+    const std::string entryName = EntryName(request);
+    const std::filesystem::path entryPath = mDirectory / (entryName + ".cso");
+
+    std::shared_ptr<const MappedFile> file = MappedFile::Open(entryPath);
+    if (file != nullptr)
+    {
+        mStats.HitCount++;
+        return std::make_shared<const Bytecode>(std::move(file));
+    }
+
+    std::vector<std::uint8_t> byteCode;
+    if (!compiler(request, byteCode) || byteCode.empty())
+    {
+        mStats.FailureCount++;
+        return nullptr;
+    }
+    mStats.CompileCount++;
+
+    // Écrit sous un autre nom puis renommé : un fichier du cache est toujours complet, même si l'application s'arrête pendant l'écriture.
+    std::error_code error;
+    const std::filesystem::path temporaryPath = mDirectory / (entryName + ".tmp");
+    {
+        std::ofstream stream(temporaryPath, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(byteCode.data()), static_cast<std::streamsize>(byteCode.size()));
+        if (!stream)
+            return std::make_shared<const Bytecode>(std::move(byteCode));
+    }
+    std::filesystem::rename(temporaryPath, entryPath, error);
+    if (error)
+    {
+        std::filesystem::remove(temporaryPath, error);
+        return std::make_shared<const Bytecode>(std::move(byteCode));
+    }
+
+    // Les autres entrées de la même requête ont été compilées avec d'anciennes sources.
+    const std::string requestPrefix = entryName.substr(0, entryName.find('-') + 1);
+    for (std::filesystem::directory_iterator it(mDirectory, error), end; !error && it != end; it.increment(error))
+    {
+        // Une entrée impossible à supprimer (encore ouverte par un autre lancement) est laissée, le parcours continue.
+        const std::string name = it->path().filename().string();
+        std::error_code removeError;
+        if (name.compare(0, requestPrefix.size(), requestPrefix) == 0 && it->path() != entryPath && std::filesystem::remove(it->path(), removeError))
+            mStats.RemovedCount++;
+    }
+
+    file = MappedFile::Open(entryPath);
+    if (file == nullptr)
+        return std::make_shared<const Bytecode>(std::move(byteCode));
+    return std::make_shared<const Bytecode>(std::move(file));
+}
+
+std::string ShaderCache::EntryName(const Request& request)
+{
+    return ToHex(HashRequest(request)) + "-" + ToHex(HashDependencies(request.SourcePath));
+}
+
+std::vector<std::filesystem::path> ShaderCache::Dependencies(const std::filesystem::path& sourcePath)
+{
+    std::vector<std::filesystem::path> dependencies;
+    std::unordered_set<std::string> visited;
+    std::vector<std::filesystem::path> pending = { sourcePath.lexically_normal() };
+    while (!pending.empty())
+    {
+        const std::filesystem::path path = pending.back();
+        pending.pop_back();
+        if (!visited.insert(PathKey(path)).second)
+            continue;
+
+        dependencies.push_back(path);
+        const SourceFile& source = GetSource(path);
+        // Empilés à l'envers pour être visités dans l'ordre du fichier.
+        for (auto include = source.Includes.rbegin(); include != source.Includes.rend(); ++include)
+            pending.push_back(*include);
+    }
+    return dependencies;
+}
+
+const ShaderCache::SourceFile& ShaderCache::GetSource(const std::filesystem::path& path)
+{
+    const std::string key = PathKey(path);
+    const auto cached = mSources.find(key);
+    if (cached != mSources.end())
+        return cached->second;
+
+    SourceFile& source = mSources[key];
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream)
+        return source;
+
+    const std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    Hasher hasher;
+    hasher.Add(text);
+    source.Exists = true;
+    source.Hash = hasher.Finish();
+    for (const std::string& include : ParseIncludes(text))
+        source.Includes.push_back((path.parent_path() / include).lexically_normal());
+    return source;
+}
+
+std::uint64_t ShaderCache::HashDependencies(const std::filesystem::path& sourcePath)
+{
+    // Un fichier inclus absent compte aussi : s'il apparaît (ou si un autre chemin de recherche le fournissait), la clé change.
+    Hasher hasher;
+    for (const std::filesystem::path& path : Dependencies(sourcePath))
+    {
+        const SourceFile& source = GetSource(path);
+        hasher.Add(PathKey(path));
+        hasher.Add(source.Exists ? source.Hash : 0);
+    }
+    return hasher.Finish();
+}
+
+std::uint64_t ShaderCache::HashRequest(const Request& request) const
+{
+    // Le chemin absolu sépare deux applications qui auraient chacune leur color.hlsl et partageraient le dossier du cache.
+    std::error_code error;
+    Hasher hasher;
+    hasher.Add(mCompilerVersion);
+    hasher.Add(PathKey(std::filesystem::absolute(request.SourcePath, error)));
+    hasher.Add(request.EntryPoint);
+    hasher.Add(request.Target);
+    hasher.Add(static_cast<std::uint64_t>(request.Flags));
+    hasher.Add(static_cast<std::uint64_t>(request.Defines.size()));
+    for (const Define& define : request.Defines)
+    {
+        hasher.Add(define.Name);
+        hasher.Add(define.Value);
+    }
+    return hasher.Finish();
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Utils/MappedFile.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Cache sur disque du bytecode des shaders, adressé par le contenu : la clé d'un shader est l'empreinte de son fichier et de tous les fichiers
+// qu'il inclut, de ses defines, de son point d'entrée, de sa cible, des options de compilation et de la version du compilateur.
+// Modifier un de ces éléments change la clé, il n'y a donc rien à invalider à la main ; l'entrée périmée de la même requête est supprimée
+// quand la nouvelle est écrite. Le bytecode en cache est projeté en mémoire au lieu d'être lu.
+// N'utilise aucun en-tête D3D12 : le compilateur est une fonction fournie par l'appelant (D3DCompileFromFile dans DirectXUtils::CompileShader),
+// ce qui permet de tester le cache sous Linux avec un faux compilateur. À utiliser depuis un seul thread.
+class ShaderCache
+{
+public:
+    struct Define
+    {
+        std::string Name;
+        std::string Value;
+    };
+
+    struct Request
+    {
+        std::filesystem::path SourcePath;
+        std::vector<Define> Defines;
+        std::string EntryPoint;
+        std::string Target;
+        std::uint32_t Flags = 0;
+    };
+
+    // Remplit byteCode et renvoie true, ou false si la compilation échoue (rien n'est alors écrit dans le cache).
+    using Compiler = std::function<bool(const Request& request, std::vector<std::uint8_t>& byteCode)>;
+
+    // Bytecode projeté depuis le cache, ou gardé en mémoire quand le cache n'a pas pu être écrit.
+    class Bytecode
+    {
+    public:
+        explicit Bytecode(std::shared_ptr<const MappedFile> file) : mFile(std::move(file)) {}
+        explicit Bytecode(std::vector<std::uint8_t>&& memory) : mMemory(std::move(memory)) {}
+
+        const std::uint8_t* Data() const { return mFile != nullptr ? mFile->Data() : mMemory.data(); }
+        size_t Size() const { return mFile != nullptr ? mFile->Size() : mMemory.size(); }
+        bool IsMapped() const { return mFile != nullptr; }
+
+    private:
+        std::shared_ptr<const MappedFile> mFile;
+        std::vector<std::uint8_t> mMemory;
+    };
+
+    struct Stats
+    {
+        std::uint32_t HitCount = 0;
+        std::uint32_t CompileCount = 0;
+        std::uint32_t FailureCount = 0;
+        // Entrées périmées supprimées.
+        std::uint32_t RemovedCount = 0;
+    };
+
+    // compilerVersion fait partie de toutes les clés : un autre compilateur ne relit pas le bytecode de celui-ci.
+    ShaderCache(std::filesystem::path directory, std::string compilerVersion);
+
+    // Bytecode de la requête, projeté depuis le cache ou compilé puis ajouté au cache. nullptr si la compilation échoue.
+    // Si le dossier du cache n'est pas accessible en écriture, le bytecode compilé est quand même renvoyé, depuis la mémoire.
+    std::shared_ptr<const Bytecode> Load(const Request& request, const Compiler& compiler);
+    // Nom du fichier de la requête dans le cache pour les sources actuelles : empreinte de la requête, puis de ses sources.
+    std::string EntryName(const Request& request);
+
+    // Fichiers dont dépend le shader (lui-même compris), dans l'ordre où ils sont inclus pour la première fois.
+    std::vector<std::filesystem::path> Dependencies(const std::filesystem::path& sourcePath);
+
+    // Oublie les empreintes des fichiers sources, qui ne sont calculées qu'une fois : à appeler quand des sources ont pu changer.
+    void ClearSourceHashes() { mSources.clear(); }
+
+    const Stats& GetStats() const { return mStats; }
+    const std::filesystem::path& Directory() const { return mDirectory; }
+
+private:
+    struct SourceFile
+    {
+        bool Exists = false;
+        std::uint64_t Hash = 0;
+        // Fichiers inclus, résolus par rapport au dossier du fichier comme le fait D3D_COMPILE_STANDARD_FILE_INCLUDE.
+        std::vector<std::filesystem::path> Includes;
+    };
+
+    const SourceFile& GetSource(const std::filesystem::path& path);
+    // Empreinte de la fermeture des inclusions de sourcePath.
+    std::uint64_t HashDependencies(const std::filesystem::path& sourcePath);
+    std::uint64_t HashRequest(const Request& request) const;
+
+    std::filesystem::path mDirectory;
+    std::string mCompilerVersion;
+    std::unordered_map<std::string, SourceFile> mSources;
+    Stats mStats;
+};
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "Graphics/TransformUtils.h"
+
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "Utils/Simd.h"
+
+namespace
+{
+    using Simd::Float8;
+
+    constexpr int LaneCount = 8;
+
+    // Applique kernel par groupes de 8 éléments. Le dernier groupe incomplet passe par des tableaux locaux complétés par des zéros,
+    // pour que chaque élément suive exactement le même calcul quelle que soit sa position.
+    template<int InputCount, int OutputCount, typename Kernel>
+    void ForEachGroup(const float* const (&inputs)[InputCount], float* const (&outputs)[OutputCount], size_t count, const Kernel& kernel)
+    {
+        Float8 in[InputCount];
+        Float8 out[OutputCount];
+
+        size_t i = 0;
+        for (; i + LaneCount <= count; i += LaneCount)
+        {
+            for (int k = 0; k < InputCount; k++)
+                in[k] = Float8::Load(inputs[k] + i);
+            kernel(in, out);
+            for (int k = 0; k < OutputCount; k++)
+                out[k].Store(outputs[k] + i);
+        }
+
+        const size_t remaining = count - i;
+        if (remaining == 0)
+            return;
+
+        for (int k = 0; k < InputCount; k++)
+        {
+            float lanes[LaneCount] = {};
+            memcpy(lanes, inputs[k] + i, remaining * sizeof(float));
+            in[k] = Float8::Load(lanes);
+        }
+        kernel(in, out);
+        for (int k = 0; k < OutputCount; k++)
+        {
+            float lanes[LaneCount];
+            out[k].Store(lanes);
+            memcpy(outputs[k] + i, lanes, remaining * sizeof(float));
+        }
+    }
+
+    // x * m[0][column] + y * m[1][column] + z * m[2][column] (+ m[3][column] pour un point)
+    struct MatrixColumns
+    {
+        MatrixColumns(const XMFLOAT4X4& matrix, bool absolute)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                for (int column = 0; column < 3; column++)
+                    M[row][column] = Float8(absolute ? fabsf(matrix.m[row][column]) : matrix.m[row][column]);
+            }
+        }
+
+        Float8 Point(int column, Float8 x, Float8 y, Float8 z) const
+        {
+            return Simd::MulAdd(x, M[0][column], Simd::MulAdd(y, M[1][column], Simd::MulAdd(z, M[2][column], M[3][column])));
+        }
+
+        Float8 Vector(int column, Float8 x, Float8 y, Float8 z) const
+        {
+            return Simd::MulAdd(x, M[0][column], Simd::MulAdd(y, M[1][column], z * M[2][column]));
+        }
+
+        Float8 M[4][3];
+    };
+}
+
+void TransformUtils::TransformPoints(const XMFLOAT4X4& matrix, ConstFloat3Array points, Float3Array result, size_t count)
+{
+    const MatrixColumns columns(matrix, false);
+    ForEachGroup<3, 3>({ points.X, points.Y, points.Z }, { result.X, result.Y, result.Z }, count, [&](const Float8 (&in)[3], Float8 (&out)[3])
+    {
+        for (int column = 0; column < 3; column++)
+            out[column] = columns.Point(column, in[0], in[1], in[2]);
+    });
+}
+
+void TransformUtils::TransformVectors(const XMFLOAT4X4& matrix, ConstFloat3Array vectors, Float3Array result, size_t count)
+{
+    const MatrixColumns columns(matrix, false);
+    ForEachGroup<3, 3>({ vectors.X, vectors.Y, vectors.Z }, { result.X, result.Y, result.Z }, count, [&](const Float8 (&in)[3], Float8 (&out)[3])
+    {
+        for (int column = 0; column < 3; column++)
+            out[column] = columns.Vector(column, in[0], in[1], in[2]);
+    });
+}
+
+void TransformUtils::NormalizeVectors(ConstFloat3Array vectors, Float3Array result, size_t count)
+{
+    ForEachGroup<3, 3>({ vectors.X, vectors.Y, vectors.Z }, { result.X, result.Y, result.Z }, count, [](const Float8 (&in)[3], Float8 (&out)[3])
+    {
+        // Sans sélection par masque : un vecteur nul donne 0 * (1 / sqrt(FLT_MIN)), soit 0.
+        const Float8 squaredLength = Simd::MulAdd(in[0], in[0], Simd::MulAdd(in[1], in[1], in[2] * in[2]));
+        const Float8 invLength = Float8(1.0f) / Simd::Sqrt(Simd::Max(squaredLength, Float8(FLT_MIN)));
+        for (int k = 0; k < 3; k++)
+            out[k] = in[k] * invLength;
+    });
+}
+
+void TransformUtils::TransformBounds(const XMFLOAT4X4& matrix, ConstBoundsArray bounds, BoundsArray result, size_t count)
+{
+    const MatrixColumns columns(matrix, false);
+    const MatrixColumns absoluteColumns(matrix, true);
+    ForEachGroup<6, 6>({ bounds.Center.X, bounds.Center.Y, bounds.Center.Z, bounds.Extents.X, bounds.Extents.Y, bounds.Extents.Z },
+        { result.Center.X, result.Center.Y, result.Center.Z, result.Extents.X, result.Extents.Y, result.Extents.Z }, count,
+        [&](const Float8 (&in)[6], Float8 (&out)[6])
+    {
+        for (int column = 0; column < 3; column++)
+        {
+            out[column] = columns.Point(column, in[0], in[1], in[2]);
+            out[column + 3] = absoluteColumns.Vector(column, in[3], in[4], in[5]);
+        }
+    });
+}
+
+void TransformUtils::TransposeMatrices(const XMFLOAT4X4* matrices, size_t count, void* destination, size_t destinationStride)
+{
+    std::uint8_t* output = static_cast<std::uint8_t*>(destination);
+    const bool stream = (reinterpret_cast<std::uintptr_t>(output) & 15) == 0 && (destinationStride & 15) == 0;
+
+    for (size_t i = 0; i < count; i++, output += destinationStride)
+    {
+        Simd::Float4 rows[4];
+        for (int row = 0; row < 4; row++)
+            rows[row] = Simd::Float4::Load(matrices[i].m[row]);
+        Simd::Transpose(rows[0], rows[1], rows[2], rows[3]);
+
+        float* transposed = reinterpret_cast<float*>(output);
+        for (int row = 0; row < 4; row++)
+        {
+            if (stream)
+                Simd::StreamStore(transposed + 4 * row, rows[row]);
+            else
+                rows[row].Store(transposed + 4 * row);
+        }
+    }
+
+    if (stream)
+        Simd::StoreFence();
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Graphics/DirectXMathUtils.h"
+#include "Utils/Simd.h"
+
+// Transformations par lots sur des tableaux de composantes séparées (x[], y[], z[]), 8 éléments à la fois.
+// Les matrices suivent la convention de DirectXMath (vecteur ligne : v' = v * M). Les sorties peuvent être les entrées.
+namespace TransformUtils
+{
+    struct Float3Array
+    {
+        float* X = nullptr;
+        float* Y = nullptr;
+        float* Z = nullptr;
+    };
+
+    struct ConstFloat3Array
+    {
+        ConstFloat3Array() = default;
+        ConstFloat3Array(const float* x, const float* y, const float* z) : X(x), Y(y), Z(z) {}
+        ConstFloat3Array(const Float3Array& array) : X(array.X), Y(array.Y), Z(array.Z) {}
+
+        const float* X = nullptr;
+        const float* Y = nullptr;
+        const float* Z = nullptr;
+    };
+
+    // Boîtes alignées sur les axes, au format centre / demi-tailles de DirectX::BoundingBox.
+    struct BoundsArray
+    {
+        Float3Array Center;
+        Float3Array Extents;
+    };
+
+    struct ConstBoundsArray
+    {
+        ConstBoundsArray() = default;
+        ConstBoundsArray(const ConstFloat3Array& center, const ConstFloat3Array& extents) : Center(center), Extents(extents) {}
+        ConstBoundsArray(const BoundsArray& bounds) : Center(bounds.Center), Extents(bounds.Extents) {}
+
+        ConstFloat3Array Center;
+        ConstFloat3Array Extents;
+    };
+
+    // Les noyaux sont dans l'espace de noms du chemin de Utils/Simd.h, comme Simd lui-même : les tests compilent TransformUtils.cpp
+    // une fois par chemin et comparent chaque version à une référence (voir Tests/Source/SimdConformance.h).
+    inline namespace SIMD_NAMESPACE
+    {
+        // Points (w = 1) par une matrice affine : la translation s'applique, il n'y a pas de division par w.
+        void TransformPoints(const XMFLOAT4X4& matrix, ConstFloat3Array points, Float3Array result, size_t count);
+
+        // Vecteurs (w = 0) : seule la partie 3x3 s'applique. Pour des normales, passer l'inverse transposée.
+        void TransformVectors(const XMFLOAT4X4& matrix, ConstFloat3Array vectors, Float3Array result, size_t count);
+
+        // Un vecteur nul reste nul, comme avec XMVector3Normalize.
+        void NormalizeVectors(ConstFloat3Array vectors, Float3Array result, size_t count);
+
+        // Boîte englobante alignée sur les axes des boîtes transformées, par la méthode d'Arvo :
+        // le centre est transformé comme un point, et chaque demi-taille devient la somme des demi-tailles pondérées par |M|.
+        void TransformBounds(const XMFLOAT4X4& matrix, ConstBoundsArray bounds, BoundsArray result, size_t count);
+
+        // Transpose count matrices, par exemple pour les écrire directement dans un constant buffer mappé (destinationStride = taille d'un élément du buffer).
+        // Si la destination et le pas sont alignés sur 16 octets, l'écriture contourne le cache, comme MemoryUtils::StreamCopy.
+        void TransposeMatrices(const XMFLOAT4X4* matrices, size_t count, void* destination, size_t destinationStride = sizeof(XMFLOAT4X4));
+    }
+}
\ No newline at end of file
@@ -1,13 +1,20 @@
 #pragma once
 
 #include "Graphics/DirectXUtils.h"
+#include "Graphics/ElementSpan.h"
+#include "Utils/MemoryUtils.h"
+
+#include <cassert>
 
 template<typename T>
 class UploadBuffer
 {
 public:
+    // Vue sur les éléments mappés, avec le pas du buffer, que l'on peut aussi passer au code sans D3D12 (voir ElementSpan.h).
+    using ElementSpan = ::ElementSpan<T>;
+
     UploadBuffer(ID3D12Device* device, UINT elementCount, bool isConstantBuffer) 
-        : mIsConstantBuffer(isConstantBuffer)
+        : mElementCount(elementCount), mIsConstantBuffer(isConstantBuffer)
     {
         mElementByteSize = sizeof(T);
 
@@ -35,15 +42,48 @@ public:
         return mUploadBuffer.Get();
     }
 
+    // Pointeur vers la mémoire mappée, pour les producteurs qui écrivent directement dans le buffer.
+    BYTE* MappedData() const
+    {
+        return mMappedData;
+    }
+
+    ElementSpan Elements() const
+    {
+        return ElementSpan(mMappedData, mElementByteSize, mElementCount);
+    }
+
     void CopyData(int elementIndex, const T& data)
     {
         memcpy(&mMappedData[elementIndex * mElementByteSize], &data, sizeof(T));
     }
 
+    // Copie count éléments consécutifs à partir de firstElementIndex : un seul memcpy si le buffer n'est pas un constant buffer.
+    void CopyData(int firstElementIndex, const T* data, UINT count)
+    {
+        CopyStrided(firstElementIndex, data, sizeof(T), count);
+    }
+
+    // Éléments lus tous les sourceStride octets, par exemple un membre de type T dans un tableau de structures plus grandes.
+    void CopyStrided(int firstElementIndex, const void* source, size_t sourceStride, UINT count)
+    {
+        assert(firstElementIndex >= 0 && static_cast<UINT>(firstElementIndex) + count <= mElementCount);
+        MemoryUtils::CopyStrided(&mMappedData[firstElementIndex * mElementByteSize], mElementByteSize, source, sourceStride, sizeof(T), count);
+    }
+
+    // Comme CopyData, avec des stores non-temporels. Réservé aux gros transferts (au-delà de quelques dizaines de Ko) :
+    // pour quelques éléments, la barrière finale coûte plus que ce que l'on gagne.
+    void StreamData(int firstElementIndex, const T* data, UINT count)
+    {
+        assert(firstElementIndex >= 0 && static_cast<UINT>(firstElementIndex) + count <= mElementCount);
+        MemoryUtils::StreamCopyStrided(&mMappedData[firstElementIndex * mElementByteSize], mElementByteSize, data, sizeof(T), sizeof(T), count);
+    }
+
 private:
     Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
     BYTE* mMappedData = nullptr;
 
     UINT mElementByteSize = 0;
+    UINT mElementCount = 0;
     bool mIsConstantBuffer = false;
 };
\ No newline at end of file
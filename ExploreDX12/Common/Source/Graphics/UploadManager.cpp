@@ -0,0 +1,179 @@
+#include "Graphics/UploadManager.h"
+
+#include <cstring>
+
+UploadManager::UploadManager(ID3D12Device* device, UINT64 stagingByteSize, BufferHeap* bufferHeap)
+    : mDevice(device), mBufferHeap(bufferHeap), mPacker(stagingByteSize)
+{
+    D3D12_COMMAND_QUEUE_DESC queueDesc = {};
+    queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+    queueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+    ThrowIfFailed(mDevice->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&mCopyQueue)));
+    ThrowIfFailed(mDevice->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&mFence)));
+
+    mFenceEvent = CreateEventEx(nullptr, nullptr, 0, EVENT_ALL_ACCESS);
+    if (mFenceEvent == nullptr)
+        ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+
+    CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_UPLOAD);
+    CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(mPacker.Ring().Capacity());
+    ThrowIfFailed(mDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&mStagingBuffer)));
+    ThrowIfFailed(mStagingBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mStagingData)));
+}
+
+UploadManager::~UploadManager()
+{
+    if (mFence != nullptr)
+        WaitForFence(mCurrentFence);
+
+    if (mStagingBuffer != nullptr)
+        mStagingBuffer->Unmap(0, nullptr);
+    mStagingData = nullptr;
+
+    if (mFenceEvent != nullptr)
+        CloseHandle(mFenceEvent);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> UploadManager::CreateDefaultBuffer(const void* initData, UINT64 byteSize)
+{
+    Microsoft::WRL::ComPtr<ID3D12Resource> defaultBuffer;
+    if (mBufferHeap != nullptr)
+    {
+        defaultBuffer = mBufferHeap->CreateBuffer(byteSize);
+    }
+    else
+    {
+        CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_DEFAULT);
+        CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(byteSize);
+        ThrowIfFailed(mDevice->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, IID_PPV_ARGS(&defaultBuffer)));
+    }
+
+    Upload(defaultBuffer.Get(), 0, initData, byteSize);
+    return defaultBuffer;
+}
+
+void UploadManager::ReleaseDefaultBuffer(Microsoft::WRL::ComPtr<ID3D12Resource>& buffer)
+{
+    if (buffer == nullptr)
+        return;
+
+    if (mBufferHeap != nullptr)
+        mBufferHeap->Free(buffer.Get());
+    buffer = nullptr;
+}
+
+void UploadManager::Upload(ID3D12Resource* destination, UINT64 destinationOffset, const void* data, UINT64 byteSize)
+{
+    Retire();
+
+    const BYTE* source = static_cast<const BYTE*>(data);
+    while (byteSize > 0)
+    {
+        const UINT64 chunkByteSize = DirectXMathUtils::Min(byteSize, mPacker.MaxCopyByteSize());
+        const UINT64 stagingOffset = mPacker.Add(DestinationIndex(destination), destinationOffset, chunkByteSize);
+        if (stagingOffset == UploadPacker::InvalidOffset)
+        {
+            // Staging plein : le lot en cours part, et on attend le plus ancien pour récupérer sa place.
+            Submit();
+            WaitForFence(mPacker.OldestBatchFence());
+            Retire();
+            continue;
+        }
+
+        memcpy(mStagingData + stagingOffset, source, chunkByteSize);
+        source += chunkByteSize;
+        destinationOffset += chunkByteSize;
+        byteSize -= chunkByteSize;
+    }
+}
+
+UINT64 UploadManager::Submit()
+{
+    if (!mPacker.HasPendingCopies())
+        return mPacker.LastBatchFence();
+
+    Batch batch;
+    // Un allocateur ne peut être réinitialisé qu'une fois son lot terminé : ceux des lots en vol restent dans mBatches.
+    if (!mFreeAllocators.empty())
+    {
+        batch.Allocator = std::move(mFreeAllocators.back());
+        mFreeAllocators.pop_back();
+        ThrowIfFailed(batch.Allocator->Reset());
+    }
+    else
+    {
+        ThrowIfFailed(mDevice->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&batch.Allocator)));
+    }
+
+    if (mCommandList == nullptr)
+    {
+        ThrowIfFailed(mDevice->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, batch.Allocator.Get(), nullptr, IID_PPV_ARGS(&mCommandList)));
+    }
+    else
+    {
+        ThrowIfFailed(mCommandList->Reset(batch.Allocator.Get(), nullptr));
+    }
+
+    for (const UploadPacker::Copy& copy : mPacker.PendingCopies())
+        mCommandList->CopyBufferRegion(mDestinations[copy.Destination].Get(), copy.DestinationOffset, mStagingBuffer.Get(), copy.StagingOffset, copy.ByteSize);
+
+    ThrowIfFailed(mCommandList->Close());
+    ID3D12CommandList* commandLists[] = { mCommandList.Get() };
+    mCopyQueue->ExecuteCommandLists(_countof(commandLists), commandLists);
+
+    mCurrentFence++;
+    ThrowIfFailed(mCopyQueue->Signal(mFence.Get(), mCurrentFence));
+    mPacker.CloseBatch(mCurrentFence);
+
+    batch.FenceValue = mCurrentFence;
+    batch.Destinations = std::move(mDestinations);
+    mDestinations.clear();
+    mBatches.push_back(std::move(batch));
+    return mCurrentFence;
+}
+
+void UploadManager::WaitOnQueue(ID3D12CommandQueue* queue)
+{
+    const UINT64 fenceValue = Submit();
+    if (fenceValue != 0)
+        ThrowIfFailed(queue->Wait(mFence.Get(), fenceValue));
+}
+
+void UploadManager::Flush()
+{
+    WaitForFence(Submit());
+    Retire();
+}
+
+UINT UploadManager::DestinationIndex(ID3D12Resource* destination)
+{
+    // Les copies d'une ressource se suivent presque toujours : la recherche part de la fin.
+    for (size_t i = mDestinations.size(); i > 0; i--)
+    {
+        if (mDestinations[i - 1].Get() == destination)
+            return static_cast<UINT>(i - 1);
+    }
+
+    mDestinations.emplace_back(destination);
+    return static_cast<UINT>(mDestinations.size() - 1);
+}
+
+void UploadManager::Retire()
+{
+    const UINT64 completedFence = mFence->GetCompletedValue();
+    mPacker.Retire(completedFence);
+    while (!mBatches.empty() && mBatches.front().FenceValue <= completedFence)
+    {
+        mFreeAllocators.push_back(std::move(mBatches.front().Allocator));
+        mBatches.pop_front();
+    }
+}
+
+void UploadManager::WaitForFence(UINT64 fenceValue)
+{
+    if (mFence->GetCompletedValue() >= fenceValue)
+        return;
+
+    ThrowIfFailed(mFence->SetEventOnCompletion(fenceValue, mFenceEvent));
+    WaitForSingleObject(mFenceEvent, INFINITE);
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "Graphics/BufferHeap.h"
+#include "Graphics/DirectXUtils.h"
+#include "Graphics/UploadPacker.h"
+
+#include <deque>
+#include <vector>
+
+// Envoi des données initiales des ressources (vertex et index buffers...) par une file de copie dédiée.
+// Remplace DirectXUtils::CreateDefaultBuffer, qui créait un buffer d'upload par ressource, deux barrières, et demandait d'attendre la fin
+// de la command list graphique avant de libérer l'uploader : ici toutes les données passent par un seul buffer de staging découpé par UploadPacker,
+// les copies d'un lot partent dans une seule command list, et le staging d'un lot est réutilisé dès que la fence de la file de copie l'a atteint.
+//
+// Pas de barrière : un buffer est créé dans l'état COMMON, passe implicitement en COPY_DEST sur la file de copie et revient en COMMON à la fin
+// de l'ExecuteCommandLists, puis est promu implicitement en état de lecture (vertex, index, constant buffer) à sa première utilisation
+// par la file graphique. La file graphique doit seulement attendre la fence des copies (WaitOnQueue), côté GPU, sans bloquer le CPU.
+// À utiliser depuis un seul thread.
+class UploadManager
+{
+public:
+    // Avec bufferHeap, CreateDefaultBuffer y place ses buffers au lieu de créer des ressources committed.
+    UploadManager(ID3D12Device* device, UINT64 stagingByteSize, BufferHeap* bufferHeap = nullptr);
+    UploadManager(const UploadManager& rhs) = delete;
+    UploadManager& operator=(const UploadManager& rhs) = delete;
+    // Attend la fin des copies en cours, qui lisent encore le staging.
+    ~UploadManager();
+
+    // Buffer du heap par défaut de byteSize octets, dont la copie de initData est ajoutée au lot en cours.
+    // Il ne doit pas être utilisé par une autre file avant WaitOnQueue.
+    Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(const void* initData, UINT64 byteSize);
+    // Rend la place d'un buffer de CreateDefaultBuffer à son BufferHeap, puis relâche la référence. Ni la file de copie (Flush) ni le GPU
+    // ne doivent encore l'utiliser : la place peut être donnée au buffer suivant.
+    void ReleaseDefaultBuffer(Microsoft::WRL::ComPtr<ID3D12Resource>& buffer);
+    // Copie de byteSize octets de data dans destination à partir de destinationOffset, ajoutée au lot en cours.
+    // Les données sont recopiées dans le staging tout de suite : data peut être libéré au retour.
+    // Si le staging est plein, le lot en cours est soumis et le CPU attend la fin du plus ancien lot.
+    void Upload(ID3D12Resource* destination, UINT64 destinationOffset, const void* data, UINT64 byteSize);
+
+    // Soumet le lot en cours à la file de copie et renvoie la valeur de fence qui en marquera la fin (celle du dernier lot s'il était vide).
+    UINT64 Submit();
+    // Soumet le lot en cours, et fait attendre à queue la fin de toutes les copies soumises avant les commandes qui y seront envoyées ensuite.
+    void WaitOnQueue(ID3D12CommandQueue* queue);
+    // Soumet le lot en cours et bloque le CPU jusqu'à la fin de toutes les copies.
+    void Flush();
+
+    const UploadPacker::Stats& GetStats() const { return mPacker.GetStats(); }
+
+private:
+    // Un lot soumis garde son allocateur de commandes et ses destinations jusqu'à ce que sa fence soit atteinte.
+    struct Batch
+    {
+        UINT64 FenceValue = 0;
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> Allocator;
+        std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> Destinations;
+    };
+
+    UINT DestinationIndex(ID3D12Resource* destination);
+    void Retire();
+    void WaitForFence(UINT64 fenceValue);
+
+    ID3D12Device* mDevice = nullptr;
+    BufferHeap* mBufferHeap = nullptr;
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> mCopyQueue;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> mCommandList;
+    Microsoft::WRL::ComPtr<ID3D12Fence> mFence;
+    UINT64 mCurrentFence = 0;
+    HANDLE mFenceEvent = nullptr;
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> mStagingBuffer;
+    BYTE* mStagingData = nullptr;
+    UploadPacker mPacker;
+
+    // Ressources du lot en cours, dans l'ordre de leurs indices pour UploadPacker.
+    std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> mDestinations;
+    std::deque<Batch> mBatches;
+    std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> mFreeAllocators;
+};
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "Graphics/UploadPacker.h"
+
+#include <cassert>
+
+UploadPacker::UploadPacker(std::uint64_t stagingByteSize)
+    : mRing((stagingByteSize + Alignment - 1) & ~(Alignment - 1))
+{
+}
+
+std::uint64_t UploadPacker::Add(std::uint32_t destination, std::uint64_t destinationOffset, std::uint64_t byteSize)
+{
+    assert(byteSize > 0 && byteSize <= MaxCopyByteSize() && "Copie à découper avant UploadPacker::Add");
+
+    const std::uint64_t stagingOffset = mRing.Allocate(byteSize, Alignment);
+    if (stagingOffset == InvalidOffset)
+    {
+        mStats.StallCount++;
+        return InvalidOffset;
+    }
+
+    mStats.RequestCount++;
+    mStats.ByteCount += byteSize;
+
+    // Les morceaux successifs d'un même upload se suivent dans le staging comme dans la destination tant que l'anneau ne fait pas le tour :
+    // une seule CopyBufferRegion suffit.
+    if (!mPendingCopies.empty())
+    {
+        Copy& last = mPendingCopies.back();
+        if (last.Destination == destination && last.DestinationOffset + last.ByteSize == destinationOffset &&
+            last.StagingOffset + last.ByteSize == stagingOffset)
+        {
+            last.ByteSize += byteSize;
+            return stagingOffset;
+        }
+    }
+
+    mPendingCopies.push_back({ destination, destinationOffset, stagingOffset, byteSize });
+    mStats.CopyCount++;
+    return stagingOffset;
+}
+
+void UploadPacker::CloseBatch(std::uint64_t fenceValue)
+{
+    assert(fenceValue > mLastBatchFence && "Les lots doivent être soumis avec des fences croissantes");
+
+    mRing.FinishFrame(fenceValue);
+    mBatchFences.push_back(fenceValue);
+    mLastBatchFence = fenceValue;
+    mPendingCopies.clear();
+    mStats.BatchCount++;
+}
+
+void UploadPacker::Retire(std::uint64_t completedFenceValue)
+{
+    mRing.Retire(completedFenceValue);
+    while (!mBatchFences.empty() && mBatchFences.front() <= completedFenceValue)
+        mBatchFences.pop_front();
+}
\ No newline at end of file
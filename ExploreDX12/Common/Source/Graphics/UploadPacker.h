@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Utils/RingAllocator.h"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// Partie indépendante de D3D12 de UploadManager : place les données initiales des ressources dans un anneau de staging, regroupe les copies
+// en lots soumis d'un coup, et rend la place d'un lot quand sa fence est atteinte. Les destinations sont des indices choisis par l'appelant
+// (UploadManager y range ses ressources), pour que le découpage puisse être vérifié avec NullDevice.
+// Comme RingAllocator::FinishFrame, toutes les fonctions sont appelées par un seul thread.
+class UploadPacker
+{
+public:
+    static constexpr std::uint64_t InvalidOffset = RingAllocator::InvalidOffset;
+    // CopyBufferRegion n'impose aucun alignement aux buffers : 16 octets gardent seulement les memcpy vers le staging alignés.
+    static constexpr std::uint64_t Alignment = 16;
+
+    struct Copy
+    {
+        std::uint32_t Destination = 0;
+        std::uint64_t DestinationOffset = 0;
+        std::uint64_t StagingOffset = 0;
+        std::uint64_t ByteSize = 0;
+    };
+
+    struct Stats
+    {
+        std::uint64_t BatchCount = 0;
+        // Appels à Add, et copies restantes une fois les morceaux contigus fusionnés.
+        std::uint64_t RequestCount = 0;
+        std::uint64_t CopyCount = 0;
+        std::uint64_t ByteCount = 0;
+        // Fois où l'anneau était plein et où il a fallu attendre un lot.
+        std::uint64_t StallCount = 0;
+    };
+
+    // La capacité est arrondie à Alignment.
+    explicit UploadPacker(std::uint64_t stagingByteSize);
+    UploadPacker(const UploadPacker& rhs) = delete;
+    UploadPacker& operator=(const UploadPacker& rhs) = delete;
+    ~UploadPacker() = default;
+
+    // Réserve byteSize octets dans le lot en cours et renvoie leur décalage dans le staging, où l'appelant copie les données.
+    // byteSize ne doit pas dépasser MaxCopyByteSize(). InvalidOffset si l'anneau est plein : il faut alors soumettre le lot en cours (CloseBatch),
+    // attendre OldestBatchFence() puis appeler Retire. Une copie qui prolonge la précédente vers la même destination est fusionnée avec elle.
+    std::uint64_t Add(std::uint32_t destination, std::uint64_t destinationOffset, std::uint64_t byteSize);
+
+    // Copies du lot en cours, à enregistrer dans la command list avant CloseBatch.
+    const std::vector<Copy>& PendingCopies() const { return mPendingCopies; }
+    bool HasPendingCopies() const { return !mPendingCopies.empty(); }
+
+    // Le lot en cours a été soumis et sera terminé quand fenceValue sera atteinte.
+    void CloseBatch(std::uint64_t fenceValue);
+    // Libère le staging des lots dont la fence est atteinte.
+    void Retire(std::uint64_t completedFenceValue);
+    // Fence du plus ancien lot soumis et pas encore libéré, 0 s'il n'y en a aucun.
+    std::uint64_t OldestBatchFence() const { return mBatchFences.empty() ? 0 : mBatchFences.front(); }
+    // Fence du dernier lot soumis, 0 si aucun lot ne l'a été.
+    std::uint64_t LastBatchFence() const { return mLastBatchFence; }
+
+    // Au-delà, une copie peut ne pas trouver de place même dans un anneau vide (la fin de l'anneau est perdue quand un bloc n'y tient pas) :
+    // les données plus grosses sont à découper.
+    std::uint64_t MaxCopyByteSize() const { return (mRing.Capacity() / 2) & ~(Alignment - 1); }
+
+    const RingAllocator& Ring() const { return mRing; }
+    const Stats& GetStats() const { return mStats; }
+
+private:
+    RingAllocator mRing;
+    std::vector<Copy> mPendingCopies;
+    std::deque<std::uint64_t> mBatchFences;
+    std::uint64_t mLastBatchFence = 0;
+    Stats mStats;
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "Graphics/UploadRing.h"
+
+namespace
+{
+    // Taille arrondie à l'alignement d'une ressource, qui est un multiple de tous les alignements demandés à Allocate.
+    UINT64 AlignRingSize(UINT64 byteSize)
+    {
+        constexpr UINT64 alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        return (byteSize + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+UploadRing::UploadRing(ID3D12Device* device, UINT64 byteSize)
+    : mAllocator(AlignRingSize(byteSize))
+{
+    CD3DX12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE_UPLOAD);
+    CD3DX12_RESOURCE_DESC resourceDesc = CD3DX12_RESOURCE_DESC::Buffer(mAllocator.Capacity());
+    ThrowIfFailed(device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &resourceDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&mUploadBuffer)));
+
+    // Le buffer reste mappé jusqu'à sa destruction : le CPU n'y écrit que dans des blocs que le GPU n'utilise plus.
+    ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mMappedData)));
+    mGpuAddress = mUploadBuffer->GetGPUVirtualAddress();
+}
+
+UploadRing::~UploadRing()
+{
+    if (mUploadBuffer != nullptr)
+        mUploadBuffer->Unmap(0, nullptr);
+
+    mMappedData = nullptr;
+}
+
+UploadRing::Allocation UploadRing::Allocate(UINT64 byteSize, UINT64 alignment)
+{
+    const UINT64 offset = mAllocator.Allocate(byteSize, alignment);
+    if (offset == RingAllocator::InvalidOffset)
+    {
+        Logs::Error("UploadRing plein : {} octets demandés, {} utilisés sur {}", byteSize, mAllocator.UsedBytes(), mAllocator.Capacity());
+        throw DxException(E_OUTOFMEMORY, L"UploadRing::Allocate", AnsiToWString(__FILE__), __LINE__);
+    }
+
+    return { mMappedData + offset, mGpuAddress + offset };
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Graphics/DirectXUtils.h"
+#include "Utils/RingAllocator.h"
+
+// Un seul grand buffer d'upload mappé en permanence et partagé par toutes les frames, découpé à la demande par RingAllocator.
+// Sert aux données entièrement réécrites à chaque frame, aujourd'hui les constantes de passe de LitWavesApp : le nombre d'allocations peut changer
+// d'une frame à l'autre sans recréer de ressource. Les constantes d'objets et de matériaux restent dans les UploadBuffer des frame resources,
+// où DirtyTracker ne réécrit que ce qui a changé.
+// Allocate peut être appelé depuis plusieurs threads d'enregistrement. FinishFrame et Retire suivent les règles de RingAllocator.
+class UploadRing
+{
+public:
+    struct Allocation
+    {
+        BYTE* CpuAddress = nullptr;
+        D3D12_GPU_VIRTUAL_ADDRESS GpuAddress = 0;
+    };
+
+    UploadRing(ID3D12Device* device, UINT64 byteSize);
+    UploadRing(const UploadRing& rhs) = delete;
+    UploadRing& operator=(const UploadRing& rhs) = delete;
+    ~UploadRing();
+
+    // Lance une DxException (E_OUTOFMEMORY) si l'anneau est plein : il est alors trop petit pour le nombre de frames en vol.
+    Allocation Allocate(UINT64 byteSize, UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+    // count constant buffers de type T consécutifs, chacun arrondi à 256 octets : l'élément i est à i * CalcConstantBufferByteSize(sizeof(T)).
+    template<typename T>
+    Allocation AllocateConstants(UINT count = 1)
+    {
+        return Allocate(static_cast<UINT64>(count) * DirectXUtils::CalcConstantBufferByteSize(sizeof(T)));
+    }
+
+    void FinishFrame(UINT64 fenceValue) { mAllocator.FinishFrame(fenceValue); }
+    void Retire(UINT64 completedFenceValue) { mAllocator.Retire(completedFenceValue); }
+
+    ID3D12Resource* Resource() const { return mUploadBuffer.Get(); }
+    const RingAllocator& Allocator() const { return mAllocator; }
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
+    BYTE* mMappedData = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS mGpuAddress = 0;
+    RingAllocator mAllocator;
+};
\ No newline at end of file
@@ -106,7 +106,7 @@ LRESULT CALLBACK WindowManager::HandleEvent(HWND hwnd, UINT msg, WPARAM wParam,
             }
             else if (sInstance->mIsResizing)
             {
-                // Rien  faire
+                // Rien à faire
             }
             else
             {
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Utils/RingAllocator.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+// Indices de descripteurs dans un heap de taille fixe, sans toucher au heap lui-même (voir Graphics/DescriptorHeap.h).
+// Le début du heap sert aux descripteurs persistants (vues des ressources qui vivent plusieurs frames), alloués un par un et rendus
+// à une liste libre. La fin est un anneau de descripteurs transitoires, écrits pour une seule frame et libérés d'un coup quand sa fence est atteinte.
+// AllocatePersistent, FreePersistent et AllocateTransient sont sans verrou et peuvent être appelés par plusieurs threads d'enregistrement.
+// FreePersistentAfter, FinishFrame et Retire sont appelés par le thread qui soumet les frames, comme pour RingAllocator.
+class DescriptorAllocator
+{
+public:
+    static constexpr std::uint32_t InvalidIndex = ~0u;
+
+    DescriptorAllocator(std::uint32_t persistentCount, std::uint32_t transientCount)
+        : mPersistentCount(persistentCount), mNext(new std::atomic<std::uint32_t>[persistentCount]), mTransient(transientCount)
+    {
+        assert(persistentCount > 0 && transientCount > 0);
+    }
+
+    DescriptorAllocator(const DescriptorAllocator& rhs) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator& rhs) = delete;
+    ~DescriptorAllocator() = default;
+
+    // Indice d'un descripteur persistant, ou InvalidIndex si tous sont utilisés.
+    std::uint32_t AllocatePersistent()
+    {
+        // Liste libre en pile de Treiber. La tête porte un compteur de modifications dans ses 32 bits hauts : un thread qui a lu une tête,
+        // puis l'a vue dépilée, réutilisée et rempilée par d'autres, ne peut pas réussir son échange avec un suivant périmé (problème ABA).
+        std::uint64_t head = mFreeHead.load(std::memory_order_acquire);
+        while (static_cast<std::uint32_t>(head) != InvalidIndex)
+        {
+            const std::uint32_t index = static_cast<std::uint32_t>(head);
+            const std::uint64_t next = ((head >> 32) + 1) << 32 | mNext[index].load(std::memory_order_relaxed);
+            if (mFreeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                mPersistentUsed.fetch_add(1, std::memory_order_relaxed);
+                return index;
+            }
+        }
+
+        // Liste vide : les indices jamais utilisés sont distribués dans l'ordre.
+        std::uint32_t unused = mNextUnused.load(std::memory_order_relaxed);
+        while (unused < mPersistentCount)
+        {
+            if (mNextUnused.compare_exchange_weak(unused, unused + 1, std::memory_order_relaxed))
+            {
+                mPersistentUsed.fetch_add(1, std::memory_order_relaxed);
+                return unused;
+            }
+        }
+        return InvalidIndex;
+    }
+
+    // Rend un descripteur que le GPU n'utilise plus.
+    void FreePersistent(std::uint32_t index)
+    {
+        assert(index < mPersistentCount);
+        std::uint64_t head = mFreeHead.load(std::memory_order_relaxed);
+        std::uint64_t newHead;
+        do
+        {
+            mNext[index].store(static_cast<std::uint32_t>(head), std::memory_order_relaxed);
+            newHead = ((head >> 32) + 1) << 32 | index;
+        } while (!mFreeHead.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+        mPersistentUsed.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // Rend un descripteur quand fenceValue sera atteinte : les frames déjà soumises peuvent encore le lire.
+    void FreePersistentAfter(std::uint32_t index, std::uint64_t fenceValue)
+    {
+        mPendingFrees.push_back({ fenceValue, index });
+    }
+
+    // Premier indice de count descripteurs transitoires consécutifs (pour une table), ou InvalidIndex si l'anneau est plein.
+    std::uint32_t AllocateTransient(std::uint32_t count)
+    {
+        const std::uint64_t offset = mTransient.Allocate(count, 1);
+        return offset != RingAllocator::InvalidOffset ? mPersistentCount + static_cast<std::uint32_t>(offset) : InvalidIndex;
+    }
+
+    // Les descripteurs transitoires alloués jusqu'ici appartiennent à la frame terminée par fenceValue.
+    void FinishFrame(std::uint64_t fenceValue) { mTransient.FinishFrame(fenceValue); }
+
+    // Libère les descripteurs transitoires des frames terminées et rend ceux de FreePersistentAfter dont la fence est atteinte.
+    void Retire(std::uint64_t completedFenceValue)
+    {
+        mTransient.Retire(completedFenceValue);
+        while (!mPendingFrees.empty() && mPendingFrees.front().FenceValue <= completedFenceValue)
+        {
+            FreePersistent(mPendingFrees.front().Index);
+            mPendingFrees.pop_front();
+        }
+    }
+
+    std::uint32_t PersistentCount() const { return mPersistentCount; }
+    std::uint32_t TransientCount() const { return static_cast<std::uint32_t>(mTransient.Capacity()); }
+    std::uint32_t PersistentUsed() const { return mPersistentUsed.load(std::memory_order_relaxed); }
+    const RingAllocator& Transient() const { return mTransient; }
+
+private:
+    struct PendingFree
+    {
+        std::uint64_t FenceValue = 0;
+        std::uint32_t Index = 0;
+    };
+
+    const std::uint32_t mPersistentCount;
+    // Suivant de chaque indice dans la liste libre. Atomique parce qu'un thread peut lire le suivant d'un indice qu'un autre vient de dépiler.
+    std::unique_ptr<std::atomic<std::uint32_t>[]> mNext;
+    std::atomic<std::uint64_t> mFreeHead { InvalidIndex };
+    std::atomic<std::uint32_t> mNextUnused { 0 };
+    std::atomic<std::uint32_t> mPersistentUsed { 0 };
+    RingAllocator mTransient;
+    // Ordonnés par fence, puisqu'ils viennent du thread qui soumet les frames.
+    std::deque<PendingFree> mPendingFrees;
+};
\ No newline at end of file
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ensemble d'indices sur deux niveaux : un bit par élément, et un bit de résumé par mot de 64 éléments qui contient au moins un bit.
+// Parcourir l'ensemble ne lit que les mots marqués par le résumé, le coût suit donc le nombre d'éléments présents et non la taille totale
+// (100 000 éléments tiennent dans 25 mots de résumé).
+class DirtyBitset
+{
+public:
+    // Les nouveaux éléments sont absents, ceux qui restent gardent leur état.
+    void Resize(size_t elementCount)
+    {
+        mElementCount = elementCount;
+        mWords.resize((elementCount + 63) / 64, 0);
+        mSummary.resize((mWords.size() + 63) / 64, 0);
+
+        // Les bits au-delà du dernier élément d'un mot partiel, et ceux du résumé au-delà du dernier mot, ne doivent pas survivre à une réduction.
+        if (elementCount % 64 != 0)
+            mWords.back() &= (1ull << (elementCount % 64)) - 1;
+        if (mWords.size() % 64 != 0)
+            mSummary.back() &= (1ull << (mWords.size() % 64)) - 1;
+    }
+
+    void Set(size_t index)
+    {
+        assert(index < mElementCount);
+        mWords[index / 64] |= 1ull << (index % 64);
+        mSummary[index / 4096] |= 1ull << ((index / 64) % 64);
+    }
+
+    void SetRange(size_t first, size_t count)
+    {
+        for (size_t index = first; index < first + count; index++)
+            Set(index);
+    }
+
+    bool Test(size_t index) const
+    {
+        assert(index < mElementCount);
+        return (mWords[index / 64] >> (index % 64)) & 1;
+    }
+
+    size_t Count() const
+    {
+        size_t count = 0;
+        ForEachWord([&](size_t, std::uint64_t bits) { count += std::popcount(bits); });
+        return count;
+    }
+
+    // Appelle function(premier indice, nombre) pour chaque suite d'indices consécutifs présents, dans l'ordre croissant,
+    // puis vide l'ensemble. Une suite peut traverser plusieurs mots.
+    template<typename Function>
+    void ConsumeRuns(Function&& function)
+    {
+        size_t runFirst = 0;
+        size_t runEnd = 0;
+        ForEachWord([&](size_t wordIndex, std::uint64_t bits)
+        {
+            while (bits != 0)
+            {
+                const int start = std::countr_zero(bits);
+                // Nombre de bits à 1 consécutifs à partir de start. Si la suite va jusqu'au bit 63, le décalage fait entrer des zéros
+                // et countr_one s'arrête bien à la fin du mot.
+                const int length = std::countr_one(bits >> start);
+                const size_t first = wordIndex * 64 + start;
+                if (first != runEnd)
+                {
+                    if (runEnd != runFirst)
+                        function(runFirst, runEnd - runFirst);
+                    runFirst = first;
+                }
+                runEnd = first + length;
+                bits = start + length < 64 ? bits & (~0ull << (start + length)) : 0;
+            }
+            mWords[wordIndex] = 0;
+        });
+        if (runEnd != runFirst)
+            function(runFirst, runEnd - runFirst);
+
+        for (std::uint64_t& summary : mSummary)
+            summary = 0;
+    }
+
+    size_t Size() const { return mElementCount; }
+
+private:
+    template<typename Function>
+    void ForEachWord(Function&& function) const
+    {
+        for (size_t summaryIndex = 0; summaryIndex < mSummary.size(); summaryIndex++)
+        {
+            std::uint64_t summary = mSummary[summaryIndex];
+            while (summary != 0)
+            {
+                const size_t wordIndex = summaryIndex * 64 + std::countr_zero(summary);
+                summary &= summary - 1;
+                assert(wordIndex < mWords.size() && "Résumé marqué au-delà du dernier mot");
+                // Le résumé peut rester marqué après un Resize qui a vidé le mot.
+                if (wordIndex < mWords.size() && mWords[wordIndex] != 0)
+                    function(wordIndex, mWords[wordIndex]);
+            }
+        }
+    }
+
+    size_t mElementCount = 0;
+    std::vector<std::uint64_t> mWords;
+    std::vector<std::uint64_t> mSummary;
+};
+
+// Suivi des constantes modifiées quand chaque frame resource a sa propre copie d'un constant buffer : un élément modifié doit être
+// réécrit dans chacune d'elles, au moment où elle redevient la frame resource courante. Remplace le compteur NumFramesDirty de chaque objet,
+// qui obligeait à parcourir tous les objets à chaque frame pour trouver ceux à réécrire.
+class DirtyTracker
+{
+public:
+    explicit DirtyTracker(int frameResourceCount)
+        : mFrameResources(frameResourceCount)
+    {
+        assert(frameResourceCount > 0);
+    }
+
+    // Les nouveaux éléments sont à écrire dans toutes les frame resources.
+    void Resize(size_t elementCount)
+    {
+        const size_t previousCount = mFrameResources[0].Size();
+        for (DirtyBitset& dirty : mFrameResources)
+        {
+            dirty.Resize(elementCount);
+            if (elementCount > previousCount)
+                dirty.SetRange(previousCount, elementCount - previousCount);
+        }
+    }
+
+    void MarkDirty(size_t index)
+    {
+        for (DirtyBitset& dirty : mFrameResources)
+            dirty.Set(index);
+    }
+
+    void MarkAllDirty()
+    {
+        for (DirtyBitset& dirty : mFrameResources)
+            dirty.SetRange(0, dirty.Size());
+    }
+
+    // Appelle function(premier indice, nombre) pour chaque suite d'éléments à réécrire dans la frame resource, qui est ensuite à jour.
+    template<typename Function>
+    void ConsumeRuns(int frameResourceIndex, Function&& function)
+    {
+        mFrameResources[frameResourceIndex].ConsumeRuns(function);
+    }
+
+    size_t DirtyCount(int frameResourceIndex) const { return mFrameResources[frameResourceIndex].Count(); }
+    int FrameResourceCount() const { return static_cast<int>(mFrameResources.size()); }
+
+private:
+    std::vector<DirtyBitset> mFrameResources;
+};
\ No newline at end of file
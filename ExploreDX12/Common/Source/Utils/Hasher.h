@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Empreinte de 64 bits (FNV-1a, suivi d'un mélange final) pour les clés des caches : quelques milliers d'entrées n'ont aucune chance réelle de collision.
+// Stable d'une exécution et d'une machine à l'autre, les clés peuvent donc être écrites sur le disque.
+class Hasher
+{
+public:
+    void Add(const void* data, size_t byteSize)
+    {
+        const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+        for (size_t i = 0; i < byteSize; i++)
+            mHash = (mHash ^ bytes[i]) * 0x100000001B3ull;
+    }
+
+    // La taille est ajoutée avant les octets : ("ab", "c") et ("a", "bc") ne donnent pas la même empreinte.
+    void Add(const std::string& text)
+    {
+        Add(static_cast<std::uint64_t>(text.size()));
+        Add(text.data(), text.size());
+    }
+
+    void Add(std::uint64_t value) { Add(&value, sizeof(value)); }
+
+    std::uint64_t Finish() const
+    {
+        std::uint64_t hash = mHash;
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+private:
+    std::uint64_t mHash = 14695981039346656037ull;
+};
\ No newline at end of file
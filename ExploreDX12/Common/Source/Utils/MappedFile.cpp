@@ -0,0 +1,68 @@
+#include "Utils/MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+std::shared_ptr<const MappedFile> MappedFile::Open(const std::filesystem::path& path)
+{
+    std::shared_ptr<MappedFile> file(new MappedFile());
+
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return nullptr;
+    file->mFile = handle;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0)
+        return nullptr;
+
+    file->mMapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (file->mMapping == nullptr)
+        return nullptr;
+
+    file->mData = static_cast<const std::uint8_t*>(MapViewOfFile(file->mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (file->mData == nullptr)
+        return nullptr;
+    file->mSize = static_cast<size_t>(size.QuadPart);
+#else
+    const int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return nullptr;
+
+    // La projection reste valide après la fermeture du descripteur.
+    struct stat status;
+    void* data = MAP_FAILED;
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+        data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor);
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    file->mData = static_cast<const std::uint8_t*>(data);
+    file->mSize = static_cast<size_t>(status.st_size);
+#endif
+
+    return file;
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    if (mData != nullptr)
+        UnmapViewOfFile(mData);
+    if (mMapping != nullptr)
+        CloseHandle(mMapping);
+    if (mFile != nullptr)
+        CloseHandle(mFile);
+#else
+    if (mData != nullptr)
+        munmap(const_cast<std::uint8_t*>(mData), mSize);
+#endif
+}
\ No newline at end of file
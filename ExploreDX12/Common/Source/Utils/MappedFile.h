@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+// Fichier projeté en mémoire en lecture seule : les pages ne sont lues sur le disque qu'au premier accès, et restent partagées avec le cache du système.
+// Implémenté avec CreateFileMapping sous Windows et mmap ailleurs, pour que le code qui s'en sert tourne aussi sous Linux.
+class MappedFile
+{
+public:
+    // nullptr si le fichier n'existe pas, est vide ou ne peut pas être projeté.
+    static std::shared_ptr<const MappedFile> Open(const std::filesystem::path& path);
+
+    MappedFile(const MappedFile& rhs) = delete;
+    MappedFile& operator=(const MappedFile& rhs) = delete;
+    ~MappedFile();
+
+    const std::uint8_t* Data() const { return mData; }
+    size_t Size() const { return mSize; }
+
+private:
+    MappedFile() = default;
+
+#ifdef _WIN32
+    void* mFile = nullptr;
+    void* mMapping = nullptr;
+#endif
+    const std::uint8_t* mData = nullptr;
+    size_t mSize = 0;
+};
\ No newline at end of file
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "Utils/Simd.h"
+
+namespace MemoryUtils
+{
+    namespace Internal
+    {
+        // Corps de StreamCopy, sans la barrière finale : les copies par éléments n'en paient qu'une pour tout le lot.
+        inline void StreamCopyUnfenced(std::uint8_t* dst, const std::uint8_t* src, size_t byteSize)
+        {
+            // Les stores non-temporels demandent une destination alignée sur 16 octets.
+            size_t head = (16 - (reinterpret_cast<std::uintptr_t>(dst) & 15)) & 15;
+            if (head > byteSize)
+                head = byteSize;
+            memcpy(dst, src, head);
+            dst += head;
+            src += head;
+            byteSize -= head;
+
+            // 64 octets par itération, soit une ligne de cache complète.
+            for (; byteSize >= 64; byteSize -= 64, dst += 64, src += 64)
+            {
+                const Simd::Int4 a = Simd::Int4::Load(src);
+                const Simd::Int4 b = Simd::Int4::Load(src + 16);
+                const Simd::Int4 c = Simd::Int4::Load(src + 32);
+                const Simd::Int4 d = Simd::Int4::Load(src + 48);
+                Simd::StreamStore(dst, a);
+                Simd::StreamStore(dst + 16, b);
+                Simd::StreamStore(dst + 32, c);
+                Simd::StreamStore(dst + 48, d);
+            }
+
+            for (; byteSize >= 16; byteSize -= 16, dst += 16, src += 16)
+                Simd::StreamStore(dst, Simd::Int4::Load(src));
+
+            memcpy(dst, src, byteSize);
+        }
+    }
+
+    // Copie pensée pour la mémoire "write-combined" (upload heap) : on écrit des lignes complètes avec des stores non-temporels
+    // pour ne pas polluer le cache avec des données que le CPU ne relira jamais.
+    inline void StreamCopy(void* destination, const void* source, size_t byteSize)
+    {
+        Internal::StreamCopyUnfenced(static_cast<std::uint8_t*>(destination), static_cast<const std::uint8_t*>(source), byteSize);
+
+        // Les stores non-temporels ne sont pas ordonnés avec les autres écritures, on doit les rendre visibles avant de soumettre au GPU.
+        Simd::StoreFence();
+    }
+
+    // Copie count éléments de elementByteSize octets, lus tous les sourceStride octets et écrits tous les destinationStride octets
+    // (par exemple des constantes d'objet vers des constant buffers arrondis à 256 octets). Une seule copie si les deux côtés sont contigus.
+    inline void CopyStrided(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t elementByteSize, size_t count)
+    {
+        std::uint8_t* dst = static_cast<std::uint8_t*>(destination);
+        const std::uint8_t* src = static_cast<const std::uint8_t*>(source);
+        if (destinationStride == elementByteSize && sourceStride == elementByteSize)
+        {
+            memcpy(dst, src, elementByteSize * count);
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++, dst += destinationStride, src += sourceStride)
+            memcpy(dst, src, elementByteSize);
+    }
+
+    // Comme CopyStrided, avec des stores non-temporels et une seule barrière pour tout le lot.
+    // Avec une destination alignée sur 16 octets et des éléments de taille multiple de 16, aucune écriture ne passe par le cache.
+    inline void StreamCopyStrided(void* destination, size_t destinationStride, const void* source, size_t sourceStride, size_t elementByteSize, size_t count)
+    {
+        std::uint8_t* dst = static_cast<std::uint8_t*>(destination);
+        const std::uint8_t* src = static_cast<const std::uint8_t*>(source);
+        if (destinationStride == elementByteSize && sourceStride == elementByteSize)
+        {
+            StreamCopy(dst, src, elementByteSize * count);
+            return;
+        }
+
+        for (size_t i = 0; i < count; i++, dst += destinationStride, src += sourceStride)
+            Internal::StreamCopyUnfenced(dst, src, elementByteSize);
+
+        Simd::StoreFence();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "Utils/ParallelUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ParallelUtils
+{
+    namespace Internal
+    {
+        // Un appel à For en cours. Il vit sur la pile du thread appelant, les threads du pool ne font que l'aider.
+        struct Job
+        {
+            RangeFunction Function = nullptr;
+            const void* Context = nullptr;
+            int End = 0;
+            int BlockSize = 1;
+            std::atomic<int> Next { 0 };
+            // Threads du pool en train de traiter des blocs de ce job, protégé par le mutex du pool.
+            int Helpers = 0;
+            // Première exception levée par un bloc, sur n'importe quel thread. Écrite par le seul thread qui passe Failed à true,
+            // lue par Run une fois tous les threads sortis du job.
+            std::atomic<bool> Failed { false };
+            std::exception_ptr Error;
+        };
+
+        // Traite des blocs jusqu'à la fin du job. Ne lève jamais d'exception : celle d'un bloc est gardée pour Run,
+        // et les blocs pas encore commencés sont abandonnés.
+        static void RunBlocks(Job& job)
+        {
+            try
+            {
+                while (true)
+                {
+                    const int begin = job.Next.fetch_add(job.BlockSize, std::memory_order_relaxed);
+                    if (begin >= job.End)
+                        return;
+                    job.Function(job.Context, begin, std::min(begin + job.BlockSize, job.End));
+                }
+            }
+            catch (...)
+            {
+                job.Next.store(job.End, std::memory_order_relaxed);
+                if (!job.Failed.exchange(true))
+                    job.Error = std::current_exception();
+            }
+        }
+
+        class Pool
+        {
+        public:
+            static Pool& Instance()
+            {
+                static Pool pool;
+                return pool;
+            }
+
+            ~Pool()
+            {
+                Stop();
+            }
+
+            int ThreadCount() const { return static_cast<int>(mWorkers.size()) + 1; }
+
+            void Start(int threadCount)
+            {
+                Stop();
+
+                if (threadCount <= 0)
+                    threadCount = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+
+                mStopRequested = false;
+                for (int i = 0; i < threadCount - 1; i++)
+                    mWorkers.emplace_back(&Pool::WorkerLoop, this);
+            }
+
+            void Run(Job& job)
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mJobs.push_back(&job);
+                }
+                mWorkAvailable.notify_all();
+
+                RunBlocks(job);
+
+                // Plus aucun thread ne peut prendre le job une fois retiré de la liste, on attend ceux qui finissent leur dernier bloc.
+                // Le job vit sur la pile : même si un bloc a échoué, il ne doit plus être référencé quand Run se termine.
+                std::unique_lock<std::mutex> lock(mMutex);
+                mJobs.erase(std::find(mJobs.begin(), mJobs.end(), &job));
+                mJobDone.wait(lock, [&job] { return job.Helpers == 0; });
+                lock.unlock();
+
+                if (job.Error)
+                    std::rethrow_exception(job.Error);
+            }
+
+        private:
+            Pool()
+            {
+                Start(0);
+            }
+
+            void Stop()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mStopRequested = true;
+                }
+                mWorkAvailable.notify_all();
+
+                for (std::thread& worker : mWorkers)
+                    worker.join();
+                mWorkers.clear();
+            }
+
+            Job* FindJob() const
+            {
+                for (Job* job : mJobs)
+                {
+                    if (job->Next.load(std::memory_order_relaxed) < job->End)
+                        return job;
+                }
+                return nullptr;
+            }
+
+            void WorkerLoop()
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                while (true)
+                {
+                    Job* job = nullptr;
+                    mWorkAvailable.wait(lock, [&] { return mStopRequested || (job = FindJob()) != nullptr; });
+                    if (mStopRequested)
+                        return;
+
+                    job->Helpers++;
+                    lock.unlock();
+                    RunBlocks(*job);
+                    lock.lock();
+
+                    if (--job->Helpers == 0)
+                        mJobDone.notify_all();
+                }
+            }
+
+            std::vector<std::thread> mWorkers;
+            std::mutex mMutex;
+            std::condition_variable mWorkAvailable;
+            std::condition_variable mJobDone;
+            std::vector<Job*> mJobs;
+            bool mStopRequested = false;
+        };
+
+        void For(int begin, int end, RangeFunction function, const void* context)
+        {
+            const int count = end - begin;
+            if (count <= 0)
+                return;
+
+            Pool& pool = Pool::Instance();
+            const int threadCount = pool.ThreadCount();
+            if (count == 1 || threadCount == 1)
+            {
+                function(context, begin, end);
+                return;
+            }
+
+            // Quelques blocs par thread pour équilibrer la charge quand les itérations n'ont pas toutes le même coût.
+            Job job;
+            job.Function = function;
+            job.Context = context;
+            job.Next = begin;
+            job.End = end;
+            job.BlockSize = std::max(count / (4 * threadCount), 1);
+            pool.Run(job);
+        }
+    }
+
+    void SetThreadCount(int threadCount)
+    {
+        Internal::Pool::Instance().Start(threadCount);
+    }
+
+    int ThreadCount()
+    {
+        return Internal::Pool::Instance().ThreadCount();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace ParallelUtils
+{
+    // Nombre de threads utilisés par For, thread appelant compris. 0 revient à un thread par cœur.
+    // Ne doit pas être appelé pendant qu'un For est en cours.
+    void SetThreadCount(int threadCount);
+    int ThreadCount();
+
+    namespace Internal
+    {
+        using RangeFunction = void (*)(const void* context, int begin, int end);
+        void For(int begin, int end, RangeFunction function, const void* context);
+    }
+
+    // Appelle function(i) pour chaque i de [begin, end), réparti par blocs sur un pool de threads persistant, et attend la fin de tous les appels.
+    // Le thread appelant travaille aussi, For peut donc être appelé depuis une fonction déjà exécutée par For.
+    // Si function lève une exception, sur n'importe quel thread, les blocs pas encore commencés sont abandonnés : For attend les blocs en cours
+    // puis relance la première exception sur le thread appelant.
+    template<typename Function>
+    void For(int begin, int end, const Function& function)
+    {
+        Internal::For(begin, end, [](const void* context, int rangeBegin, int rangeEnd)
+        {
+            const Function& f = *static_cast<const Function*>(context);
+            for (int i = rangeBegin; i < rangeEnd; i++)
+                f(i);
+        }, &function);
+    }
+}
\ No newline at end of file
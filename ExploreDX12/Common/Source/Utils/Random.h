@@ -0,0 +1,299 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <random>
+
+#include "Utils/Simd.h"
+
+// Générateurs pseudo-aléatoires utilisables depuis plusieurs threads sans verrou.
+// Les suites ne dépendent que de la graine (et du flux ou de l'index), elles sont identiques d'une exécution à l'autre
+// et d'une plateforme à l'autre, contrairement aux distributions de la STL dont l'algorithme dépend de l'implémentation.
+namespace RandomUtils
+{
+    inline std::uint64_t SplitMix64(std::uint64_t& state)
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Les 24 bits de poids fort donnent un float exact dans [0, 1).
+    inline float ToUnitFloat(std::uint32_t value)
+    {
+        return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+    }
+
+    inline Simd::Float4 ToUnitFloat(Simd::Int4 values)
+    {
+        return Simd::ToFloat(Simd::ShiftRight<8>(values)) * Simd::Float4(1.0f / 16777216.0f);
+    }
+
+    // Entier dans [a, b] par multiplication plutôt que modulo. Le biais est au plus de (b - a + 1) / 2^32, négligeable ici.
+    inline int ToRange(std::uint32_t value, int a, int b)
+    {
+        const std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::int64_t>(b) - a) + 1;
+        return static_cast<int>(a + static_cast<std::int64_t>((value * range) >> 32));
+    }
+
+    // Flux séquentiel rapide à garder par thread : quatre générateurs xoshiro128+ entrelacés, avancés ensemble sur 4 voies SIMD.
+    // La suite produite est la même que l'on tire les valeurs une à une ou par Fill, et quel que soit le découpage des appels.
+    class Xoshiro
+    {
+    public:
+        // Deux flux de même graine mais d'index différents sont indépendants, un index par thread ou par tâche suffit donc.
+        explicit Xoshiro(std::uint64_t seed, std::uint64_t stream = 0)
+        {
+            std::uint64_t state = seed ^ SplitMix64(stream);
+            std::uint32_t words[4][4];
+            for (int i = 0; i < 4; i++)
+            {
+                for (int lane = 0; lane < 4; lane++)
+                {
+                    const std::uint64_t value = SplitMix64(state);
+                    words[i][lane] = static_cast<std::uint32_t>(value >> 32);
+                }
+            }
+            // Un état entièrement nul ne produit que des zéros.
+            for (int lane = 0; lane < 4; lane++)
+            {
+                if ((words[0][lane] | words[1][lane] | words[2][lane] | words[3][lane]) == 0)
+                    words[0][lane] = 1;
+            }
+            for (int i = 0; i < 4; i++)
+                mState[i] = Simd::Int4::Load(words[i]);
+        }
+
+        std::uint32_t NextUInt()
+        {
+            if (mBufferIndex == 4)
+            {
+                Next4().Store(mBuffer);
+                mBufferIndex = 0;
+            }
+            return mBuffer[mBufferIndex++];
+        }
+
+        float NextFloat()
+        {
+            return ToUnitFloat(NextUInt());
+        }
+
+        float Randf(float a, float b)
+        {
+            return a + (b - a) * NextFloat();
+        }
+
+        int Rand(int a, int b)
+        {
+            return ToRange(NextUInt(), a, b);
+        }
+
+        void Fill(std::uint32_t* values, size_t count)
+        {
+            size_t i = Drain(values, count);
+            for (; i + 4 <= count; i += 4)
+                Next4().Store(values + i);
+            for (; i < count; i++)
+                values[i] = NextUInt();
+        }
+
+        // Floats uniformes dans [a, b), avec la même formule que Randf.
+        void Fill(float* values, size_t count, float a = 0.0f, float b = 1.0f)
+        {
+            size_t i = 0;
+            for (; i < count && mBufferIndex < 4; i++)
+                values[i] = Randf(a, b);
+
+            const Simd::Float4 low(a);
+            const Simd::Float4 range(b - a);
+            for (; i + 4 <= count; i += 4)
+                (low + range * ToUnitFloat(Next4())).Store(values + i);
+            for (; i < count; i++)
+                values[i] = Randf(a, b);
+        }
+
+    private:
+        Simd::Int4 Next4()
+        {
+            const Simd::Int4 result = mState[0] + mState[3];
+            const Simd::Int4 t = Simd::ShiftLeft<9>(mState[1]);
+            mState[2] = mState[2] ^ mState[0];
+            mState[3] = mState[3] ^ mState[1];
+            mState[1] = mState[1] ^ mState[2];
+            mState[0] = mState[0] ^ mState[3];
+            mState[2] = mState[2] ^ t;
+            mState[3] = Simd::ShiftLeft<11>(mState[3]) | Simd::ShiftRight<21>(mState[3]);
+            return result;
+        }
+
+        size_t Drain(std::uint32_t* values, size_t count)
+        {
+            size_t i = 0;
+            for (; i < count && mBufferIndex < 4; i++)
+                values[i] = mBuffer[mBufferIndex++];
+            return i;
+        }
+
+        Simd::Int4 mState[4];
+        std::uint32_t mBuffer[4] = {};
+        int mBufferIndex = 4;
+    };
+
+    // Générateur sans état (Philox4x32-10) : la valeur d'index i ne dépend que de (graine, flux, i).
+    // N'importe quel thread peut donc tirer n'importe quelle partie de la suite, dans n'importe quel ordre, et obtenir les mêmes valeurs.
+    class Philox
+    {
+    public:
+        explicit Philox(std::uint64_t seed, std::uint64_t stream = 0)
+            : mKey0(static_cast<std::uint32_t>(seed)), mKey1(static_cast<std::uint32_t>(seed >> 32)),
+            mStream0(static_cast<std::uint32_t>(stream)), mStream1(static_cast<std::uint32_t>(stream >> 32))
+        {
+        }
+
+        // Les quatre valeurs du bloc de compteur counter, soit les index 4 * counter à 4 * counter + 3.
+        void Block(std::uint64_t counter, std::uint32_t out[4]) const
+        {
+            std::uint32_t c0 = static_cast<std::uint32_t>(counter), c1 = static_cast<std::uint32_t>(counter >> 32), c2 = mStream0, c3 = mStream1;
+            std::uint32_t k0 = mKey0, k1 = mKey1;
+            for (int round = 0; round < 10; round++)
+            {
+                const std::uint64_t product0 = static_cast<std::uint64_t>(Multiplier0) * c0;
+                const std::uint64_t product1 = static_cast<std::uint64_t>(Multiplier1) * c2;
+                c0 = static_cast<std::uint32_t>(product1 >> 32) ^ c1 ^ k0;
+                c1 = static_cast<std::uint32_t>(product1);
+                c2 = static_cast<std::uint32_t>(product0 >> 32) ^ c3 ^ k1;
+                c3 = static_cast<std::uint32_t>(product0);
+                k0 += Weyl0;
+                k1 += Weyl1;
+            }
+            out[0] = c0;
+            out[1] = c1;
+            out[2] = c2;
+            out[3] = c3;
+        }
+
+        std::uint32_t UInt(std::uint64_t index) const
+        {
+            std::uint32_t block[4];
+            Block(index / 4, block);
+            return block[index % 4];
+        }
+
+        float Float(std::uint64_t index) const
+        {
+            return ToUnitFloat(UInt(index));
+        }
+
+        float Randf(std::uint64_t index, float a, float b) const
+        {
+            return a + (b - a) * Float(index);
+        }
+
+        int Rand(std::uint64_t index, int a, int b) const
+        {
+            return ToRange(UInt(index), a, b);
+        }
+
+        // Valeurs d'index firstIndex à firstIndex + count - 1.
+        void Fill(std::uint64_t firstIndex, std::uint32_t* values, size_t count) const
+        {
+            FillBlocks(firstIndex, count, [values](size_t i, Simd::Int4 block) { block.Store(values + i); },
+                [values](size_t i, std::uint32_t value) { values[i] = value; });
+        }
+
+        void Fill(std::uint64_t firstIndex, float* values, size_t count, float a = 0.0f, float b = 1.0f) const
+        {
+            const Simd::Float4 low(a);
+            const Simd::Float4 range(b - a);
+            FillBlocks(firstIndex, count, [=](size_t i, Simd::Int4 block) { (low + range * ToUnitFloat(block)).Store(values + i); },
+                [=](size_t i, std::uint32_t value) { values[i] = a + (b - a) * ToUnitFloat(value); });
+        }
+
+    private:
+        static constexpr std::uint32_t Multiplier0 = 0xD2511F53;
+        static constexpr std::uint32_t Multiplier1 = 0xCD9E8D57;
+        static constexpr std::uint32_t Weyl0 = 0x9E3779B9;
+        static constexpr std::uint32_t Weyl1 = 0xBB67AE85;
+
+        static Simd::Int4 Broadcast(std::uint32_t value)
+        {
+            return Simd::Int4(static_cast<std::int32_t>(value));
+        }
+
+        // Quatre blocs consécutifs à la fois, un par voie, puis transposés pour retrouver l'ordre des index.
+        void Block4(std::uint64_t counter, Simd::Int4 out[4]) const
+        {
+            const std::uint32_t low = static_cast<std::uint32_t>(counter);
+            const std::uint32_t high = static_cast<std::uint32_t>(counter >> 32);
+            // Le compteur peut déborder sur sa moitié haute au milieu des quatre blocs.
+            Simd::Int4 c0(static_cast<std::int32_t>(low), static_cast<std::int32_t>(low + 1), static_cast<std::int32_t>(low + 2), static_cast<std::int32_t>(low + 3));
+            Simd::Int4 c1(static_cast<std::int32_t>(high), static_cast<std::int32_t>(high + (low + 1 < low)), static_cast<std::int32_t>(high + (low + 2 < low)), static_cast<std::int32_t>(high + (low + 3 < low)));
+            Simd::Int4 c2 = Broadcast(mStream0);
+            Simd::Int4 c3 = Broadcast(mStream1);
+            Simd::Int4 k0 = Broadcast(mKey0);
+            Simd::Int4 k1 = Broadcast(mKey1);
+
+            for (int round = 0; round < 10; round++)
+            {
+                Simd::Int4 high0, low0, high1, low1;
+                Simd::MulWide(Broadcast(Multiplier0), c0, high0, low0);
+                Simd::MulWide(Broadcast(Multiplier1), c2, high1, low1);
+                c0 = high1 ^ c1 ^ k0;
+                c1 = low1;
+                c2 = high0 ^ c3 ^ k1;
+                c3 = low0;
+                k0 = k0 + Broadcast(Weyl0);
+                k1 = k1 + Broadcast(Weyl1);
+            }
+
+            Simd::Transpose(c0, c1, c2, c3);
+            out[0] = c0;
+            out[1] = c1;
+            out[2] = c2;
+            out[3] = c3;
+        }
+
+        template<typename StoreBlock, typename StoreValue>
+        void FillBlocks(std::uint64_t firstIndex, size_t count, const StoreBlock& storeBlock, const StoreValue& storeValue) const
+        {
+            size_t i = 0;
+
+            // Début non aligné sur un bloc.
+            for (; i < count && (firstIndex + i) % 4 != 0; i++)
+                storeValue(i, UInt(firstIndex + i));
+
+            Simd::Int4 blocks[4];
+            for (; i + 16 <= count; i += 16)
+            {
+                Block4((firstIndex + i) / 4, blocks);
+                for (int block = 0; block < 4; block++)
+                    storeBlock(i + 4 * block, blocks[block]);
+            }
+
+            std::uint32_t block[4];
+            for (; i < count; i++)
+            {
+                if ((firstIndex + i) % 4 == 0)
+                    Block((firstIndex + i) / 4, block);
+                storeValue(i, block[(firstIndex + i) % 4]);
+            }
+        }
+
+        std::uint32_t mKey0;
+        std::uint32_t mKey1;
+        std::uint32_t mStream0;
+        std::uint32_t mStream1;
+    };
+
+    // Flux propre au thread appelant, pour les tirages qui n'ont pas besoin d'être reproductibles.
+    // La graine est tirée une fois par processus, chaque thread reçoit ensuite son propre index de flux.
+    inline Xoshiro& ThreadStream()
+    {
+        static const std::uint64_t seed = (static_cast<std::uint64_t>(std::random_device {}()) << 32) | std::random_device {}();
+        static std::atomic<std::uint64_t> nextStream { 0 };
+        thread_local Xoshiro stream(seed, nextStream.fetch_add(1, std::memory_order_relaxed));
+        return stream;
+    }
+}
\ No newline at end of file
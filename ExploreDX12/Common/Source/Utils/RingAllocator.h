@@ -0,0 +1,108 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <deque>
+
+// Allocateur linéaire circulaire de capacité fixe, qui ne gère que des décalages : la mémoire elle-même appartient à l'appelant (upload heap, staging...).
+// Les allocations avancent une tête sans jamais rien libérer individuellement ; à la fin de chaque frame, FinishFrame associe la position de la tête
+// à la valeur de fence signalée, et Retire rend d'un coup tout ce que les frames terminées par le GPU avaient alloué.
+// Allocate est sans verrou et peut être appelé par plusieurs threads d'enregistrement en même temps. FinishFrame et Retire sont appelés par un seul thread,
+// celui qui soumet les frames, quand plus aucun Allocate n'est en cours pour la frame qui se termine.
+class RingAllocator
+{
+public:
+    static constexpr std::uint64_t InvalidOffset = ~0ull;
+
+    explicit RingAllocator(std::uint64_t capacity)
+        : mCapacity(capacity)
+    {
+        assert(capacity > 0);
+    }
+
+    RingAllocator(const RingAllocator& rhs) = delete;
+    RingAllocator& operator=(const RingAllocator& rhs) = delete;
+    ~RingAllocator() = default;
+
+    // Décalage d'un bloc de byteSize octets aligné sur alignment (puissance de 2, qui doit aussi diviser la capacité),
+    // ou InvalidOffset si l'anneau est plein jusqu'à la plus vieille frame encore utilisée par le GPU.
+    // Un bloc n'est jamais coupé par la fin de l'anneau : s'il n'y tient pas, il recommence au début et la fin est perdue jusqu'au prochain tour.
+    std::uint64_t Allocate(std::uint64_t byteSize, std::uint64_t alignment)
+    {
+        assert(alignment > 0 && (alignment & (alignment - 1)) == 0 && mCapacity % alignment == 0);
+        if (byteSize > mCapacity)
+            return InvalidOffset;
+
+        // Les positions sont des compteurs d'octets croissants depuis la création : le décalage dans l'anneau est position % capacité.
+        std::uint64_t head = mHead.load(std::memory_order_relaxed);
+        while (true)
+        {
+            const std::uint64_t offset = head % mCapacity;
+            const std::uint64_t alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+            std::uint64_t start = head + (alignedOffset - offset);
+            if (alignedOffset + byteSize > mCapacity)
+                start = head + (mCapacity - offset);
+
+            const std::uint64_t end = start + byteSize;
+            if (end - mTail.load(std::memory_order_acquire) > mCapacity)
+                return InvalidOffset;
+
+            if (mHead.compare_exchange_weak(head, end, std::memory_order_relaxed))
+            {
+                UpdatePeak(end);
+                return start % mCapacity;
+            }
+        }
+    }
+
+    // Tout ce qui a été alloué jusqu'ici appartient à la frame dont la fin est signalée par fenceValue.
+    void FinishFrame(std::uint64_t fenceValue)
+    {
+        assert(mFrames.empty() || mFrames.back().FenceValue <= fenceValue);
+        mFrames.push_back({ fenceValue, mHead.load(std::memory_order_relaxed) });
+    }
+
+    // Libère les allocations des frames dont la fence est atteinte.
+    void Retire(std::uint64_t completedFenceValue)
+    {
+        std::uint64_t tail = mTail.load(std::memory_order_relaxed);
+        while (!mFrames.empty() && mFrames.front().FenceValue <= completedFenceValue)
+        {
+            tail = mFrames.front().Head;
+            mFrames.pop_front();
+        }
+        // Release : les threads qui voient la nouvelle queue peuvent réécrire la mémoire qu'elle vient de libérer.
+        mTail.store(tail, std::memory_order_release);
+    }
+
+    std::uint64_t Capacity() const { return mCapacity; }
+    // Octets encore réservés par les frames en vol et la frame courante, pertes de fin d'anneau comprises.
+    std::uint64_t UsedBytes() const { return mHead.load(std::memory_order_relaxed) - mTail.load(std::memory_order_relaxed); }
+    // Maximum de UsedBytes depuis la création, pour dimensionner l'anneau.
+    std::uint64_t PeakBytes() const { return mPeakBytes.load(std::memory_order_relaxed); }
+
+private:
+    struct Frame
+    {
+        std::uint64_t FenceValue = 0;
+        std::uint64_t Head = 0;
+    };
+
+    void UpdatePeak(std::uint64_t end)
+    {
+        const std::uint64_t used = end - mTail.load(std::memory_order_relaxed);
+        std::uint64_t peak = mPeakBytes.load(std::memory_order_relaxed);
+        while (used > peak && !mPeakBytes.compare_exchange_weak(peak, used, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    const std::uint64_t mCapacity;
+    std::deque<Frame> mFrames;
+    std::atomic<std::uint64_t> mPeakBytes { 0 };
+
+    // Sur des lignes de cache différentes : la tête est modifiée à chaque allocation, la queue une fois par frame.
+    alignas(64) std::atomic<std::uint64_t> mHead { 0 };
+    alignas(64) std::atomic<std::uint64_t> mTail { 0 };
+};
\ No newline at end of file
@@ -0,0 +1,609 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Petite couche SIMD portable pour le code CPU qui n'utilise pas XMVECTOR (générateurs aléatoires, stockage 16 bits et échantillonnage de Waves, copies).
+// Float4/Int4 font 4 voies de 32 bits et Float8/Int8 en font 8, en SSE2 (SSE4.1 et FMA quand ils sont disponibles), AVX2, NEON (AArch64),
+// ou en code scalaire qui sert aussi de référence. Définir SIMD_FORCE_SCALAR force le chemin scalaire, SIMD_FORCE_SSE2 ou SIMD_FORCE_SSE41
+// limitent le chemin x86 à ce jeu d'instructions quelles que soient les options de compilation.
+// Les opérations entières et les conversions sont exactes sur tous les chemins. Seul MulAdd peut différer d'un arrondi selon que le FMA est disponible ou non.
+// Chaque chemin a son espace de noms inline (Simd::Avx2, Simd::Sse2...) : des fichiers compilés avec des chemins différents peuvent être liés
+// ensemble sans que leurs types et fonctions inline se confondent, ce que font les tests de conformité (Tests/Source/SimdTests.cpp).
+#if defined(SIMD_FORCE_SCALAR)
+#define SIMD_SCALAR 1
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_SSE 1
+#if (defined(__SSE4_1__) || defined(__AVX__)) && !defined(SIMD_FORCE_SSE2)
+#define SIMD_SSE41 1
+#endif
+#if !defined(SIMD_FORCE_SSE2) && !defined(SIMD_FORCE_SSE41)
+#if defined(__AVX2__)
+#define SIMD_AVX2 1
+#endif
+// MSVC ne définit pas __FMA__ et __F16C__, mais /arch:AVX2 les suppose (comme DirectXMath).
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define SIMD_FMA 1
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define SIMD_F16C 1
+#endif
+#endif
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SIMD_NEON 1
+#include <arm_neon.h>
+#else
+#define SIMD_SCALAR 1
+#endif
+
+#if defined(SIMD_AVX2)
+#define SIMD_NAMESPACE Avx2
+#elif defined(SIMD_SSE41)
+#define SIMD_NAMESPACE Sse41
+#elif defined(SIMD_SSE)
+#define SIMD_NAMESPACE Sse2
+#elif defined(SIMD_NEON)
+#define SIMD_NAMESPACE Neon
+#else
+#define SIMD_NAMESPACE Scalar
+#endif
+
+namespace Simd::inline SIMD_NAMESPACE
+{
+    inline const char* BackendName()
+    {
+#if defined(SIMD_AVX2)
+        return "AVX2";
+#elif defined(SIMD_SSE41)
+        return "SSE4.1";
+#elif defined(SIMD_SSE)
+        return "SSE2";
+#elif defined(SIMD_NEON)
+        return "NEON";
+#else
+        return "Scalar";
+#endif
+    }
+
+    inline float HalfToFloat(std::uint16_t half)
+    {
+        const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000) << 16;
+        const std::uint32_t exponent = (half >> 10) & 0x1f;
+        const std::uint32_t mantissa = half & 0x3ff;
+
+        std::uint32_t bits;
+        if (exponent == 0x1f)
+            bits = sign | 0x7f800000 | (mantissa << 13);
+        else if (exponent != 0)
+            bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+        else
+        {
+            // Zéro ou nombre dénormalisé, exactement représentable en float.
+            const float value = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+            return sign != 0 ? -value : value;
+        }
+
+        float value;
+        memcpy(&value, &bits, sizeof(float));
+        return value;
+    }
+
+#if defined(SIMD_SSE)
+    struct Float4
+    {
+        Float4() = default;
+        Float4(__m128 value) : V(value) {}
+        explicit Float4(float value) : V(_mm_set1_ps(value)) {}
+
+        static Float4 Load(const float* values) { return _mm_loadu_ps(values); }
+        void Store(float* values) const { _mm_storeu_ps(values, V); }
+
+        __m128 V;
+    };
+
+    struct Int4
+    {
+        Int4() = default;
+        Int4(__m128i value) : V(value) {}
+        explicit Int4(std::int32_t value) : V(_mm_set1_epi32(value)) {}
+        Int4(std::int32_t x, std::int32_t y, std::int32_t z, std::int32_t w) : V(_mm_setr_epi32(x, y, z, w)) {}
+
+        static Int4 Load(const void* values) { return _mm_loadu_si128(static_cast<const __m128i*>(values)); }
+        void Store(void* values) const { _mm_storeu_si128(static_cast<__m128i*>(values), V); }
+
+        __m128i V;
+    };
+
+    inline Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.V, b.V); }
+    inline Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.V, b.V); }
+    inline Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.V, b.V); }
+    inline Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.V, b.V); }
+    inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.V, b.V); }
+    inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.V, b.V); }
+    inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a.V); }
+
+    // a * b + c
+    inline Float4 MulAdd(Float4 a, Float4 b, Float4 c)
+    {
+#if defined(SIMD_FMA)
+        return _mm_fmadd_ps(a.V, b.V, c.V);
+#else
+        return _mm_add_ps(_mm_mul_ps(a.V, b.V), c.V);
+#endif
+    }
+
+    inline Float4 Floor(Float4 a)
+    {
+#if defined(SIMD_SSE41)
+        return _mm_floor_ps(a.V);
+#else
+        // Troncature puis correction des valeurs négatives non entières, valable pour |a| < 2^31.
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.V));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, a.V), _mm_set1_ps(1.0f)));
+#endif
+    }
+
+    inline Int4 operator+(Int4 a, Int4 b) { return _mm_add_epi32(a.V, b.V); }
+    inline Int4 operator-(Int4 a, Int4 b) { return _mm_sub_epi32(a.V, b.V); }
+    inline Int4 operator&(Int4 a, Int4 b) { return _mm_and_si128(a.V, b.V); }
+    inline Int4 operator|(Int4 a, Int4 b) { return _mm_or_si128(a.V, b.V); }
+    inline Int4 operator^(Int4 a, Int4 b) { return _mm_xor_si128(a.V, b.V); }
+    template<int Count> inline Int4 ShiftLeft(Int4 a) { return _mm_slli_epi32(a.V, Count); }
+    template<int Count> inline Int4 ShiftRight(Int4 a) { return _mm_srli_epi32(a.V, Count); }
+    template<int Count> inline Int4 ShiftRightArithmetic(Int4 a) { return _mm_srai_epi32(a.V, Count); }
+
+    // 32 bits de poids faible du produit, identiques pour des entiers signés ou non.
+    inline Int4 MulLow(Int4 a, Int4 b)
+    {
+#if defined(SIMD_SSE41)
+        return _mm_mullo_epi32(a.V, b.V);
+#else
+        const __m128i even = _mm_mul_epu32(a.V, b.V);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a.V, 32), _mm_srli_epi64(b.V, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+    }
+
+    // Produits complets 32 x 32 -> 64 bits non signés, séparés en parties haute et basse.
+    // _mm_mul_epu32 ne multiplie que les voies paires, les voies impaires sont décalées avant un second produit.
+    inline void MulWide(Int4 a, Int4 b, Int4& high, Int4& low)
+    {
+        const __m128i even = _mm_mul_epu32(a.V, b.V);
+        const __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a.V, 32), _mm_srli_epi64(b.V, 32));
+        const __m128i lowMask = _mm_set_epi32(0, -1, 0, -1);
+        high = _mm_or_si128(_mm_and_si128(_mm_srli_epi64(even, 32), lowMask), _mm_andnot_si128(lowMask, odd));
+        low = _mm_or_si128(_mm_and_si128(even, lowMask), _mm_slli_epi64(odd, 32));
+    }
+
+    inline Float4 ToFloat(Int4 a) { return _mm_cvtepi32_ps(a.V); }
+    inline Int4 TruncateToInt(Float4 a) { return _mm_cvttps_epi32(a.V); }
+    // Arrondi au plus proche, les égalités allant vers le pair.
+    inline Int4 RoundToInt(Float4 a) { return _mm_cvtps_epi32(a.V); }
+
+    // Lit 8 entiers 16 bits signés et les étend sur 32 bits.
+    inline void LoadInt16(const std::int16_t* values, Int4& low, Int4& high)
+    {
+        const __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+        low = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+        high = _mm_srai_epi32(_mm_unpackhi_epi16(packed, packed), 16);
+    }
+
+    // Écrit 8 entiers 16 bits signés, les valeurs hors de [-32768, 32767] sont saturées.
+    inline void StoreInt16Saturate(std::int16_t* values, Int4 low, Int4 high)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values), _mm_packs_epi32(low.V, high.V));
+    }
+
+    // Transpose la matrice 4x4 dont a, b, c, d sont les lignes.
+    inline void Transpose(Int4& a, Int4& b, Int4& c, Int4& d)
+    {
+        const __m128i t0 = _mm_unpacklo_epi32(a.V, b.V);
+        const __m128i t1 = _mm_unpacklo_epi32(c.V, d.V);
+        const __m128i t2 = _mm_unpackhi_epi32(a.V, b.V);
+        const __m128i t3 = _mm_unpackhi_epi32(c.V, d.V);
+        a = _mm_unpacklo_epi64(t0, t1);
+        b = _mm_unpackhi_epi64(t0, t1);
+        c = _mm_unpacklo_epi64(t2, t3);
+        d = _mm_unpackhi_epi64(t2, t3);
+    }
+
+    inline void Transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+    {
+        _MM_TRANSPOSE4_PS(a.V, b.V, c.V, d.V);
+    }
+
+    // Écriture qui contourne le cache, la destination doit être alignée sur 16 octets. StoreFence rend ces écritures visibles.
+    inline void StreamStore(void* destination, Int4 value) { _mm_stream_si128(static_cast<__m128i*>(destination), value.V); }
+    inline void StreamStore(float* destination, Float4 value) { _mm_stream_ps(destination, value.V); }
+    inline void StoreFence() { _mm_sfence(); }
+#elif defined(SIMD_NEON)
+    struct Float4
+    {
+        Float4() = default;
+        Float4(float32x4_t value) : V(value) {}
+        explicit Float4(float value) : V(vdupq_n_f32(value)) {}
+
+        static Float4 Load(const float* values) { return vld1q_f32(values); }
+        void Store(float* values) const { vst1q_f32(values, V); }
+
+        float32x4_t V;
+    };
+
+    struct Int4
+    {
+        Int4() = default;
+        Int4(int32x4_t value) : V(value) {}
+        explicit Int4(std::int32_t value) : V(vdupq_n_s32(value)) {}
+        Int4(std::int32_t x, std::int32_t y, std::int32_t z, std::int32_t w)
+        {
+            const std::int32_t values[4] = { x, y, z, w };
+            V = vld1q_s32(values);
+        }
+
+        static Int4 Load(const void* values) { return vld1q_s32(static_cast<const std::int32_t*>(values)); }
+        void Store(void* values) const { vst1q_s32(static_cast<std::int32_t*>(values), V); }
+
+        int32x4_t V;
+    };
+
+    inline Float4 operator+(Float4 a, Float4 b) { return vaddq_f32(a.V, b.V); }
+    inline Float4 operator-(Float4 a, Float4 b) { return vsubq_f32(a.V, b.V); }
+    inline Float4 operator*(Float4 a, Float4 b) { return vmulq_f32(a.V, b.V); }
+    inline Float4 operator/(Float4 a, Float4 b) { return vdivq_f32(a.V, b.V); }
+    inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a.V, b.V); }
+    inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a.V, b.V); }
+    inline Float4 Sqrt(Float4 a) { return vsqrtq_f32(a.V); }
+    inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return vfmaq_f32(c.V, a.V, b.V); }
+    inline Float4 Floor(Float4 a) { return vrndmq_f32(a.V); }
+
+    inline Int4 operator+(Int4 a, Int4 b) { return vaddq_s32(a.V, b.V); }
+    inline Int4 operator-(Int4 a, Int4 b) { return vsubq_s32(a.V, b.V); }
+    inline Int4 operator&(Int4 a, Int4 b) { return vandq_s32(a.V, b.V); }
+    inline Int4 operator|(Int4 a, Int4 b) { return vorrq_s32(a.V, b.V); }
+    inline Int4 operator^(Int4 a, Int4 b) { return veorq_s32(a.V, b.V); }
+    template<int Count> inline Int4 ShiftLeft(Int4 a) { return vshlq_n_s32(a.V, Count); }
+    template<int Count> inline Int4 ShiftRight(Int4 a) { return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a.V), Count)); }
+    template<int Count> inline Int4 ShiftRightArithmetic(Int4 a) { return vshrq_n_s32(a.V, Count); }
+    inline Int4 MulLow(Int4 a, Int4 b) { return vmulq_s32(a.V, b.V); }
+
+    inline void MulWide(Int4 a, Int4 b, Int4& high, Int4& low)
+    {
+        const uint32x4_t ua = vreinterpretq_u32_s32(a.V);
+        const uint32x4_t ub = vreinterpretq_u32_s32(b.V);
+        const uint32x4_t first = vreinterpretq_u32_u64(vmull_u32(vget_low_u32(ua), vget_low_u32(ub)));
+        const uint32x4_t second = vreinterpretq_u32_u64(vmull_high_u32(ua, ub));
+        low = vreinterpretq_s32_u32(vuzp1q_u32(first, second));
+        high = vreinterpretq_s32_u32(vuzp2q_u32(first, second));
+    }
+
+    inline Float4 ToFloat(Int4 a) { return vcvtq_f32_s32(a.V); }
+    inline Int4 TruncateToInt(Float4 a) { return vcvtq_s32_f32(a.V); }
+    inline Int4 RoundToInt(Float4 a) { return vcvtnq_s32_f32(a.V); }
+
+    inline void LoadInt16(const std::int16_t* values, Int4& low, Int4& high)
+    {
+        const int16x8_t packed = vld1q_s16(values);
+        low = vmovl_s16(vget_low_s16(packed));
+        high = vmovl_high_s16(packed);
+    }
+
+    inline void StoreInt16Saturate(std::int16_t* values, Int4 low, Int4 high)
+    {
+        vst1q_s16(values, vcombine_s16(vqmovn_s32(low.V), vqmovn_s32(high.V)));
+    }
+
+    inline void Transpose(Int4& a, Int4& b, Int4& c, Int4& d)
+    {
+        const int64x2_t t0 = vreinterpretq_s64_s32(vzip1q_s32(a.V, b.V));
+        const int64x2_t t1 = vreinterpretq_s64_s32(vzip1q_s32(c.V, d.V));
+        const int64x2_t t2 = vreinterpretq_s64_s32(vzip2q_s32(a.V, b.V));
+        const int64x2_t t3 = vreinterpretq_s64_s32(vzip2q_s32(c.V, d.V));
+        a = vreinterpretq_s32_s64(vzip1q_s64(t0, t1));
+        b = vreinterpretq_s32_s64(vzip2q_s64(t0, t1));
+        c = vreinterpretq_s32_s64(vzip1q_s64(t2, t3));
+        d = vreinterpretq_s32_s64(vzip2q_s64(t2, t3));
+    }
+
+    inline void Transpose(Float4& a, Float4& b, Float4& c, Float4& d)
+    {
+        const float64x2_t t0 = vreinterpretq_f64_f32(vzip1q_f32(a.V, b.V));
+        const float64x2_t t1 = vreinterpretq_f64_f32(vzip1q_f32(c.V, d.V));
+        const float64x2_t t2 = vreinterpretq_f64_f32(vzip2q_f32(a.V, b.V));
+        const float64x2_t t3 = vreinterpretq_f64_f32(vzip2q_f32(c.V, d.V));
+        a = vreinterpretq_f32_f64(vzip1q_f64(t0, t1));
+        b = vreinterpretq_f32_f64(vzip2q_f64(t0, t1));
+        c = vreinterpretq_f32_f64(vzip1q_f64(t2, t3));
+        d = vreinterpretq_f32_f64(vzip2q_f64(t2, t3));
+    }
+
+    // Pas d'écriture non-temporelle exposée par NEON, on écrit normalement.
+    inline void StreamStore(void* destination, Int4 value) { value.Store(destination); }
+    inline void StreamStore(float* destination, Float4 value) { value.Store(destination); }
+    inline void StoreFence() {}
+#else
+    struct Float4
+    {
+        Float4() = default;
+        explicit Float4(float value) : V { value, value, value, value } {}
+
+        static Float4 Load(const float* values)
+        {
+            Float4 result;
+            memcpy(result.V, values, sizeof(result.V));
+            return result;
+        }
+        void Store(float* values) const { memcpy(values, V, sizeof(V)); }
+
+        float V[4];
+    };
+
+    struct Int4
+    {
+        Int4() = default;
+        explicit Int4(std::int32_t value) : V { value, value, value, value } {}
+        Int4(std::int32_t x, std::int32_t y, std::int32_t z, std::int32_t w) : V { x, y, z, w } {}
+
+        static Int4 Load(const void* values)
+        {
+            Int4 result;
+            memcpy(result.V, values, sizeof(result.V));
+            return result;
+        }
+        void Store(void* values) const { memcpy(values, V, sizeof(V)); }
+
+        std::int32_t V[4];
+    };
+
+    template<typename Result, typename Argument, typename Operation>
+    inline Result Map(const Argument& a, const Operation& operation)
+    {
+        Result result;
+        for (int lane = 0; lane < 4; lane++)
+            result.V[lane] = operation(a.V[lane]);
+        return result;
+    }
+
+    template<typename Result, typename Argument, typename Operation>
+    inline Result Map(const Argument& a, const Argument& b, const Operation& operation)
+    {
+        Result result;
+        for (int lane = 0; lane < 4; lane++)
+            result.V[lane] = operation(a.V[lane], b.V[lane]);
+        return result;
+    }
+
+    // Les opérations entières passent par des non signés, pour que les débordements soient définis comme en SIMD.
+    inline std::uint32_t Unsigned(std::int32_t value) { return static_cast<std::uint32_t>(value); }
+    inline std::int32_t Signed(std::uint32_t value) { return static_cast<std::int32_t>(value); }
+
+    inline Float4 operator+(Float4 a, Float4 b) { return Map<Float4>(a, b, [](float x, float y) { return x + y; }); }
+    inline Float4 operator-(Float4 a, Float4 b) { return Map<Float4>(a, b, [](float x, float y) { return x - y; }); }
+    inline Float4 operator*(Float4 a, Float4 b) { return Map<Float4>(a, b, [](float x, float y) { return x * y; }); }
+    inline Float4 operator/(Float4 a, Float4 b) { return Map<Float4>(a, b, [](float x, float y) { return x / y; }); }
+    inline Float4 Min(Float4 a, Float4 b) { return Map<Float4>(a, b, [](float x, float y) { return x < y ? x : y; }); }
+    inline Float4 Max(Float4 a, Float4 b) { return Map<Float4>(a, b, [](float x, float y) { return x > y ? x : y; }); }
+    inline Float4 Sqrt(Float4 a) { return Map<Float4>(a, [](float x) { return std::sqrt(x); }); }
+    inline Float4 Floor(Float4 a) { return Map<Float4>(a, [](float x) { return std::floor(x); }); }
+    inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return a * b + c; }
+
+    inline Int4 operator+(Int4 a, Int4 b) { return Map<Int4>(a, b, [](std::int32_t x, std::int32_t y) { return Signed(Unsigned(x) + Unsigned(y)); }); }
+    inline Int4 operator-(Int4 a, Int4 b) { return Map<Int4>(a, b, [](std::int32_t x, std::int32_t y) { return Signed(Unsigned(x) - Unsigned(y)); }); }
+    inline Int4 operator&(Int4 a, Int4 b) { return Map<Int4>(a, b, [](std::int32_t x, std::int32_t y) { return x & y; }); }
+    inline Int4 operator|(Int4 a, Int4 b) { return Map<Int4>(a, b, [](std::int32_t x, std::int32_t y) { return x | y; }); }
+    inline Int4 operator^(Int4 a, Int4 b) { return Map<Int4>(a, b, [](std::int32_t x, std::int32_t y) { return x ^ y; }); }
+    template<int Count> inline Int4 ShiftLeft(Int4 a) { return Map<Int4>(a, [](std::int32_t x) { return Signed(Unsigned(x) << Count); }); }
+    template<int Count> inline Int4 ShiftRight(Int4 a) { return Map<Int4>(a, [](std::int32_t x) { return Signed(Unsigned(x) >> Count); }); }
+    template<int Count> inline Int4 ShiftRightArithmetic(Int4 a) { return Map<Int4>(a, [](std::int32_t x) { return x >> Count; }); }
+    inline Int4 MulLow(Int4 a, Int4 b) { return Map<Int4>(a, b, [](std::int32_t x, std::int32_t y) { return Signed(Unsigned(x) * Unsigned(y)); }); }
+
+    inline void MulWide(Int4 a, Int4 b, Int4& high, Int4& low)
+    {
+        for (int lane = 0; lane < 4; lane++)
+        {
+            const std::uint64_t product = static_cast<std::uint64_t>(Unsigned(a.V[lane])) * Unsigned(b.V[lane]);
+            high.V[lane] = Signed(static_cast<std::uint32_t>(product >> 32));
+            low.V[lane] = Signed(static_cast<std::uint32_t>(product));
+        }
+    }
+
+    inline Float4 ToFloat(Int4 a) { return Map<Float4>(a, [](std::int32_t x) { return static_cast<float>(x); }); }
+    inline Int4 TruncateToInt(Float4 a) { return Map<Int4>(a, [](float x) { return static_cast<std::int32_t>(x); }); }
+    inline Int4 RoundToInt(Float4 a) { return Map<Int4>(a, [](float x) { return static_cast<std::int32_t>(std::nearbyint(x)); }); }
+
+    inline void LoadInt16(const std::int16_t* values, Int4& low, Int4& high)
+    {
+        for (int lane = 0; lane < 4; lane++)
+        {
+            low.V[lane] = values[lane];
+            high.V[lane] = values[lane + 4];
+        }
+    }
+
+    inline void StoreInt16Saturate(std::int16_t* values, Int4 low, Int4 high)
+    {
+        auto saturate = [](std::int32_t x) { return static_cast<std::int16_t>(x < -32768 ? -32768 : (x > 32767 ? 32767 : x)); };
+        for (int lane = 0; lane < 4; lane++)
+        {
+            values[lane] = saturate(low.V[lane]);
+            values[lane + 4] = saturate(high.V[lane]);
+        }
+    }
+
+    template<typename Vector>
+    inline void TransposeLanes(Vector& a, Vector& b, Vector& c, Vector& d)
+    {
+        Vector* rows[4] = { &a, &b, &c, &d };
+        for (int i = 0; i < 4; i++)
+        {
+            for (int j = i + 1; j < 4; j++)
+            {
+                const auto value = rows[i]->V[j];
+                rows[i]->V[j] = rows[j]->V[i];
+                rows[j]->V[i] = value;
+            }
+        }
+    }
+
+    inline void Transpose(Int4& a, Int4& b, Int4& c, Int4& d) { TransposeLanes(a, b, c, d); }
+    inline void Transpose(Float4& a, Float4& b, Float4& c, Float4& d) { TransposeLanes(a, b, c, d); }
+
+    inline void StreamStore(void* destination, Int4 value) { value.Store(destination); }
+    inline void StreamStore(float* destination, Float4 value) { value.Store(destination); }
+    inline void StoreFence() {}
+#endif
+
+#if defined(SIMD_AVX2)
+    struct Float8
+    {
+        Float8() = default;
+        Float8(__m256 value) : V(value) {}
+        explicit Float8(float value) : V(_mm256_set1_ps(value)) {}
+
+        static Float8 Load(const float* values) { return _mm256_loadu_ps(values); }
+        void Store(float* values) const { _mm256_storeu_ps(values, V); }
+
+        __m256 V;
+    };
+
+    struct Int8
+    {
+        Int8() = default;
+        Int8(__m256i value) : V(value) {}
+        explicit Int8(std::int32_t value) : V(_mm256_set1_epi32(value)) {}
+
+        static Int8 Load(const void* values) { return _mm256_loadu_si256(static_cast<const __m256i*>(values)); }
+        void Store(void* values) const { _mm256_storeu_si256(static_cast<__m256i*>(values), V); }
+
+        __m256i V;
+    };
+
+    inline Float8 operator+(Float8 a, Float8 b) { return _mm256_add_ps(a.V, b.V); }
+    inline Float8 operator-(Float8 a, Float8 b) { return _mm256_sub_ps(a.V, b.V); }
+    inline Float8 operator*(Float8 a, Float8 b) { return _mm256_mul_ps(a.V, b.V); }
+    inline Float8 operator/(Float8 a, Float8 b) { return _mm256_div_ps(a.V, b.V); }
+    inline Float8 Min(Float8 a, Float8 b) { return _mm256_min_ps(a.V, b.V); }
+    inline Float8 Max(Float8 a, Float8 b) { return _mm256_max_ps(a.V, b.V); }
+    inline Float8 Sqrt(Float8 a) { return _mm256_sqrt_ps(a.V); }
+    inline Float8 Floor(Float8 a) { return _mm256_floor_ps(a.V); }
+
+    inline Float8 MulAdd(Float8 a, Float8 b, Float8 c)
+    {
+#if defined(SIMD_FMA)
+        return _mm256_fmadd_ps(a.V, b.V, c.V);
+#else
+        return _mm256_add_ps(_mm256_mul_ps(a.V, b.V), c.V);
+#endif
+    }
+
+    inline Int8 operator+(Int8 a, Int8 b) { return _mm256_add_epi32(a.V, b.V); }
+    inline Int8 MulLow(Int8 a, Int8 b) { return _mm256_mullo_epi32(a.V, b.V); }
+    inline Float8 ToFloat(Int8 a) { return _mm256_cvtepi32_ps(a.V); }
+    inline Int8 TruncateToInt(Float8 a) { return _mm256_cvttps_epi32(a.V); }
+
+    inline Float8 Gather(const float* values, Int8 indices)
+    {
+        return _mm256_i32gather_ps(values, indices.V, 4);
+    }
+
+    // Les entiers 16 bits sont lus par mots de 32 bits : values doit rester lisible 2 octets après le plus grand index.
+    inline Int8 GatherInt16(const std::int16_t* values, Int8 indices)
+    {
+        const __m256i words = _mm256_i32gather_epi32(reinterpret_cast<const int*>(values), indices.V, 2);
+        return _mm256_srai_epi32(_mm256_slli_epi32(words, 16), 16);
+    }
+
+    // Même contrainte de lecture que GatherInt16.
+    inline Float8 GatherHalf(const std::uint16_t* values, Int8 indices)
+    {
+#if defined(SIMD_F16C)
+        const __m256i words = _mm256_and_si256(_mm256_i32gather_epi32(reinterpret_cast<const int*>(values), indices.V, 2), _mm256_set1_epi32(0xffff));
+        return _mm256_cvtph_ps(_mm_packus_epi32(_mm256_castsi256_si128(words), _mm256_extracti128_si256(words, 1)));
+#else
+        alignas(32) std::int32_t laneIndices[8];
+        alignas(32) float laneValues[8];
+        indices.Store(laneIndices);
+        for (int lane = 0; lane < 8; lane++)
+            laneValues[lane] = HalfToFloat(values[laneIndices[lane]]);
+        return Float8::Load(laneValues);
+#endif
+    }
+#else
+    // Sans AVX2, 8 voies sont faites de deux fois 4 voies, et les lectures indexées sont faites voie par voie.
+    struct Float8
+    {
+        Float8() = default;
+        Float8(Float4 low, Float4 high) : Low(low), High(high) {}
+        explicit Float8(float value) : Low(value), High(value) {}
+
+        static Float8 Load(const float* values) { return Float8(Float4::Load(values), Float4::Load(values + 4)); }
+        void Store(float* values) const
+        {
+            Low.Store(values);
+            High.Store(values + 4);
+        }
+
+        Float4 Low;
+        Float4 High;
+    };
+
+    struct Int8
+    {
+        Int8() = default;
+        Int8(Int4 low, Int4 high) : Low(low), High(high) {}
+        explicit Int8(std::int32_t value) : Low(value), High(value) {}
+
+        static Int8 Load(const void* values) { return Int8(Int4::Load(values), Int4::Load(static_cast<const std::int32_t*>(values) + 4)); }
+        void Store(void* values) const
+        {
+            Low.Store(values);
+            High.Store(static_cast<std::int32_t*>(values) + 4);
+        }
+
+        Int4 Low;
+        Int4 High;
+    };
+
+    inline Float8 operator+(Float8 a, Float8 b) { return Float8(a.Low + b.Low, a.High + b.High); }
+    inline Float8 operator-(Float8 a, Float8 b) { return Float8(a.Low - b.Low, a.High - b.High); }
+    inline Float8 operator*(Float8 a, Float8 b) { return Float8(a.Low * b.Low, a.High * b.High); }
+    inline Float8 operator/(Float8 a, Float8 b) { return Float8(a.Low / b.Low, a.High / b.High); }
+    inline Float8 Min(Float8 a, Float8 b) { return Float8(Min(a.Low, b.Low), Min(a.High, b.High)); }
+    inline Float8 Max(Float8 a, Float8 b) { return Float8(Max(a.Low, b.Low), Max(a.High, b.High)); }
+    inline Float8 Sqrt(Float8 a) { return Float8(Sqrt(a.Low), Sqrt(a.High)); }
+    inline Float8 Floor(Float8 a) { return Float8(Floor(a.Low), Floor(a.High)); }
+    inline Float8 MulAdd(Float8 a, Float8 b, Float8 c) { return Float8(MulAdd(a.Low, b.Low, c.Low), MulAdd(a.High, b.High, c.High)); }
+
+    inline Int8 operator+(Int8 a, Int8 b) { return Int8(a.Low + b.Low, a.High + b.High); }
+    inline Int8 MulLow(Int8 a, Int8 b) { return Int8(MulLow(a.Low, b.Low), MulLow(a.High, b.High)); }
+    inline Float8 ToFloat(Int8 a) { return Float8(ToFloat(a.Low), ToFloat(a.High)); }
+    inline Int8 TruncateToInt(Float8 a) { return Int8(TruncateToInt(a.Low), TruncateToInt(a.High)); }
+
+    template<typename Value, typename Element, typename Load>
+    inline Value GatherLanes(Int8 indices, const Load& load)
+    {
+        std::int32_t laneIndices[8];
+        indices.Store(laneIndices);
+        Element laneValues[8];
+        for (int lane = 0; lane < 8; lane++)
+            laneValues[lane] = load(laneIndices[lane]);
+        return Value::Load(laneValues);
+    }
+
+    inline Float8 Gather(const float* values, Int8 indices)
+    {
+        return GatherLanes<Float8, float>(indices, [values](std::int32_t index) { return values[index]; });
+    }
+
+    inline Int8 GatherInt16(const std::int16_t* values, Int8 indices)
+    {
+        return GatherLanes<Int8, std::int32_t>(indices, [values](std::int32_t index) { return static_cast<std::int32_t>(values[index]); });
+    }
+
+    inline Float8 GatherHalf(const std::uint16_t* values, Int8 indices)
+    {
+        return GatherLanes<Float8, float>(indices, [values](std::int32_t index) { return HalfToFloat(values[index]); });
+    }
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+// File sans verrou à un seul producteur et un seul consommateur, de capacité fixe (puissance de 2).
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+        : mItems(capacity), mMask(capacity - 1)
+    {
+        assert(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    }
+
+    SpscQueue(const SpscQueue& rhs) = delete;
+    SpscQueue& operator=(const SpscQueue& rhs) = delete;
+    ~SpscQueue() = default;
+
+    // Côté producteur. Ajoute autant d'éléments que possible et renvoie le nombre d'éléments ajoutés.
+    size_t Push(const T* items, size_t count)
+    {
+        const size_t tail = mTail.load(std::memory_order_relaxed);
+        const size_t head = mHead.load(std::memory_order_acquire);
+        const size_t free = mItems.size() - (tail - head);
+        if (count > free)
+            count = free;
+
+        for (size_t i = 0; i < count; i++)
+            mItems[(tail + i) & mMask] = items[i];
+
+        mTail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Côté consommateur. Ajoute tous les éléments disponibles à la fin de output.
+    void PopAll(std::vector<T>& output)
+    {
+        const size_t head = mHead.load(std::memory_order_relaxed);
+        const size_t tail = mTail.load(std::memory_order_acquire);
+
+        for (size_t i = head; i != tail; i++)
+            output.push_back(mItems[i & mMask]);
+
+        mHead.store(tail, std::memory_order_release);
+    }
+
+private:
+    std::vector<T> mItems;
+    size_t mMask = 0;
+
+    // Sur des lignes de cache différentes pour que producteur et consommateur ne se gênent pas.
+    alignas(64) std::atomic<size_t> mHead { 0 };
+    alignas(64) std::atomic<size_t> mTail { 0 };
+};
\ No newline at end of file
@@ -0,0 +1,368 @@
+#include "Utils/TlsfAllocator.h"
+
+#include <bit>
+#include <cassert>
+
+TlsfAllocator::TlsfAllocator(std::uint64_t capacity, std::uint64_t granularity)
+    : mCapacity(capacity & ~(granularity - 1)), mGranularity(granularity), mGranularityShift(std::countr_zero(granularity))
+{
+    assert(granularity > 0 && (granularity & (granularity - 1)) == 0);
+    assert(mCapacity > 0 && "Capacité plus petite que la granularité");
+
+    for (auto& freeLists : mFreeLists)
+    {
+        for (std::uint32_t& freeList : freeLists)
+            freeList = InvalidHandle;
+    }
+
+    // Au départ, un seul bloc libre couvre tout l'espace.
+    mFirstBlock = NewBlock();
+    mBlocks[mFirstBlock].Offset = 0;
+    mBlocks[mFirstBlock].Size = mCapacity;
+    InsertFreeBlock(mFirstBlock);
+}
+
+TlsfAllocator::Allocation TlsfAllocator::Allocate(std::uint64_t byteSize, std::uint64_t alignment)
+{
+    assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    const std::uint64_t size = ((byteSize > 0 ? byteSize : 1) + mGranularity - 1) & ~(mGranularity - 1);
+    if (size > mCapacity)
+        return {};
+
+    // Les décalages des blocs sont des multiples de la granularité : pour un alignement plus grand, le début du bloc peut être perdu,
+    // au plus alignment - granularité octets, que l'on ajoute à la taille cherchée.
+    const std::uint64_t padding = alignment > mGranularity ? alignment - mGranularity : 0;
+    const std::uint32_t block = FindFreeBlock(size + padding);
+    if (block == InvalidHandle)
+        return {};
+
+    RemoveFreeBlock(block);
+
+    std::uint32_t allocated = block;
+    const std::uint64_t offset = mBlocks[block].Offset;
+    const std::uint64_t alignedOffset = (offset + alignment - 1) & ~(alignment - 1);
+    if (alignedOffset != offset)
+    {
+        // Le début perdu reste un bloc libre. Le bloc précédent n'est pas libre, sinon il aurait été fusionné avec celui-ci.
+        allocated = Split(block, alignedOffset - offset);
+        InsertFreeBlock(block);
+    }
+
+    if (mBlocks[allocated].Size - size >= mGranularity)
+        InsertFreeBlock(Split(allocated, size));
+
+    Block& result = mBlocks[allocated];
+    result.IsFree = false;
+    result.Alignment = alignment > mGranularity ? alignment : mGranularity;
+    mUsedBytes += result.Size;
+    mAllocationCount++;
+    return { result.Offset, result.Size, allocated };
+}
+
+void TlsfAllocator::Free(std::uint32_t handle)
+{
+    assert(handle < mBlocks.size() && !mBlocks[handle].IsFree && "Free d'une allocation invalide ou déjà libérée");
+
+    mUsedBytes -= mBlocks[handle].Size;
+    mAllocationCount--;
+
+    std::uint32_t block = handle;
+    const std::uint32_t next = mBlocks[block].NextPhysical;
+    if (next != InvalidHandle && mBlocks[next].IsFree)
+    {
+        RemoveFreeBlock(next);
+        Merge(block, next);
+    }
+
+    const std::uint32_t previous = mBlocks[block].PreviousPhysical;
+    if (previous != InvalidHandle && mBlocks[previous].IsFree)
+    {
+        RemoveFreeBlock(previous);
+        Merge(previous, block);
+        block = previous;
+    }
+
+    InsertFreeBlock(block);
+}
+
+TlsfAllocator::Stats TlsfAllocator::GetStats() const
+{
+    Stats stats;
+    stats.Capacity = mCapacity;
+    stats.UsedBytes = mUsedBytes;
+    stats.AllocationCount = mAllocationCount;
+
+    for (std::uint32_t block = mFirstBlock; block != InvalidHandle; block = mBlocks[block].NextPhysical)
+    {
+        if (mBlocks[block].IsFree)
+        {
+            stats.FreeBlockCount++;
+            if (mBlocks[block].Size > stats.LargestFreeBlock)
+                stats.LargestFreeBlock = mBlocks[block].Size;
+        }
+    }
+
+    const std::uint64_t freeBytes = mCapacity - mUsedBytes;
+    stats.Fragmentation = freeBytes > 0 ? 1.0f - static_cast<float>(static_cast<double>(stats.LargestFreeBlock) / static_cast<double>(freeBytes)) : 0.0f;
+    return stats;
+}
+
+bool TlsfAllocator::Validate() const
+{
+    std::uint64_t offset = 0;
+    std::uint64_t usedBytes = 0;
+    std::uint64_t allocationCount = 0;
+    std::uint64_t freeBlockCount = 0;
+    std::uint32_t previous = InvalidHandle;
+    for (std::uint32_t block = mFirstBlock; block != InvalidHandle; block = mBlocks[block].NextPhysical)
+    {
+        const Block& current = mBlocks[block];
+        if (current.PreviousPhysical != previous || current.Offset != offset || current.Size == 0 || current.Size % mGranularity != 0)
+            return false;
+        if (current.IsFree && previous != InvalidHandle && mBlocks[previous].IsFree)
+            return false;
+
+        if (current.IsFree)
+        {
+            freeBlockCount++;
+            int firstLevel = 0;
+            int secondLevel = 0;
+            Mapping(current.Size, firstLevel, secondLevel);
+            if ((mSecondLevelBitmaps[firstLevel] & (1u << secondLevel)) == 0)
+                return false;
+        }
+        else
+        {
+            if (current.Offset % current.Alignment != 0)
+                return false;
+            usedBytes += current.Size;
+            allocationCount++;
+        }
+
+        offset += current.Size;
+        previous = block;
+    }
+
+    if (offset != mCapacity || usedBytes != mUsedBytes || allocationCount != mAllocationCount)
+        return false;
+
+    // Chaque liste ne contient que des blocs libres de sa classe, et les bitmaps ne marquent que les listes non vides.
+    std::uint64_t listedCount = 0;
+    for (int firstLevel = 0; firstLevel < FirstLevelCount; firstLevel++)
+    {
+        if (((mFirstLevelBitmap >> firstLevel) & 1) != (mSecondLevelBitmaps[firstLevel] != 0 ? 1u : 0u))
+            return false;
+
+        for (int secondLevel = 0; secondLevel < SecondLevelCount; secondLevel++)
+        {
+            const std::uint32_t head = mFreeLists[firstLevel][secondLevel];
+            if (((mSecondLevelBitmaps[firstLevel] >> secondLevel) & 1) != (head != InvalidHandle ? 1u : 0u))
+                return false;
+
+            std::uint32_t previousFree = InvalidHandle;
+            for (std::uint32_t block = head; block != InvalidHandle; block = mBlocks[block].NextFree)
+            {
+                int blockFirstLevel = 0;
+                int blockSecondLevel = 0;
+                Mapping(mBlocks[block].Size, blockFirstLevel, blockSecondLevel);
+                if (!mBlocks[block].IsFree || mBlocks[block].PreviousFree != previousFree || blockFirstLevel != firstLevel || blockSecondLevel != secondLevel)
+                    return false;
+                previousFree = block;
+                listedCount++;
+            }
+        }
+    }
+
+    return listedCount == freeBlockCount;
+}
+
+void TlsfAllocator::Mapping(std::uint64_t size, int& firstLevel, int& secondLevel) const
+{
+    // En unités de granularité. Les 16 premières tailles ont chacune leur classe, au-delà chaque puissance de 2 est coupée en 16.
+    const std::uint64_t units = size >> mGranularityShift;
+    if (units < SecondLevelCount)
+    {
+        firstLevel = 0;
+        secondLevel = static_cast<int>(units);
+        return;
+    }
+
+    const int log2 = 63 - std::countl_zero(units);
+    firstLevel = log2 - SecondLevelBits + 1;
+    secondLevel = static_cast<int>(units >> (log2 - SecondLevelBits)) - SecondLevelCount;
+}
+
+std::uint32_t TlsfAllocator::FindFreeBlock(std::uint64_t size) const
+{
+    // Taille arrondie au début de la classe suivante : tous les blocs de la classe trouvée sont alors assez grands.
+    std::uint64_t units = size >> mGranularityShift;
+    if (units >= SecondLevelCount)
+        units += (1ull << (63 - std::countl_zero(units) - SecondLevelBits)) - 1;
+
+    int firstLevel = 0;
+    int secondLevel = 0;
+    Mapping(units << mGranularityShift, firstLevel, secondLevel);
+    if (firstLevel >= FirstLevelCount)
+        return InvalidHandle;
+
+    std::uint32_t secondLevelMap = mSecondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+    if (secondLevelMap == 0)
+    {
+        const std::uint64_t firstLevelMap = firstLevel + 1 < 64 ? mFirstLevelBitmap & (~0ull << (firstLevel + 1)) : 0;
+        if (firstLevelMap == 0)
+            return InvalidHandle;
+
+        firstLevel = std::countr_zero(firstLevelMap);
+        secondLevelMap = mSecondLevelBitmaps[firstLevel];
+    }
+
+    return mFreeLists[firstLevel][std::countr_zero(secondLevelMap)];
+}
+
+void TlsfAllocator::InsertFreeBlock(std::uint32_t block)
+{
+    int firstLevel = 0;
+    int secondLevel = 0;
+    Mapping(mBlocks[block].Size, firstLevel, secondLevel);
+
+    const std::uint32_t head = mFreeLists[firstLevel][secondLevel];
+    mBlocks[block].IsFree = true;
+    mBlocks[block].PreviousFree = InvalidHandle;
+    mBlocks[block].NextFree = head;
+    if (head != InvalidHandle)
+        mBlocks[head].PreviousFree = block;
+
+    mFreeLists[firstLevel][secondLevel] = block;
+    mSecondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    mFirstLevelBitmap |= 1ull << firstLevel;
+}
+
+void TlsfAllocator::RemoveFreeBlock(std::uint32_t block)
+{
+    int firstLevel = 0;
+    int secondLevel = 0;
+    Mapping(mBlocks[block].Size, firstLevel, secondLevel);
+
+    const std::uint32_t previous = mBlocks[block].PreviousFree;
+    const std::uint32_t next = mBlocks[block].NextFree;
+    if (previous != InvalidHandle)
+        mBlocks[previous].NextFree = next;
+    else
+        mFreeLists[firstLevel][secondLevel] = next;
+    if (next != InvalidHandle)
+        mBlocks[next].PreviousFree = previous;
+
+    if (mFreeLists[firstLevel][secondLevel] == InvalidHandle)
+    {
+        mSecondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+        if (mSecondLevelBitmaps[firstLevel] == 0)
+            mFirstLevelBitmap &= ~(1ull << firstLevel);
+    }
+
+    mBlocks[block].IsFree = false;
+    mBlocks[block].PreviousFree = InvalidHandle;
+    mBlocks[block].NextFree = InvalidHandle;
+}
+
+std::uint32_t TlsfAllocator::NewBlock()
+{
+    if (mUnusedBlocks != InvalidHandle)
+    {
+        const std::uint32_t block = mUnusedBlocks;
+        mUnusedBlocks = mBlocks[block].NextFree;
+        mBlocks[block] = Block();
+        return block;
+    }
+
+    mBlocks.emplace_back();
+    return static_cast<std::uint32_t>(mBlocks.size() - 1);
+}
+
+void TlsfAllocator::ReleaseBlock(std::uint32_t block)
+{
+    mBlocks[block] = Block();
+    mBlocks[block].NextFree = mUnusedBlocks;
+    mUnusedBlocks = block;
+}
+
+std::uint32_t TlsfAllocator::Split(std::uint32_t block, std::uint64_t byteSize)
+{
+    assert(byteSize > 0 && byteSize < mBlocks[block].Size);
+
+    // NewBlock peut agrandir mBlocks : pas de référence sur un bloc gardée avant.
+    const std::uint32_t second = NewBlock();
+    Block& first = mBlocks[block];
+    Block& remainder = mBlocks[second];
+    remainder.Offset = first.Offset + byteSize;
+    remainder.Size = first.Size - byteSize;
+    remainder.PreviousPhysical = block;
+    remainder.NextPhysical = first.NextPhysical;
+    if (first.NextPhysical != InvalidHandle)
+        mBlocks[first.NextPhysical].PreviousPhysical = second;
+
+    first.Size = byteSize;
+    first.NextPhysical = second;
+    return second;
+}
+
+void TlsfAllocator::Merge(std::uint32_t block, std::uint32_t next)
+{
+    assert(mBlocks[block].NextPhysical == next);
+
+    Block& first = mBlocks[block];
+    first.Size += mBlocks[next].Size;
+    first.NextPhysical = mBlocks[next].NextPhysical;
+    if (first.NextPhysical != InvalidHandle)
+        mBlocks[first.NextPhysical].PreviousPhysical = block;
+
+    ReleaseBlock(next);
+}
+
+std::uint64_t TlsfAllocator::SlideDown(std::uint32_t block)
+{
+    const std::uint32_t previous = mBlocks[block].PreviousPhysical;
+    const std::uint64_t oldOffset = mBlocks[block].Offset;
+    const std::uint64_t newOffset = (mBlocks[previous].Offset + mBlocks[block].Alignment - 1) & ~(mBlocks[block].Alignment - 1);
+    if (newOffset >= oldOffset)
+        return oldOffset;
+
+    // Le bloc libre précédent garde ce que l'alignement laisse devant le bloc déplacé (ou disparaît), et l'espace libéré derrière
+    // devient un bloc libre, fusionné avec le suivant s'il l'est aussi.
+    RemoveFreeBlock(previous);
+    const std::uint64_t gap = newOffset - mBlocks[previous].Offset;
+    if (gap == 0)
+    {
+        const std::uint32_t beforePrevious = mBlocks[previous].PreviousPhysical;
+        mBlocks[block].PreviousPhysical = beforePrevious;
+        if (beforePrevious != InvalidHandle)
+            mBlocks[beforePrevious].NextPhysical = block;
+        else
+            mFirstBlock = block;
+        ReleaseBlock(previous);
+    }
+    else
+    {
+        mBlocks[previous].Size = gap;
+        InsertFreeBlock(previous);
+    }
+
+    mBlocks[block].Offset = newOffset;
+    const std::uint32_t tail = NewBlock();
+    mBlocks[tail].Offset = newOffset + mBlocks[block].Size;
+    mBlocks[tail].Size = oldOffset - newOffset;
+    mBlocks[tail].PreviousPhysical = block;
+    mBlocks[tail].NextPhysical = mBlocks[block].NextPhysical;
+    if (mBlocks[tail].NextPhysical != InvalidHandle)
+        mBlocks[mBlocks[tail].NextPhysical].PreviousPhysical = tail;
+    mBlocks[block].NextPhysical = tail;
+
+    const std::uint32_t next = mBlocks[tail].NextPhysical;
+    if (next != InvalidHandle && mBlocks[next].IsFree)
+    {
+        RemoveFreeBlock(next);
+        Merge(tail, next);
+    }
+    InsertFreeBlock(tail);
+    return newOffset;
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Allocateur TLSF (Two-Level Segregated Fit) de décalages dans un espace de taille fixe : comme RingAllocator, il ne touche jamais à la mémoire,
+// qui peut être un heap D3D12 que le CPU ne voit pas. Les blocs libres sont rangés par classes de taille sur deux niveaux (puissance de 2, puis 16
+// subdivisions de chaque puissance), avec un bitmap par niveau : Allocate et Free sont en temps constant, quelle que soit la fragmentation.
+// Les tailles sont arrondies à la granularité (puissance de 2) donnée à la création. Deux blocs libres voisins sont toujours fusionnés.
+// Les métadonnées des blocs sont à part, dans un tableau réutilisé : aucune allocation du tas en régime établi. À utiliser depuis un seul thread.
+class TlsfAllocator
+{
+public:
+    static constexpr std::uint64_t InvalidOffset = ~0ull;
+    static constexpr std::uint32_t InvalidHandle = ~0u;
+
+    struct Allocation
+    {
+        std::uint64_t Offset = InvalidOffset;
+        // Taille réservée, arrondie à la granularité.
+        std::uint64_t ByteSize = 0;
+        // À rendre à Free. Reste valide si Defragment déplace l'allocation.
+        std::uint32_t Handle = InvalidHandle;
+
+        bool IsValid() const { return Handle != InvalidHandle; }
+    };
+
+    struct Stats
+    {
+        std::uint64_t Capacity = 0;
+        std::uint64_t UsedBytes = 0;
+        std::uint64_t AllocationCount = 0;
+        std::uint64_t FreeBlockCount = 0;
+        std::uint64_t LargestFreeBlock = 0;
+        // 0 quand tout l'espace libre est d'un seul tenant, vers 1 quand il est émietté en petits blocs.
+        float Fragmentation = 0.0f;
+    };
+
+    TlsfAllocator(std::uint64_t capacity, std::uint64_t granularity = 256);
+
+    // Bloc d'au moins byteSize octets dont le décalage est un multiple de alignment (puissance de 2), ou une allocation invalide si aucun bloc libre ne convient.
+    // Comme tout TLSF, la recherche ne regarde que les classes dont tous les blocs suffisent : une allocation peut échouer alors qu'un bloc
+    // de la classe juste en dessous aurait convenu, ce qui est le prix du temps constant.
+    Allocation Allocate(std::uint64_t byteSize, std::uint64_t alignment = 1);
+    void Free(std::uint32_t handle);
+
+    std::uint64_t Offset(std::uint32_t handle) const { return mBlocks[handle].Offset; }
+
+    // Tasse les allocations vers le début, dans l'ordre de leurs décalages, tant qu'elles gardent leur alignement. Pour chaque allocation déplacée,
+    // move(handle, ancien décalage, nouveau décalage, taille) est appelé avant le déplacement suivant : l'appelant recopie les données
+    // (les deux zones peuvent se chevaucher) et recrée ce qui dépendait du décalage. Renvoie le nombre d'allocations déplacées.
+    template<typename Move>
+    std::uint32_t Defragment(Move&& move)
+    {
+        std::uint32_t movedCount = 0;
+        for (std::uint32_t block = mFirstBlock; block != InvalidHandle; block = mBlocks[block].NextPhysical)
+        {
+            const std::uint32_t previous = mBlocks[block].PreviousPhysical;
+            if (mBlocks[block].IsFree || previous == InvalidHandle || !mBlocks[previous].IsFree)
+                continue;
+
+            const std::uint64_t oldOffset = mBlocks[block].Offset;
+            const std::uint64_t newOffset = SlideDown(block);
+            if (newOffset != oldOffset)
+            {
+                move(block, oldOffset, newOffset, mBlocks[block].Size);
+                movedCount++;
+            }
+        }
+        return movedCount;
+    }
+
+    Stats GetStats() const;
+    // Vérifie toutes les invariants (blocs contigus qui couvrent l'espace, pas de blocs libres voisins, listes et bitmaps cohérents).
+    // Coûte le parcours de tous les blocs : pour les tests et les asserts de debug.
+    bool Validate() const;
+
+    std::uint64_t Capacity() const { return mCapacity; }
+    std::uint64_t Granularity() const { return mGranularity; }
+
+private:
+    // 2^4 = 16 classes par puissance de 2 : une allocation perd au plus 1/16 de sa taille à cause de l'arrondi de la recherche.
+    static constexpr int SecondLevelBits = 4;
+    static constexpr int SecondLevelCount = 1 << SecondLevelBits;
+    static constexpr int FirstLevelCount = 64 - SecondLevelBits + 1;
+
+    struct Block
+    {
+        std::uint64_t Offset = 0;
+        std::uint64_t Size = 0;
+        std::uint32_t PreviousPhysical = InvalidHandle;
+        std::uint32_t NextPhysical = InvalidHandle;
+        // Blocs libres : liste de leur classe. Blocs non utilisés du tableau : NextFree chaîne les entrées à réutiliser.
+        std::uint32_t PreviousFree = InvalidHandle;
+        std::uint32_t NextFree = InvalidHandle;
+        std::uint64_t Alignment = 1;
+        bool IsFree = false;
+    };
+
+    // Classe d'un bloc libre de size octets.
+    void Mapping(std::uint64_t size, int& firstLevel, int& secondLevel) const;
+    std::uint32_t FindFreeBlock(std::uint64_t size) const;
+    void InsertFreeBlock(std::uint32_t block);
+    void RemoveFreeBlock(std::uint32_t block);
+    std::uint32_t NewBlock();
+    void ReleaseBlock(std::uint32_t block);
+    // Coupe block après byteSize octets et renvoie la seconde partie.
+    std::uint32_t Split(std::uint32_t block, std::uint64_t byteSize);
+    // Fusionne next, qui suit block, dans block.
+    void Merge(std::uint32_t block, std::uint32_t next);
+    std::uint64_t SlideDown(std::uint32_t block);
+
+    std::uint64_t mCapacity = 0;
+    std::uint64_t mGranularity = 0;
+    int mGranularityShift = 0;
+    std::uint64_t mUsedBytes = 0;
+    std::uint64_t mAllocationCount = 0;
+
+    std::vector<Block> mBlocks;
+    std::uint32_t mFirstBlock = InvalidHandle;
+    std::uint32_t mUnusedBlocks = InvalidHandle;
+
+    std::uint64_t mFirstLevelBitmap = 0;
+    std::uint32_t mSecondLevelBitmaps[FirstLevelCount] = {};
+    std::uint32_t mFreeLists[FirstLevelCount][SecondLevelCount];
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+
+// Triple buffer sans verrou entre un producteur et un consommateur : le producteur remplit WriteBuffer() puis publie,
+// le consommateur récupère le dernier état publié sans jamais attendre le producteur (et inversement).
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+    TripleBuffer(const TripleBuffer& rhs) = delete;
+    TripleBuffer& operator=(const TripleBuffer& rhs) = delete;
+    ~TripleBuffer() = default;
+
+    // Côté producteur.
+    T& WriteBuffer()
+    {
+        return mBuffers[mWriteIndex];
+    }
+
+    void Publish()
+    {
+        mWriteIndex = mMiddle.exchange(mWriteIndex | FreshBit, std::memory_order_acq_rel) & IndexMask;
+    }
+
+    // Côté consommateur. Renvoie vrai si un nouvel état a été publié depuis le dernier appel.
+    bool Acquire()
+    {
+        if ((mMiddle.load(std::memory_order_relaxed) & FreshBit) == 0)
+            return false;
+
+        mReadIndex = mMiddle.exchange(mReadIndex, std::memory_order_acq_rel) & IndexMask;
+        return true;
+    }
+
+    const T& ReadBuffer() const
+    {
+        return mBuffers[mReadIndex];
+    }
+
+    // Accès aux trois buffers, uniquement quand aucun des deux threads ne tourne (initialisation).
+    T& Buffer(int index)
+    {
+        return mBuffers[index];
+    }
+
+private:
+    static constexpr int IndexMask = 3;
+    static constexpr int FreshBit = 4;
+
+    T mBuffers[3];
+    int mWriteIndex = 0;
+    int mReadIndex = 1;
+    std::atomic<int> mMiddle { 2 };
+};
\ No newline at end of file
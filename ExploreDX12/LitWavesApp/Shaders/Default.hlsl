@@ -1,4 +1,4 @@
-// Dfinition par dfaut des nombres de lumires.
+// Définition par défaut des nombres de lumières.
 #ifndef NUM_DIR_LIGHTS
     #define NUM_DIR_LIGHTS 1
 #endif
@@ -13,13 +13,13 @@
 
 #include "LightingUtils.hlsl"
 
-// Donnes constantes qui varient par frame.
+// Données constantes qui varient par frame.
 cbuffer cbPerObject : register(b0)
 {
     float4x4 gWorld;
 };
 
-// Donnes constantes qui varient par matriau.
+// Données constantes qui varient par matériau.
 cbuffer cbMaterial : register(b1)
 {
     float4 gDiffuseAlbedo;
@@ -28,7 +28,7 @@ cbuffer cbMaterial : register(b1)
     float4x4 gMatTransform;
 };
 
-// Donnes constantes qui varient par passe.
+// Données constantes qui varient par passe.
 cbuffer cbPass : register(b2)
 {
     float4x4 gView;
@@ -49,6 +49,36 @@ cbuffer cbPass : register(b2)
     Light gLights[MaxLights];
 };
 
+// Constantes de la grille d'eau, utilisées pour reconstruire x et z à partir de l'indice du sommet.
+// Les sommets sont rangés par blocs de (gWavesChunkRowSize + 1) x (gWavesChunkColumnSize + 1), gWavesChunkIndex est le bloc dessiné.
+cbuffer cbWaves : register(b3)
+{
+    uint gWavesRowCount;
+    uint gWavesColumnCount;
+    float gWavesSpatialStep;
+    float gWavesHalfWidth;
+    float gWavesHalfDepth;
+    uint gWavesChunkRowSize;
+    uint gWavesChunkColumnSize;
+    uint gWavesChunkRowCount;
+    uint gWavesChunkColumnCount;
+    uint gWavesChunkIndex;
+};
+
+#ifdef WAVES_HEIGHT_ONLY
+// Hauteurs de l'eau lues directement dans l'upload buffer de la frame, pour pouvoir accéder aux voisins.
+StructuredBuffer<float> gWavesHeights : register(t0);
+
+// Position dans gWavesHeights du sommet (i, j) de la grille, dans le bloc qui le contient.
+uint WavesHeightIndex(uint i, uint j)
+{
+    uint chunkRow = min(i / gWavesChunkRowSize, gWavesChunkRowCount - 1);
+    uint chunkColumn = min(j / gWavesChunkColumnSize, gWavesChunkColumnCount - 1);
+    uint chunkVertexCount = (gWavesChunkRowSize + 1) * (gWavesChunkColumnSize + 1);
+    return (chunkRow * gWavesChunkColumnCount + chunkColumn) * chunkVertexCount + (i - chunkRow * gWavesChunkRowSize) * (gWavesChunkColumnSize + 1) + (j - chunkColumn * gWavesChunkColumnSize);
+}
+#endif
+
 struct VertexIn
 {
     float3 PosL : POSITION;
@@ -75,21 +105,68 @@ VertexOut VS(VertexIn vin)
     return vout;
 }
 
+struct WavesVertexIn
+{
+    uint VertexId : SV_VertexID;
+#ifndef WAVES_HEIGHT_ONLY
+    float Height : HEIGHT;
+    float2 PackedNormal : NORMAL;
+#endif
+};
+
+VertexOut WavesVS(WavesVertexIn vin)
+{
+    VertexOut vout = (VertexOut) 0.0f;
+
+    // x et z sont fixes pour la grille d'eau, on les retrouve à partir de la ligne et de la colonne du sommet.
+    // Le modulo donne l'indice local au bloc, que SV_VertexID inclue ou non le BaseVertexLocation du draw.
+    // Les sommets de remplissage des blocs du bord sont ramenés sur la dernière ligne ou colonne de la grille.
+    uint chunkVertexColumns = gWavesChunkColumnSize + 1;
+    uint localIndex = vin.VertexId % ((gWavesChunkRowSize + 1) * chunkVertexColumns);
+    uint i = min((gWavesChunkIndex / gWavesChunkColumnCount) * gWavesChunkRowSize + localIndex / chunkVertexColumns, gWavesRowCount - 1);
+    uint j = min((gWavesChunkIndex % gWavesChunkColumnCount) * gWavesChunkColumnSize + localIndex % chunkVertexColumns, gWavesColumnCount - 1);
+    float3 posL = float3(-gWavesHalfWidth + j * gWavesSpatialStep, 0.0f, gWavesHalfDepth - i * gWavesSpatialStep);
+    float3 normalL = float3(0.0f, 1.0f, 0.0f);
+
+#ifdef WAVES_HEIGHT_ONLY
+    posL.y = gWavesHeights[WavesHeightIndex(i, j)];
+    // Même calcul que Waves::ComputeNormal à partir des hauteurs voisines, les bordures gardent une normale verticale.
+    if (i > 0 && i < gWavesRowCount - 1 && j > 0 && j < gWavesColumnCount - 1)
+    {
+        float l = gWavesHeights[WavesHeightIndex(i, j - 1)];
+        float r = gWavesHeights[WavesHeightIndex(i, j + 1)];
+        float t = gWavesHeights[WavesHeightIndex(i - 1, j)];
+        float b = gWavesHeights[WavesHeightIndex(i + 1, j)];
+        normalL = normalize(float3(l - r, 2.0f * gWavesSpatialStep, b - t));
+    }
+#else
+    posL.y = vin.Height;
+    // La composante y de la normale est toujours positive pour la surface de l'eau.
+    normalL = float3(vin.PackedNormal.x, sqrt(saturate(1.0f - dot(vin.PackedNormal, vin.PackedNormal))), vin.PackedNormal.y);
+#endif
+
+    float4 posW = mul(float4(posL, 1.0f), gWorld);
+    vout.PosW = posW.xyz;
+    vout.NormalW = mul(normalL, (float3x3) gWorld);
+    vout.PosH = mul(posW, gViewProj);
+    return vout;
+}
+
 float4 PS(VertexOut pin) : SV_Target
 {
-    // L'interpolation des normales peut les dnormaliser, on doit donc les renormaliser.
+    // L'interpolation des normales peut les dénormaliser, on doit donc les renormaliser.
     pin.NormalW = normalize(pin.NormalW);
-    // Vecteur du point clair vers l'oeil.
+    // Vecteur du point éclairé vers l'oeil.
     float3 toEyeW = normalize(gEyePosW - pin.PosW);
-    // clairage indirect.
+    // Éclairage indirect.
     float4 ambient = gAmbientLight * gDiffuseAlbedo;
-    // clairage direct.
+    // Éclairage direct.
     const float shininess = 1.0f - gRoughness;
     Material mat = { gDiffuseAlbedo, gFresnelR0, shininess };
     float3 shadowFactor = 1.0f;
     float4 directLight = ComputeLighting(gLights, mat, pin.PosW, pin.NormalW, toEyeW, shadowFactor);
     float4 litColor = ambient + directLight;
-    // Convention courante de prendre l'alpha depuis le matriau diffus.
+    // Convention courante de prendre l'alpha depuis le matériau diffus.
     litColor.a = gDiffuseAlbedo.a;
     return litColor;
 }
\ No newline at end of file
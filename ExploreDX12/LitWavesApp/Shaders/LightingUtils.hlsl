@@ -14,17 +14,17 @@ struct Material
 {
     float4 DiffuseAlbedo;
     float3 FresnelR0;
-    // La brillance est l'inverse de la rugosit : Shininess = 1 - roughness.
+    // La brillance est l'inverse de la rugosité : Shininess = 1 - roughness.
     float Shininess;
 };
 
-// Implmentation d'un facteur d'attnuation linaire, s'applique pour les points lumineux et les projecteurs.
+// Implémentation d'un facteur d'atténuation linéaire, s'applique pour les points lumineux et les projecteurs.
 float CalcAttenuation(float d, float falloffStart, float falloffEnd)
 {
     return saturate((falloffEnd - d) / (falloffEnd - falloffStart));
 }
 
-// L'approximation de Schlick pour les quations de Fresnel, cela permet d'approximer le pourcent de lumire rflchie d'une surface avec une normale n avec un angle entre le vecteur lumire L et la normale n.
+// L'approximation de Schlick pour les équations de Fresnel, cela permet d'approximer le pourcent de lumière réfléchie d'une surface avec une normale n avec un angle entre le vecteur lumière L et la normale n.
 float3 SchlickFresnel(float3 R0, float3 normal, float3 lightVec)
 {
     float cosIncidentAngle = saturate(dot(normal, lightVec));
@@ -33,7 +33,7 @@ float3 SchlickFresnel(float3 R0, float3 normal, float3 lightVec)
     return reflectPercent;
 }
 
-// Calcul de la quantit de lumire rflchie dans l'oeil, c'est le somme de la rflectance diffuse et de la rflectance spculaire.
+// Calcul de la quantité de lumière réfléchie dans l'oeil, c'est le somme de la réflectance diffuse et de la réflectance spéculaire.
 float3 BlinnPhong(float3 lightStrength, float3 lightVec, float3 normal, float3 toEye, Material mat)
 {
     const float m = mat.Shininess * 256.0f;
@@ -41,16 +41,16 @@ float3 BlinnPhong(float3 lightStrength, float3 lightVec, float3 normal, float3 t
     float roughnessFactor = (m + 8.0f) * pow(max(dot(halfVec, normal), 0.0f), m) / 8.0f;
     float3 fresnelFactor = SchlickFresnel(mat.FresnelR0, halfVec, lightVec);
     float3 specAlbedo = fresnelFactor * roughnessFactor;
-    // L'quation spculaire va en dehors de l'interval [0,1], mais on fait du rendu LDR, donc on la scale un peu.
+    // L'équation spéculaire va en dehors de l'interval [0,1], mais on fait du rendu LDR, donc on la scale un peu.
     specAlbedo = specAlbedo / (specAlbedo + 1.0f);
     return (mat.DiffuseAlbedo.rgb + specAlbedo) * lightStrength;
 }
 
 float3 ComputeDirectionalLight(Light L, Material mat, float3 normal, float3 toEye)
 {
-    // Le vecteur lumire pointe vers la source de lumire.
+    // Le vecteur lumière pointe vers la source de lumière.
     float3 lightVec = -L.Direction;
-    // Scale la lumire par la loi des cosinus de Lambert.
+    // Scale la lumière par la loi des cosinus de Lambert.
     float ndotl = max(dot(lightVec, normal), 0.0f);
     float3 lightStrength = L.Strength * ndotl;
     return BlinnPhong(lightStrength, lightVec, normal, toEye, mat);
@@ -58,19 +58,19 @@ float3 ComputeDirectionalLight(Light L, Material mat, float3 normal, float3 toEy
 
 float3 ComputePointLight(Light L, Material mat, float3 pos, float3 normal, float3 toEye)
 {
-    // Le vecteur depuis la surface vers la lumire.
+    // Le vecteur depuis la surface vers la lumière.
     float3 lightVec = L.Position - pos;
-    // La distance entre la surface et la lumire.
+    // La distance entre la surface et la lumière.
     float d = length(lightVec);
-    // Test de porte.
+    // Test de portée.
     if (d > L.FalloffEnd)
         return 0.0f;
-    // Normaliser le vecteur de lumire.
+    // Normaliser le vecteur de lumière.
     lightVec /= d;
-    // Scale la lumire par la loi des cosinus de Lambert.
+    // Scale la lumière par la loi des cosinus de Lambert.
     float ndotl = max(dot(lightVec, normal), 0.0f);
     float3 lightStrength = L.Strength * ndotl;
-    // Attnuer la lumire par la distance.
+    // Atténuer la lumière par la distance.
     float att = CalcAttenuation(d, L.FalloffStart, L.FalloffEnd);
     lightStrength *= att;
     return BlinnPhong(lightStrength, lightVec, normal, toEye, mat);
@@ -78,19 +78,19 @@ float3 ComputePointLight(Light L, Material mat, float3 pos, float3 normal, float
 
 float3 ComputeSpotLight(Light L, Material mat, float3 pos, float3 normal, float3 toEye)
 {
-    // Le vecteur depuis la surface vers la lumire.
+    // Le vecteur depuis la surface vers la lumière.
     float3 lightVec = L.Position - pos;
-    // La distance entre la surface et la lumire.
+    // La distance entre la surface et la lumière.
     float d = length(lightVec);
-    // Test de porte.
+    // Test de portée.
     if (d > L.FalloffEnd)
         return 0.0f;
-    // Normaliser le vecteur de lumire.
+    // Normaliser le vecteur de lumière.
     lightVec /= d;
-    // Scale la lumire par la loi des cosinus de Lambert.
+    // Scale la lumière par la loi des cosinus de Lambert.
     float ndotl = max(dot(lightVec, normal), 0.0f);
     float3 lightStrength = L.Strength * ndotl;
-    // Attnuer la lumire par la distance.
+    // Atténuer la lumière par la distance.
     float att = CalcAttenuation(d, L.FalloffStart, L.FalloffEnd);
     lightStrength *= att;
     // Scale par le projecteur
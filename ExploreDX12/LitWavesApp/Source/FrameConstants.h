@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Graphics/DirectXMathUtils.h"
+#include "Graphics/Light.h"
+
+#include <cstdint>
+
+// Constantes des shaders de LitWavesApp, séparées de FrameResource pour être remplies sans D3D12 (voir LitWavesFrame.h).
+struct ObjectConstants
+{
+    XMFLOAT4X4 World = DirectXMathUtils::Identity4x4();
+};
+
+struct PassConstants
+{
+    XMFLOAT4X4 View = DirectXMathUtils::Identity4x4();
+    XMFLOAT4X4 InvView = DirectXMathUtils::Identity4x4();
+    XMFLOAT4X4 Proj = DirectXMathUtils::Identity4x4();
+    XMFLOAT4X4 InvProj = DirectXMathUtils::Identity4x4();
+    XMFLOAT4X4 ViewProj = DirectXMathUtils::Identity4x4();
+    XMFLOAT4X4 InvViewProj = DirectXMathUtils::Identity4x4();
+    XMFLOAT3 EyePosW = { 0.0f, 0.0f, 0.0f };
+    float cbPerObjectPad1 = 0.0f;
+    XMFLOAT2 RenderTargetSize = { 0.0f, 0.0f };
+    XMFLOAT2 InvRenderTargetSize = { 0.0f, 0.0f };
+    float NearZ = 0.0f;
+    float FarZ = 0.0f;
+    float TotalTime = 0.0f;
+    float DeltaTime = 0.0f;
+
+    XMFLOAT4 AmbientLight = { 0.0f, 0.0f, 0.0f, 1.0f };
+    Light Lights[MaxLights];
+};
+
+// Constantes racine de la grille d'eau (cbWaves), utilisées pour retrouver la ligne et la colonne d'un sommet dans la grille découpée en blocs.
+struct WavesConstants
+{
+    std::uint32_t RowCount = 0;
+    std::uint32_t ColumnCount = 0;
+    float SpatialStep = 0.0f;
+    float HalfWidth = 0.0f;
+    float HalfDepth = 0.0f;
+    std::uint32_t ChunkRowSize = 0;
+    std::uint32_t ChunkColumnSize = 0;
+    std::uint32_t ChunkRowCount = 0;
+    std::uint32_t ChunkColumnCount = 0;
+    // Seule constante qui change entre deux draws de l'eau.
+    std::uint32_t ChunkIndex = 0;
+};
+
+struct Vertex
+{
+    Vertex() = default;
+    Vertex(XMFLOAT3 pos, XMFLOAT3 normal)
+        : Pos(pos), Normal(normal) { }
+
+    XMFLOAT3 Pos;
+    XMFLOAT3 Normal;
+};
\ No newline at end of file
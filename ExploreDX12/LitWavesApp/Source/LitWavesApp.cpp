@@ -13,15 +13,27 @@ LitWavesApp::~LitWavesApp()
 {
     if (DirectX12::D3DDevice != nullptr)
         DirectX12::FlushCommandQueue();
+
+    // Les vertex et index buffers rendent leur place au BufferHeap.
+    if (mUploadManager != nullptr)
+    {
+        mUploadManager->Flush();
+        for (auto& [name, geo] : mGeometries)
+        {
+            // Le vertex buffer de l'eau est celui de la frame resource courante, il n'appartient pas au BufferHeap.
+            if (name != "waterGeo")
+                mUploadManager->ReleaseDefaultBuffer(geo->VertexBufferGPU);
+            mUploadManager->ReleaseDefaultBuffer(geo->IndexBufferGPU);
+        }
+    }
 }
 
 void LitWavesApp::OnWindowResize()
 {
     Application::OnWindowResize();
 
-    // Quand la fentre est resize, on doit mettre  jour l'aspect ratio et recalculer la matrice de projection.
-    XMMATRIX P = XMMatrixPerspectiveFovLH(0.25f * DirectXMathUtils::Pi, WindowManager::AspectRatio(), 1.0f, 1000.0f);
-    XMStoreFloat4x4(&mProj, P);
+    // Quand la fenêtre est resize, on doit mettre à jour l'aspect ratio et recalculer la matrice de projection.
+    mProj = LitWavesFrame::Projection(WindowManager::AspectRatio());
 }
 
 void LitWavesApp::OnMouseDown(WPARAM btnState, int x, int y)
@@ -75,15 +87,24 @@ void LitWavesApp::Update()
     mCurrentFrameResourceIndex = (mCurrentFrameResourceIndex + 1) % DirectX12::NumberOfFrameResources;
     mCurrentFrameResource = mFrameResources[mCurrentFrameResourceIndex].get();
 
-    // Est-ce que le GPU a fini de traiter les commandes de la frame resource courante ? Si ce n'est pas le cas, on attend que le GPU ait fini de traiter les commandes jusqu' cette barrire.
-    if (mCurrentFrameResource->Fence != 0 && DirectX12::Fence->GetCompletedValue() < mCurrentFrameResource->Fence)
+    // Est-ce que le GPU a fini de traiter les commandes de la frame resource courante ? Si ce n'est pas le cas, on attend que le GPU ait fini de traiter les commandes jusqu'à cette barrière.
+    // Le FramePacer peut demander d'attendre plus tôt, pour garder moins de frames en vol que de frame resources.
+    const int previousFramesInFlight = mFramePacer.FramesInFlight();
+    const FramePacer::Clock::time_point waitStart = FramePacer::Clock::now();
+    DirectX12::WaitForFence(DirectXMathUtils::Max(mCurrentFrameResource->Fence, mFramePacer.FenceValueToWait(DirectX12::CurrentFence)));
+    const UINT64 completedFence = DirectX12::Fence->GetCompletedValue();
+    mFramePacer.BeginFrame(FramePacer::Clock::now() - waitStart, completedFence);
+
+    if (mFramePacer.FramesInFlight() != previousFramesInFlight)
     {
-        HANDLE eventHandle = CreateEventEx(nullptr, nullptr, false, EVENT_ALL_ACCESS);
-        ThrowIfFailed(DirectX12::Fence->SetEventOnCompletion(mCurrentFrameResource->Fence, eventHandle));
-        WaitForSingleObject(eventHandle, INFINITE);
-        CloseHandle(eventHandle);
+        const FramePacer::Stats& stats = mFramePacer.LastStats();
+        Logs::Message("FramePacer : {} frames en vol (latence {} ms pour {} ms visées, frame {} ms dont {} ms d'attente)", mFramePacer.FramesInFlight(),
+            stats.LatencyMilliseconds, mFramePacer.TargetLatencyMilliseconds(), stats.FrameMilliseconds, stats.WaitMilliseconds);
     }
 
+    // Tout ce que les frames terminées avaient alloué dans l'anneau peut être réécrit.
+    mUploadRing->Retire(completedFence);
+
     UpdateObjectCBs();
     UpdateMainPassCB();
     UpdateMaterialCBs();
@@ -96,7 +117,7 @@ void LitWavesApp::Draw()
 
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> cmdListAlloc = mCurrentFrameResource->CommandListAllocator;
     ThrowIfFailed(cmdListAlloc->Reset());
-    ThrowIfFailed(DirectX12::CommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque"].Get()));
+    ThrowIfFailed(DirectX12::CommandList->Reset(cmdListAlloc.Get(), mPipelineStates->Get(mPSOs["opaque"])));
 
     DirectX12::CommandList->RSSetViewports(1, &DirectX12::ScreenViewport);
     DirectX12::CommandList->RSSetScissorRects(1, &DirectX12::ScissorRect);
@@ -112,10 +133,15 @@ void LitWavesApp::Draw()
 
     DirectX12::CommandList->SetGraphicsRootSignature(mRootSignature.Get());
 
-    ID3D12Resource* passCB = mCurrentFrameResource->PassCB->Resource();
-    DirectX12::CommandList->SetGraphicsRootConstantBufferView(2, passCB->GetGPUVirtualAddress());
+    DirectX12::CommandList->SetGraphicsRootConstantBufferView(LitWavesFrame::RootPassCB, mCurrentFrameResource->PassCB.GpuAddress);
+
+    DrawRenderItems(DirectX12::CommandList.Get(), mOpaqueRenderItems);
 
-    DrawRenderItems(DirectX12::CommandList.Get());
+    // L'eau a son propre vertex shader qui reconstruit x et z à partir des constantes de la grille.
+    DirectX12::CommandList->SetPipelineState(mPipelineStates->Get(mPSOs["waves"]));
+    DirectX12::CommandList->SetGraphicsRoot32BitConstants(LitWavesFrame::RootWavesConstants, sizeof(WavesConstants) / 4, &mWavesConstants, 0);
+    DirectX12::CommandList->SetGraphicsRootShaderResourceView(LitWavesFrame::RootWavesHeights, mCurrentFrameResource->WavesVB->Resource()->GetGPUVirtualAddress());
+    DrawWaves(DirectX12::CommandList.Get());
 
     resourceBarrier = CD3DX12_RESOURCE_BARRIER::Transition(DirectX12::CurrentBackBuffer(), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
     DirectX12::CommandList->ResourceBarrier(1, &resourceBarrier);
@@ -131,145 +157,83 @@ void LitWavesApp::Draw()
     mCurrentFrameResource->Fence = ++DirectX12::CurrentFence;
 
     DirectX12::CommandQueue->Signal(DirectX12::Fence.Get(), DirectX12::CurrentFence);
+    mUploadRing->FinishFrame(DirectX12::CurrentFence);
+    mFramePacer.EndFrame(DirectX12::CurrentFence);
 }
 
 bool LitWavesApp::Initialize()
 {
-    DirectX12::ResetCommandList();
+    mBufferHeap = std::make_unique<BufferHeap>(DirectX12::D3DDevice.Get(), BufferHeapByteSize);
+    mUploadManager = std::make_unique<UploadManager>(DirectX12::D3DDevice.Get(), UploadStagingByteSize, mBufferHeap.get());
+    mPipelineStates = std::make_unique<PipelineStateCache>(DirectX12::D3DDevice.Get(), "ShaderCache\\Pipelines.bin");
 
     mWaves = std::make_unique<Waves>(128, 128, 1.0f, 0.03f, 4.0f, 0.2f);
+    // La simulation tourne sur son propre thread, le thread principal ne fait que lire le dernier état publié.
+    if (mAsyncWaves)
+        mWaves->StartAsync();
+    mWavesConstants = LitWavesFrame::MakeWavesConstants(*mWaves);
 
     BuildRootSignature();
     BuildShadersAndInputLayout();
+    // Les PSO sont compilés par les threads du cache pendant que le reste s'initialise.
+    BuildPSOs();
     BuildLandGeometry();
     BuildWavesGeometryBuffers();
     BuildMaterials();
     BuildRenderItems();
     BuildFrameResources();
-    BuildPSOs();
 
-    DirectX12::ExecuteCommandsAndWait();
+    // Les géométries sont copiées par la file de copie pendant que la suite s'initialise : la file graphique attendra la fin des copies
+    // avant la première frame, sans bloquer le CPU.
+    mUploadManager->WaitOnQueue(DirectX12::CommandQueue.Get());
 
     return true;
 }
 
 void LitWavesApp::UpdateCamera()
 {
-    mEyePos.x = mRadius * sinf(mPhi) * cosf(mTheta);
-    mEyePos.z = mRadius * sinf(mPhi) * sinf(mTheta);
-    mEyePos.y = mRadius * cosf(mPhi);
-
-    // Construction de la matrice de vue.
-    XMVECTOR pos = XMVectorSet(mEyePos.x, mEyePos.y, mEyePos.z, 1.0f);
-    XMVECTOR target = XMVectorZero();
-    XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
-
-    XMMATRIX view = XMMatrixLookAtLH(pos, target, up);
-    XMStoreFloat4x4(&mView, view);
+    mEyePos = LitWavesFrame::OrbitCamera(mRadius, mTheta, mPhi, mView);
 }
 
 void LitWavesApp::UpdateObjectCBs()
 {
-    UploadBuffer<ObjectConstants>* currentObjectCB = mCurrentFrameResource->ObjectCB.get();
-    for (const std::unique_ptr<RenderItem>& e : mAllRenderItems)
-    {
-        // On ne met  jour les donnes du cbuffer que si les constantes ont chang.
-        // Attention : cela doit tre suivi pour chaque frame ressource.
-        if (e->NumFramesDirty > 0)
-        {
-            XMMATRIX world = XMLoadFloat4x4(&e->World);
-            XMMATRIX texTransform = XMLoadFloat4x4(&e->TexTransform);
-            ObjectConstants objConstants;
-            XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
-            currentObjectCB->CopyData(e->ObjCBIndex, objConstants);
-
-            // Le prochain FrameResource doit aussi tre mis  jour.
-            e->NumFramesDirty--;
-        }
-    }
+    LitWavesFrame::WriteObjectConstants(mObjectsDirty, mCurrentFrameResourceIndex, mCurrentFrameResource->ObjectCB->Elements(),
+        [&](size_t i) -> const XMFLOAT4X4& { return mAllRenderItems[i]->World; });
 }
 
 void LitWavesApp::UpdateMainPassCB()
 {
-    const int clientWidth = WindowManager::GetWidth();
-    const int clientHeight = WindowManager::GetHeight();
-
-    XMMATRIX view = XMLoadFloat4x4(&mView);
-    XMMATRIX proj = XMLoadFloat4x4(&mProj);
-
-    XMMATRIX viewProj = XMMatrixMultiply(view, proj);
-
-    XMVECTOR viewDeterminant = XMMatrixDeterminant(view);
-    XMVECTOR projDeterminant = XMMatrixDeterminant(proj);
-    XMVECTOR viewProjDeterminant = XMMatrixDeterminant(viewProj);
-
-    XMMATRIX invView = XMMatrixInverse(&viewDeterminant, view);
-    XMMATRIX invProj = XMMatrixInverse(&projDeterminant, proj);
-    XMMATRIX invViewProj = XMMatrixInverse(&viewProjDeterminant, viewProj);
-
-    XMStoreFloat4x4(&mMainPassCB.View, XMMatrixTranspose(view));
-    XMStoreFloat4x4(&mMainPassCB.InvView, XMMatrixTranspose(invView));
-    XMStoreFloat4x4(&mMainPassCB.Proj, XMMatrixTranspose(proj));
-    XMStoreFloat4x4(&mMainPassCB.InvProj, XMMatrixTranspose(invProj));
-    XMStoreFloat4x4(&mMainPassCB.ViewProj, XMMatrixTranspose(viewProj));
-    XMStoreFloat4x4(&mMainPassCB.InvViewProj, XMMatrixTranspose(invViewProj));
-    mMainPassCB.EyePosW = mEyePos;
-    mMainPassCB.RenderTargetSize = XMFLOAT2(static_cast<float>(clientWidth), static_cast<float>(clientHeight));
-    mMainPassCB.InvRenderTargetSize = XMFLOAT2(1.0f / clientWidth, 1.0f / clientHeight);
-    mMainPassCB.NearZ = 1.0f;
-    mMainPassCB.FarZ = 1000.0f;
+    LitWavesFrame::BuildPassConstants(mView, mProj, mEyePos, WindowManager::GetWidth(), WindowManager::GetHeight(), TimeManager::GetDeltaTime(),
+        mSunTheta, mSunPhi, mMainPassCB);
     //mMainPassCB.TotalTime = gameTimer.TotalTime();
-    mMainPassCB.DeltaTime = TimeManager::GetDeltaTime();
-    mMainPassCB.AmbientLight = { 0.25f, 0.25f, 0.35f, 1.0f };
 
-    XMVECTOR lightDir = -DirectXMathUtils::SphericalToCartesian(1.0f, mSunTheta, mSunPhi);
-    XMStoreFloat3(&mMainPassCB.Lights[0].Direction, lightDir);
-    mMainPassCB.Lights[0].Strength = { 1.0f, 1.0f, 0.9f };
-
-    UploadBuffer<PassConstants>* currentPassCB = mCurrentFrameResource->PassCB.get();
-    currentPassCB->CopyData(0, mMainPassCB);
+    mCurrentFrameResource->PassCB = mUploadRing->AllocateConstants<PassConstants>();
+    memcpy(mCurrentFrameResource->PassCB.CpuAddress, &mMainPassCB, sizeof(PassConstants));
 }
 
 void LitWavesApp::UpdateMaterialCBs()
 {
-    UploadBuffer<MaterialConstants>* currentMaterialCB = mCurrentFrameResource->MaterialCB.get();
-    for (const auto& [_, mat] : mMaterials)
-    {
-        // On ne met  jour les donnes du cbuffer que si les constantes ont chang.
-        // Attention : cela doit tre suivi pour chaque frame ressource.
-        if (mat->NumFramesDirty > 0)
-        {
-            XMMATRIX matTransform = XMLoadFloat4x4(&mat->MatTransform);
-            MaterialConstants matConstants(mat->DiffuseAlbedo, mat->FresnelR0, mat->Roughness);
-            currentMaterialCB->CopyData(mat->MatCBIndex, matConstants);
-            mat->NumFramesDirty--;
-        }
-    }
+    LitWavesFrame::WriteMaterialConstants(mMaterialsDirty, mCurrentFrameResourceIndex, mCurrentFrameResource->MaterialCB->Elements(), mMaterialsByCBIndex);
 }
 
 void LitWavesApp::UpdateWaves()
 {
-    static float tBase = 0.0f;
-
-    if ((TimeManager::GetTotalTime() - tBase) > 0.25f)
-    {
-        tBase += 0.25f;
-        int i = DirectXMathUtils::Rand(4, mWaves->RowCount() - 5);
-        int j = DirectXMathUtils::Rand(4, mWaves->ColumnCount() - 5);
-        float magnitude = DirectXMathUtils::Randf(0.2f, 0.5f);
-        mWaves->Disturb(i, j, magnitude);
-    }
+    // Chaque frame resource garde son propre vertex buffer, on ne réécrit que les tuiles qui ont bougé depuis sa dernière mise à jour.
+    UploadBuffer<BYTE>* currentWavesVB = mCurrentFrameResource->WavesVB.get();
+    LitWavesFrame::UpdateWaves(*mWaves, mRain, TimeManager::GetTotalTime(), TimeManager::GetDeltaTime(), RandomUtils::ThreadStream(), mWavesVertexFormat,
+        currentWavesVB->MappedData(), mCurrentFrameResource->WavesStep);
 
-    mWaves->Update();
+    mWavesRenderitem->Geo->VertexBufferGPU = currentWavesVB->Resource();
+}
 
-    UploadBuffer<Vertex>* currentWavesVB = mCurrentFrameResource->WavesVB.get();
-    for (int i = 0; i < mWaves->VertexCount(); i++)
-    {
-        Vertex v(mWaves->Position(i), mWaves->Normal(i));
-        currentWavesVB->CopyData(i, v);
-    }
+void LitWavesApp::MarkRenderItemDirty(const RenderItem* renderItem)
+{
+    mObjectsDirty.MarkDirty(renderItem->ObjCBIndex);
+}
 
-    mWavesRenderitem->Geo->VertexBufferGPU = currentWavesVB->Resource();
+void LitWavesApp::MarkMaterialDirty(const Material* material)
+{
+    mMaterialsDirty.MarkDirty(material->MatCBIndex);
 }
 
 void LitWavesApp::UpdateKeyboardInput()
@@ -286,15 +250,15 @@ void LitWavesApp::UpdateKeyboardInput()
     mSunPhi = DirectXMathUtils::Clamp(mSunPhi, 0.1f, XM_PIDIV2);
 }
 
-void LitWavesApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList)
+void LitWavesApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& renderItems)
 {
     UINT objCBByteSize = DirectXUtils::CalcConstantBufferByteSize(sizeof(ObjectConstants));
     UINT matCBByteSize = DirectXUtils::CalcConstantBufferByteSize(sizeof(MaterialConstants));
 
-    ID3D12Resource* objectCB = mCurrentFrameResource->ObjectCB->Resource();
-    ID3D12Resource* matCB = mCurrentFrameResource->MaterialCB->Resource();
+    const D3D12_GPU_VIRTUAL_ADDRESS objectCB = mCurrentFrameResource->ObjectCB->Resource()->GetGPUVirtualAddress();
+    const D3D12_GPU_VIRTUAL_ADDRESS matCB = mCurrentFrameResource->MaterialCB->Resource()->GetGPUVirtualAddress();
 
-    for (const std::unique_ptr<RenderItem>& ri : mAllRenderItems)
+    for (RenderItem* ri : renderItems)
     {
         D3D12_VERTEX_BUFFER_VIEW vbv = ri->Geo->VertexBufferView();
         D3D12_INDEX_BUFFER_VIEW ibv = ri->Geo->IndexBufferView();
@@ -303,24 +267,51 @@ void LitWavesApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList)
         cmdList->IASetIndexBuffer(&ibv);
         cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
 
-        D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB->GetGPUVirtualAddress() + ri->ObjCBIndex * objCBByteSize;
-        D3D12_GPU_VIRTUAL_ADDRESS matCBAddress = matCB->GetGPUVirtualAddress() + ri->Mat->MatCBIndex * matCBByteSize;
+        D3D12_GPU_VIRTUAL_ADDRESS objCBAddress = objectCB + ri->ObjCBIndex * objCBByteSize;
+        D3D12_GPU_VIRTUAL_ADDRESS matCBAddress = matCB + ri->Mat->MatCBIndex * matCBByteSize;
 
-        cmdList->SetGraphicsRootConstantBufferView(0, objCBAddress);
-        cmdList->SetGraphicsRootConstantBufferView(1, matCBAddress);
+        cmdList->SetGraphicsRootConstantBufferView(LitWavesFrame::RootObjectCB, objCBAddress);
+        cmdList->SetGraphicsRootConstantBufferView(LitWavesFrame::RootMaterialCB, matCBAddress);
         cmdList->DrawIndexedInstanced(ri->IndexCount, 1, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
     }
 }
 
+void LitWavesApp::DrawWaves(ID3D12GraphicsCommandList* cmdList)
+{
+    UINT objCBByteSize = DirectXUtils::CalcConstantBufferByteSize(sizeof(ObjectConstants));
+    UINT matCBByteSize = DirectXUtils::CalcConstantBufferByteSize(sizeof(MaterialConstants));
+
+    const D3D12_GPU_VIRTUAL_ADDRESS objectCB = mCurrentFrameResource->ObjectCB->Resource()->GetGPUVirtualAddress();
+    const D3D12_GPU_VIRTUAL_ADDRESS matCB = mCurrentFrameResource->MaterialCB->Resource()->GetGPUVirtualAddress();
+
+    for (RenderItem* ri : mWavesRenderItems)
+    {
+        D3D12_VERTEX_BUFFER_VIEW vbv = ri->Geo->VertexBufferView();
+        D3D12_INDEX_BUFFER_VIEW ibv = ri->Geo->IndexBufferView();
+
+        cmdList->IASetVertexBuffers(0, 1, &vbv);
+        cmdList->IASetIndexBuffer(&ibv);
+        cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
+
+        cmdList->SetGraphicsRootConstantBufferView(LitWavesFrame::RootObjectCB, objectCB + ri->ObjCBIndex * objCBByteSize);
+        cmdList->SetGraphicsRootConstantBufferView(LitWavesFrame::RootMaterialCB, matCB + ri->Mat->MatCBIndex * matCBByteSize);
+
+        LitWavesFrame::DrawWavesChunks(*cmdList, *mWaves, ri->IndexCount);
+    }
+}
+
 void LitWavesApp::BuildRootSignature()
 {
-    CD3DX12_ROOT_PARAMETER slotRootParameter[3];
+    CD3DX12_ROOT_PARAMETER slotRootParameter[5];
     
-    slotRootParameter[0].InitAsConstantBufferView(0);
-    slotRootParameter[1].InitAsConstantBufferView(1);
-    slotRootParameter[2].InitAsConstantBufferView(2);
+    slotRootParameter[LitWavesFrame::RootObjectCB].InitAsConstantBufferView(0);
+    slotRootParameter[LitWavesFrame::RootMaterialCB].InitAsConstantBufferView(1);
+    slotRootParameter[LitWavesFrame::RootPassCB].InitAsConstantBufferView(2);
+    // Hauteurs de l'eau et constantes de la grille, utilisées uniquement par le vertex shader de l'eau.
+    slotRootParameter[LitWavesFrame::RootWavesHeights].InitAsShaderResourceView(0);
+    slotRootParameter[LitWavesFrame::RootWavesConstants].InitAsConstants(sizeof(WavesConstants) / 4, 3);
 
-    CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc(3, slotRootParameter, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+    CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc(5, slotRootParameter, 0, nullptr, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
     Microsoft::WRL::ComPtr<ID3DBlob> serializedRootSignature = nullptr;
     Microsoft::WRL::ComPtr<ID3DBlob> errorBlob = nullptr;
@@ -331,6 +322,7 @@ void LitWavesApp::BuildRootSignature()
     ThrowIfFailed(hr);
 
     ThrowIfFailed(DirectX12::D3DDevice->CreateRootSignature(0, serializedRootSignature->GetBufferPointer(), serializedRootSignature->GetBufferSize(), IID_PPV_ARGS(mRootSignature.GetAddressOf())));
+    mPipelineStates->RegisterRootSignature(mRootSignature.Get(), serializedRootSignature->GetBufferPointer(), serializedRootSignature->GetBufferSize());
 }
 
 void LitWavesApp::BuildShadersAndInputLayout()
@@ -343,6 +335,30 @@ void LitWavesApp::BuildShadersAndInputLayout()
         { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
         { "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
     };
+
+    switch (mWavesVertexFormat)
+    {
+    case WavesVertexFormat::Full:
+        mShaders["wavesVS"] = mShaders["standardVS"];
+        mWavesInputLayout = mInputLayout;
+        break;
+    case WavesVertexFormat::HeightNormal:
+        mShaders["wavesVS"] = DirectXUtils::CompileShader(L"Shaders\\Default.hlsl", nullptr, "WavesVS", "vs_5_1");
+        mWavesInputLayout =
+        {
+            { "HEIGHT", 0, DXGI_FORMAT_R32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 4, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+        };
+        break;
+    case WavesVertexFormat::Height:
+    {
+        // Aucun attribut de sommet : le vertex shader lit les hauteurs dans un StructuredBuffer.
+        const D3D_SHADER_MACRO defines[] = { { "WAVES_HEIGHT_ONLY", "1" }, { nullptr, nullptr } };
+        mShaders["wavesVS"] = DirectXUtils::CompileShader(L"Shaders\\Default.hlsl", defines, "WavesVS", "vs_5_1");
+        mWavesInputLayout.clear();
+        break;
+    }
+    }
 }
 
 void LitWavesApp::BuildLandGeometry()
@@ -372,8 +388,8 @@ void LitWavesApp::BuildLandGeometry()
     ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
     CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-    geo->VertexBufferGPU = DirectXUtils::CreateDefaultBuffer(DirectX12::D3DDevice.Get(), DirectX12::CommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
-    geo->IndexBufferGPU = DirectXUtils::CreateDefaultBuffer(DirectX12::D3DDevice.Get(), DirectX12::CommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+    geo->VertexBufferGPU = mUploadManager->CreateDefaultBuffer(vertices.data(), vbByteSize);
+    geo->IndexBufferGPU = mUploadManager->CreateDefaultBuffer(indices.data(), ibByteSize);
     geo->VertexByteStride = sizeof(Vertex);
     geo->VertexBufferByteSize = vbByteSize;
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
@@ -384,12 +400,13 @@ void LitWavesApp::BuildLandGeometry()
 
 void LitWavesApp::BuildWavesGeometryBuffers()
 {
-    // 3 indices par face
-    std::vector<std::uint16_t> indices(3 * mWaves->TriangleCount());
-    assert(mWaves->VertexCount() < 0x0000ffff);
+    // Un seul index buffer 16 bits décrit un bloc de la grille, chaque bloc est ensuite dessiné avec son propre BaseVertexLocation.
+    int m = mWaves->ChunkRowSize() + 1;
+    int n = mWaves->ChunkColumnSize() + 1;
+    assert(m * n <= 0x00010000);
 
-    int m = mWaves->RowCount();
-    int n = mWaves->ColumnCount();
+    // 3 indices par face
+    std::vector<std::uint16_t> indices(6 * (m - 1) * (n - 1));
     int k = 0;
     for (int i = 0; i < m - 1; i++)
     {
@@ -407,7 +424,7 @@ void LitWavesApp::BuildWavesGeometryBuffers()
         }
     }
 
-    UINT vbByteSize = static_cast<UINT>(mWaves->VertexCount() * sizeof(Vertex));
+    UINT vbByteSize = static_cast<UINT>(mWaves->ChunkedVertexCount() * LitWavesFrame::WavesVertexByteSize(mWavesVertexFormat));
     UINT ibByteSize = static_cast<UINT>(indices.size() * sizeof(std::uint16_t));
 
     std::unique_ptr<MeshGeometry> geo = std::make_unique<MeshGeometry>();
@@ -416,12 +433,14 @@ void LitWavesApp::BuildWavesGeometryBuffers()
     ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
     CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
     
-    geo->IndexBufferGPU = DirectXUtils::CreateDefaultBuffer(DirectX12::D3DDevice.Get(), DirectX12::CommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
-    geo->VertexByteStride = sizeof(Vertex);
+    geo->IndexBufferGPU = mUploadManager->CreateDefaultBuffer(indices.data(), ibByteSize);
+    geo->VertexByteStride = LitWavesFrame::WavesVertexByteSize(mWavesVertexFormat);
     geo->VertexBufferByteSize = vbByteSize;
     geo->IndexFormat = DXGI_FORMAT_R16_UINT;
     geo->IndexBufferByteSize = ibByteSize;
-    geo->DrawArgs["grid"] = SubmeshGeometry(static_cast<UINT>(indices.size()), 0, 0);
+    // Chaque bloc est dessiné avec ce submesh et son propre BaseVertexLocation, voir LitWavesFrame::DrawWavesChunks.
+    geo->DrawArgs["chunk"] = SubmeshGeometry(static_cast<UINT>(indices.size()), 0, 0);
+
     mGeometries["waterGeo"] = std::move(geo);
 }
 
@@ -429,25 +448,38 @@ void LitWavesApp::BuildMaterials()
 {
     mMaterials["grass"] = std::make_unique<Material>("grass", 0, XMFLOAT4(0.2f, 0.6f, 0.2f, 1.0f), XMFLOAT3(0.01f, 0.01f, 0.01f), 0.125f);
     mMaterials["water"] = std::make_unique<Material>("water", 1, XMFLOAT4(0.0f, 0.2f, 0.6f, 1.0f), XMFLOAT3(0.1f, 0.1f, 0.1f), 0.0f);
+
+    mMaterialsByCBIndex.resize(mMaterials.size());
+    for (const auto& [_, mat] : mMaterials)
+        mMaterialsByCBIndex[mat->MatCBIndex] = mat.get();
+    // Tous les matériaux sont à écrire une première fois dans chaque frame resource.
+    mMaterialsDirty.Resize(mMaterialsByCBIndex.size());
 }
 
 void LitWavesApp::BuildRenderItems()
 {
     MeshGeometry* waterGeo = mGeometries["waterGeo"].get();
-    std::unique_ptr<RenderItem> wavesRenderItem = std::make_unique<RenderItem>(DirectXMathUtils::Identity4x4(), 0, mMaterials["water"].get(), waterGeo, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, waterGeo->DrawArgs["grid"].IndexCount, waterGeo->DrawArgs["grid"].StartIndexLocation, waterGeo->DrawArgs["grid"].BaseVertexLocation);
+    std::unique_ptr<RenderItem> wavesRenderItem = std::make_unique<RenderItem>(DirectXMathUtils::Identity4x4(), 0, mMaterials["water"].get(), waterGeo, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, waterGeo->DrawArgs["chunk"].IndexCount, waterGeo->DrawArgs["chunk"].StartIndexLocation, waterGeo->DrawArgs["chunk"].BaseVertexLocation);
 
     MeshGeometry* landGeo = mGeometries["landGeo"].get();
     std::unique_ptr<RenderItem> gridRenderItem = std::make_unique<RenderItem>(DirectXMathUtils::Identity4x4(), 1, mMaterials["grass"].get(), landGeo, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST, landGeo->DrawArgs["grid"].IndexCount, landGeo->DrawArgs["grid"].StartIndexLocation, landGeo->DrawArgs["grid"].BaseVertexLocation);
 
     mWavesRenderitem = wavesRenderItem.get();
+    mWavesRenderItems.push_back(wavesRenderItem.get());
+    mOpaqueRenderItems.push_back(gridRenderItem.get());
     mAllRenderItems.push_back(std::move(wavesRenderItem));
     mAllRenderItems.push_back(std::move(gridRenderItem));
+
+    for (size_t i = 0; i < mAllRenderItems.size(); i++)
+        assert(mAllRenderItems[i]->ObjCBIndex == i && "ObjCBIndex doit être la position dans mAllRenderItems");
+    mObjectsDirty.Resize(mAllRenderItems.size());
 }
 
 void LitWavesApp::BuildFrameResources()
 {
+    mUploadRing = std::make_unique<UploadRing>(DirectX12::D3DDevice.Get(), UploadRingByteSize);
     for (int i = 0; i < DirectX12::NumberOfFrameResources; i++)
-        mFrameResources.push_back(std::make_unique<FrameResource>(DirectX12::D3DDevice.Get(), 1, static_cast<UINT>(mAllRenderItems.size()), static_cast<UINT>(mMaterials.size()), mWaves->VertexCount()));
+        mFrameResources.push_back(std::make_unique<FrameResource>(DirectX12::D3DDevice.Get(), static_cast<UINT>(mAllRenderItems.size()), static_cast<UINT>(mMaterials.size()), static_cast<UINT>(mWaves->ChunkedVertexCount()), LitWavesFrame::WavesVertexByteSize(mWavesVertexFormat)));
 }
 
 void LitWavesApp::BuildPSOs()
@@ -468,7 +500,12 @@ void LitWavesApp::BuildPSOs()
     opaquePsoDesc.SampleDesc.Count = 1;
     opaquePsoDesc.SampleDesc.Quality = 0;
     opaquePsoDesc.DSVFormat = DirectX12::DepthStencilFormat;
-    ThrowIfFailed(DirectX12::D3DDevice->CreateGraphicsPipelineState(&opaquePsoDesc, IID_PPV_ARGS(&mPSOs["opaque"])));
+    mPSOs["opaque"] = mPipelineStates->Request(opaquePsoDesc);
+
+    D3D12_GRAPHICS_PIPELINE_STATE_DESC wavesPsoDesc = opaquePsoDesc;
+    wavesPsoDesc.InputLayout = { mWavesInputLayout.data(), static_cast<UINT>(mWavesInputLayout.size()) };
+    wavesPsoDesc.VS = { reinterpret_cast<BYTE*>(mShaders["wavesVS"]->GetBufferPointer()), mShaders["wavesVS"]->GetBufferSize() };
+    mPSOs["waves"] = mPipelineStates->Request(wavesPsoDesc);
 }
 
 float LitWavesApp::GetHillsHeight(float x, float z)
@@ -3,38 +3,39 @@
 #include "Application.h"
 #include "Graphics/MeshGeometry.h"
 #include "FrameResource.h"
+#include "LitWavesFrame.h"
+#include "Graphics/FramePacer.h"
+#include "Graphics/PipelineStateCache.h"
+#include "Graphics/UploadManager.h"
 #include "Waves.h"
+#include "Utils/DirtyTracker.h"
 
-// Structure lgre qui stocke les paramtres pour dessiner une forme. 
+// Structure légère qui stocke les paramètres pour dessiner une forme. 
 struct RenderItem
 {
     RenderItem() = default;
     RenderItem(XMFLOAT4X4 world, int objCBIndex, Material* mat, MeshGeometry* geo, D3D12_PRIMITIVE_TOPOLOGY primitiveType, UINT indexCount, UINT startIndexLocation, int baseVertexLocation)
         : World(world), ObjCBIndex(objCBIndex), Mat(mat), Geo(geo), PrimitiveType(primitiveType), IndexCount(indexCount), StartIndexLocation(startIndexLocation), BaseVertexLocation(baseVertexLocation) {  }
 
-    // Matrice monde de l'objet qui dcrit l'espace local de l'objet par rapport  l'espace monde.
-    // Elle dfinit la position, l'orientation et l'chelle de l'objet dans le monde.
+    // Matrice monde de l'objet qui décrit l'espace local de l'objet par rapport à l'espace monde.
+    // Elle définit la position, l'orientation et l'échelle de l'objet dans le monde.
+    // Après une modification, LitWavesApp::MarkRenderItemDirty fait réécrire les constantes de l'objet dans chaque FrameResource.
     XMFLOAT4X4 World = DirectXMathUtils::Identity4x4();
 
     XMFLOAT4X4 TexTransform = DirectXMathUtils::Identity4x4();
 
-    // Indicateur de modification indiquant que les donnes de l'objet ont chang et qu'on doit mettre  jour le constant buffer.
-    // Parce qu'on a un objet cbuffer pour chaque FrameResource, on doit appliquer la mise  jour  chaque FrameResource. 
-    // Donc, quand on modifie les donnes de l'objet, on doit dfinir NumFramesDirty = gNumFrameResources pour que chaque ressource de frame reoive la mise  jour.
-    int NumFramesDirty = DirectX12::NumberOfFrameResources;
-
-    // Indice dans le buffer constant GPU correspondant  l'ObjectCB pour ce render item.
+    // Indice dans le buffer constant GPU correspondant à l'ObjectCB pour ce render item, qui est aussi sa position dans mAllRenderItems.
     UINT ObjCBIndex = -1;
 
     Material* Mat = nullptr;
 
-    // Geometry associ  ce render item. Note : plusieurs render items peuvent partager la mme gomtrie.
+    // Geometry associé à ce render item. Note : plusieurs render items peuvent partager la même géométrie.
     MeshGeometry* Geo = nullptr;
 
     // Type de primitive.
     D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-    // Paramtres de la fonction DrawIndexedInstanced.
+    // Paramètres de la fonction DrawIndexedInstanced.
     UINT IndexCount = 0;
     UINT StartIndexLocation = 0;
     int BaseVertexLocation = 0;
@@ -63,8 +64,11 @@ private:
     void UpdateMainPassCB();
     void UpdateMaterialCBs();
     void UpdateWaves();
+    void MarkRenderItemDirty(const RenderItem* renderItem);
+    void MarkMaterialDirty(const Material* material);
     void UpdateKeyboardInput();
-    void DrawRenderItems(ID3D12GraphicsCommandList* cmdList);
+    void DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& renderItems);
+    void DrawWaves(ID3D12GraphicsCommandList* cmdList);
 
     void BuildRootSignature();
     void BuildShadersAndInputLayout();
@@ -79,16 +83,41 @@ private:
     static XMFLOAT3 GetHillsNormal(float x, float z);
 
     std::unique_ptr<Waves> mWaves = nullptr;
+    WavesVertexFormat mWavesVertexFormat = WavesVertexFormat::Height;
+    bool mAsyncWaves = true;
+    WavesConstants mWavesConstants;
+    LitWavesFrame::Rain mRain;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> mRootSignature = nullptr;
     std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3DBlob>> mShaders;
     std::vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout;
+    std::vector<D3D12_INPUT_ELEMENT_DESC> mWavesInputLayout;
+    // Déclaré avant les géométries, dont les buffers sont placés dans ses heaps.
+    static constexpr UINT64 BufferHeapByteSize = 4 * 1024 * 1024;
+    std::unique_ptr<BufferHeap> mBufferHeap = nullptr;
     std::unordered_map<std::string, std::unique_ptr<MeshGeometry>> mGeometries;
     std::unordered_map<std::string, std::unique_ptr<Material>> mMaterials;
+    // Matériaux rangés par MatCBIndex, pour retrouver ceux à réécrire sans parcourir mMaterials.
+    std::vector<Material*> mMaterialsByCBIndex;
     std::vector<std::unique_ptr<RenderItem>> mAllRenderItems;
+    // Éléments des constant buffers d'objet et de matériau à réécrire, pour chaque frame resource.
+    DirtyTracker mObjectsDirty { DirectX12::NumberOfFrameResources };
+    DirtyTracker mMaterialsDirty { DirectX12::NumberOfFrameResources };
+    std::vector<RenderItem*> mOpaqueRenderItems;
+    std::vector<RenderItem*> mWavesRenderItems;
     std::vector<std::unique_ptr<FrameResource>> mFrameResources;
+    // Les constantes de passe de toutes les frames sont découpées dans un seul buffer d'upload. Les constantes d'objet et de matériau
+    // restent dans les FrameResource, seules les constantes réécrites à chaque frame passent par l'anneau.
+    static constexpr UINT64 UploadRingByteSize = 256 * 1024;
+    std::unique_ptr<UploadRing> mUploadRing = nullptr;
+    // Données initiales des géométries, envoyées par la file de copie.
+    static constexpr UINT64 UploadStagingByteSize = 1024 * 1024;
+    std::unique_ptr<UploadManager> mUploadManager = nullptr;
     FrameResource* mCurrentFrameResource = nullptr;
     int mCurrentFrameResourceIndex = 0;
-    std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D12PipelineState>> mPSOs;
+    FramePacer mFramePacer { DirectX12::NumberOfFrameResources, DirectX12::TargetLatencyMilliseconds };
+    // Détruit avant les shaders et les input layouts, que les PSO en cours de création lisent encore.
+    std::unique_ptr<PipelineStateCache> mPipelineStates = nullptr;
+    std::unordered_map<std::string, PipelineStateCache::Key> mPSOs;
 
     RenderItem* mWavesRenderitem = nullptr;
     PassConstants mMainPassCB;
@@ -0,0 +1,143 @@
+#include "LitWavesFrame.h"
+
+std::uint32_t LitWavesFrame::WavesVertexByteSize(WavesVertexFormat format)
+{
+    switch (format)
+    {
+    case WavesVertexFormat::HeightNormal:
+        return sizeof(Waves::CompactVertex);
+    case WavesVertexFormat::Height:
+        return sizeof(float);
+    default:
+        return sizeof(Vertex);
+    }
+}
+
+WavesConstants LitWavesFrame::MakeWavesConstants(const Waves& waves)
+{
+    WavesConstants constants;
+    constants.RowCount = waves.RowCount();
+    constants.ColumnCount = waves.ColumnCount();
+    constants.SpatialStep = waves.SpatialStep();
+    constants.HalfWidth = waves.HalfWidth();
+    constants.HalfDepth = waves.HalfDepth();
+    constants.ChunkRowSize = waves.ChunkRowSize();
+    constants.ChunkColumnSize = waves.ChunkColumnSize();
+    constants.ChunkRowCount = waves.ChunkRowCount();
+    constants.ChunkColumnCount = waves.ChunkColumnCount();
+    return constants;
+}
+
+XMFLOAT3 LitWavesFrame::OrbitCamera(float radius, float theta, float phi, XMFLOAT4X4& view)
+{
+    XMFLOAT3 eyePosition;
+    eyePosition.x = radius * sinf(phi) * cosf(theta);
+    eyePosition.z = radius * sinf(phi) * sinf(theta);
+    eyePosition.y = radius * cosf(phi);
+
+    // Construction de la matrice de vue.
+    XMVECTOR pos = XMVectorSet(eyePosition.x, eyePosition.y, eyePosition.z, 1.0f);
+    XMVECTOR target = XMVectorZero();
+    XMVECTOR up = XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+    XMStoreFloat4x4(&view, XMMatrixLookAtLH(pos, target, up));
+    return eyePosition;
+}
+
+XMFLOAT4X4 LitWavesFrame::Projection(float aspectRatio)
+{
+    XMFLOAT4X4 proj;
+    XMStoreFloat4x4(&proj, XMMatrixPerspectiveFovLH(0.25f * DirectXMathUtils::Pi, aspectRatio, NearZ, FarZ));
+    return proj;
+}
+
+void LitWavesFrame::BuildPassConstants(const XMFLOAT4X4& viewMatrix, const XMFLOAT4X4& projMatrix, const XMFLOAT3& eyePosition, int width, int height, float deltaTime,
+    float sunTheta, float sunPhi, PassConstants& pass)
+{
+    XMMATRIX view = XMLoadFloat4x4(&viewMatrix);
+    XMMATRIX proj = XMLoadFloat4x4(&projMatrix);
+
+    XMMATRIX viewProj = XMMatrixMultiply(view, proj);
+
+    XMVECTOR viewDeterminant = XMMatrixDeterminant(view);
+    XMVECTOR projDeterminant = XMMatrixDeterminant(proj);
+    XMVECTOR viewProjDeterminant = XMMatrixDeterminant(viewProj);
+
+    XMMATRIX invView = XMMatrixInverse(&viewDeterminant, view);
+    XMMATRIX invProj = XMMatrixInverse(&projDeterminant, proj);
+    XMMATRIX invViewProj = XMMatrixInverse(&viewProjDeterminant, viewProj);
+
+    XMStoreFloat4x4(&pass.View, XMMatrixTranspose(view));
+    XMStoreFloat4x4(&pass.InvView, XMMatrixTranspose(invView));
+    XMStoreFloat4x4(&pass.Proj, XMMatrixTranspose(proj));
+    XMStoreFloat4x4(&pass.InvProj, XMMatrixTranspose(invProj));
+    XMStoreFloat4x4(&pass.ViewProj, XMMatrixTranspose(viewProj));
+    XMStoreFloat4x4(&pass.InvViewProj, XMMatrixTranspose(invViewProj));
+    pass.EyePosW = eyePosition;
+    pass.RenderTargetSize = XMFLOAT2(static_cast<float>(width), static_cast<float>(height));
+    pass.InvRenderTargetSize = XMFLOAT2(1.0f / width, 1.0f / height);
+    pass.NearZ = NearZ;
+    pass.FarZ = FarZ;
+    pass.DeltaTime = deltaTime;
+    pass.AmbientLight = { 0.25f, 0.25f, 0.35f, 1.0f };
+
+    XMVECTOR lightDir = -DirectXMathUtils::SphericalToCartesian(1.0f, sunTheta, sunPhi);
+    XMStoreFloat3(&pass.Lights[0].Direction, lightDir);
+    pass.Lights[0].Strength = { 1.0f, 1.0f, 0.9f };
+}
+
+void LitWavesFrame::WriteMaterialConstants(DirtyTracker& dirty, int frameResourceIndex, const ElementSpan<MaterialConstants>& constants, const std::vector<Material*>& materials)
+{
+    dirty.ConsumeRuns(frameResourceIndex, [&](size_t first, size_t count)
+    {
+        for (size_t i = first; i < first + count; i++)
+        {
+            const Material* mat = materials[i];
+            constants[static_cast<std::uint32_t>(i)] = MaterialConstants(mat->DiffuseAlbedo, mat->FresnelR0, mat->Roughness);
+        }
+    });
+}
+
+const std::vector<Waves::Disturbance>& LitWavesFrame::Rain::Fall(const Waves& waves, float totalTime, RandomUtils::Xoshiro& generator)
+{
+    const float margin = 4.0f * waves.SpatialStep();
+    mDrops.clear();
+    while (totalTime - mLastDropTime > mDropInterval)
+    {
+        mLastDropTime += mDropInterval;
+
+        // Un rayon de deux sommets donne à peu près le même impact que l'ancien Disturb sur 5 sommets.
+        Waves::Disturbance drop;
+        drop.X = generator.Randf(-waves.HalfWidth() + margin, waves.HalfWidth() - margin);
+        drop.Z = generator.Randf(-waves.HalfDepth() + margin, waves.HalfDepth() - margin);
+        drop.Radius = 2.0f * waves.SpatialStep();
+        drop.Magnitude = generator.Randf(0.2f, 0.5f);
+        mDrops.push_back(drop);
+    }
+    return mDrops;
+}
+
+void LitWavesFrame::UpdateWaves(Waves& waves, Rain& rain, float totalTime, float deltaTime, RandomUtils::Xoshiro& generator, WavesVertexFormat format,
+    std::uint8_t* vertices, std::uint64_t& writtenStep)
+{
+    const std::vector<Waves::Disturbance>& drops = rain.Fall(waves, totalTime, generator);
+    waves.Disturb(drops.data(), drops.size());
+
+    waves.Update(deltaTime);
+
+    // La simulation avance à pas fixe, on interpole entre les deux dernières solutions pour que le rendu reste fluide.
+    // Les sommets sont écrits en une seule passe directement dans le vertex buffer mappé de la frame resource.
+    // Seules les tuiles qui ont bougé depuis writtenStep sont réécrites.
+    switch (format)
+    {
+    case WavesVertexFormat::Full:
+        waves.WriteVertices(vertices, { sizeof(Vertex), offsetof(Vertex, Pos), offsetof(Vertex, Normal) }, waves.StepAlpha(), writtenStep);
+        break;
+    case WavesVertexFormat::HeightNormal:
+        waves.WriteCompactVertices(reinterpret_cast<Waves::CompactVertex*>(vertices), waves.StepAlpha(), writtenStep);
+        break;
+    case WavesVertexFormat::Height:
+        waves.WriteHeights(reinterpret_cast<float*>(vertices), waves.StepAlpha(), writtenStep);
+        break;
+    }
+    writtenStep = waves.StepCount();
+}
\ No newline at end of file
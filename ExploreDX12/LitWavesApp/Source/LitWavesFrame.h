@@ -0,0 +1,100 @@
+#pragma once
+
+#include "FrameConstants.h"
+#include "Graphics/ElementSpan.h"
+#include "Graphics/Material.h"
+#include "Utils/DirtyTracker.h"
+#include "Utils/Random.h"
+#include "Waves.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Format du flux de sommets de l'eau envoyé au GPU à chaque frame.
+enum class WavesVertexFormat
+{
+    Full,           // Position + normale, 24 octets par sommet.
+    HeightNormal,   // Hauteur + normale compressée, 8 octets par sommet.
+    Height          // Hauteur seule, 4 octets par sommet, les normales sont reconstruites dans le vertex shader.
+};
+
+// Partie CPU d'une frame de LitWavesApp qui ne dépend ni de D3D12 ni de la fenêtre : constantes de passe, d'objet et de matériau,
+// pluie et sommets de l'eau, et draws des blocs de l'eau. LitWavesApp l'appelle avec ses UploadBuffer et sa command list D3D12,
+// WavesBench avec les buffers et la command list de NullDevice : le banc mesure le code de l'application, pas une copie.
+namespace LitWavesFrame
+{
+    // Paramètres racine de la root signature de LitWavesApp.
+    enum RootParameter : std::uint32_t
+    {
+        RootObjectCB = 0,
+        RootMaterialCB = 1,
+        RootPassCB = 2,
+        RootWavesHeights = 3,
+        RootWavesConstants = 4,
+    };
+
+    constexpr float NearZ = 1.0f;
+    constexpr float FarZ = 1000.0f;
+    constexpr float RainDropsPerSecond = 4.0f;
+
+    std::uint32_t WavesVertexByteSize(WavesVertexFormat format);
+    WavesConstants MakeWavesConstants(const Waves& waves);
+
+    // Caméra en orbite autour de l'origine, à la distance radius : écrit la matrice de vue et renvoie la position de l'œil.
+    XMFLOAT3 OrbitCamera(float radius, float theta, float phi, XMFLOAT4X4& view);
+    XMFLOAT4X4 Projection(float aspectRatio);
+
+    // Constantes de passe de la frame, le soleil étant donné en coordonnées sphériques.
+    void BuildPassConstants(const XMFLOAT4X4& view, const XMFLOAT4X4& proj, const XMFLOAT3& eyePosition, int width, int height, float deltaTime,
+        float sunTheta, float sunPhi, PassConstants& pass);
+
+    // Réécrit dans constants les objets modifiés depuis la dernière utilisation de la frame resource, world(i) étant la matrice monde de l'objet i.
+    // Les suites d'indices consécutifs gardent les écritures séquentielles dans la mémoire d'upload, et un objet immobile ne coûte rien.
+    template<typename World>
+    void WriteObjectConstants(DirtyTracker& dirty, int frameResourceIndex, const ElementSpan<ObjectConstants>& constants, const World& world)
+    {
+        dirty.ConsumeRuns(frameResourceIndex, [&](size_t first, size_t count)
+        {
+            for (size_t i = first; i < first + count; i++)
+                XMStoreFloat4x4(&constants[static_cast<std::uint32_t>(i)].World, XMMatrixTranspose(XMLoadFloat4x4(&world(i))));
+        });
+    }
+
+    // Comme WriteObjectConstants, materials étant rangés par MatCBIndex.
+    void WriteMaterialConstants(DirtyTracker& dirty, int frameResourceIndex, const ElementSpan<MaterialConstants>& constants, const std::vector<Material*>& materials);
+
+    // Gouttes de pluie à intervalle régulier du temps total, envoyées en un seul lot à la simulation.
+    class Rain
+    {
+    public:
+        explicit Rain(float dropsPerSecond = RainDropsPerSecond) : mDropInterval(1.0f / dropsPerSecond) {}
+
+        // Gouttes tombées depuis le dernier appel jusqu'à totalTime, loin du bord de la grille.
+        const std::vector<Waves::Disturbance>& Fall(const Waves& waves, float totalTime, RandomUtils::Xoshiro& generator);
+
+    private:
+        float mDropInterval = 0.0f;
+        float mLastDropTime = 0.0f;
+        std::vector<Waves::Disturbance> mDrops;
+    };
+
+    // Pluie, avancée de la simulation de deltaTime, puis écriture dans vertices (ChunkedVertexCount() sommets au format donné)
+    // des seules tuiles qui ont bougé depuis writtenStep, qui est mis à jour. La simulation avance à pas fixe : les sommets sont interpolés
+    // entre les deux dernières solutions pour que le rendu reste fluide.
+    void UpdateWaves(Waves& waves, Rain& rain, float totalTime, float deltaTime, RandomUtils::Xoshiro& generator, WavesVertexFormat format,
+        std::uint8_t* vertices, std::uint64_t& writtenStep);
+
+    // Draws de l'eau, une fois son PSO, ses buffers et ses constantes racine en place. Tous les blocs partagent le même index buffer,
+    // seuls le premier sommet et l'indice du bloc changent d'un draw à l'autre.
+    // CommandList est ID3D12GraphicsCommandList ou NullDevice::CommandList, qui ont les mêmes fonctions.
+    template<typename CommandList>
+    void DrawWavesChunks(CommandList& commandList, const Waves& waves, std::uint32_t chunkIndexCount)
+    {
+        for (std::uint32_t chunk = 0; chunk < static_cast<std::uint32_t>(waves.ChunkCount()); chunk++)
+        {
+            commandList.SetGraphicsRoot32BitConstant(RootWavesConstants, chunk, offsetof(WavesConstants, ChunkIndex) / 4);
+            commandList.DrawIndexedInstanced(chunkIndexCount, 1, 0, static_cast<std::int32_t>(chunk) * waves.ChunkVertexCount(), 0);
+        }
+    }
+}
\ No newline at end of file
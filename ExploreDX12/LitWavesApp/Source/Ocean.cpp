@@ -0,0 +1,296 @@
+#include "Ocean.h"
+
+#include <random>
+
+#include "Utils/MemoryUtils.h"
+#include "Utils/ParallelUtils.h"
+
+Ocean::Ocean(int fftSize, float patchSize, const XMFLOAT2& windVelocity, float amplitude, float choppiness, unsigned int seed)
+    : mFFTSize(fftSize), mPatchSize(patchSize), mSpatialStep(patchSize / fftSize), mWindVelocity(windVelocity), mAmplitude(amplitude), mChoppiness(choppiness)
+{
+    // La FFT radix-2 ne fonctionne que sur des puissances de 2.
+    assert(fftSize >= 4 && (fftSize & (fftSize - 1)) == 0);
+    // Phillips divise par le carré de la vitesse du vent : sans vent, le spectre serait NaN.
+    assert(windVelocity.x * windVelocity.x + windVelocity.y * windVelocity.y > 0.0f);
+
+    const int n = fftSize;
+    int logSize = 0;
+    while ((1 << logSize) < n)
+        logSize++;
+
+    mBitReversal.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        int reversed = 0;
+        for (int bit = 0; bit < logSize; bit++)
+            reversed |= ((i >> bit) & 1) << (logSize - 1 - bit);
+        mBitReversal[i] = reversed;
+    }
+
+    // Étage de demi-taille h : w_j = exp(+i * pi * j / h) pour j < h (FFT inverse).
+    mTwiddleReal.resize(n - 1);
+    mTwiddleImaginary.resize(n - 1);
+    for (int h = 1; h < n; h *= 2)
+    {
+        for (int j = 0; j < h; j++)
+        {
+            mTwiddleReal[h - 1 + j] = cosf(DirectXMathUtils::Pi * j / h);
+            mTwiddleImaginary[h - 1 + j] = sinf(DirectXMathUtils::Pi * j / h);
+        }
+    }
+
+    // h0(k) = (xi_r + i * xi_i) * sqrt(P(k) / 2), avec xi des variables gaussiennes. La graine rend l'océan reproductible.
+    std::mt19937 generator(seed);
+    std::normal_distribution<float> gaussian(0.0f, 1.0f);
+    mH0.resize(n * n);
+    mOmega.resize(n * n);
+    for (int r = 0; r < n; r++)
+    {
+        for (int c = 0; c < n; c++)
+        {
+            const float kx = WaveNumber(c);
+            const float kz = WaveNumber(r);
+            const float xr = gaussian(generator);
+            const float xi = gaussian(generator);
+
+            // Les fréquences de Nyquist n'ont pas de conjuguée dans la grille, on les retire pour garder des champs réels.
+            const float amplitudeScale = (r == n / 2 || c == n / 2) ? 0.0f : sqrtf(0.5f * Phillips(kx, kz));
+            mH0[r * n + c] = XMFLOAT2(xr * amplitudeScale, xi * amplitudeScale);
+            mOmega[r * n + c] = sqrtf(Gravity * sqrtf(kx * kx + kz * kz));
+        }
+    }
+
+    mH0MinusConjugate.resize(n * n);
+    for (int r = 0; r < n; r++)
+    {
+        for (int c = 0; c < n; c++)
+        {
+            const XMFLOAT2& h0 = mH0[((n - r) % n) * n + (n - c) % n];
+            mH0MinusConjugate[r * n + c] = XMFLOAT2(h0.x, -h0.y);
+        }
+    }
+
+    for (int field = 0; field < FieldCount; field++)
+    {
+        mFieldReal[field].resize(n * n);
+        mFieldImaginary[field].resize(n * n);
+    }
+
+    mPositions.resize(VertexCount());
+    mNormals.resize(VertexCount());
+    mTangentX.resize(VertexCount());
+    Evaluate(0.0f);
+}
+
+float Ocean::WaveNumber(int index) const
+{
+    // Les indices au-delà de fftSize / 2 correspondent aux fréquences négatives.
+    const int signedIndex = index < mFFTSize / 2 ? index : index - mFFTSize;
+    return 2.0f * DirectXMathUtils::Pi * signedIndex / mPatchSize;
+}
+
+float Ocean::Phillips(float kx, float kz) const
+{
+    const float kSquared = kx * kx + kz * kz;
+    if (kSquared < 1e-12f)
+        return 0.0f;
+
+    const float windSpeedSquared = mWindVelocity.x * mWindVelocity.x + mWindVelocity.y * mWindVelocity.y;
+    const float largestWave = windSpeedSquared / Gravity;
+    const float kDotWind = (kx * mWindVelocity.x + kz * mWindVelocity.y) / sqrtf(kSquared * windSpeedSquared);
+
+    // On atténue les vagues beaucoup plus petites que la plus grande pour éviter le crénelage.
+    const float smallestWave = 0.001f * largestWave;
+    return mAmplitude * expf(-1.0f / (kSquared * largestWave * largestWave)) / (kSquared * kSquared) * (kDotWind * kDotWind) * expf(-kSquared * smallestWave * smallestWave);
+}
+
+void Ocean::Update(float deltaTime)
+{
+    mTime += deltaTime;
+    Evaluate(mTime);
+}
+
+void Ocean::Evaluate(float time)
+{
+    mTime = time;
+    const int n = mFFTSize;
+
+    // Spectre à l'instant t : h(k, t) = h0(k) * exp(i * w * t) + conj(h0(-k)) * exp(-i * w * t).
+    // Les pentes (i * k * h) et les déplacements horizontaux (-i * k / |k| * h) en sont déduits, puis regroupés deux par deux.
+    ParallelUtils::For(0, n, [&](int r)
+    {
+        const float kz = WaveNumber(r);
+        for (int c = 0; c < n; c++)
+        {
+            const int index = r * n + c;
+            const float kx = WaveNumber(c);
+            const float k = sqrtf(kx * kx + kz * kz);
+            const float cosine = cosf(mOmega[index] * time);
+            const float sine = sinf(mOmega[index] * time);
+            const XMFLOAT2& h0 = mH0[index];
+            const XMFLOAT2& h0MinusConjugate = mH0MinusConjugate[index];
+
+            const float hr = (h0.x + h0MinusConjugate.x) * cosine + (h0MinusConjugate.y - h0.y) * sine;
+            const float hi = (h0.x - h0MinusConjugate.x) * sine + (h0.y + h0MinusConjugate.y) * cosine;
+
+            const float kxOverK = k > 0.0f ? kx / k : 0.0f;
+            const float kzOverK = k > 0.0f ? kz / k : 0.0f;
+
+            // Pour deux spectres hermitiens A et B, la FFT inverse de A + i * B donne a en partie réelle et b en partie imaginaire.
+            mFieldReal[0][index] = hr - kx * hr;
+            mFieldImaginary[0][index] = hi - kx * hi;
+            mFieldReal[1][index] = kxOverK * hr - kz * hi;
+            mFieldImaginary[1][index] = kz * hr + kxOverK * hi;
+            mFieldReal[2][index] = kzOverK * hi;
+            mFieldImaginary[2][index] = -kzOverK * hr;
+        }
+    });
+
+    for (int field = 0; field < FieldCount; field++)
+        InverseFFT2D(mFieldReal[field].data(), mFieldImaginary[field].data());
+
+    // Les indices de la FFT vont vers +z alors que les lignes de la grille vont vers -z comme dans Waves, d'où les changements de signe en z.
+    const int columnCount = ColumnCount();
+    ParallelUtils::For(0, RowCount(), [&](int r)
+    {
+        for (int c = 0; c < columnCount; c++)
+        {
+            const int sample = (r % n) * n + c % n;
+            const float height = mFieldReal[0][sample];
+            const float slopeX = mFieldImaginary[0][sample];
+            const float slopeZ = -mFieldReal[1][sample];
+            const float displacementX = mFieldImaginary[1][sample];
+            const float displacementZ = -mFieldReal[2][sample];
+
+            const int index = r * columnCount + c;
+            mPositions[index] = XMFLOAT3(
+                -HalfWidth() + c * mSpatialStep + mChoppiness * displacementX,
+                height,
+                HalfDepth() - r * mSpatialStep + mChoppiness * displacementZ);
+
+            XMStoreFloat3(&mNormals[index], XMVector3Normalize(XMVectorSet(-slopeX, 1.0f, -slopeZ, 0.0f)));
+            XMStoreFloat3(&mTangentX[index], XMVector3Normalize(XMVectorSet(1.0f, slopeX, 0.0f, 0.0f)));
+        }
+    });
+}
+
+void Ocean::InverseFFT(float* real, float* imaginary) const
+{
+    const int n = mFFTSize;
+    for (int i = 0; i < n; i++)
+    {
+        const int j = mBitReversal[i];
+        if (j > i)
+        {
+            std::swap(real[i], real[j]);
+            std::swap(imaginary[i], imaginary[j]);
+        }
+    }
+
+    // Les deux premiers étages ont moins de 4 papillons consécutifs, ils restent scalaires.
+    for (int h = 1; h < n && h < 4; h *= 2)
+    {
+        for (int start = 0; start < n; start += 2 * h)
+        {
+            for (int j = 0; j < h; j++)
+            {
+                const float wr = mTwiddleReal[h - 1 + j];
+                const float wi = mTwiddleImaginary[h - 1 + j];
+                const int a = start + j;
+                const int b = a + h;
+                const float tr = real[b] * wr - imaginary[b] * wi;
+                const float ti = real[b] * wi + imaginary[b] * wr;
+                real[b] = real[a] - tr;
+                imaginary[b] = imaginary[a] - ti;
+                real[a] += tr;
+                imaginary[a] += ti;
+            }
+        }
+    }
+
+    // Les parties réelles et imaginaires sont dans des tableaux séparés, 4 papillons se font donc avec des opérations SIMD directes.
+    for (int h = 4; h < n; h *= 2)
+    {
+        for (int start = 0; start < n; start += 2 * h)
+        {
+            for (int j = 0; j < h; j += 4)
+            {
+                XMVECTOR wr = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mTwiddleReal[h - 1 + j]));
+                XMVECTOR wi = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(&mTwiddleImaginary[h - 1 + j]));
+                XMFLOAT4* ar = reinterpret_cast<XMFLOAT4*>(real + start + j);
+                XMFLOAT4* ai = reinterpret_cast<XMFLOAT4*>(imaginary + start + j);
+                XMFLOAT4* br = reinterpret_cast<XMFLOAT4*>(real + start + j + h);
+                XMFLOAT4* bi = reinterpret_cast<XMFLOAT4*>(imaginary + start + j + h);
+
+                XMVECTOR xr = XMLoadFloat4(br);
+                XMVECTOR xi = XMLoadFloat4(bi);
+                XMVECTOR tr = XMVectorSubtract(XMVectorMultiply(xr, wr), XMVectorMultiply(xi, wi));
+                XMVECTOR ti = XMVectorMultiplyAdd(xr, wi, XMVectorMultiply(xi, wr));
+
+                XMVECTOR yr = XMLoadFloat4(ar);
+                XMVECTOR yi = XMLoadFloat4(ai);
+                XMStoreFloat4(br, XMVectorSubtract(yr, tr));
+                XMStoreFloat4(bi, XMVectorSubtract(yi, ti));
+                XMStoreFloat4(ar, XMVectorAdd(yr, tr));
+                XMStoreFloat4(ai, XMVectorAdd(yi, ti));
+            }
+        }
+    }
+}
+
+void Ocean::InverseFFT2D(float* real, float* imaginary) const
+{
+    const int n = mFFTSize;
+
+    ParallelUtils::For(0, n, [&](int r)
+    {
+        InverseFFT(real + r * n, imaginary + r * n);
+    });
+
+    // Les colonnes sont recopiées dans un buffer contigu du thread pour que la FFT travaille toujours sur des données consécutives.
+    ParallelUtils::For(0, n, [&](int c)
+    {
+        thread_local std::vector<float> columnReal;
+        thread_local std::vector<float> columnImaginary;
+        columnReal.resize(n);
+        columnImaginary.resize(n);
+
+        for (int r = 0; r < n; r++)
+        {
+            columnReal[r] = real[r * n + c];
+            columnImaginary[r] = imaginary[r * n + c];
+        }
+
+        InverseFFT(columnReal.data(), columnImaginary.data());
+
+        for (int r = 0; r < n; r++)
+        {
+            real[r * n + c] = columnReal[r];
+            imaginary[r * n + c] = columnImaginary[r];
+        }
+    });
+}
+
+void Ocean::WriteVertices(void* destination, const Waves::VertexLayout& layout) const
+{
+    const int columnCount = ColumnCount();
+    const size_t rowByteSize = columnCount * layout.Stride;
+    std::uint8_t* output = static_cast<std::uint8_t*>(destination);
+
+    ParallelUtils::For(0, RowCount(), [&](int r)
+    {
+        // Comme pour Waves, la ligne est préparée dans un buffer du thread puis copiée d'un bloc dans la mémoire mappée.
+        thread_local std::vector<std::uint8_t> row;
+        if (row.size() < rowByteSize)
+            row.resize(rowByteSize);
+
+        for (int c = 0; c < columnCount; c++)
+        {
+            std::uint8_t* vertex = row.data() + c * layout.Stride;
+            memcpy(vertex + layout.PositionOffset, &mPositions[r * columnCount + c], sizeof(XMFLOAT3));
+            memcpy(vertex + layout.NormalOffset, &mNormals[r * columnCount + c], sizeof(XMFLOAT3));
+        }
+
+        MemoryUtils::StreamCopy(output + r * rowByteSize, row.data(), rowByteSize);
+    });
+}
\ No newline at end of file
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Waves.h"
+
+// Océan spectral de Tessendorf : les hauteurs sont obtenues par FFT inverse d'un spectre de Phillips animé dans le temps.
+// Le motif est périodique (patchSize mètres) et peut être répété sans raccord visible, le coût par frame ne dépend que de la taille de la FFT.
+// L'interface de requête est la même que celle de Waves.
+class Ocean
+{
+public:
+    // fftSize doit être une puissance de 2 et le vent non nul (il fixe la taille de la plus grande vague). La grille contient fftSize + 1 sommets de côté, la dernière ligne et la dernière colonne
+    // reprennent la première pour que deux motifs voisins se raccordent exactement.
+    Ocean(int fftSize, float patchSize, const XMFLOAT2& windVelocity, float amplitude, float choppiness, unsigned int seed = 0);
+    Ocean(const Ocean& rhs) = delete;
+    Ocean& operator=(const Ocean& rhs) = delete;
+    ~Ocean() = default;
+
+    int RowCount() const { return mFFTSize + 1; }
+    int ColumnCount() const { return mFFTSize + 1; }
+    int VertexCount() const { return RowCount() * ColumnCount(); }
+    int TriangleCount() const { return 2 * mFFTSize * mFFTSize; }
+    float Width() const { return mPatchSize; }
+    float Depth() const { return mPatchSize; }
+    float SpatialStep() const { return mSpatialStep; }
+    float HalfWidth() const { return 0.5f * mPatchSize; }
+    float HalfDepth() const { return 0.5f * mPatchSize; }
+    float Time() const { return mTime; }
+
+    const XMFLOAT3& Position(int i) const { return mPositions[i]; }
+    const XMFLOAT3& Normal(int i) const { return mNormals[i]; }
+    const XMFLOAT3& TangentX(int i) const { return mTangentX[i]; }
+
+    void Update(float deltaTime);
+
+    // Calcule la surface à l'instant time. Update l'appelle avec le temps écoulé, mais on peut l'appeler directement pour un rendu déterministe.
+    void Evaluate(float time);
+
+    // Écrit positions et normales dans une mémoire mappée, avec le même format de sommet que Waves::WriteVertices.
+    void WriteVertices(void* destination, const Waves::VertexLayout& layout) const;
+
+    // FFT inverse 2D en place, non normalisée : x(r, c) = somme des X(kr, kc) * exp(+2 * i * pi * (kr * r + kc * c) / fftSize),
+    // sur fftSize * fftSize nombres complexes rangés par lignes.
+    void InverseFFT2D(float* real, float* imaginary) const;
+
+    // Les trois champs après la dernière évaluation, voir mFieldReal. La partie imaginaire du champ 2 (déplacement z seul) reste nulle
+    // tant que le spectre est hermitien, ce que vérifie le test ocean.
+    const float* FieldReal(int field) const { return mFieldReal[field].data(); }
+    const float* FieldImaginary(int field) const { return mFieldImaginary[field].data(); }
+
+    static constexpr int FieldCount = 3;
+
+private:
+    float Phillips(float kx, float kz) const;
+    float WaveNumber(int index) const;
+
+    // FFT inverse en place sur fftSize nombres complexes stockés en deux tableaux (réels et imaginaires).
+    void InverseFFT(float* real, float* imaginary) const;
+
+    static constexpr float Gravity = 9.81f;
+
+    int mFFTSize = 0;
+    float mPatchSize = 0.0f;
+    float mSpatialStep = 0.0f;
+    XMFLOAT2 mWindVelocity;
+    float mAmplitude = 0.0f;
+    float mChoppiness = 0.0f;
+    float mTime = 0.0f;
+
+    // h0(k) et conj(h0(-k)), fixés à la construction, et la pulsation de chaque vague.
+    std::vector<XMFLOAT2> mH0;
+    std::vector<XMFLOAT2> mH0MinusConjugate;
+    std::vector<float> mOmega;
+
+    std::vector<int> mBitReversal;
+    // Facteurs de rotation de chaque étage : ceux de l'étage de demi-taille h sont rangés à partir de l'indice h - 1.
+    std::vector<float> mTwiddleReal;
+    std::vector<float> mTwiddleImaginary;
+
+    // Deux champs réels sont transformés par FFT complexe : (hauteur, pente x), (pente z, déplacement x), (déplacement z, inutilisé).
+    std::vector<float> mFieldReal[FieldCount];
+    std::vector<float> mFieldImaginary[FieldCount];
+
+    std::vector<XMFLOAT3> mPositions;
+    std::vector<XMFLOAT3> mNormals;
+    std::vector<XMFLOAT3> mTangentX;
+};
\ No newline at end of file
@@ -1,11 +1,15 @@
 #include "Waves.h"
 
-#include <ppl.h>
+#include <algorithm>
+#include <cmath>
+#include <DirectXPackedVector.h>
 
-#include "Managers/TimeManager.h"
+#include "Utils/MemoryUtils.h"
+#include "Utils/ParallelUtils.h"
+#include "Utils/Simd.h"
 
-Waves::Waves(int m, int n, float dx, float dt, float speed, float damping)
-    : mNumberOfRows(m), mNumberOfColumns(n), mVertexCount(m * n), mTriangleCount((m - 1) * (n - 1) * 2), mTimeStep(dt), mSpatialStep(dx)
+Waves::Waves(int m, int n, float dx, float dt, float speed, float damping, StoragePrecision precision, float heightRange)
+    : mNumberOfRows(m), mNumberOfColumns(n), mVertexCount(m * n), mTriangleCount((m - 1) * (n - 1) * 2), mTimeStep(dt), mSpatialStep(dx), mPrecision(precision)
 {
     float d = damping * dt + 2.0f;
     float e = (speed * speed) * (dt * dt) / (dx * dx);
@@ -13,89 +17,1061 @@ Waves::Waves(int m, int n, float dx, float dt, float speed, float damping)
     mK2 = (4.0f - 8.0f * e) / d;
     mK3 = (2.0f * e) / d;
 
-    mPreviousSolution.resize(m * n);
-    mCurrentSolution.resize(m * n);
-    mNormals.resize(m * n);
-    mTangentX.resize(m * n);
+    // La grille est centrée sur l'origine, x et z de chaque sommet se déduisent de (i, j).
+    mHalfWidth = (n - 1) * dx * 0.5f;
+    mHalfDepth = (m - 1) * dx * 0.5f;
 
-    // Ici, on gnre les sommets de la grille.
-    float halfWidth = (n - 1) * dx * 0.5f;
-    float halfDepth = (m - 1) * dx * 0.5f;
-    for(int i = 0; i < m; i++)
+    // Dans les trois formats, une hauteur nulle s'écrit avec des octets à zéro.
+    mHeightByteSize = precision == StoragePrecision::Float32 ? sizeof(float) : sizeof(std::uint16_t);
+    mFixedScale = heightRange / 32767.0f;
+    mInvFixedScale = 32767.0f / heightRange;
+    mPreviousSolution.assign(static_cast<size_t>(m) * n * mHeightByteSize + sizeof(float), 0);
+    mCurrentSolution.assign(static_cast<size_t>(m) * n * mHeightByteSize + sizeof(float), 0);
+    mNormals.assign(m * n, XMFLOAT3(0.0f, 1.0f, 0.0f));
+    mTangentX.assign(m * n, XMFLOAT3(1.0f, 0.0f, 0.0f));
+
+    // Au départ l'eau est plate, toutes les tuiles dorment.
+    mTileRowCount = (m + TileSize - 1) / TileSize;
+    mTileColumnCount = (n + TileSize - 1) / TileSize;
+
+    // Une petite grille tient dans un seul bloc sans remplissage.
+    mChunkRowSize = DirectXMathUtils::Min(MaxChunkSize, m - 1);
+    mChunkColumnSize = DirectXMathUtils::Min(MaxChunkSize, n - 1);
+    mChunkRowCount = (m - 1 + mChunkRowSize - 1) / mChunkRowSize;
+    mChunkColumnCount = (n - 1 + mChunkColumnSize - 1) / mChunkColumnSize;
+    mTileActive.assign(mTileRowCount * mTileColumnCount, 0);
+    mTileLastChange.assign(mTileRowCount * mTileColumnCount, 0);
+    mTileEdgeActivity.resize(mTileRowCount * mTileColumnCount);
+    mTileActivity.resize(mTileRowCount * mTileColumnCount);
+
+    // Les normales et tangentes initiales correspondent à l'eau plate de l'étape 0.
+    mTileNormalStep.assign(mTileRowCount * mTileColumnCount, 0);
+    mTileTangentStep.assign(mTileRowCount * mTileColumnCount, 0);
+}
+
+Waves::~Waves()
+{
+    StopAsync();
+}
+
+void Waves::StartAsync()
+{
+    if (IsAsync())
+        return;
+
+    // Les trois instantanés partent de l'état courant, le lecteur a donc toujours un état complet à lire.
+    for (int index = 0; index < 3; index++)
+        Publish(mSnapshots.Buffer(index), true);
+
+    mDisturbanceQueue = std::make_unique<SpscQueue<Disturbance>>(4096);
+    mStopRequested = false;
+    mAsyncAlpha = 0.0f;
+    mWorker = std::thread(&Waves::RunAsync, this);
+}
+
+void Waves::StopAsync()
+{
+    if (!IsAsync())
+        return;
+
+    mStopRequested = true;
+    mWorker.join();
+
+    // Les impacts encore en attente sont gardés pour la prochaine étape synchrone.
+    mDisturbanceQueue->PopAll(mPendingDisturbances);
+    mPendingDisturbances.insert(mPendingDisturbances.end(), mOverflowDisturbances.begin(), mOverflowDisturbances.end());
+    mOverflowDisturbances.clear();
+    mDisturbanceQueue.reset();
+}
+
+void Waves::RunAsync()
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::duration timeStep = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(mTimeStep));
+
+    Clock::time_point nextStep = Clock::now();
+    while (!mStopRequested)
+    {
+        mDisturbanceQueue->PopAll(mPendingDisturbances);
+        Step();
+
+        Snapshot& snapshot = mSnapshots.WriteBuffer();
+        Publish(snapshot, false);
+        snapshot.StepTime = nextStep;
+        mSnapshots.Publish();
+
+        // Comme en mode synchrone, on ne cherche pas à rattraper le retard si la simulation est plus lente que le temps réel.
+        nextStep += timeStep;
+        const Clock::time_point now = Clock::now();
+        if (nextStep < now)
+            nextStep = now;
+        std::this_thread::sleep_until(nextStep);
+    }
+}
+
+void Waves::Publish(Snapshot& snapshot, bool copyAll) const
+{
+    if (copyAll)
     {
-        float z = halfDepth - i * dx;
-        for (int j = 0; j < n; j++)
+        snapshot.Previous = mPreviousSolution;
+        snapshot.Current = mCurrentSolution;
+    }
+    else
+    {
+        // Seules les tuiles modifiées depuis le dernier remplissage de cet instantané sont recopiées.
+        const std::uint64_t snapshotStep = snapshot.StepCount;
+        ParallelUtils::For(0, mTileRowCount * mTileColumnCount, [&](int tile)
         {
-            float x = -halfWidth + j * dx;
-            mPreviousSolution[i * n + j] = XMFLOAT3(x, 0.0f, z);
-            mCurrentSolution[i * n + j] = XMFLOAT3(x, 0.0f, z);
-            mNormals[i * n + j] = XMFLOAT3(0.0f, 1.0f, 0.0f);
-            mTangentX[i * n + j] = XMFLOAT3(1.0f, 0.0f, 0.0f);
-        }
+            if (mTileLastChange[tile] <= snapshotStep)
+                return;
+
+            const int rowBegin = (tile / mTileColumnCount) * TileSize;
+            const int rowEnd = DirectXMathUtils::Min(rowBegin + TileSize, mNumberOfRows);
+            const int columnBegin = (tile % mTileColumnCount) * TileSize;
+            const int columnByteSize = (DirectXMathUtils::Min(columnBegin + TileSize, mNumberOfColumns) - columnBegin) * mHeightByteSize;
+            for (int i = rowBegin; i < rowEnd; i++)
+            {
+                const size_t offset = static_cast<size_t>(i * mNumberOfColumns + columnBegin) * mHeightByteSize;
+                memcpy(&snapshot.Previous[offset], &mPreviousSolution[offset], columnByteSize);
+                memcpy(&snapshot.Current[offset], &mCurrentSolution[offset], columnByteSize);
+            }
+        });
+    }
+
+    snapshot.TileActive = mTileActive;
+    snapshot.TileLastChange = mTileLastChange;
+    snapshot.StepCount = mStepCount;
+    snapshot.ActiveTileCount = static_cast<int>(mActiveTiles.size());
+    snapshot.StepTime = std::chrono::steady_clock::now();
+}
+
+Waves::View Waves::ReadView() const
+{
+    View view;
+    if (IsAsync())
+    {
+        const Snapshot& snapshot = mSnapshots.ReadBuffer();
+        view.Previous = snapshot.Previous.data();
+        view.Current = snapshot.Current.data();
+        view.TileActive = snapshot.TileActive.data();
+        view.TileLastChange = snapshot.TileLastChange.data();
+        view.StepCount = snapshot.StepCount;
+        view.ActiveTileCount = snapshot.ActiveTileCount;
     }
+    else
+    {
+        view.Previous = mPreviousSolution.data();
+        view.Current = mCurrentSolution.data();
+        view.TileActive = mTileActive.data();
+        view.TileLastChange = mTileLastChange.data();
+        view.StepCount = mStepCount;
+        view.ActiveTileCount = static_cast<int>(mActiveTiles.size());
+    }
+    return view;
 }
 
-void Waves::Update()
+void Waves::Update(float deltaTime)
 {
-    static float t = 0.0f;
-    t += TimeManager::GetDeltaTime();
-    if (t < mTimeStep)
+    if (IsAsync())
+    {
+        if (!mOverflowDisturbances.empty())
+        {
+            const size_t pushed = mDisturbanceQueue->Push(mOverflowDisturbances.data(), mOverflowDisturbances.size());
+            mOverflowDisturbances.erase(mOverflowDisturbances.begin(), mOverflowDisturbances.begin() + pushed);
+        }
+
+        // On récupère la dernière étape terminée, l'interpolation se fait entre sa solution précédente et sa solution courante.
+        mSnapshots.Acquire();
+        const std::chrono::duration<float> elapsed = std::chrono::steady_clock::now() - mSnapshots.ReadBuffer().StepTime;
+        mAsyncAlpha = DirectXMathUtils::Clamp(elapsed.count() / mTimeStep, 0.0f, 1.0f);
         return;
+    }
+
+    mAccumulatedTime += deltaTime;
+    if (mAccumulatedTime < mTimeStep)
+        return;
+
+    // On garde le reste du pas de temps pour l'interpolation, sans accumuler de retard si le rendu est plus lent que la simulation.
+    mAccumulatedTime = DirectXMathUtils::Clamp(mAccumulatedTime - mTimeStep, 0.0f, mTimeStep);
 
-    Concurrency::parallel_for(1, mNumberOfRows - 1, [this](int i)
+    Step();
+}
+
+void Waves::Step()
+{
+    ApplyDisturbances();
+
+    mStepCount++;
+
+    // Chaque tuile n'écrit que ses propres sommets, les tuiles actives peuvent donc être traitées en parallèle sans conflit.
+    ParallelUtils::For(0, static_cast<int>(mActiveTiles.size()), [this](int k)
     {
-        for (int j = 0; j < mNumberOfColumns - 1; j++)
+        const int tile = mActiveTiles[k];
+        const int rowBegin = DirectXMathUtils::Max((tile / mTileColumnCount) * TileSize, 1);
+        const int rowEnd = DirectXMathUtils::Min((tile / mTileColumnCount + 1) * TileSize, mNumberOfRows - 1);
+        const int columnBegin = DirectXMathUtils::Max((tile % mTileColumnCount) * TileSize, 1);
+        const int columnEnd = DirectXMathUtils::Min((tile % mTileColumnCount + 1) * TileSize, mNumberOfColumns - 1);
+        const int width = columnEnd - columnBegin;
+        if (rowBegin >= rowEnd || width <= 0)
+            return;
+
+        // Trois lignes de la solution courante, avec une colonne de plus de chaque côté, et la ligne à mettre à jour de la solution précédente.
+        // Elles sont lues une seule fois en float (décodées si besoin), les lignes courantes tournent dans les trois premiers emplacements.
+        constexpr int ScratchRowSize = TileSize + 2;
+        thread_local float scratch[4 * ScratchRowSize];
+        const std::uint8_t* current = mCurrentSolution.data();
+        std::uint8_t* previous = mPreviousSolution.data();
+
+        const float* rows[3];
+        rows[0] = LoadHeights(current, (rowBegin - 1) * mNumberOfColumns + columnBegin - 1, width + 2, scratch);
+        rows[1] = LoadHeights(current, rowBegin * mNumberOfColumns + columnBegin - 1, width + 2, scratch + ScratchRowSize);
+        for (int i = rowBegin; i < rowEnd; i++)
         {
-            mPreviousSolution[i * mNumberOfColumns + j].y =
-                mK1 * mPreviousSolution[i * mNumberOfColumns + j].y +
-                mK2 * mCurrentSolution[i * mNumberOfColumns + j].y +
-                mK3 * (
-                    mCurrentSolution[(i + 1) * mNumberOfColumns + j].y +
-                    mCurrentSolution[(i - 1) * mNumberOfColumns + j].y +
-                    mCurrentSolution[i * mNumberOfColumns + j + 1].y +
-                    mCurrentSolution[i * mNumberOfColumns + j - 1].y
-                    );
+            const int below = (i - rowBegin + 2) % 3;
+            rows[below] = LoadHeights(current, (i + 1) * mNumberOfColumns + columnBegin - 1, width + 2, scratch + below * ScratchRowSize);
+
+            const float* t = rows[(i - rowBegin) % 3] + 1;
+            const float* c = rows[(i - rowBegin + 1) % 3] + 1;
+            const float* b = rows[below] + 1;
+            float* next = LoadHeights(previous, i * mNumberOfColumns + columnBegin, width, scratch + 3 * ScratchRowSize);
+            for (int j = 0; j < width; j++)
+                next[j] = mK1 * next[j] + mK2 * c[j] + mK3 * (b[j] + t[j] + c[j + 1] + c[j - 1]);
+            StoreHeights(previous, i * mNumberOfColumns + columnBegin, width, next);
         }
     });
 
+    // Les tuiles endormies ont la même hauteur dans les deux solutions, l'échange ne les modifie pas.
     std::swap(mPreviousSolution, mCurrentSolution);
 
-    t = 0.0f;
+    ParallelUtils::For(0, static_cast<int>(mActiveTiles.size()), [this](int k)
+    {
+        const int tile = mActiveTiles[k];
+        const int tileRowBegin = (tile / mTileColumnCount) * TileSize;
+        const int tileRowEnd = DirectXMathUtils::Min(tileRowBegin + TileSize, mNumberOfRows);
+        const int tileColumnBegin = (tile % mTileColumnCount) * TileSize;
+        const int tileColumnEnd = DirectXMathUtils::Min(tileColumnBegin + TileSize, mNumberOfColumns);
+
+        // On mesure l'activité de la tuile (hauteur et vitesse). Normales et tangentes ne sont calculées qu'à la demande, voir RequestAttributes.
+        thread_local float scratch[2 * TileSize];
+        float activity = 0.0f;
+        XMFLOAT4 edgeActivity(0.0f, 0.0f, 0.0f, 0.0f);
+        for (int i = tileRowBegin; i < tileRowEnd; i++)
+        {
+            const float* current = LoadHeights(mCurrentSolution.data(), i * mNumberOfColumns + tileColumnBegin, tileColumnEnd - tileColumnBegin, scratch);
+            const float* previous = LoadHeights(mPreviousSolution.data(), i * mNumberOfColumns + tileColumnBegin, tileColumnEnd - tileColumnBegin, scratch + TileSize);
+            for (int j = tileColumnBegin; j < tileColumnEnd; j++)
+            {
+                const float height = current[j - tileColumnBegin];
+                const float value = DirectXMathUtils::Max(std::abs(height), std::abs(height - previous[j - tileColumnBegin]));
+                activity = DirectXMathUtils::Max(activity, value);
+
+                // Une bande de deux sommets sur chaque bord suffit à réveiller la voisine avant que l'onde ne l'atteigne.
+                if (i < tileRowBegin + 2)
+                    edgeActivity.x = DirectXMathUtils::Max(edgeActivity.x, value);
+                if (i >= tileRowEnd - 2)
+                    edgeActivity.y = DirectXMathUtils::Max(edgeActivity.y, value);
+                if (j < tileColumnBegin + 2)
+                    edgeActivity.z = DirectXMathUtils::Max(edgeActivity.z, value);
+                if (j >= tileColumnEnd - 2)
+                    edgeActivity.w = DirectXMathUtils::Max(edgeActivity.w, value);
+            }
+        }
+
+        mTileActivity[tile] = activity;
+        mTileEdgeActivity[tile] = edgeActivity;
+        mTileLastChange[tile] = mStepCount;
+    });
+
+    UpdateActiveTiles();
+}
+
+void Waves::UpdateActiveTiles()
+{
+    std::vector<int> stepped;
+    stepped.swap(mActiveTiles);
+
+    // Les tuiles calmes sont d'abord marquées inactives, sans être remises à plat : une voisine encore agitée peut les réveiller.
+    for (int tile : stepped)
+    {
+        if (mTileActivity[tile] < mSleepThreshold)
+            mTileActive[tile] = 0;
+        else
+            mActiveTiles.push_back(tile);
+    }
+
+    for (int tile : stepped)
+    {
+        const int tileRow = tile / mTileColumnCount;
+        const int tileColumn = tile % mTileColumnCount;
+        const XMFLOAT4& edge = mTileEdgeActivity[tile];
+
+        if (edge.x >= mSleepThreshold)
+            WakeTile(tileRow - 1, tileColumn);
+        if (edge.y >= mSleepThreshold)
+            WakeTile(tileRow + 1, tileColumn);
+        if (edge.z >= mSleepThreshold)
+            WakeTile(tileRow, tileColumn - 1);
+        if (edge.w >= mSleepThreshold)
+            WakeTile(tileRow, tileColumn + 1);
+    }
+
+    for (int tile : stepped)
+    {
+        if (mTileActive[tile] == 0)
+            SleepTile(tile);
+    }
+
+    // On garde les tuiles dans l'ordre de la mémoire pour le parcours de l'étape suivante.
+    std::sort(mActiveTiles.begin(), mActiveTiles.end());
+}
+
+void Waves::WakeTile(int tileRow, int tileColumn)
+{
+    if (tileRow < 0 || tileRow >= mTileRowCount || tileColumn < 0 || tileColumn >= mTileColumnCount)
+        return;
+
+    const int tile = tileRow * mTileColumnCount + tileColumn;
+    if (mTileActive[tile] != 0)
+        return;
+
+    mTileActive[tile] = 1;
+    mActiveTiles.push_back(tile);
+}
+
+void Waves::WakeTilesAround(int i, int j)
+{
+    // Réveille la tuile du sommet (i, j) et celles de ses voisins directs, qui peuvent être dans une autre tuile.
+    WakeTile(i / TileSize, j / TileSize);
+    WakeTile((i - 1) / TileSize, j / TileSize);
+    WakeTile((i + 1) / TileSize, j / TileSize);
+    WakeTile(i / TileSize, (j - 1) / TileSize);
+    WakeTile(i / TileSize, (j + 1) / TileSize);
+}
+
+void Waves::SleepTile(int tile)
+{
+    mTileActive[tile] = 0;
+    mTileLastChange[tile] = mStepCount;
+
+    // L'activité résiduelle est sous le seuil, on remet la tuile à plat pour que les deux solutions soient identiques.
+    const int rowBegin = (tile / mTileColumnCount) * TileSize;
+    const int rowEnd = DirectXMathUtils::Min(rowBegin + TileSize, mNumberOfRows);
+    const int columnBegin = (tile % mTileColumnCount) * TileSize;
+    const int columnEnd = DirectXMathUtils::Min(columnBegin + TileSize, mNumberOfColumns);
+    for (int i = rowBegin; i < rowEnd; i++)
+    {
+        const size_t offset = static_cast<size_t>(i * mNumberOfColumns + columnBegin) * mHeightByteSize;
+        memset(&mPreviousSolution[offset], 0, (columnEnd - columnBegin) * mHeightByteSize);
+        memset(&mCurrentSolution[offset], 0, (columnEnd - columnBegin) * mHeightByteSize);
+    }
+}
+
+std::uint64_t Waves::LastChangeAround(const View& view, int tile) const
+{
+    // Les sommets du bord d'une tuile dépendent des hauteurs des tuiles voisines.
+    const int tileRow = tile / mTileColumnCount;
+    const int tileColumn = tile % mTileColumnCount;
+    std::uint64_t lastChange = view.TileLastChange[tile];
+    if (tileRow > 0)
+        lastChange = DirectXMathUtils::Max(lastChange, view.TileLastChange[tile - mTileColumnCount]);
+    if (tileRow < mTileRowCount - 1)
+        lastChange = DirectXMathUtils::Max(lastChange, view.TileLastChange[tile + mTileColumnCount]);
+    if (tileColumn > 0)
+        lastChange = DirectXMathUtils::Max(lastChange, view.TileLastChange[tile - 1]);
+    if (tileColumn < mTileColumnCount - 1)
+        lastChange = DirectXMathUtils::Max(lastChange, view.TileLastChange[tile + 1]);
+    return lastChange;
+}
+
+void Waves::RequestAttributes(std::uint32_t attributes, int rowBegin, int rowEnd, int columnBegin, int columnEnd) const
+{
+    const View view = ReadView();
+
+    // Liste des tuiles de la région dont le cache est plus ancien que la dernière modification des hauteurs.
+    thread_local std::vector<std::pair<int, std::uint32_t>> staleTiles;
+    staleTiles.clear();
+    for (int tileRow = rowBegin / TileSize; tileRow <= (rowEnd - 1) / TileSize; tileRow++)
+    {
+        for (int tileColumn = columnBegin / TileSize; tileColumn <= (columnEnd - 1) / TileSize; tileColumn++)
+        {
+            const int tile = tileRow * mTileColumnCount + tileColumn;
+            const std::uint64_t lastChange = LastChangeAround(view, tile);
+
+            std::uint32_t stale = 0;
+            if ((attributes & AttributeNormal) && (mTileNormalStep[tile] == NeverWritten || mTileNormalStep[tile] < lastChange))
+                stale |= AttributeNormal;
+            if ((attributes & AttributeTangentX) && (mTileTangentStep[tile] == NeverWritten || mTileTangentStep[tile] < lastChange))
+                stale |= AttributeTangentX;
+
+            if (stale != 0)
+                staleTiles.emplace_back(tile, stale);
+        }
+    }
+
+    // Le vecteur est propre au thread appelant, les threads du pool le lisent par pointeur.
+    const std::pair<int, std::uint32_t>* tiles = staleTiles.data();
+    if (staleTiles.size() == 1)
+        ComputeAttributes(view, tiles[0].first, tiles[0].second);
+    else if (!staleTiles.empty())
+        ParallelUtils::For(0, static_cast<int>(staleTiles.size()), [this, &view, tiles](int k) { ComputeAttributes(view, tiles[k].first, tiles[k].second); });
+}
+
+void Waves::ComputeAttributes(const View& view, int tile, std::uint32_t attributes) const
+{
+    const int rowBegin = (tile / mTileColumnCount) * TileSize;
+    const int rowEnd = DirectXMathUtils::Min(rowBegin + TileSize, mNumberOfRows);
+    const int columnBegin = (tile % mTileColumnCount) * TileSize;
+    const int columnEnd = DirectXMathUtils::Min(columnBegin + TileSize, mNumberOfColumns);
+
+    // Hauteurs des lignes i - 1, i et i + 1 sur les colonnes de la tuile, plus une de chaque côté quand elle existe.
+    constexpr int ScratchRowSize = TileSize + 2;
+    thread_local float scratch[3 * ScratchRowSize];
+    const int scratchBegin = DirectXMathUtils::Max(columnBegin - 1, 0);
+    const int scratchWidth = DirectXMathUtils::Min(columnEnd + 1, mNumberOfColumns) - scratchBegin;
+
+    for (int i = rowBegin; i < rowEnd; i++)
+    {
+        const float* above = nullptr;
+        const float* center = nullptr;
+        const float* below = nullptr;
+        if (i > 0 && i < mNumberOfRows - 1)
+        {
+            above = LoadHeights(view.Current, (i - 1) * mNumberOfColumns + scratchBegin, scratchWidth, scratch);
+            center = LoadHeights(view.Current, i * mNumberOfColumns + scratchBegin, scratchWidth, scratch + ScratchRowSize);
+            below = LoadHeights(view.Current, (i + 1) * mNumberOfColumns + scratchBegin, scratchWidth, scratch + 2 * ScratchRowSize);
+        }
+
+        for (int j = columnBegin; j < columnEnd; j++)
+        {
+            const int index = i * mNumberOfColumns + j;
+            if (i == 0 || i == mNumberOfRows - 1 || j == 0 || j == mNumberOfColumns - 1)
+            {
+                mNormals[index] = XMFLOAT3(0.0f, 1.0f, 0.0f);
+                mTangentX[index] = XMFLOAT3(1.0f, 0.0f, 0.0f);
+                continue;
+            }
+
+            const int k = j - scratchBegin;
+            float l = center[k - 1];
+            float r = center[k + 1];
+            if (attributes & AttributeNormal)
+                mNormals[index] = ComputeNormal(l, r, above[k], below[k]);
+
+            if (attributes & AttributeTangentX)
+            {
+                XMVECTOR T = XMVector3Normalize(XMVectorSet(2.0f * mSpatialStep, r - l, 0.0f, 0.0f));
+                XMStoreFloat3(&mTangentX[index], T);
+            }
+        }
+    }
+
+    if (attributes & AttributeNormal)
+        mTileNormalStep[tile] = view.StepCount;
+    if (attributes & AttributeTangentX)
+        mTileTangentStep[tile] = view.StepCount;
+}
+
+XMFLOAT3 Waves::ComputeNormal(float l, float r, float t, float b) const
+{
+    XMFLOAT3 normal(-r + l, 2.0f * mSpatialStep, b - t);
+    XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&normal));
+    XMStoreFloat3(&normal, n);
+    return normal;
+}
+
+TransformUtils::Float3Array Waves::ComputeRowNormals(int i, const float* above, const float* center, const float* below, int jBegin, int jEnd) const
+{
+    thread_local std::vector<float> normals;
+    const size_t count = jEnd - jBegin;
+    if (normals.size() < 3 * count)
+        normals.resize(3 * count);
+
+    // Mêmes vecteurs que ComputeNormal, le bord de la grille garde (0, 1, 0).
+    const TransformUtils::Float3Array result = { normals.data(), normals.data() + count, normals.data() + 2 * count };
+    const bool borderRow = i == 0 || i == mNumberOfRows - 1;
+    for (int j = jBegin; j < jEnd; j++)
+    {
+        const int k = j - jBegin;
+        const bool border = borderRow || j == 0 || j == mNumberOfColumns - 1;
+        result.X[k] = border ? 0.0f : center[j - 1] - center[j + 1];
+        result.Y[k] = border ? 1.0f : 2.0f * mSpatialStep;
+        result.Z[k] = border ? 0.0f : below[j] - above[j];
+    }
+
+    TransformUtils::NormalizeVectors(result, result, count);
+    return result;
+}
+
+const float* Waves::LoadHeights(const std::uint8_t* solution, int index, int count, float* scratch) const
+{
+    switch (mPrecision)
+    {
+    case StoragePrecision::Float16:
+        PackedVector::XMConvertHalfToFloatStream(scratch, sizeof(float), reinterpret_cast<const PackedVector::HALF*>(solution) + index, sizeof(PackedVector::HALF), count);
+        return scratch;
+    case StoragePrecision::Fixed16:
+    {
+        const std::int16_t* values = reinterpret_cast<const std::int16_t*>(solution) + index;
+        const Simd::Float4 scale(mFixedScale);
+        int j = 0;
+        for (; j + 8 <= count; j += 8)
+        {
+            Simd::Int4 low, high;
+            Simd::LoadInt16(values + j, low, high);
+            (Simd::ToFloat(low) * scale).Store(scratch + j);
+            (Simd::ToFloat(high) * scale).Store(scratch + j + 4);
+        }
+        for (; j < count; j++)
+            scratch[j] = values[j] * mFixedScale;
+        return scratch;
+    }
+    default:
+        return reinterpret_cast<const float*>(solution) + index;
+    }
+}
+
+float* Waves::LoadHeights(std::uint8_t* solution, int index, int count, float* scratch) const
+{
+    if (mPrecision == StoragePrecision::Float32)
+        return reinterpret_cast<float*>(solution) + index;
+    return const_cast<float*>(LoadHeights(static_cast<const std::uint8_t*>(solution), index, count, scratch));
+}
+
+void Waves::StoreHeights(std::uint8_t* solution, int index, int count, const float* heights) const
+{
+    switch (mPrecision)
+    {
+    case StoragePrecision::Float16:
+        PackedVector::XMConvertFloatToHalfStream(reinterpret_cast<PackedVector::HALF*>(solution) + index, sizeof(PackedVector::HALF), heights, sizeof(float), count);
+        break;
+    case StoragePrecision::Fixed16:
+    {
+        // L'écriture sature à [-32768, 32767], une hauteur hors de heightRange est simplement écrêtée.
+        std::int16_t* values = reinterpret_cast<std::int16_t*>(solution) + index;
+        const Simd::Float4 invScale(mInvFixedScale);
+        int j = 0;
+        for (; j + 8 <= count; j += 8)
+        {
+            const Simd::Int4 low = Simd::RoundToInt(Simd::Float4::Load(heights + j) * invScale);
+            const Simd::Int4 high = Simd::RoundToInt(Simd::Float4::Load(heights + j + 4) * invScale);
+            Simd::StoreInt16Saturate(values + j, low, high);
+        }
+        // Mêmes arrondi (égalités vers le pair) et saturation que Simd::RoundToInt et Simd::StoreInt16Saturate.
+        for (; j < count; j++)
+        {
+            const float value = DirectXMathUtils::Clamp(heights[j] * mInvFixedScale, -32768.0f, 32767.0f);
+            values[j] = static_cast<std::int16_t>(std::nearbyint(value));
+        }
+        break;
+    }
+    default:
+        // En Float32 les hauteurs ont été modifiées en place par LoadHeights.
+        if (heights != reinterpret_cast<float*>(solution) + index)
+            memcpy(reinterpret_cast<float*>(solution) + index, heights, count * sizeof(float));
+        break;
+    }
+}
+
+float Waves::LoadHeight(const std::uint8_t* solution, int index) const
+{
+    float height;
+    return *LoadHeights(solution, index, 1, &height);
+}
+
+void Waves::StoreHeight(std::uint8_t* solution, int index, float height) const
+{
+    StoreHeights(solution, index, 1, &height);
+}
+
+void Waves::InterpolateRow(const View& view, int i, float alpha, float* heights) const
+{
+    thread_local std::vector<float> scratch;
+    if (mPrecision != StoragePrecision::Float32 && scratch.size() < 2 * static_cast<size_t>(mNumberOfColumns))
+        scratch.resize(2 * static_cast<size_t>(mNumberOfColumns));
+
+    const float* previous = LoadHeights(view.Previous, i * mNumberOfColumns, mNumberOfColumns, scratch.data());
+    const float* current = LoadHeights(view.Current, i * mNumberOfColumns, mNumberOfColumns, scratch.data() + mNumberOfColumns);
+
+    int j = 0;
+    for (; j + 4 <= mNumberOfColumns; j += 4)
+    {
+        XMVECTOR h0 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(previous + j));
+        XMVECTOR h1 = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(current + j));
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(heights + j), XMVectorLerp(h0, h1, alpha));
+    }
+    for (; j < mNumberOfColumns; j++)
+        heights[j] = previous[j] + alpha * (current[j] - previous[j]);
+}
+
+// Lit les hauteurs de 8 sommets d'une solution, quel que soit son format de stockage.
+// Les lectures 16 bits peuvent déborder de 2 octets après le dernier sommet, d'où le remplissage en fin de solution.
+static Simd::Float8 GatherHeights(const std::uint8_t* solution, Simd::Int8 indices, Waves::StoragePrecision precision, float fixedScale)
+{
+    switch (precision)
+    {
+    case Waves::StoragePrecision::Float16:
+        return Simd::GatherHalf(reinterpret_cast<const std::uint16_t*>(solution), indices);
+    case Waves::StoragePrecision::Fixed16:
+        return Simd::ToFloat(Simd::GatherInt16(reinterpret_cast<const std::int16_t*>(solution), indices)) * Simd::Float8(fixedScale);
+    default:
+        return Simd::Gather(reinterpret_cast<const float*>(solution), indices);
+    }
+}
+
+void Waves::SampleSurface(const float* x, const float* z, size_t count, float* heights, XMFLOAT3* normals, float alpha) const
+{
+    alpha = DirectXMathUtils::Clamp(alpha, 0.0f, 1.0f);
+    const View view = ReadView();
+
+    // Les requêtes sont traitées par blocs indépendants, en parallèle dès qu'il y en a plus d'un.
+    constexpr size_t BlockSize = 2048;
+    const int blockCount = static_cast<int>((count + BlockSize - 1) / BlockSize);
+    auto sampleBlock = [&](int block)
+    {
+        const size_t begin = block * BlockSize;
+        const int sampleCount = static_cast<int>(DirectXMathUtils::Min(begin + BlockSize, count) - begin);
+        SampleBlock(view, x + begin, z + begin, sampleCount, alpha, heights + begin, normals != nullptr ? normals + begin : nullptr);
+    };
+
+    if (blockCount == 1)
+        sampleBlock(0);
+    else if (blockCount > 1)
+        ParallelUtils::For(0, blockCount, sampleBlock);
+}
+
+void Waves::SampleBlock(const View& view, const float* x, const float* z, int count, float alpha, float* heights, XMFLOAT3* normals) const
+{
+    constexpr int LaneCount = 8;
+    float laneX[LaneCount];
+    float laneZ[LaneCount];
+    float laneHeight[LaneCount];
+    float laneNormal[3][LaneCount];
+
+    using Simd::Float8;
+    using Simd::Int8;
+    const float invSpatialStep = 1.0f / mSpatialStep;
+    for (int k = 0; k < count; k += LaneCount)
+    {
+        // Le dernier groupe incomplet est complété en répétant la dernière requête.
+        const int laneCount = DirectXMathUtils::Min(LaneCount, count - k);
+        for (int lane = 0; lane < LaneCount; lane++)
+        {
+            laneX[lane] = x[k + DirectXMathUtils::Min(lane, laneCount - 1)];
+            laneZ[lane] = z[k + DirectXMathUtils::Min(lane, laneCount - 1)];
+        }
+
+        // Coordonnées dans la grille, ramenées sur la grille, puis cellule (i0, j0) et position (fx, fz) dans la cellule.
+        const Float8 column = Simd::Min(Simd::Max((Float8::Load(laneX) + Float8(mHalfWidth)) * Float8(invSpatialStep), Float8(0.0f)), Float8(static_cast<float>(mNumberOfColumns - 1)));
+        const Float8 row = Simd::Min(Simd::Max((Float8(mHalfDepth) - Float8::Load(laneZ)) * Float8(invSpatialStep), Float8(0.0f)), Float8(static_cast<float>(mNumberOfRows - 1)));
+        const Float8 j0 = Simd::Min(Simd::Floor(column), Float8(static_cast<float>(mNumberOfColumns - 2)));
+        const Float8 i0 = Simd::Min(Simd::Floor(row), Float8(static_cast<float>(mNumberOfRows - 2)));
+        const Float8 fx = column - j0;
+        const Float8 fz = row - i0;
+
+        const Int8 index00 = Simd::MulLow(Simd::TruncateToInt(i0), Int8(mNumberOfColumns)) + Simd::TruncateToInt(j0);
+        const Int8 index01 = index00 + Int8(1);
+        const Int8 index10 = index00 + Int8(mNumberOfColumns);
+        const Int8 index11 = index10 + Int8(1);
+
+        Float8 h00 = GatherHeights(view.Current, index00, mPrecision, mFixedScale);
+        Float8 h01 = GatherHeights(view.Current, index01, mPrecision, mFixedScale);
+        Float8 h10 = GatherHeights(view.Current, index10, mPrecision, mFixedScale);
+        Float8 h11 = GatherHeights(view.Current, index11, mPrecision, mFixedScale);
+        if (alpha < 1.0f)
+        {
+            const Float8 a(alpha);
+            const Float8 p00 = GatherHeights(view.Previous, index00, mPrecision, mFixedScale);
+            const Float8 p01 = GatherHeights(view.Previous, index01, mPrecision, mFixedScale);
+            const Float8 p10 = GatherHeights(view.Previous, index10, mPrecision, mFixedScale);
+            const Float8 p11 = GatherHeights(view.Previous, index11, mPrecision, mFixedScale);
+            h00 = Simd::MulAdd(h00 - p00, a, p00);
+            h01 = Simd::MulAdd(h01 - p01, a, p01);
+            h10 = Simd::MulAdd(h10 - p10, a, p10);
+            h11 = Simd::MulAdd(h11 - p11, a, p11);
+        }
+
+        const Float8 top = Simd::MulAdd(h01 - h00, fx, h00);
+        const Float8 bottom = Simd::MulAdd(h11 - h10, fx, h10);
+        Simd::MulAdd(bottom - top, fz, top).Store(laneHeight);
+
+        if (normals != nullptr)
+        {
+            // Dérivées de la surface bilinéaire le long des colonnes (x) et des lignes (-z), la normale vaut normalize(-dh/dx, 1, -dh/dz).
+            const Float8 dhdj = Simd::MulAdd((h11 - h10) - (h01 - h00), fz, h01 - h00);
+            const Float8 dhdi = Simd::MulAdd((h11 - h01) - (h10 - h00), fx, h10 - h00);
+            const Float8 nx = dhdj * Float8(-invSpatialStep);
+            const Float8 nz = dhdi * Float8(invSpatialStep);
+            const Float8 invLength = Float8(1.0f) / Simd::Sqrt(Simd::MulAdd(nx, nx, Simd::MulAdd(nz, nz, Float8(1.0f))));
+            (nx * invLength).Store(laneNormal[0]);
+            invLength.Store(laneNormal[1]);
+            (nz * invLength).Store(laneNormal[2]);
+        }
+
+        memcpy(heights + k, laneHeight, laneCount * sizeof(float));
+        if (normals != nullptr)
+        {
+            for (int lane = 0; lane < laneCount; lane++)
+                normals[k + lane] = XMFLOAT3(laneNormal[0][lane], laneNormal[1][lane], laneNormal[2][lane]);
+        }
+    }
+}
+
+void Waves::CopyRowToChunks(int i, const std::uint8_t* row, int jBegin, int jEnd, size_t vertexByteSize, std::uint8_t* destination) const
+{
+    const int chunkVertexColumns = mChunkColumnSize + 1;
+    const size_t chunkByteSize = static_cast<size_t>(ChunkVertexCount()) * vertexByteSize;
+
+    // Le segment qui contient la dernière colonne s'étend sur les colonnes de remplissage du dernier bloc (déjà recopiées dans row).
+    if (jEnd == mNumberOfColumns)
+        jEnd = mChunkColumnCount * mChunkColumnSize + 1;
+
+    // La ligne i est la ligne locale i - chunkRow * ChunkRowSize() du bloc qui la contient, et aussi la dernière ligne du bloc du dessus
+    // si elle est sur la frontière. La dernière ligne de la grille remplit en plus les lignes de remplissage du dernier bloc.
+    const int homeChunkRow = DirectXMathUtils::Min(i / mChunkRowSize, mChunkRowCount - 1);
+    const int localRowBegin = i - homeChunkRow * mChunkRowSize;
+    const int localRowEnd = i == mNumberOfRows - 1 ? mChunkRowSize + 1 : localRowBegin + 1;
+
+    auto copyToChunkRow = [&](int chunkRow, int localRow)
+    {
+        const int firstChunkColumn = jBegin > 0 ? (jBegin - 1) / mChunkColumnSize : 0;
+        const int lastChunkColumn = DirectXMathUtils::Min((jEnd - 1) / mChunkColumnSize, mChunkColumnCount - 1);
+        for (int chunkColumn = firstChunkColumn; chunkColumn <= lastChunkColumn; chunkColumn++)
+        {
+            const int chunkColumnBegin = chunkColumn * mChunkColumnSize;
+            const int j0 = DirectXMathUtils::Max(jBegin, chunkColumnBegin);
+            const int j1 = DirectXMathUtils::Min(jEnd, chunkColumnBegin + chunkVertexColumns);
+            if (j0 >= j1)
+                continue;
+
+            std::uint8_t* chunk = destination + (chunkRow * mChunkColumnCount + chunkColumn) * chunkByteSize;
+            const size_t localIndex = static_cast<size_t>(localRow) * chunkVertexColumns + (j0 - chunkColumnBegin);
+            MemoryUtils::StreamCopy(chunk + localIndex * vertexByteSize, row + j0 * vertexByteSize, (j1 - j0) * vertexByteSize);
+        }
+    };
+
+    for (int localRow = localRowBegin; localRow < localRowEnd; localRow++)
+        copyToChunkRow(homeChunkRow, localRow);
+    if (localRowBegin == 0 && homeChunkRow > 0)
+        copyToChunkRow(homeChunkRow - 1, mChunkRowSize);
+}
+
+template<typename WriteRow>
+void Waves::WriteRows(void* destination, size_t vertexByteSize, float alpha, std::uint64_t writtenStep, const WriteRow& writeRow) const
+{
+    alpha = DirectXMathUtils::Clamp(alpha, 0.0f, 1.0f);
+    const View view = ReadView();
+
+    // Une tuile doit être réécrite si elle est active (l'interpolation change à chaque frame) ou si elle a changé depuis writtenStep.
+    thread_local std::vector<std::uint8_t> dirtyTiles;
+    dirtyTiles.resize(mTileActive.size());
+    for (size_t tile = 0; tile < mTileActive.size(); tile++)
+        dirtyTiles[tile] = writtenStep == NeverWritten || view.TileActive[tile] != 0 || view.TileLastChange[tile] > writtenStep;
+
+    const std::uint8_t* dirty = dirtyTiles.data();
+    // Le buffer de ligne couvre aussi les colonnes de remplissage du dernier bloc.
+    const int paddedColumnCount = mChunkColumnCount * mChunkColumnSize + 1;
+    const size_t rowByteSize = paddedColumnCount * vertexByteSize;
+    std::uint8_t* output = static_cast<std::uint8_t*>(destination);
+
+    ParallelUtils::For(0, mNumberOfRows, [&](int i)
+    {
+        const std::uint8_t* dirtyRow = dirty + (i / TileSize) * mTileColumnCount;
+        if (std::find(dirtyRow, dirtyRow + mTileColumnCount, 1) == dirtyRow + mTileColumnCount)
+            return;
+
+        // Le buffer de ligne reste dans le cache du thread, seule la copie finale touche la mémoire write-combined.
+        thread_local std::vector<float> heights;
+        thread_local std::vector<std::uint8_t> row;
+        if (heights.size() < 3 * static_cast<size_t>(mNumberOfColumns))
+            heights.resize(3 * static_cast<size_t>(mNumberOfColumns));
+        if (row.size() < rowByteSize)
+            row.resize(rowByteSize);
+
+        float* above = heights.data();
+        float* center = above + mNumberOfColumns;
+        float* below = center + mNumberOfColumns;
+        InterpolateRow(view, i, alpha, center);
+        if (i > 0)
+            InterpolateRow(view, i - 1, alpha, above);
+        if (i < mNumberOfRows - 1)
+            InterpolateRow(view, i + 1, alpha, below);
+
+        // Les tuiles sales consécutives sont regroupées pour garder des écritures séquentielles les plus longues possibles.
+        for (int tileColumn = 0; tileColumn < mTileColumnCount; tileColumn++)
+        {
+            if (dirtyRow[tileColumn] == 0)
+                continue;
+
+            const int jBegin = tileColumn * TileSize;
+            while (tileColumn + 1 < mTileColumnCount && dirtyRow[tileColumn + 1] != 0)
+                tileColumn++;
+            const int jEnd = DirectXMathUtils::Min((tileColumn + 1) * TileSize, mNumberOfColumns);
+
+            writeRow(i, above, center, below, row.data(), jBegin, jEnd);
+
+            if (jEnd == mNumberOfColumns)
+            {
+                const std::uint8_t* lastVertex = row.data() + (mNumberOfColumns - 1) * vertexByteSize;
+                for (int j = mNumberOfColumns; j < paddedColumnCount; j++)
+                    memcpy(row.data() + j * vertexByteSize, lastVertex, vertexByteSize);
+            }
+
+            CopyRowToChunks(i, row.data(), jBegin, jEnd, vertexByteSize, output);
+        }
+    });
+}
+
+void Waves::Interpolate(float alpha, XMFLOAT3* positions, XMFLOAT3* normals) const
+{
+    alpha = DirectXMathUtils::Clamp(alpha, 0.0f, 1.0f);
+    const View view = ReadView();
+
+    ParallelUtils::For(0, mNumberOfRows, [&](int i)
+    {
+        thread_local std::vector<float> heights;
+        if (heights.size() < 3 * static_cast<size_t>(mNumberOfColumns))
+            heights.resize(3 * static_cast<size_t>(mNumberOfColumns));
+
+        float* above = heights.data();
+        float* center = above + mNumberOfColumns;
+        float* below = center + mNumberOfColumns;
+        InterpolateRow(view, i, alpha, center);
+        if (i > 0)
+            InterpolateRow(view, i - 1, alpha, above);
+        if (i < mNumberOfRows - 1)
+            InterpolateRow(view, i + 1, alpha, below);
+
+        // Les normales sont recalculées à partir des hauteurs interpolées, ce qui évite de garder les normales de l'étape précédente.
+        const TransformUtils::Float3Array rowNormals = ComputeRowNormals(i, above, center, below, 0, mNumberOfColumns);
+        for (int j = 0; j < mNumberOfColumns; j++)
+        {
+            const int index = i * mNumberOfColumns + j;
+            positions[index] = XMFLOAT3(-mHalfWidth + j * mSpatialStep, center[j], mHalfDepth - i * mSpatialStep);
+            normals[index] = XMFLOAT3(rowNormals.X[j], rowNormals.Y[j], rowNormals.Z[j]);
+        }
+    });
+}
 
-    Concurrency::parallel_for(1, mNumberOfRows - 1, [this](int i)
+void Waves::WriteVertices(void* destination, const VertexLayout& layout, float alpha, std::uint64_t writtenStep) const
+{
+    WriteRows(destination, layout.Stride, alpha, writtenStep, [&](int i, const float* above, const float* center, const float* below, std::uint8_t* row, int jBegin, int jEnd)
     {
-        for (int j = 1; j < mNumberOfColumns - 1; ++j)
+        const float z = mHalfDepth - i * mSpatialStep;
+        const TransformUtils::Float3Array normals = ComputeRowNormals(i, above, center, below, jBegin, jEnd);
+        for (int j = jBegin; j < jEnd; j++)
         {
-            float l = mCurrentSolution[i * mNumberOfColumns + j - 1].y;
-            float r = mCurrentSolution[i * mNumberOfColumns + j + 1].y;
-            float t = mCurrentSolution[(i - 1) * mNumberOfColumns + j].y;
-            float b = mCurrentSolution[(i + 1) * mNumberOfColumns + j].y;
-            mNormals[i * mNumberOfColumns + j].x = -r + l;
-            mNormals[i * mNumberOfColumns + j].y = 2.0f * mSpatialStep;
-            mNormals[i * mNumberOfColumns + j].z = b - t;
+            std::uint8_t* vertex = row + static_cast<size_t>(j) * layout.Stride;
+
+            XMFLOAT3 position(-mHalfWidth + j * mSpatialStep, center[j], z);
+            XMFLOAT3 normal(normals.X[j - jBegin], normals.Y[j - jBegin], normals.Z[j - jBegin]);
 
-            XMVECTOR n = XMVector3Normalize(XMLoadFloat3(&mNormals[i * mNumberOfColumns + j]));
-            XMStoreFloat3(&mNormals[i * mNumberOfColumns + j], n);
+            memcpy(vertex + layout.PositionOffset, &position, sizeof(XMFLOAT3));
+            memcpy(vertex + layout.NormalOffset, &normal, sizeof(XMFLOAT3));
+        }
+    });
+}
 
-            mTangentX[i * mNumberOfColumns + j] = XMFLOAT3(2.0f * mSpatialStep, r - l, 0.0f);
-            XMVECTOR T = XMVector3Normalize(XMLoadFloat3(&mTangentX[i * mNumberOfColumns + j]));
-            XMStoreFloat3(&mTangentX[i * mNumberOfColumns + j], T);
+void Waves::WriteCompactVertices(CompactVertex* destination, float alpha, std::uint64_t writtenStep) const
+{
+    WriteRows(destination, sizeof(CompactVertex), alpha, writtenStep, [&](int i, const float* above, const float* center, const float* below, std::uint8_t* row, int jBegin, int jEnd)
+    {
+        CompactVertex* vertices = reinterpret_cast<CompactVertex*>(row);
+        const TransformUtils::Float3Array normals = ComputeRowNormals(i, above, center, below, jBegin, jEnd);
+        for (int j = jBegin; j < jEnd; j++)
+        {
+            vertices[j].Height = center[j];
+            vertices[j].PackedNormal = PackNormal(XMFLOAT3(normals.X[j - jBegin], normals.Y[j - jBegin], normals.Z[j - jBegin]));
         }
     });
 }
 
+void Waves::WriteHeights(float* destination, float alpha, std::uint64_t writtenStep) const
+{
+    // Ici les normales sont calculées dans le vertex shader à partir des hauteurs voisines, seule la ligne courante est utile.
+    WriteRows(destination, sizeof(float), alpha, writtenStep, [&](int /*i*/, const float* /*above*/, const float* center, const float* /*below*/, std::uint8_t* row, int jBegin, int jEnd)
+    {
+        memcpy(row + jBegin * sizeof(float), center + jBegin, (jEnd - jBegin) * sizeof(float));
+    });
+}
+
+std::uint32_t Waves::PackNormal(const XMFLOAT3& normal)
+{
+    // Même encodage que DXGI_FORMAT_R16G16_SNORM : x dans les 16 bits de poids faible, z dans les 16 bits de poids fort.
+    std::int16_t x = static_cast<std::int16_t>(DirectXMathUtils::Clamp(normal.x, -1.0f, 1.0f) * 32767.0f + (normal.x >= 0.0f ? 0.5f : -0.5f));
+    std::int16_t z = static_cast<std::int16_t>(DirectXMathUtils::Clamp(normal.z, -1.0f, 1.0f) * 32767.0f + (normal.z >= 0.0f ? 0.5f : -0.5f));
+    return static_cast<std::uint16_t>(x) | (static_cast<std::uint32_t>(static_cast<std::uint16_t>(z)) << 16);
+}
+
 void Waves::Disturb(int i, int j, float magnitude)
 {
-    // Ne pas troubler les frontires / bordures
+    assert(!IsAsync());
+
+    // Ne pas troubler les frontières / bordures
     assert(i > 1 && i < mNumberOfRows - 2);
     assert(j > 1 && j < mNumberOfColumns - 2);
 
     float halfMagnitude = 0.5f * magnitude;
 
-    // On trouble la hauteur du i/j me sommet et ses voisins.
-    mCurrentSolution[i * mNumberOfColumns + j].y += magnitude;
-    mCurrentSolution[i * mNumberOfColumns + j + 1].y += halfMagnitude;
-    mCurrentSolution[i * mNumberOfColumns + j - 1].y += halfMagnitude;
-    mCurrentSolution[(i + 1) * mNumberOfColumns + j].y += halfMagnitude;
-    mCurrentSolution[(i - 1) * mNumberOfColumns + j].y += halfMagnitude;
+    // On trouble la hauteur du i/j ème sommet et ses voisins.
+    auto add = [this](int index, float value) { StoreHeight(mCurrentSolution.data(), index, LoadHeight(mCurrentSolution.data(), index) + value); };
+    add(i * mNumberOfColumns + j, magnitude);
+    add(i * mNumberOfColumns + j + 1, halfMagnitude);
+    add(i * mNumberOfColumns + j - 1, halfMagnitude);
+    add((i + 1) * mNumberOfColumns + j, halfMagnitude);
+    add((i - 1) * mNumberOfColumns + j, halfMagnitude);
+
+    WakeTilesAround(i, j);
+
+    // Les hauteurs changent sans nouvelle étape, les attributs déjà calculés autour de (i, j) ne sont plus valides.
+    for (int tileRow = (i - 2) / TileSize; tileRow <= (i + 2) / TileSize; tileRow++)
+    {
+        for (int tileColumn = (j - 2) / TileSize; tileColumn <= (j + 2) / TileSize; tileColumn++)
+        {
+            if (tileRow < mTileRowCount && tileColumn < mTileColumnCount)
+            {
+                mTileNormalStep[tileRow * mTileColumnCount + tileColumn] = NeverWritten;
+                mTileTangentStep[tileRow * mTileColumnCount + tileColumn] = NeverWritten;
+            }
+        }
+    }
+}
+
+void Waves::Disturb(const Disturbance* disturbances, size_t count)
+{
+    if (!IsAsync())
+    {
+        mPendingDisturbances.insert(mPendingDisturbances.end(), disturbances, disturbances + count);
+        return;
+    }
+
+    // Si la file est pleine, le reste attend le prochain Update plutôt que de bloquer le thread principal.
+    const size_t pushed = mOverflowDisturbances.empty() ? mDisturbanceQueue->Push(disturbances, count) : 0;
+    mOverflowDisturbances.insert(mOverflowDisturbances.end(), disturbances + pushed, disturbances + count);
+}
+
+bool Waves::DisturbanceRange(const Disturbance& disturbance, int& rowBegin, int& rowEnd, int& columnBegin, int& columnEnd) const
+{
+    if (disturbance.Radius <= 0.0f)
+        return false;
+
+    // Sommets couverts par le disque de l'impact, limités à l'intérieur de la grille.
+    const float column = (disturbance.X + mHalfWidth) / mSpatialStep;
+    const float row = (mHalfDepth - disturbance.Z) / mSpatialStep;
+    const float radius = disturbance.Radius / mSpatialStep;
+    rowBegin = DirectXMathUtils::Max(static_cast<int>(ceilf(row - radius)), 1);
+    rowEnd = DirectXMathUtils::Min(static_cast<int>(floorf(row + radius)) + 1, mNumberOfRows - 1);
+    columnBegin = DirectXMathUtils::Max(static_cast<int>(ceilf(column - radius)), 1);
+    columnEnd = DirectXMathUtils::Min(static_cast<int>(floorf(column + radius)) + 1, mNumberOfColumns - 1);
+
+    return rowBegin < rowEnd && columnBegin < columnEnd;
+}
+
+void Waves::SplatRow(int i, int columnBegin, int columnEnd, const Disturbance& disturbance)
+{
+    // Les hauteurs du segment sont lues en float, indexées à partir de columnBegin.
+    thread_local std::vector<float> scratch;
+    if (scratch.size() < static_cast<size_t>(columnEnd - columnBegin))
+        scratch.resize(columnEnd - columnBegin);
+    float* heights = LoadHeights(mCurrentSolution.data(), i * mNumberOfColumns + columnBegin, columnEnd - columnBegin, scratch.data());
+
+    const float invRadiusSquared = 1.0f / (disturbance.Radius * disturbance.Radius);
+    const float dz = mHalfDepth - i * mSpatialStep - disturbance.Z;
+    const float x0 = -mHalfWidth - disturbance.X;
+
+    const XMVECTOR spatialStep = XMVectorReplicate(mSpatialStep);
+    const XMVECTOR dzSquared = XMVectorReplicate(dz * dz);
+    const XMVECTOR invRadius = XMVectorReplicate(invRadiusSquared);
+    const XMVECTOR magnitude = XMVectorReplicate(disturbance.Magnitude);
+    const XMVECTOR one = XMVectorReplicate(1.0f);
+    const XMVECTOR offsets = XMVectorSet(0.0f, 1.0f, 2.0f, 3.0f);
+
+    int j = columnBegin;
+    for (; j + 4 <= columnEnd; j += 4)
+    {
+        XMVECTOR dx = XMVectorMultiplyAdd(XMVectorAdd(XMVectorReplicate(static_cast<float>(j)), offsets), spatialStep, XMVectorReplicate(x0));
+        XMVECTOR w = XMVectorSubtract(one, XMVectorMultiply(XMVectorMultiplyAdd(dx, dx, dzSquared), invRadius));
+        w = XMVectorMax(w, XMVectorZero());
+        XMVECTOR h = XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(heights + j - columnBegin));
+        XMStoreFloat4(reinterpret_cast<XMFLOAT4*>(heights + j - columnBegin), XMVectorMultiplyAdd(XMVectorMultiply(w, w), magnitude, h));
+    }
+    for (; j < columnEnd; j++)
+    {
+        const float dx = x0 + j * mSpatialStep;
+        const float w = DirectXMathUtils::Max(1.0f - (dx * dx + dz * dz) * invRadiusSquared, 0.0f);
+        heights[j - columnBegin] += disturbance.Magnitude * w * w;
+    }
+
+    StoreHeights(mCurrentSolution.data(), i * mNumberOfColumns + columnBegin, columnEnd - columnBegin, heights);
+}
+
+void Waves::ApplyDisturbances()
+{
+    if (mPendingDisturbances.empty())
+        return;
+
+    // Tri par comptage des impacts dans chaque tuile qu'ils touchent. Un impact à cheval sur plusieurs tuiles est découpé,
+    // chaque tuile n'écrit ensuite que ses propres sommets et les tuiles peuvent être traitées en parallèle sans conflit.
+    const int tileCount = mTileRowCount * mTileColumnCount;
+    mDisturbanceBinOffsets.assign(tileCount + 1, 0);
+    mDisturbedTiles.clear();
+
+    for (const Disturbance& disturbance : mPendingDisturbances)
+    {
+        int rowBegin, rowEnd, columnBegin, columnEnd;
+        if (!DisturbanceRange(disturbance, rowBegin, rowEnd, columnBegin, columnEnd))
+            continue;
+
+        for (int tileRow = rowBegin / TileSize; tileRow <= (rowEnd - 1) / TileSize; tileRow++)
+            for (int tileColumn = columnBegin / TileSize; tileColumn <= (columnEnd - 1) / TileSize; tileColumn++)
+                mDisturbanceBinOffsets[tileRow * mTileColumnCount + tileColumn + 1]++;
+
+        // Comme pour Disturb, les tuiles qui bordent l'impact sont aussi réveillées pour que la vague parte dès la première étape.
+        for (int tileRow = (rowBegin - 1) / TileSize; tileRow <= rowEnd / TileSize; tileRow++)
+            for (int tileColumn = (columnBegin - 1) / TileSize; tileColumn <= columnEnd / TileSize; tileColumn++)
+                WakeTile(tileRow, tileColumn);
+    }
+
+    for (int tile = 0; tile < tileCount; tile++)
+    {
+        if (mDisturbanceBinOffsets[tile + 1] > 0)
+            mDisturbedTiles.push_back(tile);
+        mDisturbanceBinOffsets[tile + 1] += mDisturbanceBinOffsets[tile];
+    }
+
+    mDisturbanceBins.resize(mDisturbanceBinOffsets[tileCount]);
+    std::vector<int> cursors(mDisturbanceBinOffsets.begin(), mDisturbanceBinOffsets.end() - 1);
+    for (int k = 0; k < static_cast<int>(mPendingDisturbances.size()); k++)
+    {
+        int rowBegin, rowEnd, columnBegin, columnEnd;
+        if (!DisturbanceRange(mPendingDisturbances[k], rowBegin, rowEnd, columnBegin, columnEnd))
+            continue;
+
+        for (int tileRow = rowBegin / TileSize; tileRow <= (rowEnd - 1) / TileSize; tileRow++)
+            for (int tileColumn = columnBegin / TileSize; tileColumn <= (columnEnd - 1) / TileSize; tileColumn++)
+                mDisturbanceBins[cursors[tileRow * mTileColumnCount + tileColumn]++] = k;
+    }
+
+    ParallelUtils::For(0, static_cast<int>(mDisturbedTiles.size()), [this](int k)
+    {
+        const int tile = mDisturbedTiles[k];
+        const int tileRowBegin = (tile / mTileColumnCount) * TileSize;
+        const int tileColumnBegin = (tile % mTileColumnCount) * TileSize;
+
+        for (int b = mDisturbanceBinOffsets[tile]; b < mDisturbanceBinOffsets[tile + 1]; b++)
+        {
+            const Disturbance& disturbance = mPendingDisturbances[mDisturbanceBins[b]];
+
+            int rowBegin, rowEnd, columnBegin, columnEnd;
+            DisturbanceRange(disturbance, rowBegin, rowEnd, columnBegin, columnEnd);
+            rowBegin = DirectXMathUtils::Max(rowBegin, tileRowBegin);
+            rowEnd = DirectXMathUtils::Min(rowEnd, tileRowBegin + TileSize);
+            columnBegin = DirectXMathUtils::Max(columnBegin, tileColumnBegin);
+            columnEnd = DirectXMathUtils::Min(columnEnd, tileColumnBegin + TileSize);
+
+            for (int i = rowBegin; i < rowEnd; i++)
+                SplatRow(i, columnBegin, columnEnd, disturbance);
+        }
+    });
+
+    mPendingDisturbances.clear();
 }
@@ -1,15 +1,58 @@
 #pragma once
 
 #include "Graphics/DirectXMathUtils.h"
+#include "Graphics/TransformUtils.h"
+#include "Utils/SpscQueue.h"
+#include "Utils/TripleBuffer.h"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
 #include <vector>
 
 class Waves
 {
 public:
-    Waves(int m, int n, float dx, float dt, float speed, float damping);
+    // Décrit où écrire la position et la normale dans un sommet de destination.
+    struct VertexLayout
+    {
+        std::uint32_t Stride = 0;
+        std::uint32_t PositionOffset = 0;
+        std::uint32_t NormalOffset = 0;
+    };
+
+    // Sommet compact : x et z sont reconstruits dans le shader à partir de l'indice du sommet.
+    // La normale est stockée en deux snorm16 (x, z), y est toujours positif pour la surface de l'eau.
+    struct CompactVertex
+    {
+        float Height = 0.0f;
+        std::uint32_t PackedNormal = 0;
+    };
+
+    // Impact à la surface de l'eau (goutte de pluie, sillage...), centré en (X, Z) dans le même repère que Position().
+    struct Disturbance
+    {
+        float X = 0.0f;
+        float Z = 0.0f;
+        float Radius = 0.0f;
+        float Magnitude = 0.0f;
+    };
+
+    // Format de stockage des hauteurs. Les calculs se font toujours en float, seules les lectures et écritures en mémoire convertissent :
+    // sur 16 bits la simulation lit et écrit deux fois moins de mémoire, et une tuile deux fois plus grande tient dans le cache.
+    enum class StoragePrecision
+    {
+        Float32,
+        Float16,    // Demi-flottant IEEE, converti avec F16C quand DirectXMath est compilé pour AVX2.
+        Fixed16     // Entier signé sur 16 bits, saturé à +/- heightRange.
+    };
+
+    Waves(int m, int n, float dx, float dt, float speed, float damping, StoragePrecision precision = StoragePrecision::Float32, float heightRange = 4.0f);
     Waves(const Waves& rhs) = delete;
     Waves& operator=(const Waves& rhs) = delete;
-    ~Waves() = default;
+    ~Waves();
 
     int RowCount() const { return mNumberOfRows; }
     int ColumnCount() const { return mNumberOfColumns; }
@@ -17,15 +60,159 @@ public:
     int TriangleCount() const { return mTriangleCount; }
     float Width() const { return mNumberOfColumns * mSpatialStep; }
     float Depth() const { return mNumberOfRows * mSpatialStep; }
+    float SpatialStep() const { return mSpatialStep; }
+    float HalfWidth() const { return mHalfWidth; }
+    float HalfDepth() const { return mHalfDepth; }
+    StoragePrecision Precision() const { return mPrecision; }
 
-    const XMFLOAT3& Position(int i) const { return mCurrentSolution[i]; }
+    // Seule la hauteur est simulée, x et z sont fixés par la grille.
+    XMFLOAT3 Position(int i) const { return XMFLOAT3(-mHalfWidth + (i % mNumberOfColumns) * mSpatialStep, LoadHeight(ReadView().Current, i), mHalfDepth - (i / mNumberOfColumns) * mSpatialStep); }
+    // Normales et tangentes ne sont plus calculées à chaque étape : elles le sont à la demande, par tuile, et gardées jusqu'à
+    // ce que les hauteurs autour de la tuile changent. Comme Position, elles suivent l'état publié (le dernier instantané en mode asynchrone) :
+    // RequestAttributes ne doit pas être appelé pendant un Update, ni depuis plusieurs threads à la fois.
+    enum Attribute : std::uint32_t
+    {
+        AttributeNormal = 1 << 0,
+        AttributeTangentX = 1 << 1,
+    };
+    // Calcule les attributs demandés pour les sommets [rowBegin, rowEnd) x [columnBegin, columnEnd), à appeler avant de lire une région entière.
+    void RequestAttributes(std::uint32_t attributes, int rowBegin, int rowEnd, int columnBegin, int columnEnd) const;
+    // Valeurs gardées par le dernier RequestAttributes qui couvrait le sommet i, sans aucun calcul.
     const XMFLOAT3& Normal(int i) const { return mNormals[i]; }
     const XMFLOAT3& TangentX(int i) const { return mTangentX[i]; }
 
-    void Update();
+    // Requêtes groupées sur la surface de l'eau pour le gameplay (flottaison, particules, collision de la caméra).
+    // Pour chaque position monde (x[k], z[k]), écrit la hauteur interpolée bilinéairement dans la cellule qui la contient et, si normals
+    // n'est pas nul, la normale de cette surface bilinéaire. Les positions hors de la grille sont ramenées sur son bord.
+    // La lecture se fait sur l'état publié (le dernier instantané en mode asynchrone) : plusieurs threads peuvent interroger la surface
+    // en même temps, tant qu'Update n'est pas appelé pendant ce temps. alpha interpole entre les deux dernières solutions comme pour le rendu.
+    void SampleSurface(const float* x, const float* z, size_t count, float* heights, XMFLOAT3* normals = nullptr, float alpha = 1.0f) const;
+
+    // La grille est découpée en tuiles de TileSize x TileSize sommets. Seules les tuiles actives sont simulées :
+    // une tuile s'endort quand sa hauteur et sa vitesse passent sous SleepThreshold, et se réveille par Disturb ou par ses voisines.
+    static constexpr int TileSize = 32;
+    int TileRowCount() const { return mTileRowCount; }
+    int TileColumnCount() const { return mTileColumnCount; }
+    int ActiveTileCount() const { return ReadView().ActiveTileCount; }
+    bool IsTileActive(int tile) const { return ReadView().TileActive[tile] != 0; }
+    // À appeler avant StartAsync : le thread de simulation lit le seuil sans synchronisation.
+    void SetSleepThreshold(float threshold)
+    {
+        assert(!IsAsync());
+        mSleepThreshold = threshold;
+    }
+
+    // Les sommets écrits pour le GPU sont rangés par blocs (chunks) de ChunkRowSize() x ChunkColumnSize() quads, les uns après les autres.
+    // Deux blocs voisins dupliquent leur ligne ou colonne commune, chaque bloc se dessine donc seul avec un index buffer 16 bits partagé.
+    // Les blocs du bord sont complétés en répétant la dernière ligne ou colonne de la grille (triangles dégénérés).
+    static constexpr int MaxChunkSize = 7 * TileSize;
+    int ChunkRowSize() const { return mChunkRowSize; }
+    int ChunkColumnSize() const { return mChunkColumnSize; }
+    int ChunkRowCount() const { return mChunkRowCount; }
+    int ChunkColumnCount() const { return mChunkColumnCount; }
+    int ChunkCount() const { return mChunkRowCount * mChunkColumnCount; }
+    int ChunkVertexCount() const { return (mChunkRowSize + 1) * (mChunkColumnSize + 1); }
+    size_t ChunkedVertexCount() const { return static_cast<size_t>(ChunkCount()) * ChunkVertexCount(); }
+
+    // Nombre d'étapes de simulation effectuées. Une destination qui a été écrite à l'étape N n'a besoin de recevoir
+    // que les tuiles modifiées depuis, voir le paramètre writtenStep des fonctions Write*.
+    static constexpr std::uint64_t NeverWritten = ~0ull;
+    std::uint64_t StepCount() const { return ReadView().StepCount; }
+
+    // Fraction du pas de temps écoulée depuis la dernière étape de simulation, utilisée pour interpoler au rendu.
+    float StepAlpha() const { return IsAsync() ? mAsyncAlpha : mAccumulatedTime / mTimeStep; }
+
+    // En mode asynchrone la simulation avance sur son propre thread, au rythme de dt en temps réel. Chaque étape est publiée
+    // dans un triple buffer : Update se contente alors de récupérer le dernier état publié, sans jamais attendre la simulation.
+    // Les impacts passés à Disturb(disturbances, count) sont transmis au thread par une file sans verrou.
+    void StartAsync();
+    void StopAsync();
+    bool IsAsync() const { return mWorker.joinable(); }
+
+    // Fait au plus un pas de simulation de dt, quand les deltaTime cumulés depuis le dernier pas l'atteignent.
+    // En mode asynchrone, récupère seulement le dernier état publié.
+    void Update(float deltaTime);
+    // Modifie directement la solution courante, uniquement en mode synchrone.
     void Disturb(int i, int j, float magnitude);
 
+    // Ajoute des impacts qui seront appliqués en parallèle au début de la prochaine étape de simulation.
+    // Chaque impact soulève l'eau de magnitude * (1 - r² / radius²)², les sommets du bord de la grille restent fixes.
+    void Disturb(const Disturbance* disturbances, size_t count);
+
+    // Écrit les positions et normales interpolées entre la solution précédente (alpha = 0) et la solution courante (alpha = 1).
+    // Les deux tableaux de sortie doivent contenir VertexCount() éléments.
+    void Interpolate(float alpha, XMFLOAT3* positions, XMFLOAT3* normals) const;
+
+    // Écrit directement les sommets interpolés dans une mémoire mappée (upload buffer), ligne par ligne et en un seul passage.
+    // La destination est rangée par blocs (voir ChunkRowSize) et doit contenir ChunkedVertexCount() sommets.
+    // Positions et normales sont calculées dans un buffer de ligne puis copiées avec des écritures séquentielles non-temporelles.
+    // Si writtenStep est donné, seules les tuiles actives ou modifiées depuis cette étape sont réécrites.
+    void WriteVertices(void* destination, const VertexLayout& layout, float alpha = 1.0f, std::uint64_t writtenStep = NeverWritten) const;
+
+    // Variantes compactes du flux de sommets : 8 octets (hauteur + normale compressée) ou 4 octets (hauteur seule) au lieu de 24.
+    void WriteCompactVertices(CompactVertex* destination, float alpha = 1.0f, std::uint64_t writtenStep = NeverWritten) const;
+    void WriteHeights(float* destination, float alpha = 1.0f, std::uint64_t writtenStep = NeverWritten) const;
+
+    static std::uint32_t PackNormal(const XMFLOAT3& normal);
+
 private:
+    // Ce que lisent Position, StepCount et les fonctions Write* : l'état de la simulation en mode synchrone,
+    // le dernier instantané publié en mode asynchrone.
+    struct View
+    {
+        const std::uint8_t* Previous = nullptr;
+        const std::uint8_t* Current = nullptr;
+        const std::uint8_t* TileActive = nullptr;
+        const std::uint64_t* TileLastChange = nullptr;
+        std::uint64_t StepCount = 0;
+        int ActiveTileCount = 0;
+    };
+
+    struct Snapshot
+    {
+        std::vector<std::uint8_t> Previous;
+        std::vector<std::uint8_t> Current;
+        std::vector<std::uint8_t> TileActive;
+        std::vector<std::uint64_t> TileLastChange;
+        std::uint64_t StepCount = 0;
+        int ActiveTileCount = 0;
+        std::chrono::steady_clock::time_point StepTime;
+    };
+
+    View ReadView() const;
+    void Publish(Snapshot& snapshot, bool copyAll) const;
+    void RunAsync();
+
+    void Step();
+    void WakeTile(int tileRow, int tileColumn);
+    void WakeTilesAround(int i, int j);
+    void SleepTile(int tile);
+    void UpdateActiveTiles();
+    void ApplyDisturbances();
+    bool DisturbanceRange(const Disturbance& disturbance, int& rowBegin, int& rowEnd, int& columnBegin, int& columnEnd) const;
+    void SplatRow(int i, int columnBegin, int columnEnd, const Disturbance& disturbance);
+    std::uint64_t LastChangeAround(const View& view, int tile) const;
+    void ComputeAttributes(const View& view, int tile, std::uint32_t attributes) const;
+    void InterpolateRow(const View& view, int i, float alpha, float* heights) const;
+    void SampleBlock(const View& view, const float* x, const float* z, int count, float alpha, float* heights, XMFLOAT3* normals) const;
+    XMFLOAT3 ComputeNormal(float l, float r, float t, float b) const;
+    // Normales de la ligne i sur [jBegin, jEnd) (indice 0 pour jBegin), normalisées par lot dans un tampon propre au thread appelant.
+    TransformUtils::Float3Array ComputeRowNormals(int i, const float* above, const float* center, const float* below, int jBegin, int jEnd) const;
+
+    // Hauteurs [index, index + count) d'une solution en float : un pointeur direct dans la solution en Float32, sinon une copie décodée dans scratch.
+    const float* LoadHeights(const std::uint8_t* solution, int index, int count, float* scratch) const;
+    float* LoadHeights(std::uint8_t* solution, int index, int count, float* scratch) const;
+    // Réécrit des hauteurs obtenues par LoadHeights, sans effet en Float32 où elles pointent déjà dans la solution.
+    void StoreHeights(std::uint8_t* solution, int index, int count, const float* heights) const;
+    float LoadHeight(const std::uint8_t* solution, int index) const;
+    void StoreHeight(std::uint8_t* solution, int index, float height) const;
+
+    // Appelle writeRow(i, above, row, below, output, jBegin, jEnd) pour chaque segment de ligne à écrire, avec les hauteurs interpolées
+    // des lignes voisines, puis copie le segment du buffer de ligne du thread vers les blocs de la destination qui le contiennent.
+    void CopyRowToChunks(int i, const std::uint8_t* row, int jBegin, int jEnd, size_t vertexByteSize, std::uint8_t* destination) const;
+    template<typename WriteRow>
+    void WriteRows(void* destination, size_t vertexByteSize, float alpha, std::uint64_t writtenStep, const WriteRow& writeRow) const;
+
     int mNumberOfRows = 0;
     int mNumberOfColumns = 0;
     int mVertexCount = 0;
@@ -37,9 +224,54 @@ private:
 
     float mTimeStep = 0.0f;
     float mSpatialStep = 0.0f;
+    float mHalfWidth = 0.0f;
+    float mHalfDepth = 0.0f;
+    float mAccumulatedTime = 0.0f;
+    float mSleepThreshold = 1e-3f;
+    std::uint64_t mStepCount = 0;
+
+    StoragePrecision mPrecision = StoragePrecision::Float32;
+    int mHeightByteSize = sizeof(float);
+    // En Fixed16 : hauteur = valeur entière * mFixedScale.
+    float mFixedScale = 1.0f;
+    float mInvFixedScale = 1.0f;
+
+    int mTileRowCount = 0;
+    int mTileColumnCount = 0;
+
+    int mChunkRowSize = 0;
+    int mChunkColumnSize = 0;
+    int mChunkRowCount = 0;
+    int mChunkColumnCount = 0;
+    std::vector<std::uint8_t> mTileActive;
+    std::vector<int> mActiveTiles;
+    // Étape à laquelle les hauteurs de chaque tuile ont changé pour la dernière fois.
+    std::vector<std::uint64_t> mTileLastChange;
+    // Maximum de |hauteur| et |vitesse| sur toute la tuile, puis sur chacun de ses quatre bords (haut, bas, gauche, droite).
+    std::vector<float> mTileActivity;
+    std::vector<XMFLOAT4> mTileEdgeActivity;
+
+    std::vector<Disturbance> mPendingDisturbances;
+    // Impacts rangés par tuile : ceux de la tuile t sont mDisturbanceBins[mDisturbanceBinOffsets[t]] à mDisturbanceBins[mDisturbanceBinOffsets[t + 1] - 1].
+    std::vector<int> mDisturbanceBinOffsets;
+    std::vector<int> mDisturbanceBins;
+    std::vector<int> mDisturbedTiles;
+
+    std::thread mWorker;
+    std::atomic<bool> mStopRequested { false };
+    TripleBuffer<Snapshot> mSnapshots;
+    std::unique_ptr<SpscQueue<Disturbance>> mDisturbanceQueue;
+    // Impacts qui n'ont pas trouvé de place dans la file, renvoyés au prochain Update.
+    std::vector<Disturbance> mOverflowDisturbances;
+    float mAsyncAlpha = 0.0f;
 
-    std::vector<XMFLOAT3> mPreviousSolution;
-    std::vector<XMFLOAT3> mCurrentSolution;
-    std::vector<XMFLOAT3> mNormals;
-    std::vector<XMFLOAT3> mTangentX;
+    // Hauteurs des deux dernières solutions, mHeightByteSize octets par sommet selon mPrecision.
+    // Quelques octets de plus en fin de tableau permettent de lire les hauteurs 16 bits par mots de 32 bits (voir SampleSurface).
+    std::vector<std::uint8_t> mPreviousSolution;
+    std::vector<std::uint8_t> mCurrentSolution;
+    // Caches des attributs calculés à la demande, avec pour chaque tuile l'étape à laquelle ils ont été calculés.
+    mutable std::vector<XMFLOAT3> mNormals;
+    mutable std::vector<XMFLOAT3> mTangentX;
+    mutable std::vector<std::uint64_t> mTileNormalStep;
+    mutable std::vector<std::uint64_t> mTileTangentStep;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Graphics/DescriptorHeap.h"
 #include "Graphics/DirectXMathUtils.h"
 #include "Graphics/UploadBuffer.h"
 
@@ -32,7 +33,7 @@ struct Vertex
     XMFLOAT4 Color;
 };
 
-// Permet de stocker les ressources ncessaires au CPU pour construire les listes de commande pour une frame.
+// Permet de stocker les ressources nécessaires au CPU pour construire les listes de commande pour une frame.
 struct FrameResource
 {
 public:
@@ -46,13 +47,15 @@ public:
     FrameResource(const FrameResource& rhs) = delete;
     FrameResource& operator=(const FrameResource& rhs) = delete;
 
-    // On ne peut pas rinitialiser l'allocateur tant que le GPU n'a pas fini de traiter les commandes. Donc chaque frame a son propre allocateur.
+    // On ne peut pas réinitialiser l'allocateur tant que le GPU n'a pas fini de traiter les commandes. Donc chaque frame a son propre allocateur.
     Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CommandListAllocator;
 
-    // On ne peut pas mettre  jour un constant buffer tant que le GPu n'a pas fini de traiter les commandes qui le rfrencent. Donc chaque frame a son propre cbuffer.
+    // On ne peut pas mettre à jour un constant buffer tant que le GPu n'a pas fini de traiter les commandes qui le référencent. Donc chaque frame a son propre cbuffer.
     std::unique_ptr<UploadBuffer<PassConstants>> PassCB = nullptr;
     std::unique_ptr<UploadBuffer<ObjectConstants>> ObjectCB = nullptr;
+    // CBV persistant de chaque élément de ObjectCB, indexé par ObjCBIndex.
+    std::vector<DescriptorHeap::Handle> ObjectCbvs;
 
-    // Valeur de la barrire pour marquer les commandes jusqu' ce point. Cela nous permet de vrifier si ces ressources de frame sont toujours utilises par le GPU.
+    // Valeur de la barrière pour marquer les commandes jusqu'à ce point. Cela nous permet de vérifier si ces ressources de frame sont toujours utilisées par le GPU.
     UINT64 Fence = 0;
 };
\ No newline at end of file
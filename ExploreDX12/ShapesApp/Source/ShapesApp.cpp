@@ -11,13 +11,24 @@ ShapesApp::~ShapesApp()
 {
 	if (DirectX12::D3DDevice != nullptr)
 		DirectX12::FlushCommandQueue();
+
+	// Les vertex et index buffers rendent leur place au BufferHeap.
+	if (mUploadManager != nullptr)
+	{
+		mUploadManager->Flush();
+		for (auto& [name, geo] : mGeometries)
+		{
+			mUploadManager->ReleaseDefaultBuffer(geo->VertexBufferGPU);
+			mUploadManager->ReleaseDefaultBuffer(geo->IndexBufferGPU);
+		}
+	}
 }
 
 void ShapesApp::OnWindowResize()
 {
 	Application::OnWindowResize();
 
-	// Quand la fentre est resize, on doit mettre  jour l'aspect ratio et recalculer la matrice de projection.
+	// Quand la fenêtre est resize, on doit mettre à jour l'aspect ratio et recalculer la matrice de projection.
 	XMMATRIX P = XMMatrixPerspectiveFovLH(0.25f * DirectXMathUtils::Pi, WindowManager::AspectRatio(), 1.0f, 1000.0f);
 	XMStoreFloat4x4(&mProj, P);
 }
@@ -73,14 +84,9 @@ void ShapesApp::Update()
 	mCurrentFrameResourceIndex = (mCurrentFrameResourceIndex + 1) % DirectX12::NumberOfFrameResources;
 	mCurrentFrameResource = mFrameResources[mCurrentFrameResourceIndex].get();
 
-	// Est-ce que le GPU a fini de traiter les commandes de la frame resource courante ? Si ce n'est pas le cas, on attend que le GPU ait fini de traiter les commandes jusqu' cette barrire.
-	if (mCurrentFrameResource->Fence != 0 && DirectX12::Fence->GetCompletedValue() < mCurrentFrameResource->Fence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, nullptr, false, EVENT_ALL_ACCESS);
-		ThrowIfFailed(DirectX12::Fence->SetEventOnCompletion(mCurrentFrameResource->Fence, eventHandle));
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	// Est-ce que le GPU a fini de traiter les commandes de la frame resource courante ? Si ce n'est pas le cas, on attend que le GPU ait fini de traiter les commandes jusqu'à cette barrière.
+	DirectX12::WaitForFence(mCurrentFrameResource->Fence);
+	mCbvHeap->Retire(DirectX12::Fence->GetCompletedValue());
 
 	UpdateObjectCBs();
 	UpdateMainPassCB();
@@ -95,11 +101,11 @@ void ShapesApp::Draw()
 
 	if (mIsWireframe)
 	{
-		ThrowIfFailed(DirectX12::CommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque_wireframe"].Get()));
+		ThrowIfFailed(DirectX12::CommandList->Reset(cmdListAlloc.Get(), mPipelineStates->Get(mPSOs["opaque_wireframe"])));
 	}
 	else
 	{
-		ThrowIfFailed(DirectX12::CommandList->Reset(cmdListAlloc.Get(), mPSOs["opaque"].Get()));
+		ThrowIfFailed(DirectX12::CommandList->Reset(cmdListAlloc.Get(), mPipelineStates->Get(mPSOs["opaque"])));
 	}
 
 	DirectX12::CommandList->RSSetViewports(1, &DirectX12::ScreenViewport);
@@ -114,16 +120,18 @@ void ShapesApp::Draw()
 	DirectX12::CommandList->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 	DirectX12::CommandList->OMSetRenderTargets(1, &cbbv, true, &dsv);
 
-	ID3D12DescriptorHeap* descriptorHeaps[] = { mCbvHeap.Get() };
+	ID3D12DescriptorHeap* descriptorHeaps[] = { mCbvHeap->Resource() };
 	DirectX12::CommandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
 	DirectX12::CommandList->SetGraphicsRootSignature(mRootSignature.Get());
 
-	// On calcule l'index du cbv de la passe en fonction de la frame resource.
-	int passCbvIndex = mPassCbvOffset + mCurrentFrameResourceIndex;
-	CD3DX12_GPU_DESCRIPTOR_HANDLE passCbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mCbvHeap->GetGPUDescriptorHandleForHeapStart());
-	passCbvHandle.Offset(passCbvIndex, DirectX12::CbvSrvUavDescriptorSize);
-	DirectX12::CommandList->SetGraphicsRootDescriptorTable(1, passCbvHandle);
+	// Le CBV de la passe est réécrit à chaque frame dans un descripteur transitoire, rendu quand la frame est terminée.
+	DescriptorHeap::Handle passCbv = mCbvHeap->AllocateTransient();
+	D3D12_CONSTANT_BUFFER_VIEW_DESC passCbvDesc;
+	passCbvDesc.BufferLocation = mCurrentFrameResource->PassCB->Resource()->GetGPUVirtualAddress();
+	passCbvDesc.SizeInBytes = DirectXUtils::CalcConstantBufferByteSize(sizeof(PassConstants));
+	DirectX12::D3DDevice->CreateConstantBufferView(&passCbvDesc, passCbv.CpuHandle());
+	DirectX12::CommandList->SetGraphicsRootDescriptorTable(1, passCbv.GpuHandle());
 
 	DrawRenderItems(DirectX12::CommandList.Get(), mOpaqueRitems);
 
@@ -141,6 +149,7 @@ void ShapesApp::Draw()
 	mCurrentFrameResource->Fence = ++DirectX12::CurrentFence;
 
 	DirectX12::CommandQueue->Signal(DirectX12::Fence.Get(), DirectX12::CurrentFence);
+	mCbvHeap->FinishFrame(DirectX12::CurrentFence);
 }
 
 void ShapesApp::UpdateCamera()
@@ -160,22 +169,17 @@ void ShapesApp::UpdateCamera()
 
 void ShapesApp::UpdateObjectCBs()
 {
-	UploadBuffer<ObjectConstants>* currentObjectCB = mCurrentFrameResource->ObjectCB.get();
-	for (const std::unique_ptr<RenderItem>& e : mAllRitems)
+	// On ne met à jour les données du cbuffer que pour les objets modifiés depuis la dernière utilisation de cette frame resource,
+	// directement dans le buffer mappé et par suites d'indices consécutifs.
+	const UploadBuffer<ObjectConstants>::ElementSpan objectConstants = mCurrentFrameResource->ObjectCB->Elements();
+	mObjectsDirty.ConsumeRuns(mCurrentFrameResourceIndex, [&](size_t first, size_t count)
 	{
-		// On ne met  jour les donnes du cbuffer que si les constantes ont chang.
-		// Attention : cela doit tre suivi pour chaque frame ressource.
-		if (e->NumFramesDirty > 0)
+		for (size_t i = first; i < first + count; i++)
 		{
-			XMMATRIX world = XMLoadFloat4x4(&e->World);
-			ObjectConstants objConstants;
-			XMStoreFloat4x4(&objConstants.World, XMMatrixTranspose(world));
-			currentObjectCB->CopyData(e->ObjCBIndex, objConstants);
-
-			// Le prochain FrameResource doit aussi tre mis  jour.
-			e->NumFramesDirty--;
+			XMMATRIX world = XMLoadFloat4x4(&mAllRitems[i]->World);
+			XMStoreFloat4x4(&objectConstants[(UINT)i].World, XMMatrixTranspose(world));
 		}
-	}
+	});
 }
 
 void ShapesApp::UpdateMainPassCB()
@@ -216,10 +220,6 @@ void ShapesApp::UpdateMainPassCB()
 
 void ShapesApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::vector<RenderItem*>& ritems)
 {
-	UINT objCBByteSize = DirectXUtils::CalcConstantBufferByteSize(sizeof(ObjectConstants));
-
-	ID3D12Resource* objectCB = mCurrentFrameResource->ObjectCB->Resource();
-
 	for (RenderItem* ri : ritems)
 	{
 		D3D12_VERTEX_BUFFER_VIEW vbv = ri->Geo->VertexBufferView();
@@ -228,11 +228,7 @@ void ShapesApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::v
 		cmdList->IASetIndexBuffer(&ibv);
 		cmdList->IASetPrimitiveTopology(ri->PrimitiveType);
 
-		UINT cbvIndex = mCurrentFrameResourceIndex * (UINT)mOpaqueRitems.size() + ri->ObjCBIndex;
-		CD3DX12_GPU_DESCRIPTOR_HANDLE cbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(mCbvHeap->GetGPUDescriptorHandleForHeapStart());
-		cbvHandle.Offset(cbvIndex, DirectX12::CbvSrvUavDescriptorSize);
-
-		cmdList->SetGraphicsRootDescriptorTable(0, cbvHandle);
+		cmdList->SetGraphicsRootDescriptorTable(0, mCurrentFrameResource->ObjectCbvs[ri->ObjCBIndex].GpuHandle());
 
 		cmdList->DrawIndexedInstanced(ri->IndexCount, 1, ri->StartIndexLocation, ri->BaseVertexLocation, 0);
 	}
@@ -240,18 +236,22 @@ void ShapesApp::DrawRenderItems(ID3D12GraphicsCommandList* cmdList, const std::v
 
 bool ShapesApp::Initialize()
 {
-    DirectX12::ResetCommandList();
+    mBufferHeap = std::make_unique<BufferHeap>(DirectX12::D3DDevice.Get(), BufferHeapByteSize);
+    mUploadManager = std::make_unique<UploadManager>(DirectX12::D3DDevice.Get(), UploadStagingByteSize, mBufferHeap.get());
+    mPipelineStates = std::make_unique<PipelineStateCache>(DirectX12::D3DDevice.Get(), "ShaderCache\\Pipelines.bin");
 
     BuildRootSignature();
     BuildShadersAndInputLayout();
+    // Les PSO (plein et fil de fer) sont compilés par les threads du cache pendant que le reste s'initialise.
+    BuildPSOs();
     BuildShapeGeometry();
     BuildRenderItems();
     BuildFrameResources();
     BuildDescriptorHeaps();
     BuildConstantBufferViews();
-    BuildPSOs();
 
-    DirectX12::ExecuteCommandsAndWait();
+    // La file graphique attend la fin des copies des géométries avant la première frame, sans bloquer le CPU.
+    mUploadManager->WaitOnQueue(DirectX12::CommandQueue.Get());
 
     return true;
 }
@@ -280,6 +280,7 @@ void ShapesApp::BuildRootSignature()
     ThrowIfFailed(hr);
    
     ThrowIfFailed(DirectX12::D3DDevice->CreateRootSignature(0, serializedRootSig->GetBufferPointer(), serializedRootSig->GetBufferSize(), IID_PPV_ARGS(mRootSignature.GetAddressOf())));
+    mPipelineStates->RegisterRootSignature(mRootSignature.Get(), serializedRootSig->GetBufferPointer(), serializedRootSig->GetBufferSize());
 }
 
 void ShapesApp::BuildShadersAndInputLayout()
@@ -301,7 +302,7 @@ void ShapesApp::BuildShapeGeometry()
 	GeometryGenerator::MeshData sphere = GeometryGenerator::CreateSphere(0.5f, 20, 20);
 	GeometryGenerator::MeshData cylinder = GeometryGenerator::CreateCylinder(0.5f, 0.3f, 3.0f, 20, 20);
 
-	// On concatne toutes les gomtries en un seul gros vertex/index buffer. Il faut donc dfinir les rgions que chaque buffer couvre.
+	// On concatène toutes les géométries en un seul gros vertex/index buffer. Il faut donc définir les régions que chaque buffer couvre.
 
 	UINT boxVertexOffset = 0;
 	UINT gridVertexOffset = (UINT)box.Vertices.size();
@@ -313,7 +314,7 @@ void ShapesApp::BuildShapeGeometry()
 	UINT sphereIndexOffset = gridIndexOffset + (UINT)grid.Indices32.size();
 	UINT cylinderIndexOffset = sphereIndexOffset + (UINT)sphere.Indices32.size();
 
-	// On dfini les SubmeshGeometry que couvre chaque tampon.
+	// On défini les SubmeshGeometry que couvre chaque tampon.
 	SubmeshGeometry boxSubmesh;
 	boxSubmesh.IndexCount = (UINT)box.Indices32.size();
 	boxSubmesh.StartIndexLocation = boxIndexOffset;
@@ -334,7 +335,7 @@ void ShapesApp::BuildShapeGeometry()
 	cylinderSubmesh.StartIndexLocation = cylinderIndexOffset;
 	cylinderSubmesh.BaseVertexLocation = cylinderVertexOffset;
 
-	// On extrait les sommets qui nous intressent et on les regroupe dans un seul buffer.
+	// On extrait les sommets qui nous intéressent et on les regroupe dans un seul buffer.
 
 	size_t totalVertexCount = box.Vertices.size() + grid.Vertices.size() + sphere.Vertices.size() + cylinder.Vertices.size();
 
@@ -383,8 +384,8 @@ void ShapesApp::BuildShapeGeometry()
 	ThrowIfFailed(D3DCreateBlob(ibByteSize, &geo->IndexBufferCPU));
 	CopyMemory(geo->IndexBufferCPU->GetBufferPointer(), indices.data(), ibByteSize);
 
-	geo->VertexBufferGPU = DirectXUtils::CreateDefaultBuffer(DirectX12::D3DDevice.Get(), DirectX12::CommandList.Get(), vertices.data(), vbByteSize, geo->VertexBufferUploader);
-	geo->IndexBufferGPU = DirectXUtils::CreateDefaultBuffer(DirectX12::D3DDevice.Get(), DirectX12::CommandList.Get(), indices.data(), ibByteSize, geo->IndexBufferUploader);
+	geo->VertexBufferGPU = mUploadManager->CreateDefaultBuffer(vertices.data(), vbByteSize);
+	geo->IndexBufferGPU = mUploadManager->CreateDefaultBuffer(indices.data(), ibByteSize);
 
 	geo->VertexByteStride = sizeof(Vertex);
 	geo->VertexBufferByteSize = vbByteSize;
@@ -476,6 +477,9 @@ void ShapesApp::BuildRenderItems()
 	// Tous les RenderItem sont opaques.
 	for (const std::unique_ptr<RenderItem>& e : mAllRitems)
 		mOpaqueRitems.push_back(e.get());
+
+	// Tous les objets sont à écrire une première fois dans chaque frame resource.
+	mObjectsDirty.Resize(mAllRitems.size());
 }
 
 void ShapesApp::BuildFrameResources()
@@ -486,20 +490,9 @@ void ShapesApp::BuildFrameResources()
 
 void ShapesApp::BuildDescriptorHeaps()
 {
-	UINT objCount = (UINT)mOpaqueRitems.size();
-
-	// On a besoin d'un descriptor CBV pour chaque objet par frame resource + 1 descriptor CBV pour la passe par frame resource.
-	UINT numDescriptors = (objCount + 1) * DirectX12::NumberOfFrameResources;
-
-	// On sauvegarde un offset pour le descriptor CBV de la passe (les 3 derniers).
-	mPassCbvOffset = objCount * DirectX12::NumberOfFrameResources;
-
-	D3D12_DESCRIPTOR_HEAP_DESC cbvHeapDesc;
-	cbvHeapDesc.NumDescriptors = numDescriptors;
-	cbvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	cbvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	cbvHeapDesc.NodeMask = 0;
-	ThrowIfFailed(DirectX12::D3DDevice->CreateDescriptorHeap(&cbvHeapDesc, IID_PPV_ARGS(&mCbvHeap)));
+	// Un seul heap pour toute l'application : les CBV des objets y sont persistants, celui de la passe transitoire.
+	// Ajouter des objets ne demande que de nouveaux descripteurs persistants, jamais de recréer le heap.
+	mCbvHeap = std::make_unique<DescriptorHeap>(DirectX12::D3DDevice.Get(), D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, PersistentDescriptorCount, TransientDescriptorCount);
 }
 
 void ShapesApp::BuildConstantBufferViews()
@@ -508,49 +501,25 @@ void ShapesApp::BuildConstantBufferViews()
 
 	UINT objCount = (UINT)mOpaqueRitems.size();
 
-	// On a besoin d'un descripteur CBV pour chaque objet de chaque frame resource.
+	// On a besoin d'un descripteur CBV pour chaque objet de chaque frame resource, rangé à l'indice ObjCBIndex de l'objet.
 	for (int frameIndex = 0; frameIndex < DirectX12::NumberOfFrameResources; frameIndex++)
 	{
-		// On accde  la ressource de l'upload buffer d'objet constants de la frame resource actuelle.
-		ID3D12Resource* objectCB = mFrameResources[frameIndex]->ObjectCB->Resource();
+		// On accède à la ressource de l'upload buffer d'objet constants de la frame resource actuelle.
+		FrameResource* frameResource = mFrameResources[frameIndex].get();
+		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = frameResource->ObjectCB->Resource()->GetGPUVirtualAddress();
 		for (UINT i = 0; i < objCount; ++i)
 		{
-			D3D12_GPU_VIRTUAL_ADDRESS cbAddress = objectCB->GetGPUVirtualAddress();
-
-			// On fait l'offset vers le ime buffer constant.
-			cbAddress += i * objCBByteSize;
-
-			// On calcule l'offset de l'objet CBV dans le tas de descripteur.
-			int heapIndex = frameIndex * objCount + i;
-			CD3DX12_CPU_DESCRIPTOR_HANDLE handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(mCbvHeap->GetCPUDescriptorHandleForHeapStart());
-			handle.Offset(heapIndex, DirectX12::CbvSrvUavDescriptorSize);
+			DescriptorHeap::Handle handle = mCbvHeap->AllocatePersistent();
 
+			// On fait l'offset vers le ième buffer constant.
 			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-			cbvDesc.BufferLocation = cbAddress;
+			cbvDesc.BufferLocation = cbAddress + i * objCBByteSize;
 			cbvDesc.SizeInBytes = objCBByteSize;
 
-			DirectX12::D3DDevice->CreateConstantBufferView(&cbvDesc, handle);
+			DirectX12::D3DDevice->CreateConstantBufferView(&cbvDesc, handle.CpuHandle());
+			frameResource->ObjectCbvs.push_back(handle);
 		}
 	}
-
-	UINT passCBByteSize = DirectXUtils::CalcConstantBufferByteSize(sizeof(PassConstants));
-
-	// Les trois derniers descripteurs sont des CBV de la "passe" pour chaque frame resource.
-	for (int frameIndex = 0; frameIndex < DirectX12::NumberOfFrameResources; frameIndex++)
-	{
-		ID3D12Resource* passCB = mFrameResources[frameIndex]->PassCB->Resource();
-		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = passCB->GetGPUVirtualAddress();
-
-		int heapIndex = mPassCbvOffset + frameIndex;
-		CD3DX12_CPU_DESCRIPTOR_HANDLE handle(mCbvHeap->GetCPUDescriptorHandleForHeapStart());
-		handle.Offset(heapIndex, DirectX12::CbvSrvUavDescriptorSize);
-
-		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-		cbvDesc.BufferLocation = cbAddress;
-		cbvDesc.SizeInBytes = passCBByteSize;
-
-		DirectX12::D3DDevice->CreateConstantBufferView(&cbvDesc, handle);
-	}
 }
 
 void ShapesApp::BuildPSOs()
@@ -573,9 +542,9 @@ void ShapesApp::BuildPSOs()
 	opaquePsoDesc.SampleDesc.Count = 1;
 	opaquePsoDesc.SampleDesc.Quality = 0;
 	opaquePsoDesc.DSVFormat = DirectX12::DepthStencilFormat;
-	ThrowIfFailed(DirectX12::D3DDevice->CreateGraphicsPipelineState(&opaquePsoDesc, IID_PPV_ARGS(&mPSOs["opaque"])));
+	mPSOs["opaque"] = mPipelineStates->Request(opaquePsoDesc);
 
 	D3D12_GRAPHICS_PIPELINE_STATE_DESC opaqueWireframePsoDesc = opaquePsoDesc;
 	opaqueWireframePsoDesc.RasterizerState.FillMode = D3D12_FILL_MODE_WIREFRAME;
-	ThrowIfFailed(DirectX12::D3DDevice->CreateGraphicsPipelineState(&opaqueWireframePsoDesc, IID_PPV_ARGS(&mPSOs["opaque_wireframe"])));
+	mPSOs["opaque_wireframe"] = mPipelineStates->Request(opaqueWireframePsoDesc);
 }
@@ -3,32 +3,32 @@
 #include "Application.h"
 #include "Graphics/MeshGeometry.h"
 #include "Graphics/GeometryGenerator.h"
+#include "Graphics/PipelineStateCache.h"
+#include "Graphics/UploadManager.h"
 #include "FrameResource.h"
+#include "Utils/DirtyTracker.h"
 
-// Structure lgre qui stocke les paramtres pour dessiner une forme. 
+// Structure légère qui stocke les paramètres pour dessiner une forme. 
 struct RenderItem
 {
     RenderItem() = default;
 
-    // Matrice monde de l'objet qui dcrit l'espace local de l'objet par rapport  l'espace monde.
-    // Elle dfinit la position, l'orientation et l'chelle de l'objet dans le monde.
+    // Matrice monde de l'objet qui décrit l'espace local de l'objet par rapport à l'espace monde.
+    // Elle définit la position, l'orientation et l'échelle de l'objet dans le monde.
+    // Parce qu'on a un objet cbuffer pour chaque FrameResource, une modification doit être appliquée à chaque FrameResource :
+    // on le signale avec ShapesApp::mObjectsDirty.MarkDirty(ObjCBIndex).
     XMFLOAT4X4 World = DirectXMathUtils::Identity4x4();
 
-    // Indicateur de modification indiquant que les donnes de l'objet ont chang et qu'on doit mettre  jour le constant buffer.
-    // Parce qu'on a un objet cbuffer pour chaque FrameResource, on doit appliquer la mise  jour  chaque FrameResource. 
-    // Donc, quand on modifie les donnes de l'objet, on doit dfinir NumFramesDirty = gNumFrameResources pour que chaque ressource de frame reoive la mise  jour.
-    int NumFramesDirty = DirectX12::NumberOfFrameResources;
-
-    // Indice dans le buffer constant GPU correspondant  l'ObjectCB pour ce render item.
+    // Indice dans le buffer constant GPU correspondant à l'ObjectCB pour ce render item, qui est aussi sa position dans mAllRitems.
     UINT ObjCBIndex = -1;
 
-    // Geometry associ  ce render item. Note : plusieurs render items peuvent partager la mme gomtrie.
+    // Geometry associé à ce render item. Note : plusieurs render items peuvent partager la même géométrie.
     MeshGeometry* Geo = nullptr;
 
     // Type de primitive.
     D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
-    // Paramtres de la fonction DrawIndexedInstanced.
+    // Paramètres de la fonction DrawIndexedInstanced.
     UINT IndexCount = 0;
     UINT StartIndexLocation = 0;
     int BaseVertexLocation = 0;
@@ -70,7 +70,13 @@ private:
     Microsoft::WRL::ComPtr<ID3D12RootSignature> mRootSignature = nullptr;
     std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3DBlob>> mShaders;
     std::vector<D3D12_INPUT_ELEMENT_DESC> mInputLayout;
+    // Déclaré avant les géométries, dont les buffers sont placés dans ses heaps.
+    static constexpr UINT64 BufferHeapByteSize = 4 * 1024 * 1024;
+    std::unique_ptr<BufferHeap> mBufferHeap = nullptr;
     std::unordered_map<std::string, std::unique_ptr<MeshGeometry>> mGeometries;
+    // Données initiales des géométries, envoyées par la file de copie.
+    static constexpr UINT64 UploadStagingByteSize = 1024 * 1024;
+    std::unique_ptr<UploadManager> mUploadManager = nullptr;
 
     std::vector<std::unique_ptr<FrameResource>> mFrameResources;
     FrameResource* mCurrentFrameResource = nullptr;
@@ -79,10 +85,15 @@ private:
 
     std::vector<std::unique_ptr<RenderItem>> mAllRitems;
     std::vector<RenderItem*> mOpaqueRitems;
-    std::unordered_map<std::string, Microsoft::WRL::ComPtr<ID3D12PipelineState>> mPSOs;
-
-    UINT mPassCbvOffset = 0;
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> mCbvHeap = nullptr;
+    // Objets dont les constantes sont à réécrire, pour chaque frame resource.
+    DirtyTracker mObjectsDirty { DirectX12::NumberOfFrameResources };
+    // Détruit avant les shaders et l'input layout, que les PSO en cours de création lisent encore.
+    std::unique_ptr<PipelineStateCache> mPipelineStates = nullptr;
+    std::unordered_map<std::string, PipelineStateCache::Key> mPSOs;
+
+    static constexpr UINT PersistentDescriptorCount = 4096;
+    static constexpr UINT TransientDescriptorCount = 1024;
+    std::unique_ptr<DescriptorHeap> mCbvHeap = nullptr;
 
     XMFLOAT3 mEyePos = { 0.0f, 0.0f, 0.0f };
     XMFLOAT4X4 mView = DirectXMathUtils::Identity4x4();
@@ -0,0 +1,104 @@
+#include "Test.h"
+
+#include "Utils/DescriptorAllocator.h"
+#include "Utils/Random.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// threadCount threads prennent et rendent des descripteurs persistants en même temps, chacun en gardant jusqu'à 64 à la fois, et prennent
+// des tables de descripteurs transitoires pendant que le thread principal termine et retire des frames. Chaque indice a un propriétaire,
+// posé par échange atomique : en trouver un déjà posé veut dire que l'indice a été donné deux fois.
+static bool RunDescriptors(int threadCount, int operationCount)
+{
+    constexpr std::uint32_t PersistentCount = 4096;
+    constexpr std::uint32_t TransientCount = 4096;
+    constexpr int HeldCount = 64;
+
+    DescriptorAllocator allocator(PersistentCount, TransientCount);
+    std::vector<std::atomic<int>> owners(PersistentCount + TransientCount);
+    for (std::atomic<int>& owner : owners)
+        owner.store(-1, std::memory_order_relaxed);
+
+    std::atomic<bool> unique { true };
+    std::atomic<bool> inRange { true };
+    std::atomic<int> runningCount { threadCount };
+    const auto claim = [&](std::uint32_t index, int thread)
+    {
+        int expected = -1;
+        if (!owners[index].compare_exchange_strong(expected, thread, std::memory_order_relaxed))
+            unique.store(false, std::memory_order_relaxed);
+    };
+    const auto release = [&](std::uint32_t index) { owners[index].store(-1, std::memory_order_relaxed); };
+
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < threadCount; thread++)
+    {
+        threads.emplace_back([&, thread]
+        {
+            RandomUtils::Xoshiro generator(1, thread);
+            std::uint32_t held[HeldCount];
+            for (std::uint32_t& index : held)
+                index = DescriptorAllocator::InvalidIndex;
+
+            for (int i = 0; i < operationCount; i++)
+            {
+                std::uint32_t& index = held[generator.Rand(0, HeldCount - 1)];
+                if (index != DescriptorAllocator::InvalidIndex)
+                {
+                    release(index);
+                    allocator.FreePersistent(index);
+                }
+                index = allocator.AllocatePersistent();
+                if (index != DescriptorAllocator::InvalidIndex)
+                    claim(index, thread);
+
+                // Une table transitoire de temps en temps, comme un draw qui écrit ses descripteurs pour la frame.
+                if (i % 16 == 0)
+                {
+                    const std::uint32_t first = allocator.AllocateTransient(4);
+                    if (first != DescriptorAllocator::InvalidIndex && (first < PersistentCount || first + 4 > PersistentCount + TransientCount))
+                        inRange.store(false, std::memory_order_relaxed);
+                }
+            }
+
+            for (std::uint32_t index : held)
+            {
+                if (index != DescriptorAllocator::InvalidIndex)
+                {
+                    release(index);
+                    allocator.FreePersistent(index);
+                }
+            }
+            runningCount.fetch_sub(1, std::memory_order_release);
+        });
+    }
+
+    // Le thread principal joue le rôle de celui qui soumet les frames : les fences sont atteintes deux frames plus tard.
+    std::uint64_t fence = 0;
+    while (runningCount.load(std::memory_order_acquire) > 0)
+    {
+        allocator.FinishFrame(++fence);
+        allocator.Retire(fence > 2 ? fence - 2 : 0);
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+
+    bool ok = Check(unique.load(), "descripteur persistant donné à deux threads à la fois");
+    ok &= Check(inRange.load(), "table transitoire en dehors de sa partie du heap");
+    ok &= Check(allocator.PersistentUsed() == 0, "descripteurs persistants encore utilisés après leur libération");
+    return ok;
+}
+
+static bool TestDescriptors()
+{
+    bool ok = true;
+    for (int threadCount : { 1, 2, 4, 8 })
+        ok &= RunDescriptors(threadCount, 50000);
+    return ok;
+}
+
+static const TestRegistration descriptorsTest("descriptors", &TestDescriptors);
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "Test.h"
+
+#include "Utils/DirtyTracker.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+static std::vector<std::pair<size_t, size_t>> ConsumeAll(DirtyBitset& bitset)
+{
+    std::vector<std::pair<size_t, size_t>> runs;
+    bitset.ConsumeRuns([&](size_t first, size_t count) { runs.emplace_back(first, count); });
+    return runs;
+}
+
+// Suites traversant plusieurs mots, et réductions qui coupent un mot ou un mot de résumé : aucun indice au-delà de la nouvelle taille ne doit ressortir.
+static bool TestDirtyBitset()
+{
+    bool ok = true;
+
+    DirtyBitset bitset;
+    bitset.Resize(10000);
+    bitset.SetRange(60, 10);
+    bitset.SetRange(127, 130);
+    bitset.Set(9999);
+    ok &= Check(bitset.Count() == 141, "Count ne compte pas tous les indices présents");
+    const std::vector<std::pair<size_t, size_t>> runs = ConsumeAll(bitset);
+    ok &= Check(runs == std::vector<std::pair<size_t, size_t>> { { 60, 10 }, { 127, 130 }, { 9999, 1 } }, "suites incorrectes");
+    ok &= Check(bitset.Count() == 0 && ConsumeAll(bitset).empty(), "ConsumeRuns n'a pas vidé l'ensemble");
+
+    // Mot de 6500 au-delà du dernier mot après la réduction, dans le même mot de résumé que 4096..4999.
+    bitset.Set(6500);
+    bitset.Resize(5000);
+    ok &= Check(bitset.Count() == 0 && ConsumeAll(bitset).empty(), "indice au-delà de la taille après une réduction");
+
+    // Bit d'un mot partiel coupé par la réduction.
+    bitset.Set(4999);
+    bitset.Resize(4990);
+    ok &= Check(ConsumeAll(bitset).empty(), "bit d'un mot partiel conservé après une réduction");
+
+    // Les éléments rendus par un agrandissement sont absents.
+    bitset.Set(100);
+    bitset.Resize(50);
+    bitset.Resize(10000);
+    ok &= Check(bitset.Count() == 0 && !bitset.Test(100), "élément présent après réduction puis agrandissement");
+    bitset.Set(9000);
+    const std::vector<std::pair<size_t, size_t>> grown = ConsumeAll(bitset);
+    ok &= Check(grown == std::vector<std::pair<size_t, size_t>> { { 9000, 1 } }, "suites incorrectes après agrandissement");
+    return ok;
+}
+
+// Un élément marqué est rendu une fois par frame resource, et les éléments ajoutés sont à écrire partout.
+static bool TestDirtyTracker()
+{
+    bool ok = true;
+    DirtyTracker tracker(3);
+    tracker.Resize(100);
+    for (int frameResource = 0; frameResource < 3; frameResource++)
+    {
+        ok &= Check(tracker.DirtyCount(frameResource) == 100, "nouveaux éléments absents d'une frame resource");
+        tracker.ConsumeRuns(frameResource, [](size_t, size_t) {});
+    }
+
+    tracker.MarkDirty(42);
+    tracker.Resize(40);
+    tracker.Resize(80);
+    for (int frameResource = 0; frameResource < 3; frameResource++)
+    {
+        std::vector<std::pair<size_t, size_t>> runs;
+        tracker.ConsumeRuns(frameResource, [&](size_t first, size_t count) { runs.emplace_back(first, count); });
+        ok &= Check(runs == std::vector<std::pair<size_t, size_t>> { { 40, 40 } }, "suites incorrectes après réduction puis agrandissement");
+    }
+    return ok;
+}
+
+static const TestRegistration dirtyBitsetTest("dirty-bitset", &TestDirtyBitset);
+static const TestRegistration dirtyTrackerTest("dirty-tracker", &TestDirtyTracker);
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "Test.h"
+
+#include "HeadlessFrames.h"
+
+#include <cstdio>
+
+// Boucle de frame de LitWavesApp sur NullDevice, pour chaque format de sommets et chaque profondeur : aucune frame resource
+// ni constante de passe ne doit être réécrite pendant que le "GPU" la lit encore.
+static bool TestFrames()
+{
+    bool ok = true;
+    for (WavesVertexFormat format : { WavesVertexFormat::Height, WavesVertexFormat::HeightNormal, WavesVertexFormat::Full })
+    {
+        for (int framesInFlight = 1; framesInFlight <= 3; framesInFlight++)
+        {
+            HeadlessFrameSettings settings;
+            settings.Size = 128;
+            settings.VertexFormat = format;
+            settings.FrameCount = 60;
+            settings.GpuFrameMilliseconds = 1.0f;
+            settings.FramesInFlight = framesInFlight;
+            const HeadlessFrameResult result = RunHeadlessFrames(settings);
+
+            char what[128];
+            std::snprintf(what, sizeof(what), "format %d, %d frames en vol : %llu conflits, %llu draws", static_cast<int>(format), framesInFlight,
+                static_cast<unsigned long long>(result.ConflictCount), static_cast<unsigned long long>(result.DrawCount));
+            ok &= Check(result.Valid, what);
+        }
+    }
+    return ok;
+}
+
+// Avec une latence GPU bien au-dessus de la cible, le FramePacer descend à une frame en vol ; sans cible, il garde le maximum.
+static bool TestFramePacing()
+{
+    HeadlessFrameSettings settings;
+    settings.Size = 128;
+    settings.FrameCount = 150;
+    settings.GpuFrameMilliseconds = 2.0f;
+    settings.FramesInFlight = 3;
+
+    const HeadlessFrameResult unpaced = RunHeadlessFrames(settings);
+    bool ok = Check(unpaced.Valid, "frames sans cible de latence");
+    ok &= Check(unpaced.FramesInFlight == 3, "profondeur maximale sans cible de latence");
+
+    settings.LatencyTargetMilliseconds = 3.0f;
+    const HeadlessFrameResult paced = RunHeadlessFrames(settings);
+    ok &= Check(paced.Valid, "frames avec une cible de latence");
+    ok &= Check(paced.FramesInFlight == 1, "une frame en vol pour une cible sous la durée de deux frames GPU");
+    ok &= Check(paced.LatencyMilliseconds < unpaced.LatencyMilliseconds, "latence plus faible avec une cible");
+    return ok;
+}
+
+static const TestRegistration framesTest("frames", &TestFrames);
+static const TestRegistration framePacingTest("frame-pacing", &TestFramePacing);
\ No newline at end of file
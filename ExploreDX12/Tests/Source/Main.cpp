@@ -0,0 +1,86 @@
+// Lance les tests fonctionnels, tous ou seulement ceux dont le nom est donné, et termine avec un code non nul si l'un d'eux échoue.
+//
+// Usage : Tests [--list] [nom...]
+//
+// Sous Linux, avec les en-têtes de DirectXMath (et sal.h) dans le chemin d'inclusion, depuis le dossier ExploreDX12 :
+//   g++ -std=c++20 -O2 -pthread -ICommon/Source -ILitWavesApp/Source -IWavesBench/Source Tests/Source/*.cpp WavesBench/Source/HeadlessFrames.cpp LitWavesApp/Source/Waves.cpp LitWavesApp/Source/Ocean.cpp LitWavesApp/Source/LitWavesFrame.cpp Common/Source/Graphics/NullDevice.cpp Common/Source/Graphics/FramePacer.cpp Common/Source/Graphics/UploadPacker.cpp Common/Source/Graphics/ShaderCache.cpp Common/Source/Utils/ParallelUtils.cpp Common/Source/Utils/MappedFile.cpp Common/Source/Utils/TlsfAllocator.cpp -o Tests
+// Graphics/TransformUtils.cpp n'est pas dans la liste : les fichiers Simd*.cpp le compilent une fois par chemin (voir SimdConformance.h).
+
+#include "Test.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+TestRegistration::TestRegistration(const char* name, TestFunction function)
+{
+    RegisteredTests().push_back({ name, function });
+}
+
+std::vector<TestCase>& RegisteredTests()
+{
+    // Construit au premier enregistrement, quel que soit l'ordre d'initialisation des fichiers.
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+bool Check(bool condition, const char* what)
+{
+    if (!condition)
+        std::fprintf(stderr, "    échec : %s\n", what);
+    return condition;
+}
+
+int main(int argc, char** argv)
+{
+    const std::vector<TestCase>& tests = RegisteredTests();
+    std::vector<const TestCase*> selected;
+    bool unknown = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (std::strcmp(argv[i], "--list") == 0)
+        {
+            for (const TestCase& test : tests)
+                std::printf("%s\n", test.Name);
+            return 0;
+        }
+
+        const TestCase* found = nullptr;
+        for (const TestCase& test : tests)
+        {
+            if (std::strcmp(test.Name, argv[i]) == 0)
+                found = &test;
+        }
+        if (found == nullptr)
+        {
+            std::fprintf(stderr, "Test inconnu : %s (voir --list)\n", argv[i]);
+            unknown = true;
+        }
+        else
+        {
+            selected.push_back(found);
+        }
+    }
+    if (unknown)
+        return 1;
+    if (selected.empty())
+    {
+        for (const TestCase& test : tests)
+            selected.push_back(&test);
+    }
+
+    int failureCount = 0;
+    for (const TestCase* test : selected)
+    {
+        std::printf("%s\n", test->Name);
+        std::fflush(stdout);
+        const auto start = std::chrono::steady_clock::now();
+        const bool ok = test->Function();
+        const double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::printf("  %s (%.1f ms)\n", ok ? "ok" : "ÉCHEC", milliseconds);
+        failureCount += ok ? 0 : 1;
+    }
+
+    std::printf("%zu tests, %d échecs\n", selected.size(), failureCount);
+    return failureCount == 0 ? 0 : 1;
+}
\ No newline at end of file
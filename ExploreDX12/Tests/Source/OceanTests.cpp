@@ -0,0 +1,124 @@
+#include "Test.h"
+
+#include "Ocean.h"
+#include "Utils/Random.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// La FFT radix-2 (étages scalaires puis SIMD), la transformation des colonnes par buffer du thread et l'inversion des bits donnent
+// la même chose qu'une DFT inverse directe en double.
+static bool CheckInverseFFT2D(const Ocean& ocean, int n)
+{
+    RandomUtils::Xoshiro generator(5);
+    std::vector<float> real(n * n);
+    std::vector<float> imaginary(n * n);
+    for (int i = 0; i < n * n; i++)
+    {
+        real[i] = generator.Randf(-1.0f, 1.0f);
+        imaginary[i] = generator.Randf(-1.0f, 1.0f);
+    }
+
+    std::vector<float> transformedReal = real;
+    std::vector<float> transformedImaginary = imaginary;
+    ocean.InverseFFT2D(transformedReal.data(), transformedImaginary.data());
+
+    const double twoPi = 2.0 * 3.14159265358979323846;
+    double maxError = 0.0;
+    double maxMagnitude = 0.0;
+    for (int r = 0; r < n; r++)
+    {
+        for (int c = 0; c < n; c++)
+        {
+            double sumReal = 0.0;
+            double sumImaginary = 0.0;
+            for (int kr = 0; kr < n; kr++)
+            {
+                for (int kc = 0; kc < n; kc++)
+                {
+                    const double angle = twoPi * ((kr * r + kc * c) % n) / n;
+                    const double xr = real[kr * n + kc];
+                    const double xi = imaginary[kr * n + kc];
+                    sumReal += xr * std::cos(angle) - xi * std::sin(angle);
+                    sumImaginary += xr * std::sin(angle) + xi * std::cos(angle);
+                }
+            }
+            maxError = std::fmax(maxError, std::fabs(transformedReal[r * n + c] - sumReal));
+            maxError = std::fmax(maxError, std::fabs(transformedImaginary[r * n + c] - sumImaginary));
+            maxMagnitude = std::fmax(maxMagnitude, std::fmax(std::fabs(sumReal), std::fabs(sumImaginary)));
+        }
+    }
+
+    char what[96];
+    std::snprintf(what, sizeof(what), "InverseFFT2D %dx%d : écart %.2e avec la DFT directe (max %.2e)", n, n, maxError, maxMagnitude);
+    return Check(maxError <= 1e-5 * maxMagnitude * n, what);
+}
+
+// Deux champs réels sont transformés ensemble dans une FFT complexe : le champ 2, qui ne porte que le déplacement z, doit donc
+// ressortir réel si le spectre h(k, t) est bien hermitien (fréquences de Nyquist retirées, h0(-k) conjugué).
+static bool CheckHermitianFields(const Ocean& ocean, int n)
+{
+    float maxImaginary = 0.0f;
+    float maxDisplacement = 0.0f;
+    float maxHeight = 0.0f;
+    for (int i = 0; i < n * n; i++)
+    {
+        maxImaginary = std::fmax(maxImaginary, std::fabs(ocean.FieldImaginary(2)[i]));
+        maxDisplacement = std::fmax(maxDisplacement, std::fabs(ocean.FieldReal(2)[i]));
+        maxHeight = std::fmax(maxHeight, std::fabs(ocean.FieldReal(0)[i]));
+    }
+
+    bool ok = Check(maxHeight > 0.0f && maxDisplacement > 0.0f, "surface plate : le test hermitien ne vérifierait rien");
+    char what[96];
+    std::snprintf(what, sizeof(what), "partie imaginaire du champ 2 : %.2e pour un déplacement z de %.2e", maxImaginary, maxDisplacement);
+    ok &= Check(maxImaginary <= 1e-4f * maxDisplacement, what);
+    return ok;
+}
+
+// La dernière ligne et la dernière colonne reprennent la première, décalées d'un motif : deux motifs voisins se raccordent sans couture.
+static bool CheckSeamlessTiling(const Ocean& ocean)
+{
+    const int columnCount = ocean.ColumnCount();
+    const int last = columnCount - 1;
+    const float tolerance = 1e-4f * ocean.Width();
+    bool columnsMatch = true;
+    bool rowsMatch = true;
+    for (int i = 0; i < columnCount; i++)
+    {
+        const XMFLOAT3& first = ocean.Position(i * columnCount);
+        const XMFLOAT3& lastColumn = ocean.Position(i * columnCount + last);
+        columnsMatch &= first.y == lastColumn.y && first.z == lastColumn.z && std::fabs(lastColumn.x - first.x - ocean.Width()) <= tolerance;
+        columnsMatch &= ocean.Normal(i * columnCount).y == ocean.Normal(i * columnCount + last).y;
+
+        const XMFLOAT3& top = ocean.Position(i);
+        const XMFLOAT3& bottom = ocean.Position(last * columnCount + i);
+        rowsMatch &= top.y == bottom.y && top.x == bottom.x && std::fabs(top.z - bottom.z - ocean.Depth()) <= tolerance;
+        rowsMatch &= ocean.Normal(i).x == ocean.Normal(last * columnCount + i).x;
+    }
+
+    bool ok = Check(columnsMatch, "la dernière colonne ne reprend pas la première");
+    ok &= Check(rowsMatch, "la dernière ligne ne reprend pas la première");
+    return ok;
+}
+
+static bool TestOcean()
+{
+    bool ok = true;
+    for (int n : { 8, 32 })
+    {
+        Ocean ocean(n, 64.0f, XMFLOAT2(12.0f, 5.0f), 0.0005f, 1.2f, 3);
+        ok &= CheckInverseFFT2D(ocean, n);
+
+        // Quelques instants, dont un où les phases exp(i * w * t) sont loin de 1.
+        for (float time : { 0.0f, 1.7f, 23.3f })
+        {
+            ocean.Evaluate(time);
+            ok &= CheckHermitianFields(ocean, n);
+            ok &= CheckSeamlessTiling(ocean);
+        }
+    }
+    return ok;
+}
+
+static const TestRegistration oceanTest("ocean", &TestOcean);
\ No newline at end of file
@@ -0,0 +1,61 @@
+#include "Test.h"
+
+#include "Utils/ParallelUtils.h"
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+// Lance un For où throwIndex lève une exception, seulement sur un thread du pool si onWorker est vrai.
+// Rend vrai si l'exception est arrivée jusqu'au thread appelant.
+static bool ThrowFrom(int throwIndex, bool onWorker, bool& thrown)
+{
+    const std::thread::id caller = std::this_thread::get_id();
+    thrown = false;
+    try
+    {
+        ParallelUtils::For(0, 64, [&](int i)
+        {
+            // Des itérations lentes pour que les threads du pool prennent des blocs.
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            if (i >= throwIndex && (!onWorker || std::this_thread::get_id() != caller))
+            {
+                thrown = true;
+                throw std::runtime_error("bloc en échec");
+            }
+        });
+    }
+    catch (const std::runtime_error&)
+    {
+        return true;
+    }
+    return false;
+}
+
+// Une exception levée par un bloc, sur le thread appelant ou sur un thread du pool, ressort de For sans laisser le job dans le pool :
+// les For suivants traitent tous leurs éléments.
+static bool TestParallelExceptions()
+{
+    ParallelUtils::SetThreadCount(4);
+
+    bool ok = true;
+    for (bool onWorker : { false, true })
+    {
+        for (int attempt = 0; attempt < 20; attempt++)
+        {
+            bool thrown = false;
+            const bool caught = ThrowFrom(onWorker ? 0 : 63, onWorker, thrown);
+            ok &= Check(caught == thrown, onWorker ? "exception d'un thread du pool perdue par For" : "exception du thread appelant perdue par For");
+
+            std::atomic<int> sum { 0 };
+            ParallelUtils::For(0, 1000, [&sum](int i) { sum.fetch_add(i, std::memory_order_relaxed); });
+            ok &= Check(sum.load() == 999 * 1000 / 2, "For incomplet après une exception");
+        }
+    }
+
+    ParallelUtils::SetThreadCount(0);
+    return ok;
+}
+
+static const TestRegistration parallelExceptionsTest("parallel-exceptions", &TestParallelExceptions);
\ No newline at end of file
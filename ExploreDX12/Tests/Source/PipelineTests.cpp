@@ -0,0 +1,105 @@
+#include "Test.h"
+
+#include "Graphics/NullDevice.h"
+#include "Graphics/PipelineCache.h"
+#include "Utils/Hasher.h"
+#include "Utils/ParallelUtils.h"
+#include "Utils/Random.h"
+
+#include <chrono>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+// Demandes de PSO faites en même temps par les threads de ParallelUtils, comme des systèmes qui préparent leurs permutations pendant l'initialisation,
+// puis premières utilisations dans l'ordre des demandes. La clé d'une permutation est construite comme celle de PipelineStateCache,
+// sur une description réduite : remplissage, éclairage, nombre de lumières et format de sommet.
+static bool RunPipelines(int threadCount, int requestCount)
+{
+    constexpr int PermutationCount = 2 * 2 * 4 * 3;
+
+    const auto permutationKey = [](int permutation)
+    {
+        Hasher hasher;
+        hasher.Add(static_cast<std::uint64_t>(permutation % 2));
+        hasher.Add(static_cast<std::uint64_t>(permutation / 2 % 2));
+        hasher.Add(static_cast<std::uint64_t>(permutation / 4 % 4));
+        hasher.Add(static_cast<std::uint64_t>(permutation / 16));
+        return hasher.Finish();
+    };
+
+    RandomUtils::Xoshiro generator(1);
+    std::vector<int> permutations(requestCount);
+    for (int& permutation : permutations)
+        permutation = generator.Rand(0, PermutationCount - 1);
+    const std::set<int> unique(permutations.begin(), permutations.end());
+
+    NullDevice::Device device;
+    device.SetPipelineCreationTime(std::chrono::microseconds(200));
+    ParallelUtils::SetThreadCount(threadCount);
+
+    bool shared = true;
+    PipelineCache<std::uint64_t>::Stats stats;
+    {
+        PipelineCache<std::uint64_t> cache(threadCount);
+        ParallelUtils::For(0, requestCount, [&](int i)
+        {
+            cache.Request(permutationKey(permutations[i]), [&device] { return device.CreateGraphicsPipelineState(); });
+        });
+
+        // Une même permutation rend toujours le même PSO, et deux permutations jamais le même.
+        std::map<int, std::uint64_t> pipelines;
+        std::set<std::uint64_t> pipelineIds;
+        for (int permutation : permutations)
+        {
+            const std::uint64_t pipeline = cache.Get(permutationKey(permutation));
+            const auto [found, inserted] = pipelines.emplace(permutation, pipeline);
+            shared &= found->second == pipeline && (!inserted || pipelineIds.insert(pipeline).second);
+        }
+        stats = cache.GetStats();
+    }
+
+    bool ok = Check(shared, "PSO différent pour une même permutation, ou partagé entre deux permutations");
+    ok &= Check(stats.RequestCount == static_cast<std::uint32_t>(requestCount) && stats.DuplicateCount == stats.RequestCount - unique.size(),
+        "demandes ou doublons mal comptés");
+    ok &= Check(stats.CreatedCount == unique.size() && device.PipelineStateCount() == unique.size(), "PSO créé plus d'une fois");
+    return ok;
+}
+
+// L'exception d'un créateur est relancée par chaque Get de sa clé, sans empêcher les autres pipelines d'être créés.
+static bool RunFailingPipeline()
+{
+    PipelineCache<int> cache(2);
+    cache.Request(1, [] { return 1; });
+    cache.Request(2, []() -> int { throw std::runtime_error("compilation"); });
+    cache.Request(3, [] { return 3; });
+
+    int rethrowCount = 0;
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        try
+        {
+            cache.Get(2);
+        }
+        catch (const std::runtime_error&)
+        {
+            rethrowCount++;
+        }
+    }
+
+    bool ok = Check(rethrowCount == 2, "exception du créateur non relancée par Get");
+    ok &= Check(cache.Get(1) == 1 && cache.Get(3) == 3, "pipelines voisins d'un échec");
+    return ok;
+}
+
+static bool TestPipelines()
+{
+    bool ok = true;
+    for (int threadCount : { 1, 2, 4, 8 })
+        ok &= RunPipelines(threadCount, 500);
+    ok &= RunFailingPipeline();
+    return ok;
+}
+
+static const TestRegistration pipelinesTest("pipelines", &TestPipelines);
\ No newline at end of file
@@ -0,0 +1,135 @@
+#include "Test.h"
+
+#include "Utils/Random.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Vecteurs de référence de Random123 pour Philox4x32-10 (kat_vectors) : compteur et clé nuls, puis les décimales de pi.
+// La graine donne la clé (mot bas d'abord), le flux les mots 2 et 3 du compteur et le compteur de bloc les mots 0 et 1.
+static bool CheckPhiloxKnownAnswers()
+{
+    struct KnownAnswer
+    {
+        std::uint32_t Counter[4];
+        std::uint32_t Key[2];
+        std::uint32_t Expected[4];
+    };
+    const KnownAnswer answers[] = {
+        { { 0, 0, 0, 0 }, { 0, 0 }, { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } },
+        { { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 }, { 0xa4093822, 0x299f31d0 }, { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } },
+    };
+
+    bool ok = true;
+    for (const KnownAnswer& answer : answers)
+    {
+        const RandomUtils::Philox philox((static_cast<std::uint64_t>(answer.Key[1]) << 32) | answer.Key[0],
+            (static_cast<std::uint64_t>(answer.Counter[3]) << 32) | answer.Counter[2]);
+        const std::uint64_t counter = (static_cast<std::uint64_t>(answer.Counter[1]) << 32) | answer.Counter[0];
+
+        std::uint32_t block[4];
+        philox.Block(counter, block);
+        char what[128];
+        std::snprintf(what, sizeof(what), "Philox : %08x %08x %08x %08x au lieu de %08x %08x %08x %08x", block[0], block[1], block[2], block[3],
+            answer.Expected[0], answer.Expected[1], answer.Expected[2], answer.Expected[3]);
+        ok &= Check(block[0] == answer.Expected[0] && block[1] == answer.Expected[1] && block[2] == answer.Expected[2] && block[3] == answer.Expected[3], what);
+
+        // Le chemin SIMD de Fill (Block4) doit donner le même bloc, quand l'index 4 * counter tient sur 64 bits.
+        if (counter >= (1ull << 62))
+            continue;
+        std::uint32_t filled[16];
+        philox.Fill(4 * counter, filled, 16);
+        ok &= Check(filled[0] == answer.Expected[0] && filled[1] == answer.Expected[1] && filled[2] == answer.Expected[2] && filled[3] == answer.Expected[3],
+            "Philox::Fill différent du vecteur de référence");
+    }
+    return ok;
+}
+
+// Fill donne les mêmes valeurs que UInt(i) et Randf(i) : début au milieu d'un bloc, groupes de 16 par Block4 et fin incomplète,
+// y compris quand le compteur de bloc passe 2^32 au milieu des quatre blocs de Block4 (retenue sur le mot haut).
+static bool CheckPhiloxFill()
+{
+    const RandomUtils::Philox philox(0x0123456789abcdefull, 42);
+    const std::uint64_t firstIndices[] = { 0, 3, 4 * 0xfffffffeull - 2, 4 * 0xfffffffdull + 1, 4 * 0xffffffffull };
+    constexpr size_t Count = 77;
+
+    bool ok = true;
+    for (std::uint64_t firstIndex : firstIndices)
+    {
+        std::vector<std::uint32_t> values(Count);
+        std::vector<float> floats(Count);
+        philox.Fill(firstIndex, values.data(), Count);
+        philox.Fill(firstIndex, floats.data(), Count, -2.0f, 3.0f);
+
+        bool sameValues = true;
+        bool sameFloats = true;
+        for (size_t i = 0; i < Count; i++)
+        {
+            sameValues &= values[i] == philox.UInt(firstIndex + i);
+            sameFloats &= floats[i] == philox.Randf(firstIndex + i, -2.0f, 3.0f);
+        }
+
+        char what[96];
+        std::snprintf(what, sizeof(what), "Philox::Fill depuis l'index %llu différent de UInt", static_cast<unsigned long long>(firstIndex));
+        ok &= Check(sameValues, what);
+        std::snprintf(what, sizeof(what), "Philox::Fill (float) depuis l'index %llu différent de Randf", static_cast<unsigned long long>(firstIndex));
+        ok &= Check(sameFloats, what);
+    }
+    return ok;
+}
+
+// Xoshiro produit la même suite tirée une à une ou par Fill, même quand le buffer de NextUInt est entamé avant l'appel,
+// et la suite continue au même endroit après Fill.
+static bool CheckXoshiroFill()
+{
+    bool ok = true;
+    for (int drained = 0; drained <= 4; drained++)
+    {
+        for (size_t count : { 1, 3, 4, 37 })
+        {
+            RandomUtils::Xoshiro filled(9, 2);
+            RandomUtils::Xoshiro drawn(9, 2);
+            for (int i = 0; i < drained; i++)
+            {
+                filled.NextUInt();
+                drawn.NextUInt();
+            }
+
+            std::vector<std::uint32_t> values(count);
+            filled.Fill(values.data(), count);
+            bool sameValues = true;
+            for (size_t i = 0; i < count; i++)
+                sameValues &= values[i] == drawn.NextUInt();
+
+            // Buffer de nouveau entamé, puis floats.
+            filled.NextUInt();
+            drawn.NextUInt();
+            std::vector<float> floats(count);
+            filled.Fill(floats.data(), count, -3.0f, 5.0f);
+            bool sameFloats = true;
+            for (size_t i = 0; i < count; i++)
+                sameFloats &= floats[i] == drawn.Randf(-3.0f, 5.0f);
+            const bool sameAfter = filled.NextUInt() == drawn.NextUInt() && filled.NextUInt() == drawn.NextUInt();
+
+            char what[96];
+            std::snprintf(what, sizeof(what), "Xoshiro::Fill de %zu valeurs après %d tirages différent de NextUInt", count, drained);
+            ok &= Check(sameValues, what);
+            std::snprintf(what, sizeof(what), "Xoshiro::Fill de %zu floats après %d tirages différent de Randf", count, drained + 1);
+            ok &= Check(sameFloats, what);
+            std::snprintf(what, sizeof(what), "Xoshiro : suite décalée après Fill de %zu valeurs", count);
+            ok &= Check(sameAfter, what);
+        }
+    }
+    return ok;
+}
+
+static bool TestRandom()
+{
+    bool ok = CheckPhiloxKnownAnswers();
+    ok &= CheckPhiloxFill();
+    ok &= CheckXoshiroFill();
+    return ok;
+}
+
+static const TestRegistration randomTest("random", &TestRandom);
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "Test.h"
+
+#include "Graphics/ShaderCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+// Faux compilateur : le "bytecode" reprend la requête et le fichier source, ce qui suffit à vérifier qu'une entrée du cache
+// correspond bien à sa requête.
+static bool StubCompile(const ShaderCache::Request& request, std::vector<std::uint8_t>& byteCode)
+{
+    std::ifstream file(request.SourcePath, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::string text = request.EntryPoint + "|" + request.Target + "|" + std::to_string(request.Flags) + "|";
+    for (const ShaderCache::Define& define : request.Defines)
+        text += define.Name + "=" + define.Value + "|";
+    text.append(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    byteCode.assign(text.begin(), text.end());
+    return true;
+}
+
+// Chaque lancement d'une application est simulé par un nouveau ShaderCache sur le même dossier : premier lancement (tout est compilé),
+// deuxième (tout est relu), modification d'un fichier inclus (seuls les shaders qui l'incluent sont recompilés), puis dossier du cache
+// impossible à créer. Les requêtes sont celles d'une application : VS et PS de chaque shader, plus une variante avec un define.
+static bool TestShaderCache()
+{
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "ExploreDX12TestsShaderCache";
+    const fs::path shaderDirectory = root / "Shaders";
+    const fs::path cacheDirectory = root / "ShaderCache";
+    std::error_code error;
+    fs::remove_all(root, error);
+    fs::create_directories(shaderDirectory, error);
+    if (!Check(!error, "impossible de créer le dossier temporaire"))
+        return false;
+
+    // Deux shaders qui incluent le même en-tête, et un sans inclusion qui ne doit pas être recompilé quand l'en-tête change.
+    const fs::path header = (shaderDirectory / "LightingUtils.hlsl").lexically_normal();
+    std::ofstream(header) << "float3 Ambient(float3 albedo) { return 0.25f * albedo; }\n";
+    std::ofstream(shaderDirectory / "Default.hlsl") << "#include \"LightingUtils.hlsl\"\n"
+        "float4 VS(float3 p : POSITION) : SV_POSITION { return float4(p, 1.0f); }\n"
+        "float4 PS(float4 p : SV_POSITION) : SV_Target { return float4(Ambient(1.0f), 1.0f); }\n";
+    std::ofstream(shaderDirectory / "Waves.hlsl") << "#include \"LightingUtils.hlsl\"\n"
+        "float4 VS(float h : HEIGHT) : SV_POSITION { return float4(0.0f, h, 0.0f, 1.0f); }\n"
+        "float4 PS(float4 p : SV_POSITION) : SV_Target { return float4(Ambient(0.5f), 1.0f); }\n";
+    std::ofstream(shaderDirectory / "Unlit.hlsl") << "float4 VS(float3 p : POSITION) : SV_POSITION { return float4(p, 1.0f); }\n"
+        "float4 PS(float4 p : SV_POSITION) : SV_Target { return 1.0f; }\n";
+
+    std::vector<ShaderCache::Request> requests;
+    for (const char* name : { "Default.hlsl", "Waves.hlsl", "Unlit.hlsl" })
+    {
+        const fs::path source = (shaderDirectory / name).lexically_normal();
+        requests.push_back({ source, {}, "VS", "vs_5_1", 0 });
+        requests.push_back({ source, {}, "PS", "ps_5_1", 0 });
+        requests.push_back({ source, { { "FOG", "1" } }, "PS", "ps_5_1", 0 });
+    }
+
+    ShaderCache scanner(cacheDirectory, "stub");
+    std::set<size_t> dependents;
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        const std::vector<fs::path> dependencies = scanner.Dependencies(requests[i].SourcePath);
+        if (std::find(dependencies.begin(), dependencies.end(), header) != dependencies.end())
+            dependents.insert(i);
+    }
+    bool allOk = Check(dependents.size() == 6, "inclusions mal suivies");
+
+    const auto run = [&](const char* name, const fs::path& directory, size_t expectedCompileCount, const std::set<size_t>& expectedCompiled)
+    {
+        ShaderCache cache(directory, "stub");
+        std::set<size_t> compiled;
+        size_t current = 0;
+        const ShaderCache::Compiler compiler = [&](const ShaderCache::Request& request, std::vector<std::uint8_t>& byteCode)
+        {
+            compiled.insert(current);
+            return StubCompile(request, byteCode);
+        };
+
+        bool identical = true;
+        size_t mappedCount = 0;
+        for (current = 0; current < requests.size(); current++)
+        {
+            const std::shared_ptr<const ShaderCache::Bytecode> byteCode = cache.Load(requests[current], compiler);
+            std::vector<std::uint8_t> expected;
+            StubCompile(requests[current], expected);
+            identical &= byteCode != nullptr && byteCode->Size() == expected.size() && std::memcmp(byteCode->Data(), expected.data(), expected.size()) == 0;
+            mappedCount += byteCode != nullptr && byteCode->IsMapped() ? 1 : 0;
+        }
+
+        size_t entryCount = 0;
+        for (const fs::directory_entry& entry : fs::directory_iterator(directory, error))
+            entryCount += entry.path().extension() == ".cso" ? 1 : 0;
+
+        const ShaderCache::Stats& stats = cache.GetStats();
+        char what[128];
+        std::snprintf(what, sizeof(what), "%s : bytecode différent de sa requête", name);
+        bool ok = Check(identical, what);
+        // Une entrée par requête : la nouvelle entrée d'une requête ne remplace que la sienne.
+        std::snprintf(what, sizeof(what), "%s : %zu entrées pour %zu bytecodes projetés", name, entryCount, mappedCount);
+        ok &= Check(entryCount == mappedCount, what);
+        std::snprintf(what, sizeof(what), "%s : %u compilations, %zu attendues", name, stats.CompileCount, expectedCompileCount);
+        ok &= Check(stats.CompileCount == expectedCompileCount && stats.HitCount + stats.CompileCount == requests.size() && stats.FailureCount == 0, what);
+        if (!expectedCompiled.empty())
+        {
+            std::snprintf(what, sizeof(what), "%s : shaders recompilés différents de ceux qui incluent l'en-tête", name);
+            ok &= Check(compiled == expectedCompiled && stats.RemovedCount == expectedCompiled.size(), what);
+        }
+        allOk &= ok;
+    };
+
+    const std::set<size_t> none;
+    run("cold", cacheDirectory, requests.size(), none);
+    run("warm", cacheDirectory, 0, none);
+
+    std::ofstream(header, std::ios::app) << "\n// modifié par Tests\n";
+    run("modified", cacheDirectory, dependents.size(), dependents);
+    run("warm", cacheDirectory, 0, none);
+
+    // Dossier du cache impossible à créer (un fichier porte son nom) : le bytecode est compilé et renvoyé depuis la mémoire à chaque lancement.
+    std::ofstream(root / "Blocked") << "";
+    run("unwritable", root / "Blocked" / "ShaderCache", requests.size(), none);
+
+    fs::remove_all(root, error);
+    return allOk;
+}
+
+static const TestRegistration shaderCacheTest("shader-cache", &TestShaderCache);
\ No newline at end of file
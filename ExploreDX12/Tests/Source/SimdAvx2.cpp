@@ -0,0 +1,31 @@
+// Chemin AVX2 (voir SimdConformance.h). Sans /arch:AVX2 ou -mavx2, c'est un chemin plus ancien.
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include "SimdOperations.h"
+// Les noyaux de TransformUtils de ce chemin (voir SimdConformance.h), seulement s'il est vraiment compilé ici : sinon, le fichier
+// du chemin plus ancien les fournit déjà.
+#if defined(SIMD_AVX2)
+#include "Graphics/TransformUtils.cpp"
+#endif
+
+SimdResults RecordSimdAvx2()
+{
+    return RecordSimdOperations();
+}
+
+TransformResults RecordTransformsAvx2(const TransformInputs& inputs)
+{
+    return RecordTransforms(inputs);
+}
+#else
+#include "SimdConformance.h"
+
+SimdResults RecordSimdAvx2()
+{
+    return {};
+}
+
+TransformResults RecordTransformsAvx2(const TransformInputs&)
+{
+    return {};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Graphics/DirectXMathUtils.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Résultats de toutes les opérations de Utils/Simd.h sur les mêmes entrées, calculés par un chemin. Chaque chemin est compilé dans son propre
+// fichier (SimdScalar.cpp, SimdSse2.cpp...), qui le choisit par SIMD_FORCE_... avant d'inclure SimdOperations.h : SimdTests compare ensuite
+// chaque chemin au chemin scalaire, voie par voie.
+struct SimdResult
+{
+    std::string Name;
+    // Bits de chaque voie.
+    std::vector<std::uint32_t> Lanes;
+    // Les voies flottantes sont comparées par valeur (0 et -0 sont égaux), les voies entières bit à bit.
+    bool IsFloat = false;
+};
+
+struct SimdResults
+{
+    // Simd::BackendName du chemin réellement compilé, vide s'il n'existe pas sur cette plateforme : SSE4.1 et AVX2 retombent
+    // sur un chemin plus ancien si les options de compilation ne les permettent pas.
+    std::string Backend;
+    std::vector<SimdResult> Operations;
+};
+
+SimdResults RecordSimdScalar();
+SimdResults RecordSimdSse2();
+SimdResults RecordSimdSse41();
+SimdResults RecordSimdAvx2();
+SimdResults RecordSimdNeon();
+
+// Entrées des noyaux de Graphics/TransformUtils.h, tirées par SimdTests : chaque fichier de chemin compile aussi TransformUtils.cpp
+// avec son chemin et renvoie les sorties de ses noyaux, que SimdTests compare à un calcul direct en double.
+struct TransformInputs
+{
+    XMFLOAT4X4 Matrix;
+    // Points ou vecteurs, puis demi-tailles des boîtes centrées sur les points.
+    std::vector<float> X;
+    std::vector<float> Y;
+    std::vector<float> Z;
+    std::vector<float> ExtentX;
+    std::vector<float> ExtentY;
+    std::vector<float> ExtentZ;
+    std::vector<XMFLOAT4X4> Matrices;
+};
+
+struct TransformResults
+{
+    // Simd::BackendName du chemin compilé, comme SimdResults::Backend.
+    std::string Backend;
+    std::vector<float> Points[3];
+    std::vector<float> Vectors[3];
+    std::vector<float> Normalized[3];
+    std::vector<float> Centers[3];
+    std::vector<float> Extents[3];
+    // Matrices transposées avec un pas de TransposeStride octets, à une adresse alignée sur 16 octets puis décalée de 4 :
+    // l'écriture en streaming puis l'écriture normale. Les octets entre deux matrices doivent garder TransposePadding.
+    std::vector<std::uint8_t> Transposed;
+    std::vector<std::uint8_t> TransposedUnaligned;
+};
+
+constexpr size_t TransposeStride = 256;
+constexpr std::uint8_t TransposePadding = 0xcd;
+
+TransformResults RecordTransformsScalar(const TransformInputs& inputs);
+TransformResults RecordTransformsSse2(const TransformInputs& inputs);
+TransformResults RecordTransformsSse41(const TransformInputs& inputs);
+TransformResults RecordTransformsAvx2(const TransformInputs& inputs);
+TransformResults RecordTransformsNeon(const TransformInputs& inputs);
\ No newline at end of file
@@ -0,0 +1,31 @@
+// Chemin NEON, sur AArch64 seulement (voir SimdConformance.h).
+#if (defined(__aarch64__) || defined(_M_ARM64)) && !defined(SIMD_FORCE_SCALAR)
+#include "SimdOperations.h"
+// Les noyaux de TransformUtils de ce chemin (voir SimdConformance.h), seulement s'il est vraiment compilé ici : sinon, le fichier
+// du chemin plus ancien les fournit déjà.
+#if defined(SIMD_NEON)
+#include "Graphics/TransformUtils.cpp"
+#endif
+
+SimdResults RecordSimdNeon()
+{
+    return RecordSimdOperations();
+}
+
+TransformResults RecordTransformsNeon(const TransformInputs& inputs)
+{
+    return RecordTransforms(inputs);
+}
+#else
+#include "SimdConformance.h"
+
+SimdResults RecordSimdNeon()
+{
+    return {};
+}
+
+TransformResults RecordTransformsNeon(const TransformInputs&)
+{
+    return {};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,279 @@
+#pragma once
+
+// Corps commun des fichiers de chemin (voir SimdConformance.h), à inclure une seule fois par fichier après avoir choisi le chemin.
+// Tout est dans un espace de noms anonyme : chaque fichier a sa propre copie, compilée avec son chemin.
+#include "SimdConformance.h"
+
+#include "Graphics/TransformUtils.h"
+#include "Utils/Simd.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Débordements des produits (INT32_MAX * INT32_MAX, INT32_MIN * -1, 46341 * 46341 juste au-delà de 2^31, 0xffffffff * 0xffffffff en non signé),
+    // et valeurs autour des bornes 16 bits pour la saturation.
+    const std::int32_t IntInputsA[16] = { 0, 1, -1, 2, 2147483647, -2147483647 - 1, -2147483647, 32767,
+        32768, -32768, -32769, 65535, 0x12345678, static_cast<std::int32_t>(0xdeadbeef), 46341, -46341 };
+    const std::int32_t IntInputsB[16] = { 0, -1, -1, -2147483647 - 1, 2147483647, -1, -2147483647 - 1, 32767,
+        32768, -32768, 65537, 65535, static_cast<std::int32_t>(0x9abcdef0), static_cast<std::int32_t>(0xdeadbeef), 46341, 46341 };
+
+    // Égalités d'arrondi (0.5, 1.5, 2.5...), -0, et valeurs qui ne tiennent pas exactement dans un float. Pas de NaN ni de diviseur nul.
+    const float FloatInputsA[16] = { 0.0f, -0.0f, 0.5f, -0.5f, 1.5f, -1.5f, 2.5f, -2.5f, 3.75f, -3.25f, 1e-3f, 12345.678f, -98765.43f, 0.1f, 16777216.0f, -1e6f };
+    const float FloatInputsB[16] = { 1.0f, -2.0f, 0.5f, 0.5f, -0.75f, 3.0f, 1e-3f, -7.0f, 3.75f, 1e4f, -0.1f, 0.3f, 2.0f, -0.0001f, 3.0f, 1e-6f };
+
+    // Arrondi puis saturation des hauteurs Fixed16 (Waves::StoreHeights) : égalités et dépassements de part et d'autre de [-32768, 32767].
+    const float Fixed16Inputs[16] = { 32766.5f, 32767.0f, 32767.5f, 32768.0f, 40000.0f, -32767.0f, -32767.5f, -32768.0f,
+        -32768.5f, -32769.0f, -40000.0f, 0.5f, -0.5f, 1.5f, -1.5f, 100000.0f };
+
+    // Produits et sommes exacts en float : MulAdd ne peut alors pas dépendre du FMA.
+    const float MulAddInputsA[8] = { 0.5f, 1.5f, -2.0f, 3.0f, 4.0f, -0.25f, 8.0f, 100.0f };
+    const float MulAddInputsB[8] = { 2.0f, -4.0f, 0.75f, 0.125f, -1.0f, 16.0f, 0.5f, -3.0f };
+    const float MulAddInputsC[8] = { 1.0f, 0.25f, -8.0f, 1024.0f, -0.5f, 2.0f, 3.0f, -7.0f };
+
+    const std::int16_t Int16Inputs[8] = { 0, 1, -1, 32767, -32768, -32767, 12345, -12345 };
+
+    // Index des lectures indexées. Les tables ont une entrée de plus que le plus grand index : GatherInt16 et GatherHalf lisent des mots de 32 bits.
+    const std::int32_t GatherIndices[16] = { 0, 63, 5, 17, 17, 1, 32, 62, 7, 8, 9, 40, 0, 63, 31, 2 };
+    // Zéros, dénormalisé, plus grand fini, infinis : tout sauf les NaN, qui ne se comparent pas par valeur.
+    const std::uint16_t HalfSpecials[12] = { 0x0000, 0x8000, 0x0001, 0x03ff, 0x3c00, 0xbc00, 0x7bff, 0xfbff, 0x7c00, 0xfc00, 0x3555, 0x0400 };
+
+    void Add(SimdResults& results, const char* name, const std::int32_t* lanes, int count)
+    {
+        SimdResult result;
+        result.Name = name;
+        for (int lane = 0; lane < count; lane++)
+            result.Lanes.push_back(static_cast<std::uint32_t>(lanes[lane]));
+        results.Operations.push_back(std::move(result));
+    }
+
+    void Add(SimdResults& results, const char* name, const float* lanes, int count)
+    {
+        SimdResult result;
+        result.Name = name;
+        result.IsFloat = true;
+        for (int lane = 0; lane < count; lane++)
+        {
+            std::uint32_t bits;
+            std::memcpy(&bits, &lanes[lane], sizeof(bits));
+            result.Lanes.push_back(bits);
+        }
+        results.Operations.push_back(std::move(result));
+    }
+
+    void Add(SimdResults& results, const char* name, Simd::Int4 value)
+    {
+        std::int32_t lanes[4];
+        value.Store(lanes);
+        Add(results, name, lanes, 4);
+    }
+
+    void Add(SimdResults& results, const char* name, Simd::Float4 value)
+    {
+        float lanes[4];
+        value.Store(lanes);
+        Add(results, name, lanes, 4);
+    }
+
+    void Add(SimdResults& results, const char* name, Simd::Int8 value)
+    {
+        std::int32_t lanes[8];
+        value.Store(lanes);
+        Add(results, name, lanes, 8);
+    }
+
+    void Add(SimdResults& results, const char* name, Simd::Float8 value)
+    {
+        float lanes[8];
+        value.Store(lanes);
+        Add(results, name, lanes, 8);
+    }
+
+    void Add(SimdResults& results, const char* name, const std::int16_t* values, int count)
+    {
+        std::int32_t lanes[8];
+        for (int lane = 0; lane < count; lane++)
+            lanes[lane] = values[lane];
+        Add(results, name, lanes, count);
+    }
+
+    SimdResults RecordSimdOperations()
+    {
+        using namespace Simd;
+
+        SimdResults results;
+        results.Backend = BackendName();
+
+        for (int group = 0; group < 4; group++)
+        {
+            const Int4 a = Int4::Load(IntInputsA + 4 * group);
+            const Int4 b = Int4::Load(IntInputsB + 4 * group);
+            Add(results, "Int4 +", a + b);
+            Add(results, "Int4 -", a - b);
+            Add(results, "Int4 &", a & b);
+            Add(results, "Int4 |", a | b);
+            Add(results, "Int4 ^", a ^ b);
+            Add(results, "ShiftLeft<1>", ShiftLeft<1>(a));
+            Add(results, "ShiftLeft<16>", ShiftLeft<16>(a));
+            Add(results, "ShiftLeft<31>", ShiftLeft<31>(a));
+            Add(results, "ShiftRight<1>", ShiftRight<1>(a));
+            Add(results, "ShiftRight<16>", ShiftRight<16>(a));
+            Add(results, "ShiftRight<31>", ShiftRight<31>(a));
+            Add(results, "ShiftRightArithmetic<1>", ShiftRightArithmetic<1>(a));
+            Add(results, "ShiftRightArithmetic<16>", ShiftRightArithmetic<16>(a));
+            Add(results, "ShiftRightArithmetic<31>", ShiftRightArithmetic<31>(a));
+            Add(results, "MulLow", MulLow(a, b));
+            Int4 high;
+            Int4 low;
+            MulWide(a, b, high, low);
+            Add(results, "MulWide high", high);
+            Add(results, "MulWide low", low);
+            Add(results, "ToFloat", ToFloat(a));
+            Add(results, "Int4 constructeur", Int4(IntInputsA[4 * group], IntInputsA[4 * group + 1], IntInputsA[4 * group + 2], IntInputsA[4 * group + 3]));
+            Add(results, "Int4 diffusion", Int4(IntInputsA[4 * group]));
+
+            const Float4 x = Float4::Load(FloatInputsA + 4 * group);
+            const Float4 y = Float4::Load(FloatInputsB + 4 * group);
+            Add(results, "Float4 +", x + y);
+            Add(results, "Float4 -", x - y);
+            Add(results, "Float4 *", x * y);
+            Add(results, "Float4 /", x / y);
+            Add(results, "Min", Min(x, y));
+            Add(results, "Max", Max(x, y));
+            Add(results, "Sqrt", Sqrt(Max(x, Float4(0.0f))));
+            Add(results, "Floor", Floor(x));
+            Add(results, "TruncateToInt", TruncateToInt(x));
+            Add(results, "RoundToInt", RoundToInt(x));
+            Add(results, "Float4 diffusion", Float4(FloatInputsA[4 * group]));
+
+            const Float4 fixed = Float4::Load(Fixed16Inputs + 4 * group);
+            Add(results, "Fixed16 RoundToInt", RoundToInt(fixed));
+        }
+
+        for (int group = 0; group < 2; group++)
+        {
+            const Float4 a = Float4::Load(MulAddInputsA + 4 * group);
+            const Float4 b = Float4::Load(MulAddInputsB + 4 * group);
+            const Float4 c = Float4::Load(MulAddInputsC + 4 * group);
+            Add(results, "Float4 MulAdd", MulAdd(a, b, c));
+        }
+
+        // Saturation 16 bits : entiers quelconques, puis chaîne complète d'écriture des hauteurs Fixed16.
+        for (int group = 0; group < 4; group += 2)
+        {
+            std::int16_t values[8];
+            StoreInt16Saturate(values, Int4::Load(IntInputsA + 4 * group), Int4::Load(IntInputsA + 4 * group + 4));
+            Add(results, "StoreInt16Saturate", values, 8);
+            StoreInt16Saturate(values, RoundToInt(Float4::Load(Fixed16Inputs + 4 * group)), RoundToInt(Float4::Load(Fixed16Inputs + 4 * group + 4)));
+            Add(results, "Fixed16 StoreInt16Saturate", values, 8);
+        }
+
+        Int4 int16Low;
+        Int4 int16High;
+        LoadInt16(Int16Inputs, int16Low, int16High);
+        Add(results, "LoadInt16 low", int16Low);
+        Add(results, "LoadInt16 high", int16High);
+
+        Int4 rows[4] = { Int4::Load(IntInputsA), Int4::Load(IntInputsA + 4), Int4::Load(IntInputsA + 8), Int4::Load(IntInputsA + 12) };
+        Transpose(rows[0], rows[1], rows[2], rows[3]);
+        for (const Int4& row : rows)
+            Add(results, "Transpose Int4", row);
+
+        Float4 floatRows[4] = { Float4::Load(FloatInputsA), Float4::Load(FloatInputsA + 4), Float4::Load(FloatInputsA + 8), Float4::Load(FloatInputsA + 12) };
+        Transpose(floatRows[0], floatRows[1], floatRows[2], floatRows[3]);
+        for (const Float4& row : floatRows)
+            Add(results, "Transpose Float4", row);
+
+        alignas(16) std::int32_t streamedInts[4];
+        alignas(16) float streamedFloats[4];
+        StreamStore(streamedInts, Int4::Load(IntInputsA + 4));
+        StreamStore(streamedFloats, Float4::Load(FloatInputsA + 4));
+        StoreFence();
+        Add(results, "StreamStore Int4", streamedInts, 4);
+        Add(results, "StreamStore Float4", streamedFloats, 4);
+
+        for (int group = 0; group < 2; group++)
+        {
+            const Int8 a = Int8::Load(IntInputsA + 8 * group);
+            const Int8 b = Int8::Load(IntInputsB + 8 * group);
+            Add(results, "Int8 +", a + b);
+            Add(results, "Int8 MulLow", MulLow(a, b));
+            Add(results, "Int8 ToFloat", ToFloat(a));
+            Add(results, "Int8 diffusion", Int8(IntInputsA[8 * group]));
+
+            const Float8 x = Float8::Load(FloatInputsA + 8 * group);
+            const Float8 y = Float8::Load(FloatInputsB + 8 * group);
+            Add(results, "Float8 +", x + y);
+            Add(results, "Float8 -", x - y);
+            Add(results, "Float8 *", x * y);
+            Add(results, "Float8 /", x / y);
+            Add(results, "Float8 Min", Min(x, y));
+            Add(results, "Float8 Max", Max(x, y));
+            Add(results, "Float8 Sqrt", Sqrt(Max(x, Float8(0.0f))));
+            Add(results, "Float8 Floor", Floor(x));
+            Add(results, "Float8 TruncateToInt", TruncateToInt(x));
+            Add(results, "Float8 diffusion", Float8(FloatInputsA[8 * group]));
+        }
+        Add(results, "Float8 MulAdd", MulAdd(Float8::Load(MulAddInputsA), Float8::Load(MulAddInputsB), Float8::Load(MulAddInputsC)));
+
+        float floatTable[65];
+        std::int16_t int16Table[65];
+        std::uint16_t halfTable[65];
+        for (int i = 0; i < 65; i++)
+        {
+            floatTable[i] = static_cast<float>(i) * 0.5f - 3.0f;
+            int16Table[i] = static_cast<std::int16_t>(i % 2 == 0 ? 32767 - i : -32768 + i);
+            halfTable[i] = HalfSpecials[i % 12];
+        }
+        for (int group = 0; group < 2; group++)
+        {
+            const Int8 indices = Int8::Load(GatherIndices + 8 * group);
+            Add(results, "Gather", Gather(floatTable, indices));
+            Add(results, "GatherInt16", GatherInt16(int16Table, indices));
+            Add(results, "GatherHalf", GatherHalf(halfTable, indices));
+        }
+
+        return results;
+    }
+
+    // Sorties des noyaux de TransformUtils compilés avec le chemin du fichier (voir SimdConformance.h). Les normalisations se font en place.
+    TransformResults RecordTransforms(const TransformInputs& inputs)
+    {
+        const size_t count = inputs.X.size();
+        TransformResults results;
+        results.Backend = Simd::BackendName();
+        for (int k = 0; k < 3; k++)
+        {
+            results.Points[k].resize(count);
+            results.Vectors[k].resize(count);
+            results.Centers[k].resize(count);
+            results.Extents[k].resize(count);
+        }
+
+        const TransformUtils::ConstFloat3Array points(inputs.X.data(), inputs.Y.data(), inputs.Z.data());
+        TransformUtils::TransformPoints(inputs.Matrix, points, { results.Points[0].data(), results.Points[1].data(), results.Points[2].data() }, count);
+        TransformUtils::TransformVectors(inputs.Matrix, points, { results.Vectors[0].data(), results.Vectors[1].data(), results.Vectors[2].data() }, count);
+
+        results.Normalized[0] = inputs.X;
+        results.Normalized[1] = inputs.Y;
+        results.Normalized[2] = inputs.Z;
+        const TransformUtils::Float3Array normalized = { results.Normalized[0].data(), results.Normalized[1].data(), results.Normalized[2].data() };
+        TransformUtils::NormalizeVectors(normalized, normalized, count);
+
+        const TransformUtils::ConstBoundsArray bounds(points, TransformUtils::ConstFloat3Array(inputs.ExtentX.data(), inputs.ExtentY.data(), inputs.ExtentZ.data()));
+        TransformUtils::TransformBounds(inputs.Matrix, bounds,
+            { { results.Centers[0].data(), results.Centers[1].data(), results.Centers[2].data() }, { results.Extents[0].data(), results.Extents[1].data(), results.Extents[2].data() } }, count);
+
+        // 16 octets de plus pour l'écriture décalée. Le buffer d'un std::vector est aligné sur 16 octets.
+        const size_t byteSize = inputs.Matrices.size() * TransposeStride;
+        std::vector<std::uint8_t> buffer(byteSize + 16, TransposePadding);
+        TransformUtils::TransposeMatrices(inputs.Matrices.data(), inputs.Matrices.size(), buffer.data(), TransposeStride);
+        results.Transposed.assign(buffer.begin(), buffer.begin() + byteSize);
+
+        std::fill(buffer.begin(), buffer.end(), TransposePadding);
+        TransformUtils::TransposeMatrices(inputs.Matrices.data(), inputs.Matrices.size(), buffer.data() + 4, TransposeStride);
+        results.TransposedUnaligned.assign(buffer.begin() + 4, buffer.begin() + 4 + byteSize);
+        return results;
+    }
+}
\ No newline at end of file
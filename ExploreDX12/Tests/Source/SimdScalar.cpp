@@ -0,0 +1,15 @@
+// Chemin scalaire, référence des tests de conformité (voir SimdConformance.h).
+#define SIMD_FORCE_SCALAR
+#include "SimdOperations.h"
+// Les noyaux de TransformUtils de ce chemin (voir SimdConformance.h).
+#include "Graphics/TransformUtils.cpp"
+
+SimdResults RecordSimdScalar()
+{
+    return RecordSimdOperations();
+}
+
+TransformResults RecordTransformsScalar(const TransformInputs& inputs)
+{
+    return RecordTransforms(inputs);
+}
\ No newline at end of file
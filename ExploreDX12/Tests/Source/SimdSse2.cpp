@@ -0,0 +1,32 @@
+// Chemin SSE2, même si le projet est compilé pour AVX2 (voir SimdConformance.h).
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_FORCE_SSE2
+#include "SimdOperations.h"
+// Les noyaux de TransformUtils de ce chemin (voir SimdConformance.h), seulement s'il est vraiment compilé ici : sinon, le fichier
+// du chemin plus ancien les fournit déjà.
+#if defined(SIMD_SSE) && !defined(SIMD_SSE41)
+#include "Graphics/TransformUtils.cpp"
+#endif
+
+SimdResults RecordSimdSse2()
+{
+    return RecordSimdOperations();
+}
+
+TransformResults RecordTransformsSse2(const TransformInputs& inputs)
+{
+    return RecordTransforms(inputs);
+}
+#else
+#include "SimdConformance.h"
+
+SimdResults RecordSimdSse2()
+{
+    return {};
+}
+
+TransformResults RecordTransformsSse2(const TransformInputs&)
+{
+    return {};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,32 @@
+// Chemin SSE4.1, même si le projet est compilé pour AVX2 (voir SimdConformance.h). Sans /arch:AVX (MSVC) ou -msse4.1, c'est le chemin SSE2.
+#if defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMD_FORCE_SSE41
+#include "SimdOperations.h"
+// Les noyaux de TransformUtils de ce chemin (voir SimdConformance.h), seulement s'il est vraiment compilé ici : sinon, le fichier
+// du chemin plus ancien les fournit déjà.
+#if defined(SIMD_SSE41) && !defined(SIMD_AVX2)
+#include "Graphics/TransformUtils.cpp"
+#endif
+
+SimdResults RecordSimdSse41()
+{
+    return RecordSimdOperations();
+}
+
+TransformResults RecordTransformsSse41(const TransformInputs& inputs)
+{
+    return RecordTransforms(inputs);
+}
+#else
+#include "SimdConformance.h"
+
+SimdResults RecordSimdSse41()
+{
+    return {};
+}
+
+TransformResults RecordTransformsSse41(const TransformInputs&)
+{
+    return {};
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "Test.h"
+
+#include "SimdConformance.h"
+#include "Utils/Random.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+
+static const SimdResult* FindOperation(const SimdResults& results, const char* name, int occurrence = 0)
+{
+    for (const SimdResult& result : results.Operations)
+    {
+        if (result.Name == name && occurrence-- == 0)
+            return &result;
+    }
+    return nullptr;
+}
+
+static float LaneFloat(std::uint32_t bits)
+{
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Quelques résultats attendus du chemin scalaire lui-même, qui sert de référence aux autres : débordements des produits,
+// arrondi des égalités au pair et saturation à [-32768, 32767].
+static bool CheckScalarReference(const SimdResults& scalar)
+{
+    bool ok = true;
+    const auto lanesEqual = [&](const char* name, int occurrence, std::initializer_list<std::int32_t> expected)
+    {
+        const SimdResult* result = FindOperation(scalar, name, occurrence);
+        if (result == nullptr || result->Lanes.size() != expected.size())
+            return false;
+        int lane = 0;
+        for (std::int32_t value : expected)
+        {
+            if (result->Lanes[lane++] != static_cast<std::uint32_t>(value))
+                return false;
+        }
+        return true;
+    };
+
+    // Groupe 0 : 0xffffffff * 0xffffffff et 2 * 2^31 en non signé. Groupe 1 : INT32_MAX * INT32_MAX, INT32_MIN * -1, -INT32_MAX * INT32_MIN, 32767 * 32767.
+    ok &= Check(lanesEqual("MulLow", 1, { 1, -2147483647 - 1, -2147483647 - 1, 32767 * 32767 }), "scalaire : MulLow déborde mal");
+    ok &= Check(lanesEqual("MulWide high", 1, { 0x3fffffff, 0x7fffffff, 0x40000000, 0 }), "scalaire : MulWide high incorrect");
+    ok &= Check(lanesEqual("MulWide low", 0, { 0, -1, 1, 0 }), "scalaire : MulWide low de 0xffffffff * 0xffffffff incorrect");
+    ok &= Check(lanesEqual("MulWide high", 0, { 0, 0, -2, 1 }), "scalaire : MulWide high de 0xffffffff * 0xffffffff incorrect");
+    // Groupe 3 : 46341 * 46341 dépasse 2^31 de peu.
+    ok &= Check(lanesEqual("MulLow", 3, { static_cast<std::int32_t>(0x12345678u * 0x9abcdef0u), static_cast<std::int32_t>(0xdeadbeefu * 0xdeadbeefu), -2147479015, 2147479015 }),
+        "scalaire : MulLow autour de 2^31 incorrect");
+
+    // 0.5, -0.5, 1.5, -1.5, 2.5, -2.5 : égalités vers le pair.
+    ok &= Check(lanesEqual("RoundToInt", 0, { 0, 0, 0, 0 }) && lanesEqual("RoundToInt", 1, { 2, -2, 2, -2 }), "scalaire : RoundToInt n'arrondit pas les égalités au pair");
+    ok &= Check(lanesEqual("Fixed16 StoreInt16Saturate", 0, { 32766, 32767, 32767, 32767, 32767, -32767, -32768, -32768 }),
+        "scalaire : saturation Fixed16 incorrecte vers 32767");
+    ok &= Check(lanesEqual("Fixed16 StoreInt16Saturate", 1, { -32768, -32768, -32768, 0, 0, 2, -2, 32767 }),
+        "scalaire : saturation Fixed16 incorrecte vers -32768");
+    ok &= Check(lanesEqual("StoreInt16Saturate", 0, { 0, 1, -1, 2, 32767, -32768, -32768, 32767 }), "scalaire : StoreInt16Saturate incorrect");
+    return ok;
+}
+
+// Compare un chemin au chemin scalaire, opération par opération. Une seule différence est écrite par opération.
+static bool CompareWithScalar(const SimdResults& scalar, const SimdResults& results)
+{
+    if (!Check(results.Operations.size() == scalar.Operations.size(), "nombre d'opérations différent du chemin scalaire"))
+        return false;
+
+    bool ok = true;
+    for (size_t i = 0; i < scalar.Operations.size(); i++)
+    {
+        const SimdResult& expected = scalar.Operations[i];
+        const SimdResult& actual = results.Operations[i];
+        for (size_t lane = 0; lane < expected.Lanes.size() && lane < actual.Lanes.size(); lane++)
+        {
+            const bool equal = expected.IsFloat ? LaneFloat(expected.Lanes[lane]) == LaneFloat(actual.Lanes[lane]) : expected.Lanes[lane] == actual.Lanes[lane];
+            if (!equal)
+            {
+                char what[160];
+                std::snprintf(what, sizeof(what), "%s, %s (opération %zu) voie %zu : 0x%08x au lieu de 0x%08x", results.Backend.c_str(), expected.Name.c_str(), i, lane,
+                    actual.Lanes[lane], expected.Lanes[lane]);
+                ok &= Check(false, what);
+                break;
+            }
+        }
+    }
+    return ok;
+}
+
+// Chaque chemin de Utils/Simd.h compilé ici donne les mêmes résultats que le chemin scalaire, voie par voie, sur des entrées qui touchent
+// les bords (débordements, égalités d'arrondi, saturation 16 bits). Les chemins que la plateforme ou les options de compilation excluent sont ignorés.
+static bool TestSimdConformance()
+{
+    const SimdResults scalar = RecordSimdScalar();
+    bool ok = Check(scalar.Backend == "Scalar", "SimdScalar.cpp n'est pas compilé avec le chemin scalaire");
+    ok &= CheckScalarReference(scalar);
+
+    struct Backend
+    {
+        const char* Name;
+        SimdResults (*Record)();
+    };
+    const Backend backends[] = { { "SSE2", &RecordSimdSse2 }, { "SSE4.1", &RecordSimdSse41 }, { "AVX2", &RecordSimdAvx2 }, { "NEON", &RecordSimdNeon } };
+    for (const Backend& backend : backends)
+    {
+        const SimdResults results = backend.Record();
+        if (results.Backend != backend.Name)
+        {
+            std::printf("  %s non compilé ici, ignoré\n", backend.Name);
+            continue;
+        }
+        ok &= CompareWithScalar(scalar, results);
+    }
+    return ok;
+}
+
+// Nombre d'éléments qui n'est pas un multiple de 8, pour passer aussi par le dernier groupe incomplet de TransformUtils.
+constexpr int TransformCount = 83;
+
+static TransformInputs MakeTransformInputs()
+{
+    RandomUtils::Xoshiro generator(11);
+    TransformInputs inputs;
+
+    // Matrice affine quelconque (vecteur ligne : la translation est sur la dernière ligne).
+    for (int row = 0; row < 4; row++)
+    {
+        for (int column = 0; column < 3; column++)
+            inputs.Matrix.m[row][column] = row < 3 ? generator.Randf(-2.0f, 2.0f) : generator.Randf(-10.0f, 10.0f);
+        inputs.Matrix.m[row][3] = row < 3 ? 0.0f : 1.0f;
+    }
+
+    for (int i = 0; i < TransformCount; i++)
+    {
+        inputs.X.push_back(generator.Randf(-50.0f, 50.0f));
+        inputs.Y.push_back(generator.Randf(-50.0f, 50.0f));
+        inputs.Z.push_back(generator.Randf(-50.0f, 50.0f));
+        inputs.ExtentX.push_back(generator.Randf(0.0f, 5.0f));
+        inputs.ExtentY.push_back(generator.Randf(0.0f, 5.0f));
+        inputs.ExtentZ.push_back(generator.Randf(0.0f, 5.0f));
+    }
+    // Un vecteur nul, dans un groupe complet et dans le dernier groupe, et une boîte plate.
+    for (int i : { 3, TransformCount - 2 })
+        inputs.X[i] = inputs.Y[i] = inputs.Z[i] = 0.0f;
+    inputs.ExtentY[5] = 0.0f;
+
+    for (int i = 0; i < 5; i++)
+    {
+        XMFLOAT4X4 matrix;
+        for (int row = 0; row < 4; row++)
+        {
+            for (int column = 0; column < 4; column++)
+                matrix.m[row][column] = static_cast<float>(100 * i + 10 * row + column);
+        }
+        inputs.Matrices.push_back(matrix);
+    }
+    return inputs;
+}
+
+// v * M en double, avec w = 1 pour un point et 0 pour un vecteur. magnitude reçoit la somme des |termes|, qui borne l'erreur d'arrondi.
+static double TransformReference(const XMFLOAT4X4& matrix, double x, double y, double z, double w, int column, double& magnitude)
+{
+    const double terms[4] = { x * matrix.m[0][column], y * matrix.m[1][column], z * matrix.m[2][column], w * matrix.m[3][column] };
+    magnitude = std::fabs(terms[0]) + std::fabs(terms[1]) + std::fabs(terms[2]) + std::fabs(terms[3]);
+    return terms[0] + terms[1] + terms[2] + terms[3];
+}
+
+static bool CloseTo(float actual, double expected, double magnitude)
+{
+    return std::fabs(actual - expected) <= 1e-6 * magnitude + 1e-6;
+}
+
+static bool CheckTransforms(const TransformInputs& inputs, const TransformResults& results)
+{
+    bool points = true;
+    bool vectors = true;
+    bool normalized = true;
+    bool bounds = true;
+    for (int i = 0; i < TransformCount; i++)
+    {
+        const double x = inputs.X[i];
+        const double y = inputs.Y[i];
+        const double z = inputs.Z[i];
+        for (int column = 0; column < 3; column++)
+        {
+            double magnitude;
+            const double point = TransformReference(inputs.Matrix, x, y, z, 1.0, column, magnitude);
+            points &= CloseTo(results.Points[column][i], point, magnitude);
+            const double vector = TransformReference(inputs.Matrix, x, y, z, 0.0, column, magnitude);
+            vectors &= CloseTo(results.Vectors[column][i], vector, magnitude);
+        }
+
+        // Un vecteur nul doit rester nul, pas devenir NaN.
+        const double length = std::sqrt(x * x + y * y + z * z);
+        const double components[3] = { x, y, z };
+        for (int k = 0; k < 3; k++)
+            normalized &= length == 0.0 ? results.Normalized[k][i] == 0.0f : CloseTo(results.Normalized[k][i], components[k] / length, 1.0);
+
+        // Boîte englobante des 8 coins transformés, comparée à centre +- demi-tailles.
+        const double extents[3] = { inputs.ExtentX[i], inputs.ExtentY[i], inputs.ExtentZ[i] };
+        for (int column = 0; column < 3; column++)
+        {
+            double lowest = 1e30;
+            double highest = -1e30;
+            double magnitude = 0.0;
+            for (int corner = 0; corner < 8; corner++)
+            {
+                double cornerMagnitude;
+                const double value = TransformReference(inputs.Matrix, x + ((corner & 1) ? extents[0] : -extents[0]), y + ((corner & 2) ? extents[1] : -extents[1]),
+                    z + ((corner & 4) ? extents[2] : -extents[2]), 1.0, column, cornerMagnitude);
+                lowest = std::fmin(lowest, value);
+                highest = std::fmax(highest, value);
+                magnitude = std::fmax(magnitude, cornerMagnitude);
+            }
+            const double center = results.Centers[column][i];
+            const double extent = results.Extents[column][i];
+            bounds &= extent >= 0.0 && CloseTo(static_cast<float>(center - extent), lowest, magnitude) && CloseTo(static_cast<float>(center + extent), highest, magnitude);
+        }
+    }
+
+    // La transposée est exacte, et les octets entre deux matrices ne sont pas touchés.
+    bool transposed = true;
+    for (const std::vector<std::uint8_t>* bytes : { &results.Transposed, &results.TransposedUnaligned })
+    {
+        transposed &= bytes->size() == inputs.Matrices.size() * TransposeStride;
+        for (size_t i = 0; transposed && i < inputs.Matrices.size(); i++)
+        {
+            float written[16];
+            std::memcpy(written, bytes->data() + i * TransposeStride, sizeof(written));
+            for (int row = 0; row < 4; row++)
+            {
+                for (int column = 0; column < 4; column++)
+                    transposed &= written[4 * row + column] == inputs.Matrices[i].m[column][row];
+            }
+            for (size_t byte = sizeof(written); byte < TransposeStride; byte++)
+                transposed &= (*bytes)[i * TransposeStride + byte] == TransposePadding;
+        }
+    }
+
+    char what[96];
+    bool ok = true;
+    std::snprintf(what, sizeof(what), "%s : TransformPoints différent de v * M", results.Backend.c_str());
+    ok &= Check(points, what);
+    std::snprintf(what, sizeof(what), "%s : TransformVectors différent de v * M sans translation", results.Backend.c_str());
+    ok &= Check(vectors, what);
+    std::snprintf(what, sizeof(what), "%s : NormalizeVectors incorrect (ou vecteur nul non nul)", results.Backend.c_str());
+    ok &= Check(normalized, what);
+    std::snprintf(what, sizeof(what), "%s : TransformBounds différent de la boîte des 8 coins transformés", results.Backend.c_str());
+    ok &= Check(bounds, what);
+    std::snprintf(what, sizeof(what), "%s : TransposeMatrices incorrect avec un pas de %zu octets", results.Backend.c_str(), TransposeStride);
+    ok &= Check(transposed, what);
+    return ok;
+}
+
+// Les noyaux de Graphics/TransformUtils.h de chaque chemin compilé ici, comparés à un calcul direct en double : points et vecteurs par v * M,
+// normalisation (vecteur nul compris), boîtes englobantes contre les 8 coins transformés et transposition dans un buffer à pas de 256 octets.
+static bool TestSimdTransforms()
+{
+    const TransformInputs inputs = MakeTransformInputs();
+    bool ok = true;
+
+    struct Backend
+    {
+        const char* Name;
+        TransformResults (*Record)(const TransformInputs&);
+    };
+    const Backend backends[] = { { "Scalar", &RecordTransformsScalar }, { "SSE2", &RecordTransformsSse2 }, { "SSE4.1", &RecordTransformsSse41 },
+        { "AVX2", &RecordTransformsAvx2 }, { "NEON", &RecordTransformsNeon } };
+    for (const Backend& backend : backends)
+    {
+        const TransformResults results = backend.Record(inputs);
+        if (results.Backend != backend.Name)
+        {
+            std::printf("  %s non compilé ici, ignoré\n", backend.Name);
+            continue;
+        }
+        ok &= CheckTransforms(inputs, results);
+    }
+    return ok;
+}
+
+static const TestRegistration simdConformanceTest("simd-conformance", &TestSimdConformance);
+static const TestRegistration simdTransformsTest("simd-transforms", &TestSimdTransforms);
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <vector>
+
+// Tests fonctionnels du code CPU, sans fenêtre ni GPU (voir Graphics/NullDevice.h) : chaque fichier enregistre ses tests
+// par un TestRegistration statique, et Main les lance par nom. Un test écrit la raison de chaque échec sur stderr et renvoie false.
+using TestFunction = bool (*)();
+
+struct TestCase
+{
+    const char* Name = nullptr;
+    TestFunction Function = nullptr;
+};
+
+struct TestRegistration
+{
+    TestRegistration(const char* name, TestFunction function);
+};
+
+// Tests enregistrés, dans l'ordre d'enregistrement.
+std::vector<TestCase>& RegisteredTests();
+
+// Écrit what sur stderr si condition est fausse, et renvoie condition : ok &= Check(..., "...").
+bool Check(bool condition, const char* what);
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "Test.h"
+
+#include "Utils/Random.h"
+#include "Utils/TlsfAllocator.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// Découpe d'un bloc et fusion des blocs libres voisins dans les deux sens : l'espace libéré redevient un seul bloc.
+static bool TestTlsfSplitMerge()
+{
+    bool ok = true;
+    TlsfAllocator allocator(1024 * 1024, 256);
+
+    const TlsfAllocator::Allocation a = allocator.Allocate(1000);
+    const TlsfAllocator::Allocation b = allocator.Allocate(1024);
+    const TlsfAllocator::Allocation c = allocator.Allocate(1);
+    ok &= Check(a.Offset == 0 && a.ByteSize == 1024 && b.Offset == 1024 && c.Offset == 2048 && c.ByteSize == 256, "découpe ou arrondi à la granularité incorrects");
+    ok &= Check(allocator.GetStats().FreeBlockCount == 1 && allocator.Validate(), "invariants fausses après les allocations");
+
+    // b seul : un trou entre deux allocations, plus le reste de l'espace.
+    allocator.Free(b.Handle);
+    ok &= Check(allocator.GetStats().FreeBlockCount == 2 && allocator.Validate(), "bloc libéré au milieu");
+    // a se fusionne avec le bloc libre qui le suit.
+    allocator.Free(a.Handle);
+    ok &= Check(allocator.GetStats().FreeBlockCount == 2 && allocator.GetStats().LargestFreeBlock == 1024 * 1024 - 2304 && allocator.Validate(), "fusion avec le bloc suivant");
+    // c se fusionne des deux côtés.
+    allocator.Free(c.Handle);
+    const TlsfAllocator::Stats stats = allocator.GetStats();
+    ok &= Check(stats.FreeBlockCount == 1 && stats.LargestFreeBlock == stats.Capacity && stats.UsedBytes == 0 && stats.AllocationCount == 0 && allocator.Validate(),
+        "l'espace n'est pas revenu à un seul bloc libre");
+
+    // Le premier bloc réutilise le début de l'espace.
+    ok &= Check(allocator.Allocate(4096).Offset == 0, "espace libéré non réutilisé");
+    return ok;
+}
+
+// Un alignement plus grand que la granularité laisse un bloc libre devant l'allocation, réutilisable par les petites allocations.
+static bool TestTlsfAlignment()
+{
+    bool ok = true;
+    TlsfAllocator allocator(1024 * 1024, 256);
+
+    const TlsfAllocator::Allocation small = allocator.Allocate(256);
+    const TlsfAllocator::Allocation aligned = allocator.Allocate(1000, 64 * 1024);
+    ok &= Check(aligned.IsValid() && aligned.Offset == 64 * 1024, "allocation alignée mal placée");
+    ok &= Check(allocator.Allocate(256).Offset == 256, "début perdu par l'alignement non réutilisé");
+    ok &= Check(allocator.Validate(), "invariants fausses après une allocation alignée");
+
+    for (std::uint64_t alignment = 256; alignment <= 256 * 1024; alignment *= 2)
+    {
+        const TlsfAllocator::Allocation allocation = allocator.Allocate(768, alignment);
+        char what[64];
+        std::snprintf(what, sizeof(what), "décalage non aligné sur %llu", static_cast<unsigned long long>(alignment));
+        ok &= Check(allocation.IsValid() && allocation.Offset % alignment == 0, what);
+    }
+    ok &= Check(allocator.Validate(), "invariants fausses après les allocations alignées");
+
+    allocator.Free(small.Handle);
+    allocator.Free(aligned.Handle);
+    ok &= Check(allocator.Validate(), "invariants fausses après les libérations");
+    return ok;
+}
+
+// Un espace plein refuse proprement, et un trou ne sert qu'aux allocations qui y tiennent.
+static bool TestTlsfExhaustion()
+{
+    bool ok = true;
+    constexpr std::uint64_t Granularity = 4096;
+    TlsfAllocator allocator(16 * Granularity, Granularity);
+
+    ok &= Check(!allocator.Allocate(16 * Granularity + 1).IsValid(), "allocation plus grande que l'espace acceptée");
+
+    std::vector<TlsfAllocator::Allocation> allocations;
+    for (int i = 0; i < 16; i++)
+        allocations.push_back(allocator.Allocate(Granularity));
+    bool allValid = true;
+    for (const TlsfAllocator::Allocation& allocation : allocations)
+        allValid &= allocation.IsValid();
+    ok &= Check(allValid, "espace non rempli entièrement");
+    ok &= Check(!allocator.Allocate(1).IsValid(), "allocation acceptée dans un espace plein");
+    ok &= Check(allocator.GetStats().FreeBlockCount == 0 && allocator.GetStats().Fragmentation == 0.0f && allocator.Validate(), "statistiques d'un espace plein");
+
+    // Deux trous séparés : 8 Ko ne tiennent nulle part, 4 Ko reprennent un des trous.
+    allocator.Free(allocations[3].Handle);
+    allocator.Free(allocations[9].Handle);
+    ok &= Check(allocator.GetStats().Fragmentation > 0.0f, "fragmentation nulle avec deux trous");
+    ok &= Check(!allocator.Allocate(2 * Granularity).IsValid(), "allocation plus grande que chaque trou acceptée");
+    const TlsfAllocator::Allocation refill = allocator.Allocate(Granularity);
+    ok &= Check(refill.IsValid() && (refill.Offset == 3 * Granularity || refill.Offset == 9 * Granularity), "trou non réutilisé");
+
+    // Les poignées libérées sont réutilisées : le tableau des blocs ne grandit plus.
+    for (int i = 0; i < 1000; i++)
+    {
+        allocator.Free(refill.Handle);
+        if (allocator.Allocate(Granularity).Handle != refill.Handle)
+        {
+            ok &= Check(false, "poignée non réutilisée");
+            break;
+        }
+    }
+    ok &= Check(allocator.Validate(), "invariants fausses après les libérations");
+    return ok;
+}
+
+// Allocations et libérations aléatoires, d'alignements variés, dans un espace simulé où chaque allocation est remplie de sa poignée :
+// Defragment doit déplacer les données comme l'appelant le ferait (zones qui se chevauchent), garder chaque alignement et regrouper l'espace libre.
+static bool TestTlsfDefragment()
+{
+    bool ok = true;
+    constexpr std::uint64_t Capacity = 4 * 1024 * 1024;
+    constexpr std::uint64_t Granularity = 256;
+    TlsfAllocator allocator(Capacity, Granularity);
+    std::vector<std::uint8_t> memory(Capacity);
+    RandomUtils::Xoshiro generator(7);
+
+    struct Live
+    {
+        TlsfAllocator::Allocation Allocation;
+        std::uint64_t Alignment = 1;
+    };
+    std::vector<Live> live;
+
+    const auto fill = [&](const TlsfAllocator::Allocation& allocation)
+    {
+        std::memset(memory.data() + allocation.Offset, static_cast<int>(allocation.Handle & 0xff), allocation.ByteSize);
+    };
+
+    for (int step = 0; step < 4000; step++)
+    {
+        if (!live.empty() && generator.Rand(0, 2) == 0)
+        {
+            const int victim = generator.Rand(0, static_cast<int>(live.size()) - 1);
+            allocator.Free(live[victim].Allocation.Handle);
+            live[victim] = live.back();
+            live.pop_back();
+        }
+        else
+        {
+            const std::uint64_t alignment = generator.Rand(0, 7) == 0 ? 64 * 1024 : 1;
+            const TlsfAllocator::Allocation allocation = allocator.Allocate(static_cast<std::uint64_t>(generator.Rand(1, 32 * 1024)), alignment);
+            if (allocation.IsValid())
+            {
+                fill(allocation);
+                live.push_back({ allocation, alignment });
+            }
+        }
+    }
+    ok &= Check(allocator.Validate(), "invariants fausses après les allocations aléatoires");
+
+    std::uint32_t movedCount = 0;
+    const std::uint32_t reported = allocator.Defragment([&](std::uint32_t, std::uint64_t oldOffset, std::uint64_t newOffset, std::uint64_t byteSize)
+    {
+        std::memmove(memory.data() + newOffset, memory.data() + oldOffset, byteSize);
+        movedCount++;
+    });
+    ok &= Check(reported == movedCount && movedCount > 0, "nombre de déplacements incorrect");
+    ok &= Check(allocator.Validate(), "invariants fausses après Defragment");
+
+    bool intact = true;
+    bool aligned = true;
+    for (const Live& entry : live)
+    {
+        const std::uint64_t offset = allocator.Offset(entry.Allocation.Handle);
+        aligned &= offset % entry.Alignment == 0;
+        for (std::uint64_t i = 0; i < entry.Allocation.ByteSize; i++)
+            intact &= memory[offset + i] == static_cast<std::uint8_t>(entry.Allocation.Handle & 0xff);
+    }
+    ok &= Check(intact, "données perdues par Defragment");
+    ok &= Check(aligned, "alignement perdu par Defragment");
+    ok &= Check(allocator.GetStats().Fragmentation < 0.1f, "espace libre encore émietté après Defragment");
+
+    // Sans alignement particulier, tout l'espace libre finit d'un seul tenant.
+    TlsfAllocator packed(Capacity, Granularity);
+    std::vector<std::uint32_t> handles;
+    for (int i = 0; i < 64; i++)
+        handles.push_back(packed.Allocate(static_cast<std::uint64_t>(generator.Rand(1, 64 * 1024))).Handle);
+    for (size_t i = 0; i < handles.size(); i += 2)
+        packed.Free(handles[i]);
+    packed.Defragment([](std::uint32_t, std::uint64_t, std::uint64_t, std::uint64_t) {});
+    const TlsfAllocator::Stats stats = packed.GetStats();
+    ok &= Check(stats.FreeBlockCount == 1 && stats.LargestFreeBlock == Capacity - stats.UsedBytes && packed.Validate(), "espace libre non regroupé");
+    ok &= Check(packed.Defragment([](std::uint32_t, std::uint64_t, std::uint64_t, std::uint64_t) {}) == 0, "second Defragment a déplacé des allocations");
+    return ok;
+}
+
+static const TestRegistration tlsfSplitMergeTest("tlsf-split-merge", &TestTlsfSplitMerge);
+static const TestRegistration tlsfAlignmentTest("tlsf-alignment", &TestTlsfAlignment);
+static const TestRegistration tlsfExhaustionTest("tlsf-exhaustion", &TestTlsfExhaustion);
+static const TestRegistration tlsfDefragmentTest("tlsf-defragment", &TestTlsfDefragment);
\ No newline at end of file
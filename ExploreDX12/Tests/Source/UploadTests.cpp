@@ -0,0 +1,102 @@
+#include "Test.h"
+
+#include "Graphics/DirectXMathUtils.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/UploadPacker.h"
+#include "Utils/Random.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+// Données initiales de buffers de 256 octets à 256 Ko, envoyées comme le fait UploadManager : même découpage par UploadPacker,
+// une command list de copies par lot, et attente du plus ancien lot quand le staging, volontairement petit, est plein.
+// Chaque buffer doit finir avec ses données, sans qu'aucune plage du staging ne soit réécrite avant la fin de sa copie.
+static bool RunUploads(int uploadCount, float copyLatencyMilliseconds)
+{
+    constexpr std::uint64_t StagingByteSize = 1024 * 1024;
+
+    RandomUtils::Xoshiro generator(1);
+    std::vector<std::unique_ptr<NullDevice::Buffer>> buffers;
+    std::vector<std::vector<std::uint32_t>> contents;
+    for (int i = 0; i < uploadCount; i++)
+    {
+        // Distribution log-uniforme : beaucoup de petits buffers et quelques gros, dont certains à découper.
+        const size_t wordCount = static_cast<size_t>(std::exp2(generator.Randf(6.0f, 16.0f)));
+        contents.emplace_back(wordCount);
+        generator.Fill(contents.back().data(), wordCount);
+        buffers.push_back(std::make_unique<NullDevice::Buffer>(wordCount * sizeof(std::uint32_t)));
+    }
+
+    NullDevice::Buffer staging(StagingByteSize);
+    UploadPacker packer(StagingByteSize);
+    NullDevice::CommandList commandList;
+    NullDevice::CommandQueue copyQueue;
+    NullDevice::Fence fence;
+    std::uint64_t currentFence = 0;
+    copyQueue.SetLatency(std::chrono::duration_cast<NullDevice::Clock::duration>(std::chrono::duration<float, std::milli>(copyLatencyMilliseconds)));
+    copyQueue.SetValidation(true);
+
+    const auto submit = [&]
+    {
+        if (!packer.HasPendingCopies())
+            return;
+
+        commandList.Reset();
+        for (const UploadPacker::Copy& copy : packer.PendingCopies())
+        {
+            commandList.CopyBufferRegion(buffers[copy.Destination]->GetGPUVirtualAddress() + copy.DestinationOffset,
+                staging.GetGPUVirtualAddress() + copy.StagingOffset, static_cast<std::uint32_t>(copy.ByteSize));
+        }
+        commandList.Close();
+        copyQueue.ExecuteCommandList(commandList);
+        copyQueue.Signal(fence, ++currentFence);
+        packer.CloseBatch(currentFence);
+    };
+
+    for (int i = 0; i < uploadCount; i++)
+    {
+        packer.Retire(fence.GetCompletedValue());
+
+        const std::uint8_t* source = reinterpret_cast<const std::uint8_t*>(contents[i].data());
+        std::uint64_t remaining = contents[i].size() * sizeof(std::uint32_t);
+        std::uint64_t offset = 0;
+        while (remaining > 0)
+        {
+            const std::uint64_t chunkByteSize = DirectXMathUtils::Min(remaining, packer.MaxCopyByteSize());
+            const std::uint64_t stagingOffset = packer.Add(static_cast<std::uint32_t>(i), offset, chunkByteSize);
+            if (stagingOffset == UploadPacker::InvalidOffset)
+            {
+                submit();
+                fence.Wait(packer.OldestBatchFence());
+                packer.Retire(fence.GetCompletedValue());
+                continue;
+            }
+
+            memcpy(staging.MappedData() + stagingOffset, source + offset, chunkByteSize);
+            offset += chunkByteSize;
+            remaining -= chunkByteSize;
+        }
+    }
+    submit();
+    fence.Wait(currentFence);
+    packer.Retire(currentFence);
+
+    bool ok = Check(fence.ConflictCount() == 0, "staging réécrit avant la fin de sa copie");
+    ok &= Check(packer.Ring().UsedBytes() == 0, "staging encore utilisé après la dernière fence");
+    ok &= Check(packer.GetStats().StallCount > 0, "le staging aurait dû se remplir");
+    bool intact = true;
+    for (int i = 0; i < uploadCount; i++)
+        intact &= memcmp(buffers[i]->MappedData(), contents[i].data(), buffers[i]->ByteSize()) == 0;
+    ok &= Check(intact, "buffer différent de ses données");
+    return ok;
+}
+
+static bool TestUploads()
+{
+    return RunUploads(300, 0.0f) && RunUploads(100, 0.5f);
+}
+
+static const TestRegistration uploadsTest("uploads", &TestUploads);
\ No newline at end of file
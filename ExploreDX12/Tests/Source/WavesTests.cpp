@@ -0,0 +1,170 @@
+#include "Test.h"
+
+#include "Waves.h"
+#include "Utils/ParallelUtils.h"
+#include "Utils/Random.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+// FNV-1a sur les bits des hauteurs après steps étapes de pluie tirée d'une graine fixe.
+static std::uint64_t WavesChecksum(int size, Waves::StoragePrecision precision, int steps)
+{
+    Waves waves(size, size, 1.0f, 0.03f, 4.0f, 0.2f, precision, 4.0f);
+    RandomUtils::Xoshiro generator(1);
+    std::vector<Waves::Disturbance> drops(4);
+    for (int step = 0; step < steps; step++)
+    {
+        for (Waves::Disturbance& drop : drops)
+        {
+            drop.X = generator.Randf(-0.9f, 0.9f) * waves.HalfWidth();
+            drop.Z = generator.Randf(-0.9f, 0.9f) * waves.HalfDepth();
+            drop.Radius = generator.Randf(1.5f, 4.0f) * waves.SpatialStep();
+            drop.Magnitude = generator.Randf(0.1f, 0.4f);
+        }
+        waves.Disturb(drops.data(), drops.size());
+        // Un Update de exactement dt fait toujours une étape, ce qui garde la simulation indépendante de l'horloge.
+        waves.Update(0.03f);
+    }
+
+    std::uint64_t checksum = 14695981039346656037ull;
+    for (int i = 0; i < waves.VertexCount(); i++)
+    {
+        const float height = waves.Position(i).y;
+        std::uint32_t bits;
+        std::memcpy(&bits, &height, sizeof(bits));
+        for (int byte = 0; byte < 4; byte++)
+            checksum = (checksum ^ ((bits >> (8 * byte)) & 0xff)) * 1099511628211ull;
+    }
+    return checksum;
+}
+
+// La simulation découpe la grille entre les threads de ParallelUtils : le résultat doit être le même au bit près quel que soit leur nombre.
+static bool TestWavesDeterminism()
+{
+    bool ok = true;
+    for (Waves::StoragePrecision precision : { Waves::StoragePrecision::Float32, Waves::StoragePrecision::Float16, Waves::StoragePrecision::Fixed16 })
+    {
+        ParallelUtils::SetThreadCount(1);
+        const std::uint64_t reference = WavesChecksum(256, precision, 60);
+        for (int threadCount : { 2, 3, 8 })
+        {
+            ParallelUtils::SetThreadCount(threadCount);
+            char what[96];
+            std::snprintf(what, sizeof(what), "précision %d, %d threads : hauteurs différentes d'un seul thread", static_cast<int>(precision), threadCount);
+            ok &= Check(WavesChecksum(256, precision, 60) == reference, what);
+        }
+    }
+    ParallelUtils::SetThreadCount(0);
+    return ok;
+}
+
+// Interpolation bilinéaire directe, en double, des hauteurs écrites par Interpolate : même cellule et même bord que SampleSurface,
+// normale tirée des dérivées de la surface bilinéaire. Les coordonnées dans la grille sont calculées en float comme le fait SampleSurface :
+// l'arrondi de x + HalfWidth() vaut déjà quelques 1e-6 cellule loin du centre, bien plus que l'erreur de l'interpolation elle-même.
+static void SampleReference(const Waves& waves, const std::vector<XMFLOAT3>& positions, float x, float z, double& height, double normal[3])
+{
+    const int rowCount = waves.RowCount();
+    const int columnCount = waves.ColumnCount();
+    const double step = waves.SpatialStep();
+    const float invStep = 1.0f / waves.SpatialStep();
+    const double column = std::fmin(std::fmax((x + waves.HalfWidth()) * invStep, 0.0f), columnCount - 1.0f);
+    const double row = std::fmin(std::fmax((waves.HalfDepth() - z) * invStep, 0.0f), rowCount - 1.0f);
+    const int j0 = static_cast<int>(std::fmin(std::floor(column), columnCount - 2.0));
+    const int i0 = static_cast<int>(std::fmin(std::floor(row), rowCount - 2.0));
+    const double fx = column - j0;
+    const double fz = row - i0;
+
+    const double h00 = positions[i0 * columnCount + j0].y;
+    const double h01 = positions[i0 * columnCount + j0 + 1].y;
+    const double h10 = positions[(i0 + 1) * columnCount + j0].y;
+    const double h11 = positions[(i0 + 1) * columnCount + j0 + 1].y;
+    height = (1.0 - fz) * ((1.0 - fx) * h00 + fx * h01) + fz * ((1.0 - fx) * h10 + fx * h11);
+
+    // Les lignes vont vers -z : dh/dz = -dh/di / step.
+    const double dhdx = ((1.0 - fz) * (h01 - h00) + fz * (h11 - h10)) / step;
+    const double dhdz = -((1.0 - fx) * (h10 - h00) + fx * (h11 - h01)) / step;
+    const double length = std::sqrt(dhdx * dhdx + 1.0 + dhdz * dhdz);
+    normal[0] = -dhdx / length;
+    normal[1] = 1.0 / length;
+    normal[2] = -dhdz / length;
+}
+
+// SampleSurface comparé à l'interpolation bilinéaire des sommets d'Interpolate, pour les trois formats de stockage, sur des positions tirées
+// au hasard dont une partie hors de la grille (ramenées sur le bord), assez nombreuses pour être découpées en plusieurs blocs parallèles.
+// Bornes d'erreur : 2e-6 sur la hauteur, 2e-7 sur chaque composante de la normale.
+static bool TestWavesSampling()
+{
+    bool ok = true;
+    for (Waves::StoragePrecision precision : { Waves::StoragePrecision::Float32, Waves::StoragePrecision::Float16, Waves::StoragePrecision::Fixed16 })
+    {
+        Waves waves(83, 97, 1.0f, 0.03f, 4.0f, 0.2f, precision, 4.0f);
+        RandomUtils::Xoshiro generator(3);
+        std::vector<Waves::Disturbance> drops(6);
+        for (int step = 0; step < 40; step++)
+        {
+            for (Waves::Disturbance& drop : drops)
+            {
+                drop.X = generator.Randf(-0.9f, 0.9f) * waves.HalfWidth();
+                drop.Z = generator.Randf(-0.9f, 0.9f) * waves.HalfDepth();
+                drop.Radius = generator.Randf(1.5f, 4.0f) * waves.SpatialStep();
+                drop.Magnitude = generator.Randf(0.1f, 0.4f);
+            }
+            waves.Disturb(drops.data(), drops.size());
+            waves.Update(0.03f);
+        }
+
+        // Positions jusqu'à 20 % au-delà du bord, puis les coins exacts et des points loin de la grille.
+        constexpr size_t Count = 5000;
+        std::vector<float> x(Count);
+        std::vector<float> z(Count);
+        for (size_t k = 0; k < Count; k++)
+        {
+            x[k] = generator.Randf(-1.2f, 1.2f) * waves.HalfWidth();
+            z[k] = generator.Randf(-1.2f, 1.2f) * waves.HalfDepth();
+        }
+        const float corners[][2] = { { -waves.HalfWidth(), waves.HalfDepth() }, { waves.HalfWidth(), -waves.HalfDepth() }, { 0.0f, 0.0f }, { 1e6f, -1e6f }, { -1e6f, 1e6f } };
+        for (size_t k = 0; k < sizeof(corners) / sizeof(corners[0]); k++)
+        {
+            x[k] = corners[k][0];
+            z[k] = corners[k][1];
+        }
+
+        std::vector<XMFLOAT3> positions(waves.VertexCount());
+        std::vector<XMFLOAT3> vertexNormals(waves.VertexCount());
+        std::vector<float> heights(Count);
+        std::vector<XMFLOAT3> normals(Count);
+        for (float alpha : { 1.0f, 0.35f })
+        {
+            waves.Interpolate(alpha, positions.data(), vertexNormals.data());
+            waves.SampleSurface(x.data(), z.data(), Count, heights.data(), normals.data(), alpha);
+
+            double heightError = 0.0;
+            double normalError = 0.0;
+            double peakHeight = 0.0;
+            for (size_t k = 0; k < Count; k++)
+            {
+                double height;
+                double normal[3];
+                SampleReference(waves, positions, x[k], z[k], height, normal);
+                heightError = std::fmax(heightError, std::fabs(heights[k] - height));
+                normalError = std::fmax(normalError, std::fmax(std::fabs(normals[k].x - normal[0]), std::fmax(std::fabs(normals[k].y - normal[1]), std::fabs(normals[k].z - normal[2]))));
+                peakHeight = std::fmax(peakHeight, std::fabs(height));
+            }
+
+            char what[128];
+            std::snprintf(what, sizeof(what), "précision %d, alpha %.2f : surface plate, la comparaison ne vérifierait rien", static_cast<int>(precision), alpha);
+            ok &= Check(peakHeight > 0.01, what);
+            std::snprintf(what, sizeof(what), "précision %d, alpha %.2f : hauteur à %.2e de l'interpolation bilinéaire", static_cast<int>(precision), alpha, heightError);
+            ok &= Check(heightError <= 2e-6, what);
+            std::snprintf(what, sizeof(what), "précision %d, alpha %.2f : normale à %.2e de celle de la surface bilinéaire", static_cast<int>(precision), alpha, normalError);
+            ok &= Check(normalError <= 2e-7, what);
+        }
+    }
+    return ok;
+}
+
+static const TestRegistration wavesDeterminismTest("waves-determinism", &TestWavesDeterminism);
+static const TestRegistration wavesSamplingTest("waves-sampling", &TestWavesSampling);
\ No newline at end of file
@@ -0,0 +1,239 @@
+#include "HeadlessFrames.h"
+
+#include "LitWavesFrame.h"
+#include "Graphics/ElementSpan.h"
+#include "Graphics/FramePacer.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/PipelineCache.h"
+#include "Utils/DirtyTracker.h"
+#include "Utils/Hasher.h"
+#include "Utils/Random.h"
+#include "Utils/RingAllocator.h"
+
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Tailles des constant buffers de LitWavesApp (voir FrameResource.h), arrondies à 256 octets comme le fait CalcConstantBufferByteSize.
+constexpr std::uint32_t ConstantBufferElementSize = 256;
+// Même taille que LitWavesApp::UploadRingByteSize.
+constexpr std::uint64_t UploadRingByteSize = 256 * 1024;
+
+// Ressources d'une frame de LitWavesApp (voir FrameResource.h), en mémoire hôte. Les constantes de passe sont allouées dans l'anneau à chaque frame,
+// les constantes d'objet et de matériau restent dans la frame resource.
+struct HeadlessFrameResource
+{
+    HeadlessFrameResource(std::uint32_t objectCount, std::uint32_t materialCount, size_t wavesVertexBufferByteSize)
+        : ObjectCB(objectCount * ConstantBufferElementSize), MaterialCB(materialCount * ConstantBufferElementSize), WavesVB(wavesVertexBufferByteSize),
+        ObjectConstantsSpan(ObjectCB.MappedData(), ConstantBufferElementSize, objectCount),
+        MaterialConstantsSpan(MaterialCB.MappedData(), ConstantBufferElementSize, materialCount)
+    {
+    }
+
+    std::uint8_t* PassCB = nullptr;
+    NullDevice::Buffer ObjectCB;
+    NullDevice::Buffer MaterialCB;
+    NullDevice::Buffer WavesVB;
+    ElementSpan<ObjectConstants> ObjectConstantsSpan;
+    ElementSpan<MaterialConstants> MaterialConstantsSpan;
+    std::uint64_t WavesStep = Waves::NeverWritten;
+    std::uint64_t Fence = 0;
+};
+
+HeadlessFrameResult RunHeadlessFrames(const HeadlessFrameSettings& settings)
+{
+    enum : std::uint32_t { StatePresent = 0, StateRenderTarget = 4, TopologyTriangleList = 4 };
+    constexpr int BackBufferCount = 2;
+    constexpr int Width = 1280;
+    constexpr int Height = 720;
+    constexpr std::uint32_t PassCBByteSize = (sizeof(PassConstants) + ConstantBufferElementSize - 1) & ~(ConstantBufferElementSize - 1);
+
+    // La simulation tourne sur son propre thread, comme dans l'application.
+    Waves waves(settings.Size, settings.Size, 1.0f, 0.03f, 4.0f, 0.2f);
+    waves.SetSleepThreshold(settings.SleepThreshold);
+    waves.StartAsync();
+    const WavesConstants wavesConstants = LitWavesFrame::MakeWavesConstants(waves);
+
+    const WavesVertexFormat vertexFormat = settings.VertexFormat;
+    const std::uint32_t vertexByteSize = LitWavesFrame::WavesVertexByteSize(vertexFormat);
+    const std::uint32_t wavesVertexBufferByteSize = static_cast<std::uint32_t>(waves.ChunkedVertexCount() * vertexByteSize);
+
+    // Grille de 50 x 50 sommets du terrain, et index buffer 16 bits d'un bloc de l'eau.
+    const std::uint32_t landIndexCount = 49 * 49 * 6;
+    const std::uint32_t chunkIndexCount = 6 * waves.ChunkRowSize() * waves.ChunkColumnSize();
+    NullDevice::Buffer landVB(50 * 50 * sizeof(Vertex));
+    NullDevice::Buffer landIB(landIndexCount * sizeof(std::uint16_t));
+    NullDevice::Buffer wavesIB(chunkIndexCount * sizeof(std::uint16_t));
+
+    // Le swap chain et le depth buffer n'ont pas d'équivalent dans NullDevice : des buffers de la même taille leur donnent des identifiants distincts.
+    std::vector<std::unique_ptr<NullDevice::Buffer>> backBuffers;
+    for (int i = 0; i < BackBufferCount; i++)
+        backBuffers.push_back(std::make_unique<NullDevice::Buffer>(Width * Height * 4));
+    NullDevice::Buffer depthStencil(Width * Height * 4);
+    int currentBackBuffer = 0;
+
+    // Même root signature et mêmes PSO que l'application, créés par le Device à travers un PipelineCache.
+    NullDevice::Device device;
+    const std::uint64_t rootSignature = device.CreateRootSignature();
+    const auto pipelineKey = [](const std::string& name)
+    {
+        Hasher hasher;
+        hasher.Add(name);
+        return hasher.Finish();
+    };
+    PipelineCache<std::uint64_t> pipelines(1);
+    pipelines.Request(pipelineKey("opaque"), [&device] { return device.CreateGraphicsPipelineState(); });
+    pipelines.Request(pipelineKey("waves"), [&device] { return device.CreateGraphicsPipelineState(); });
+    const std::uint64_t opaquePSO = pipelines.Get(pipelineKey("opaque"));
+    const std::uint64_t wavesPSO = pipelines.Get(pipelineKey("waves"));
+
+    // Objets et matériaux de LitWavesApp::BuildRenderItems et BuildMaterials : l'eau puis le terrain, l'herbe puis l'eau.
+    enum : std::uint32_t { WavesObject = 0, LandObject, ObjectCount };
+    Material grass("grass", 0, XMFLOAT4(0.2f, 0.6f, 0.2f, 1.0f), XMFLOAT3(0.01f, 0.01f, 0.01f), 0.125f);
+    Material water("water", 1, XMFLOAT4(0.0f, 0.2f, 0.6f, 1.0f), XMFLOAT3(0.1f, 0.1f, 0.1f), 0.0f);
+    const std::vector<Material*> materialsByCBIndex = { &grass, &water };
+    const XMFLOAT4X4 worlds[ObjectCount] = { DirectXMathUtils::Identity4x4(), DirectXMathUtils::Identity4x4() };
+    DirtyTracker objectsDirty(settings.FramesInFlight);
+    DirtyTracker materialsDirty(settings.FramesInFlight);
+    objectsDirty.Resize(ObjectCount);
+    materialsDirty.Resize(materialsByCBIndex.size());
+
+    NullDevice::Buffer uploadBuffer(UploadRingByteSize);
+    RingAllocator uploadRing(UploadRingByteSize);
+
+    std::vector<std::unique_ptr<HeadlessFrameResource>> frameResources;
+    for (int i = 0; i < settings.FramesInFlight; i++)
+        frameResources.push_back(std::make_unique<HeadlessFrameResource>(ObjectCount, static_cast<std::uint32_t>(materialsByCBIndex.size()), wavesVertexBufferByteSize));
+
+    NullDevice::CommandList commandList;
+    NullDevice::CommandQueue commandQueue;
+    NullDevice::Fence fence;
+    std::uint64_t currentFence = 0;
+    commandQueue.SetExecutionTime(std::chrono::duration_cast<NullDevice::Clock::duration>(std::chrono::duration<float, std::milli>(settings.GpuFrameMilliseconds)));
+    commandQueue.SetLatency(std::chrono::duration_cast<NullDevice::Clock::duration>(std::chrono::duration<float, std::milli>(settings.GpuLatencyMilliseconds)));
+    commandQueue.SetValidation(true);
+    FramePacer framePacer(settings.FramesInFlight, settings.LatencyTargetMilliseconds);
+    int framesInFlightSum = 0;
+
+    LitWavesFrame::Rain rain;
+    RandomUtils::Xoshiro generator(settings.Seed);
+    const XMFLOAT4X4 proj = LitWavesFrame::Projection(static_cast<float>(Width) / Height);
+    XMFLOAT4X4 view = DirectXMathUtils::Identity4x4();
+    PassConstants passConstants;
+    float theta = 1.5f * DirectXMathUtils::Pi;
+
+    HeadlessFrameResult result;
+    bool valid = true;
+    const auto firstFrame = std::chrono::steady_clock::now();
+    auto previousFrame = firstFrame;
+    for (int frame = 0; frame < settings.FrameCount; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        const float deltaTime = std::chrono::duration<float>(start - previousFrame).count();
+        const float totalTime = std::chrono::duration<float>(start - firstFrame).count();
+        previousFrame = start;
+
+        const int frameResourceIndex = frame % settings.FramesInFlight;
+        HeadlessFrameResource& frameResource = *frameResources[frameResourceIndex];
+        const std::uint64_t waitFence = DirectXMathUtils::Max(frameResource.Fence, framePacer.FenceValueToWait(currentFence));
+        if (fence.GetCompletedValue() < waitFence)
+            fence.Wait(waitFence);
+
+        auto end = std::chrono::steady_clock::now();
+        framePacer.BeginFrame(end - start, fence.GetCompletedValue());
+        framesInFlightSum += framePacer.FramesInFlight();
+        uploadRing.Retire(fence.GetCompletedValue());
+        result.WaitSeconds += std::chrono::duration<double>(end - start).count();
+        start = end;
+
+        // Update, dans l'ordre de LitWavesApp::Update. Un anneau plein est une erreur de dimensionnement, comme dans l'application.
+        // La caméra bouge à chaque frame, ce qui rend visible toute écriture dans un bloc encore lu par le GPU.
+        theta += 0.01f;
+        const XMFLOAT3 eyePosition = LitWavesFrame::OrbitCamera(50.0f, theta, 0.5f * DirectXMathUtils::Pi - 0.1f, view);
+
+        LitWavesFrame::WriteObjectConstants(objectsDirty, frameResourceIndex, frameResource.ObjectConstantsSpan,
+            [&](size_t i) -> const XMFLOAT4X4& { return worlds[i]; });
+
+        LitWavesFrame::BuildPassConstants(view, proj, eyePosition, Width, Height, deltaTime, 1.25f * DirectXMathUtils::Pi, 0.25f * DirectXMathUtils::Pi, passConstants);
+        const std::uint64_t passOffset = uploadRing.Allocate(PassCBByteSize, ConstantBufferElementSize);
+        if (passOffset == RingAllocator::InvalidOffset)
+        {
+            waves.StopAsync();
+            return result;
+        }
+        frameResource.PassCB = uploadBuffer.MappedData() + passOffset;
+        memcpy(frameResource.PassCB, &passConstants, sizeof(PassConstants));
+
+        LitWavesFrame::WriteMaterialConstants(materialsDirty, frameResourceIndex, frameResource.MaterialConstantsSpan, materialsByCBIndex);
+
+        LitWavesFrame::UpdateWaves(waves, rain, totalTime, deltaTime, generator, vertexFormat, frameResource.WavesVB.MappedData(), frameResource.WavesStep);
+
+        end = std::chrono::steady_clock::now();
+        result.UpdateSeconds += std::chrono::duration<double>(end - start).count();
+        start = end;
+
+        // Draw : mêmes commandes que LitWavesApp::Draw, dans le même ordre.
+        const std::uint64_t backBuffer = backBuffers[currentBackBuffer]->GetGPUVirtualAddress();
+        commandList.Reset();
+        commandList.SetPipelineState(opaquePSO);
+        commandList.ResourceBarrier(backBuffer, StatePresent, StateRenderTarget);
+        commandList.ClearRenderTargetView(backBuffer);
+        commandList.ClearDepthStencilView(depthStencil.GetGPUVirtualAddress());
+        commandList.SetGraphicsRootSignature(rootSignature);
+        commandList.SetGraphicsRootConstantBufferView(LitWavesFrame::RootPassCB, uploadBuffer.GetGPUVirtualAddress() + passOffset, PassCBByteSize);
+
+        commandList.IASetVertexBuffer(landVB.GetGPUVirtualAddress(), static_cast<std::uint32_t>(landVB.ByteSize()), sizeof(Vertex));
+        commandList.IASetIndexBuffer(landIB.GetGPUVirtualAddress(), static_cast<std::uint32_t>(landIB.ByteSize()), sizeof(std::uint16_t));
+        commandList.IASetPrimitiveTopology(TopologyTriangleList);
+        commandList.SetGraphicsRootConstantBufferView(LitWavesFrame::RootObjectCB, frameResource.ObjectCB.GetGPUVirtualAddress() + LandObject * ConstantBufferElementSize);
+        commandList.SetGraphicsRootConstantBufferView(LitWavesFrame::RootMaterialCB, frameResource.MaterialCB.GetGPUVirtualAddress() + grass.MatCBIndex * ConstantBufferElementSize);
+        commandList.DrawIndexedInstanced(landIndexCount, 1, 0, 0, 0);
+
+        commandList.SetPipelineState(wavesPSO);
+        commandList.SetGraphicsRoot32BitConstants(LitWavesFrame::RootWavesConstants, sizeof(WavesConstants) / 4, &wavesConstants, 0);
+        commandList.SetGraphicsRootShaderResourceView(LitWavesFrame::RootWavesHeights, frameResource.WavesVB.GetGPUVirtualAddress(), wavesVertexBufferByteSize);
+        commandList.IASetVertexBuffer(frameResource.WavesVB.GetGPUVirtualAddress(), wavesVertexBufferByteSize, vertexByteSize);
+        commandList.IASetIndexBuffer(wavesIB.GetGPUVirtualAddress(), static_cast<std::uint32_t>(wavesIB.ByteSize()), sizeof(std::uint16_t));
+        commandList.IASetPrimitiveTopology(TopologyTriangleList);
+        commandList.SetGraphicsRootConstantBufferView(LitWavesFrame::RootObjectCB, frameResource.ObjectCB.GetGPUVirtualAddress() + WavesObject * ConstantBufferElementSize);
+        commandList.SetGraphicsRootConstantBufferView(LitWavesFrame::RootMaterialCB, frameResource.MaterialCB.GetGPUVirtualAddress() + water.MatCBIndex * ConstantBufferElementSize);
+        LitWavesFrame::DrawWavesChunks(commandList, waves, chunkIndexCount);
+
+        commandList.ResourceBarrier(backBuffer, StateRenderTarget, StatePresent);
+        commandList.Close();
+
+        end = std::chrono::steady_clock::now();
+        result.RecordSeconds += std::chrono::duration<double>(end - start).count();
+
+        // Ce qui a été soumis : un draw pour le terrain et un par bloc d'eau, chacun dans le vertex buffer de l'eau.
+        valid &= commandList.CountOf(NullDevice::CommandType::DrawIndexedInstanced) == static_cast<size_t>(waves.ChunkCount()) + 1;
+        for (const NullDevice::Command& command : commandList.Commands())
+        {
+            if (command.Type == NullDevice::CommandType::DrawIndexedInstanced && command.Arguments[0] == chunkIndexCount)
+                valid &= (static_cast<std::uint64_t>(command.Arguments[3]) + waves.ChunkVertexCount()) * vertexByteSize <= wavesVertexBufferByteSize;
+        }
+
+        commandQueue.ExecuteCommandList(commandList);
+        currentBackBuffer = (currentBackBuffer + 1) % BackBufferCount;
+        frameResource.Fence = ++currentFence;
+        commandQueue.Signal(fence, currentFence);
+        uploadRing.FinishFrame(currentFence);
+        framePacer.EndFrame(currentFence);
+    }
+
+    // Comme FlushCommandQueue : les dernières frames doivent aussi être vérifiées.
+    fence.Wait(currentFence);
+    waves.StopAsync();
+    valid &= fence.ConflictCount() == 0 && commandQueue.Stats().DrawCount == static_cast<std::uint64_t>(settings.FrameCount) * (waves.ChunkCount() + 1);
+
+    result.DrawCount = commandQueue.Stats().DrawCount;
+    result.CommandCount = commandQueue.Stats().CommandCount;
+    result.ConflictCount = fence.ConflictCount();
+    result.AverageFramesInFlight = static_cast<double>(framesInFlightSum) / settings.FrameCount;
+    result.FramesInFlight = framePacer.FramesInFlight();
+    result.LatencyMilliseconds = framePacer.LastStats().LatencyMilliseconds;
+    result.Valid = valid;
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "LitWavesFrame.h"
+
+#include <cstdint>
+
+struct HeadlessFrameSettings
+{
+    int Size = 256;
+    WavesVertexFormat VertexFormat = WavesVertexFormat::Height;
+    int FrameCount = 100;
+    // Durée simulée d'une frame côté GPU, et délai fixe avant que chaque fence soit atteinte (voir NullDevice::CommandQueue).
+    float GpuFrameMilliseconds = 0.0f;
+    float GpuLatencyMilliseconds = 0.0f;
+    int FramesInFlight = 3;
+    // 0 garde toujours FramesInFlight frames en vol, sinon le FramePacer choisit la profondeur.
+    float LatencyTargetMilliseconds = 0.0f;
+    float SleepThreshold = 0.0f;
+    unsigned int Seed = 1;
+};
+
+struct HeadlessFrameResult
+{
+    double WaitSeconds = 0.0;
+    double UpdateSeconds = 0.0;
+    double RecordSeconds = 0.0;
+    std::uint64_t DrawCount = 0;
+    std::uint64_t CommandCount = 0;
+    // Plages de buffers modifiées par le CPU pendant que le "GPU" les utilisait encore.
+    std::uint64_t ConflictCount = 0;
+    double AverageFramesInFlight = 0.0;
+    // Profondeur choisie par le FramePacer à la fin de la boucle.
+    int FramesInFlight = 0;
+    // Latence de la dernière fenêtre de mesure du FramePacer, 0 si moins de FramePacer::AdaptationInterval frames.
+    float LatencyMilliseconds = 0.0f;
+    // Aucun conflit, un draw pour le terrain et un par bloc d'eau à chaque frame, chacun dans le vertex buffer de l'eau.
+    bool Valid = false;
+};
+
+// Boucle de frame de LitWavesApp (Update puis Draw) sans fenêtre ni GPU, sur NullDevice. Les constantes, la pluie, la simulation,
+// les sommets de l'eau et ses draws passent par les mêmes fonctions que l'application (LitWavesFrame.h) ; seuls la caméra,
+// qui tourne à chaque frame comme sous la souris, et le générateur de la pluie, qui part de la graine, diffèrent.
+// Utilisée par WavesBench pour la mesure et par Tests pour la vérification.
+HeadlessFrameResult RunHeadlessFrames(const HeadlessFrameSettings& settings);
\ No newline at end of file
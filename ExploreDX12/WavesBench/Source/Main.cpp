@@ -0,0 +1,857 @@
+// Banc d'essai de Waves sans fenêtre ni GPU : la simulation tourne sur plusieurs tailles de grille et nombres de threads,
+// avec une pluie rejouable (graine ou script enregistré), et chaque mesure est vérifiée par une somme de contrôle des hauteurs finales.
+// Les vérifications fonctionnelles, sans mesure, sont dans le projet Tests.
+//
+// Usage : WavesBench [--sizes 256,512,1024] [--threads 1,2,4,8] [--steps 200] [--warmup 20] [--seed 1] [--drops 4]
+//                    [--sleep-threshold 0] [--precision float32|float16|fixed16|all] [--height-range 0]
+//                    [--record script.txt | --replay script.txt] [--reference checksums.txt] [--kernels 1000000]
+//                    [--frames 1000] [--gpu-time 0] [--gpu-latency 0] [--frames-in-flight 3] [--latency-target 0] [--vertex-format height|compact|full]
+//                    [--heap 1000000] [--ocean 100] [--sweep]
+//
+// Le balayage de Waves tourne par défaut ; avec --kernels, --frames, --heap ou --ocean, seule la mesure demandée tourne, sauf si --sweep est aussi donné.
+// Les formats 16 bits sont comparés aux hauteurs finales d'un passage en float32 : un écart maximal au-delà de la tolérance du format
+// (en fraction du pic de hauteur du passage float32) fait échouer le banc. --height-range fixe la hauteur maximale du format Fixed16 ;
+// 0, la valeur par défaut, la déduit du pic du passage float32 avec une marge de 25 %.
+// --kernels mesure aussi, sur un thread et pour le nombre d'éléments donné, les noyaux SIMD du code CPU (échantillonnage de la surface, transformations par lots, générateurs, copie en streaming).
+// --frames fait aussi tourner, pour chaque taille de grille, la partie CPU de la boucle de frame de LitWavesApp sur un périphérique factice (HeadlessFrames.h) :
+// ring de frame resources et anneau d'upload des constant buffers, pluie, mise à jour de la simulation sur son thread, écriture des sommets et enregistrement des draws,
+// par les fonctions de LitWavesApp/Source/LitWavesFrame.h que l'application appelle aussi. --gpu-time simule la durée
+// d'une frame côté GPU en millisecondes, et chaque frame soumise est vérifiée (nombre de draws, ressources modifiées pendant leur utilisation).
+// --gpu-latency ajoute un délai fixe avant que chaque fence soit atteinte, sans occuper le GPU, et --latency-target laisse le FramePacer choisir
+// le nombre de frames en vol (au plus --frames-in-flight) : on voit la profondeur retenue et la latence obtenue pour une latence GPU donnée.
+// --heap mesure TlsfAllocator, qui découpe les heaps des buffers placés (Graphics/BufferHeap.h) : le nombre donné de paires libération/allocation
+// de tailles aléatoires dans un espace à moitié plein, puis la fragmentation obtenue, avant et après Defragment, et la vérification de toutes les invariants.
+// --ocean mesure l'océan spectral (LitWavesApp/Source/Ocean.h) pour plusieurs tailles de FFT : le nombre donné d'évaluations à des instants successifs,
+// puis l'écriture des sommets au format complet (le seul que l'océan produit, ses sommets se déplaçant aussi en x et z).
+// Les sommes de contrôle dépendent des options de compilation (le FMA change les arrondis) : un fichier de référence vaut pour une configuration.
+//
+// Sous Linux, avec les en-têtes de DirectXMath (et sal.h) dans le chemin d'inclusion, depuis le dossier ExploreDX12 :
+//   g++ -std=c++20 -O2 -pthread -ICommon/Source -ILitWavesApp/Source WavesBench/Source/Main.cpp WavesBench/Source/HeadlessFrames.cpp LitWavesApp/Source/Waves.cpp LitWavesApp/Source/Ocean.cpp LitWavesApp/Source/LitWavesFrame.cpp Common/Source/Graphics/TransformUtils.cpp Common/Source/Graphics/NullDevice.cpp Common/Source/Graphics/FramePacer.cpp Common/Source/Utils/ParallelUtils.cpp Common/Source/Utils/TlsfAllocator.cpp -o WavesBench
+// Ajouter -mavx2 -mfma -mf16c pour le chemin AVX2, ou -DSIMD_FORCE_SCALAR -D_XM_NO_INTRINSICS_ pour le chemin scalaire (aussi sur ARM, où NEON est choisi par défaut).
+
+#include "HeadlessFrames.h"
+#include "Ocean.h"
+#include "Waves.h"
+#include "Graphics/NullDevice.h"
+#include "Graphics/TransformUtils.h"
+#include "Utils/DirtyTracker.h"
+#include "Utils/MemoryUtils.h"
+#include "Utils/ParallelUtils.h"
+#include "Utils/Random.h"
+#include "Utils/TlsfAllocator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Goutte de pluie en coordonnées normalisées, pour qu'un même script s'applique à toutes les tailles de grille.
+struct ScriptedDisturbance
+{
+    int Step = 0;
+    float U = 0.0f;
+    float V = 0.0f;
+    float RadiusInCells = 0.0f;
+    float Magnitude = 0.0f;
+};
+
+struct Options
+{
+    std::vector<int> Sizes = { 256, 512, 1024, 2048 };
+    std::vector<int> ThreadCounts;
+    std::vector<Waves::StoragePrecision> Precisions = { Waves::StoragePrecision::Float32 };
+    int Steps = 200;
+    int WarmupSteps = 20;
+    unsigned int Seed = 1;
+    int DropsPerStep = 4;
+    // 0 garde toute la grille active, ce qui mesure le débit de la simulation plutôt que celui du suivi des tuiles.
+    float SleepThreshold = 0.0f;
+    // 0 : déduite du pic de hauteur du passage float32, voir HeightRangeHeadroom.
+    float HeightRange = 0.0f;
+    std::string RecordPath;
+    std::string ReplayPath;
+    std::string ReferencePath;
+    int KernelElementCount = 0;
+    int FrameCount = 0;
+    float GpuFrameMilliseconds = 0.0f;
+    float GpuLatencyMilliseconds = 0.0f;
+    int FramesInFlight = 3;
+    float LatencyTargetMilliseconds = 0.0f;
+    std::string VertexFormat = "height";
+    int HeapOperationCount = 0;
+    int OceanEvaluationCount = 0;
+    // Balayage de Waves même avec une mesure particulière, voir main.
+    bool Sweep = false;
+};
+
+struct RunResult
+{
+    double Seconds = 0.0;
+    double ActiveCellSteps = 0.0;
+    std::uint64_t Checksum = 0;
+    std::vector<float> Heights;
+    // Plus grande hauteur absolue atteinte pendant le passage, mesurée seulement si demandée.
+    float PeakHeight = 0.0f;
+};
+
+// Marge au-dessus du pic du passage float32 pour la hauteur maximale du format Fixed16 : sans elle, une crête un peu plus haute
+// en 16 bits serait saturée.
+constexpr float HeightRangeHeadroom = 1.25f;
+
+// Écart maximal toléré avec le passage float32, en fraction de son pic de hauteur. Le demi-flottant garde 11 bits de mantisse,
+// le Fixed16 un pas constant de heightRange / 32767 : les écarts s'accumulent au fil des étapes mais restent loin de ces bornes
+// tant que rien ne sature.
+static float MaxRelativeError(Waves::StoragePrecision precision)
+{
+    switch (precision)
+    {
+    case Waves::StoragePrecision::Float16:
+        return 0.04f;
+    case Waves::StoragePrecision::Fixed16:
+        return 0.02f;
+    default:
+        return 0.0f;
+    }
+}
+
+static const char* PrecisionName(Waves::StoragePrecision precision)
+{
+    switch (precision)
+    {
+    case Waves::StoragePrecision::Float16:
+        return "float16";
+    case Waves::StoragePrecision::Fixed16:
+        return "fixed16";
+    default:
+        return "float32";
+    }
+}
+
+static std::vector<int> ParseList(const char* text)
+{
+    std::vector<int> values;
+    const char* p = text;
+    while (*p != '\0')
+    {
+        char* end = nullptr;
+        const long value = std::strtol(p, &end, 10);
+        if (end == p)
+            break;
+        values.push_back(static_cast<int>(value));
+        p = *end == ',' ? end + 1 : end;
+    }
+    return values;
+}
+
+static bool ParseOptions(int argc, char** argv, Options& options)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string name = argv[i];
+        if (name == "--sweep")
+        {
+            options.Sweep = true;
+            continue;
+        }
+        if (i + 1 >= argc)
+        {
+            std::fprintf(stderr, "Valeur manquante pour %s\n", name.c_str());
+            return false;
+        }
+
+        const char* value = argv[++i];
+        if (name == "--sizes")
+            options.Sizes = ParseList(value);
+        else if (name == "--threads")
+            options.ThreadCounts = ParseList(value);
+        else if (name == "--steps")
+            options.Steps = std::atoi(value);
+        else if (name == "--warmup")
+            options.WarmupSteps = std::atoi(value);
+        else if (name == "--seed")
+            options.Seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+        else if (name == "--drops")
+            options.DropsPerStep = std::atoi(value);
+        else if (name == "--sleep-threshold")
+            options.SleepThreshold = static_cast<float>(std::atof(value));
+        else if (name == "--height-range")
+            options.HeightRange = static_cast<float>(std::atof(value));
+        else if (name == "--record")
+            options.RecordPath = value;
+        else if (name == "--replay")
+            options.ReplayPath = value;
+        else if (name == "--reference")
+            options.ReferencePath = value;
+        else if (name == "--kernels")
+            options.KernelElementCount = std::atoi(value);
+        else if (name == "--frames")
+            options.FrameCount = std::atoi(value);
+        else if (name == "--gpu-time")
+            options.GpuFrameMilliseconds = static_cast<float>(std::atof(value));
+        else if (name == "--gpu-latency")
+            options.GpuLatencyMilliseconds = static_cast<float>(std::atof(value));
+        else if (name == "--frames-in-flight")
+            options.FramesInFlight = DirectXMathUtils::Max(std::atoi(value), 1);
+        else if (name == "--latency-target")
+            options.LatencyTargetMilliseconds = static_cast<float>(std::atof(value));
+        else if (name == "--vertex-format")
+            options.VertexFormat = value;
+        else if (name == "--heap")
+            options.HeapOperationCount = std::atoi(value);
+        else if (name == "--ocean")
+            options.OceanEvaluationCount = std::atoi(value);
+        else if (name == "--precision")
+        {
+            const std::string precision = value;
+            if (precision == "all")
+                options.Precisions = { Waves::StoragePrecision::Float32, Waves::StoragePrecision::Float16, Waves::StoragePrecision::Fixed16 };
+            else if (precision == "float16")
+                options.Precisions = { Waves::StoragePrecision::Float16 };
+            else if (precision == "fixed16")
+                options.Precisions = { Waves::StoragePrecision::Fixed16 };
+            else
+                options.Precisions = { Waves::StoragePrecision::Float32 };
+        }
+        else
+        {
+            std::fprintf(stderr, "Option inconnue : %s\n", name.c_str());
+            return false;
+        }
+    }
+
+    // Par défaut : 1, 2, 4... jusqu'au nombre de cœurs.
+    if (options.ThreadCounts.empty())
+    {
+        const int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+        for (int threadCount = 1; threadCount < hardwareThreads; threadCount *= 2)
+            options.ThreadCounts.push_back(threadCount);
+        options.ThreadCounts.push_back(hardwareThreads > 0 ? hardwareThreads : 1);
+    }
+
+    return !options.Sizes.empty() && options.Steps > 0 && options.WarmupSteps >= 0;
+}
+
+static std::vector<ScriptedDisturbance> GenerateScript(const Options& options)
+{
+    // Les distributions de la STL diffèrent d'une implémentation à l'autre, le script ne serait pas le même sous Windows et Linux.
+    RandomUtils::Xoshiro generator(options.Seed);
+
+    std::vector<ScriptedDisturbance> script;
+    for (int step = 0; step < options.WarmupSteps + options.Steps; step++)
+    {
+        for (int drop = 0; drop < options.DropsPerStep; drop++)
+        {
+            ScriptedDisturbance disturbance;
+            disturbance.Step = step;
+            disturbance.U = generator.Randf(0.05f, 0.95f);
+            disturbance.V = generator.Randf(0.05f, 0.95f);
+            disturbance.RadiusInCells = generator.Randf(1.5f, 4.0f);
+            disturbance.Magnitude = generator.Randf(0.1f, 0.4f);
+            script.push_back(disturbance);
+        }
+    }
+    return script;
+}
+
+// Une goutte par ligne : étape u v rayon (en cellules) magnitude, triées par étape.
+static bool SaveScript(const std::string& path, const std::vector<ScriptedDisturbance>& script)
+{
+    std::ofstream file(path);
+    if (!file)
+        return false;
+
+    file.precision(9);
+    for (const ScriptedDisturbance& disturbance : script)
+        file << disturbance.Step << ' ' << disturbance.U << ' ' << disturbance.V << ' ' << disturbance.RadiusInCells << ' ' << disturbance.Magnitude << '\n';
+    return true;
+}
+
+static bool LoadScript(const std::string& path, std::vector<ScriptedDisturbance>& script)
+{
+    std::ifstream file(path);
+    if (!file)
+        return false;
+
+    ScriptedDisturbance disturbance;
+    while (file >> disturbance.Step >> disturbance.U >> disturbance.V >> disturbance.RadiusInCells >> disturbance.Magnitude)
+        script.push_back(disturbance);
+    return true;
+}
+
+// Débit mémoire de référence, mesuré comme la "triad" de STREAM (a = b + s * c) sur des tableaux bien plus grands que le cache.
+static double MeasureStreamBandwidth()
+{
+    constexpr int Count = 1 << 24;
+    constexpr int BlockSize = 1 << 14;
+    std::vector<float> a(Count, 0.0f);
+    std::vector<float> b(Count, 1.0f);
+    std::vector<float> c(Count, 2.0f);
+
+    double bestSeconds = 1e30;
+    for (int repeat = 0; repeat < 5; repeat++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        ParallelUtils::For(0, Count / BlockSize, [&](int block)
+        {
+            for (int i = block * BlockSize; i < (block + 1) * BlockSize; i++)
+                a[i] = b[i] + 3.0f * c[i];
+        });
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        bestSeconds = DirectXMathUtils::Min(bestSeconds, elapsed.count());
+    }
+
+    return 3.0 * Count * sizeof(float) / bestSeconds * 1e-9;
+}
+
+// heightRange n'est utilisé qu'en Fixed16. Avec measurePeak, les hauteurs sont relues après chaque étape, hors de la mesure du temps.
+static RunResult RunWaves(int size, Waves::StoragePrecision precision, float heightRange, bool measurePeak, const Options& options,
+    const std::vector<ScriptedDisturbance>& script)
+{
+    // Mêmes paramètres que la scène LitWavesApp.
+    Waves waves(size, size, 1.0f, 0.03f, 4.0f, 0.2f, precision, heightRange);
+    waves.SetSleepThreshold(options.SleepThreshold);
+    std::vector<float> heights(measurePeak ? waves.ChunkedVertexCount() : 0);
+    std::uint64_t writtenStep = Waves::NeverWritten;
+
+    RunResult result;
+    const double tileCells = static_cast<double>(Waves::TileSize) * Waves::TileSize;
+    const double gridCells = static_cast<double>(size) * size;
+    std::vector<Waves::Disturbance> drops;
+    size_t next = 0;
+    for (int step = 0; step < options.WarmupSteps + options.Steps; step++)
+    {
+        drops.clear();
+        for (; next < script.size() && script[next].Step <= step; next++)
+        {
+            const ScriptedDisturbance& scripted = script[next];
+            Waves::Disturbance drop;
+            drop.X = -waves.HalfWidth() + 2.0f * waves.HalfWidth() * scripted.U;
+            drop.Z = -waves.HalfDepth() + 2.0f * waves.HalfDepth() * scripted.V;
+            drop.Radius = scripted.RadiusInCells * waves.SpatialStep();
+            drop.Magnitude = scripted.Magnitude;
+            drops.push_back(drop);
+        }
+        waves.Disturb(drops.data(), drops.size());
+
+        // Un Update de exactement dt fait toujours une étape, ce qui garde la simulation indépendante de l'horloge.
+        const bool timed = step >= options.WarmupSteps;
+        const auto start = std::chrono::steady_clock::now();
+        waves.Update(0.03f);
+        if (timed)
+        {
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            result.Seconds += elapsed.count();
+            result.ActiveCellSteps += DirectXMathUtils::Min(waves.ActiveTileCount() * tileCells, gridCells);
+        }
+
+        if (measurePeak)
+        {
+            waves.WriteHeights(heights.data(), 1.0f, writtenStep);
+            writtenStep = waves.StepCount();
+            for (float height : heights)
+                result.PeakHeight = DirectXMathUtils::Max(result.PeakHeight, std::abs(height));
+        }
+    }
+
+    // FNV-1a sur les bits des hauteurs : la simulation est déterministe, quel que soit le nombre de threads.
+    result.Checksum = 14695981039346656037ull;
+    result.Heights.resize(waves.VertexCount());
+    for (int i = 0; i < waves.VertexCount(); i++)
+    {
+        result.Heights[i] = waves.Position(i).y;
+        std::uint32_t bits;
+        std::memcpy(&bits, &result.Heights[i], sizeof(bits));
+        for (int byte = 0; byte < 4; byte++)
+            result.Checksum = (result.Checksum ^ ((bits >> (8 * byte)) & 0xff)) * 1099511628211ull;
+    }
+    return result;
+}
+
+// Tailles des constant buffers de LitWavesApp (voir FrameResource.h), arrondies à 256 octets comme le fait CalcConstantBufferByteSize.
+constexpr std::uint32_t ConstantBufferElementSize = 256;
+// Valeur par défaut de DirectX12::NumberOfFrameResources, et même taille que LitWavesApp::UploadRingByteSize.
+constexpr int FrameResourceCount = 3;
+constexpr std::uint64_t UploadRingByteSize = 256 * 1024;
+
+// Meilleur temps sur quelques répétitions, en nanosecondes par élément.
+template<typename Kernel>
+static double MeasureKernel(int elementCount, const Kernel& kernel)
+{
+    double bestSeconds = 1e30;
+    for (int repeat = 0; repeat < 5; repeat++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        kernel();
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        bestSeconds = DirectXMathUtils::Min(bestSeconds, elapsed.count());
+    }
+    return bestSeconds * 1e9 / elementCount;
+}
+
+static void RunKernels(const Options& options)
+{
+    const int count = options.KernelElementCount;
+    ParallelUtils::SetThreadCount(1);
+
+    std::printf("\nNoyaux SIMD (%s), %d éléments, 1 thread, ns/élément\n", Simd::BackendName(), count);
+
+    std::vector<float> x(count);
+    std::vector<float> z(count);
+    std::vector<float> heights(count);
+    std::vector<XMFLOAT3> normals(count);
+    for (Waves::StoragePrecision precision : { Waves::StoragePrecision::Float32, Waves::StoragePrecision::Float16, Waves::StoragePrecision::Fixed16 })
+    {
+        // Une seule goutte de 0,5 : la hauteur maximale par défaut du Fixed16 suffit.
+        Waves waves(1024, 1024, 1.0f, 0.03f, 4.0f, 0.2f, precision);
+        Waves::Disturbance drop = { 0.0f, 0.0f, 200.0f, 0.5f };
+        waves.Disturb(&drop, 1);
+        waves.Update(0.03f);
+
+        // Requêtes dispersées sur toute la grille, le pire cas pour les lectures indexées.
+        RandomUtils::Xoshiro generator(options.Seed);
+        generator.Fill(x.data(), x.size(), -waves.HalfWidth(), waves.HalfWidth());
+        generator.Fill(z.data(), z.size(), -waves.HalfDepth(), waves.HalfDepth());
+
+        const double heightOnly = MeasureKernel(count, [&] { waves.SampleSurface(x.data(), z.data(), count, heights.data(), nullptr, 0.5f); });
+        const double withNormals = MeasureKernel(count, [&] { waves.SampleSurface(x.data(), z.data(), count, heights.data(), normals.data(), 0.5f); });
+        std::printf("  SampleSurface %-8s hauteur %6.2f   hauteur + normale %6.2f\n", PrecisionName(precision), heightOnly, withNormals);
+    }
+
+    // Transformations par lots en place sur des tableaux séparés, la matrice n'a pas d'importance pour la mesure.
+    std::vector<float> components(6 * static_cast<size_t>(count), 0.5f);
+    const TransformUtils::Float3Array points = { components.data(), components.data() + count, components.data() + 2 * static_cast<size_t>(count) };
+    const TransformUtils::Float3Array extents = { points.X + 3 * static_cast<size_t>(count), points.X + 4 * static_cast<size_t>(count), points.X + 5 * static_cast<size_t>(count) };
+    const XMFLOAT4X4 matrix = DirectXMathUtils::Identity4x4();
+    std::printf("  TransformPoints %6.2f   NormalizeVectors %6.2f   TransformBounds %6.2f\n",
+        MeasureKernel(count, [&] { TransformUtils::TransformPoints(matrix, points, points, count); }),
+        MeasureKernel(count, [&] { TransformUtils::NormalizeVectors(points, points, count); }),
+        MeasureKernel(count, [&] { TransformUtils::TransformBounds(matrix, TransformUtils::BoundsArray { points, extents }, TransformUtils::BoundsArray { points, extents }, count); }));
+
+    std::vector<XMFLOAT4X4> matrices(count / 16, matrix);
+    std::vector<XMFLOAT4X4> transposed(matrices.size());
+    std::printf("  TransposeMatrices %6.2f ns/matrice\n", MeasureKernel(static_cast<int>(matrices.size()), [&] { TransformUtils::TransposeMatrices(matrices.data(), matrices.size(), transposed.data()); }));
+
+    std::vector<std::uint32_t> words(count);
+    RandomUtils::Xoshiro xoshiro(options.Seed);
+    const RandomUtils::Philox philox(options.Seed);
+    std::printf("  Xoshiro::Fill  float %6.2f   uint %6.2f\n",
+        MeasureKernel(count, [&] { xoshiro.Fill(heights.data(), heights.size()); }), MeasureKernel(count, [&] { xoshiro.Fill(words.data(), words.size()); }));
+    std::printf("  Philox::Fill   float %6.2f   uint %6.2f\n",
+        MeasureKernel(count, [&] { philox.Fill(0, heights.data(), heights.size()); }), MeasureKernel(count, [&] { philox.Fill(0, words.data(), words.size()); }));
+
+    std::vector<float> copy(count);
+    std::printf("  StreamCopy     float %6.2f\n", MeasureKernel(count, [&] { MemoryUtils::StreamCopy(copy.data(), heights.data(), count * sizeof(float)); }));
+
+    // Chemins de copie de UploadBuffer, sur de la mémoire hôte : d'abord une matrice par constant buffer de 256 octets (constantes d'objet),
+    // CopyData élément par élément contre les copies par lot et la construction en place ; puis des normales vers un vertex buffer contigu.
+    const int objectCount = static_cast<int>(matrices.size());
+    NullDevice::Buffer constantBuffer(static_cast<size_t>(objectCount) * ConstantBufferElementSize);
+    std::uint8_t* mapped = constantBuffer.MappedData();
+    const auto copyData = [mapped](int index, const void* data, size_t byteSize) { memcpy(mapped + static_cast<size_t>(index) * ConstantBufferElementSize, data, byteSize); };
+    std::printf("  UploadBuffer constantes  CopyData %6.2f   CopyStrided %6.2f   StreamData %6.2f ns/élément\n",
+        MeasureKernel(objectCount, [&] { for (int i = 0; i < objectCount; i++) copyData(i, &matrices[i], sizeof(XMFLOAT4X4)); }),
+        MeasureKernel(objectCount, [&] { MemoryUtils::CopyStrided(mapped, ConstantBufferElementSize, matrices.data(), sizeof(XMFLOAT4X4), sizeof(XMFLOAT4X4), objectCount); }),
+        MeasureKernel(objectCount, [&] { MemoryUtils::StreamCopyStrided(mapped, ConstantBufferElementSize, matrices.data(), sizeof(XMFLOAT4X4), sizeof(XMFLOAT4X4), objectCount); }));
+    std::printf("  UploadBuffer transposée  temporaire + CopyData %6.2f   en place %6.2f ns/élément\n",
+        MeasureKernel(objectCount, [&]
+        {
+            for (int i = 0; i < objectCount; i++)
+            {
+                XMFLOAT4X4 world;
+                XMStoreFloat4x4(&world, XMMatrixTranspose(XMLoadFloat4x4(&matrices[i])));
+                copyData(i, &world, sizeof(world));
+            }
+        }),
+        MeasureKernel(objectCount, [&]
+        {
+            for (int i = 0; i < objectCount; i++)
+                XMStoreFloat4x4(reinterpret_cast<XMFLOAT4X4*>(mapped + static_cast<size_t>(i) * ConstantBufferElementSize), XMMatrixTranspose(XMLoadFloat4x4(&matrices[i])));
+        }));
+
+    NullDevice::Buffer vertexBuffer(count * sizeof(XMFLOAT3));
+    XMFLOAT3* vertices = reinterpret_cast<XMFLOAT3*>(vertexBuffer.MappedData());
+    std::printf("  UploadBuffer sommets     CopyData %6.2f   CopyData(plage) %6.2f   StreamData %6.2f ns/élément\n",
+        MeasureKernel(count, [&] { for (int i = 0; i < count; i++) memcpy(&vertices[i], &normals[i], sizeof(XMFLOAT3)); }),
+        MeasureKernel(count, [&] { MemoryUtils::CopyStrided(vertices, sizeof(XMFLOAT3), normals.data(), sizeof(XMFLOAT3), sizeof(XMFLOAT3), count); }),
+        MeasureKernel(count, [&] { MemoryUtils::StreamCopyStrided(vertices, sizeof(XMFLOAT3), normals.data(), sizeof(XMFLOAT3), sizeof(XMFLOAT3), count); }));
+
+    // Recherche des constantes d'objet à réécrire pour 100 000 objets dont 100 changent à chaque frame : compteur NumFramesDirty
+    // dans chaque objet, tous parcourus à chaque frame, contre DirtyTracker. Ne mesure que le marquage et la recherche, pas l'écriture.
+    struct TrackedObject
+    {
+        XMFLOAT4X4 World = DirectXMathUtils::Identity4x4();
+        int NumFramesDirty = 0;
+    };
+    constexpr int trackedObjectCount = 100000;
+    constexpr int changedObjectCount = 100;
+    std::vector<std::unique_ptr<TrackedObject>> trackedObjects;
+    for (int i = 0; i < trackedObjectCount; i++)
+        trackedObjects.push_back(std::make_unique<TrackedObject>());
+    DirtyTracker objectsDirty(FrameResourceCount);
+    objectsDirty.Resize(trackedObjectCount);
+    for (int frameResource = 0; frameResource < FrameResourceCount; frameResource++)
+        objectsDirty.ConsumeRuns(frameResource, [](size_t, size_t) {});
+
+    std::vector<std::uint32_t> changed(changedObjectCount);
+    int trackedFrame = 0;
+    const double counters = MeasureKernel(1, [&]
+    {
+        xoshiro.Fill(changed.data(), changed.size());
+        for (std::uint32_t index : changed)
+            trackedObjects[index % trackedObjectCount]->NumFramesDirty = FrameResourceCount;
+        for (const std::unique_ptr<TrackedObject>& object : trackedObjects)
+        {
+            if (object->NumFramesDirty > 0)
+                object->NumFramesDirty--;
+        }
+    });
+    const double tracker = MeasureKernel(1, [&]
+    {
+        xoshiro.Fill(changed.data(), changed.size());
+        for (std::uint32_t index : changed)
+            objectsDirty.MarkDirty(index % trackedObjectCount);
+        objectsDirty.ConsumeRuns(trackedFrame++ % FrameResourceCount, [](size_t, size_t) {});
+    });
+    std::printf("  Objets modifiés (%d sur %d)  NumFramesDirty %8.2f   DirtyTracker %8.2f µs/frame\n",
+        changedObjectCount, trackedObjectCount, counters * 1e-3, tracker * 1e-3);
+}
+
+static WavesVertexFormat ParseVertexFormat(const std::string& name)
+{
+    if (name == "compact")
+        return WavesVertexFormat::HeightNormal;
+    if (name == "full")
+        return WavesVertexFormat::Full;
+    return WavesVertexFormat::Height;
+}
+
+static bool RunFrames(int size, const Options& options)
+{
+    HeadlessFrameSettings settings;
+    settings.Size = size;
+    settings.VertexFormat = ParseVertexFormat(options.VertexFormat);
+    settings.FrameCount = options.FrameCount;
+    settings.GpuFrameMilliseconds = options.GpuFrameMilliseconds;
+    settings.GpuLatencyMilliseconds = options.GpuLatencyMilliseconds;
+    settings.FramesInFlight = options.FramesInFlight;
+    settings.LatencyTargetMilliseconds = options.LatencyTargetMilliseconds;
+    settings.SleepThreshold = options.SleepThreshold;
+    settings.Seed = options.Seed;
+    const HeadlessFrameResult result = RunHeadlessFrames(settings);
+
+    // Profondeur moyenne sur toutes les frames, latence de la dernière fenêtre de mesure du FramePacer (0 si moins de FramePacer::AdaptationInterval frames).
+    std::printf("%6d %8s %10.3f %10.3f %10.3f %10.3f %8.0f %10.1f %9" PRIu64 " %6.2f %8.2f %s\n", size, options.VertexFormat.c_str(),
+        (result.WaitSeconds + result.UpdateSeconds + result.RecordSeconds) * 1e3 / options.FrameCount, result.WaitSeconds * 1e3 / options.FrameCount,
+        result.UpdateSeconds * 1e3 / options.FrameCount, result.RecordSeconds * 1e3 / options.FrameCount,
+        static_cast<double>(result.DrawCount) / options.FrameCount, static_cast<double>(result.CommandCount) / options.FrameCount,
+        result.ConflictCount, result.AverageFramesInFlight, result.LatencyMilliseconds, result.Valid ? "ok" : "!");
+    return result.Valid;
+}
+
+// Libérations et allocations alternées dans un TlsfAllocator de 256 Mo rempli à moitié, avec la granularité donnée (256 octets pour découper un buffer,
+// 64 Ko pour placer des ressources dans un heap). Les tailles, de 256 octets à 1 Mo, et les allocations à libérer sont tirées avant la mesure.
+static bool RunHeap(std::uint64_t granularity, const Options& options)
+{
+    constexpr std::uint64_t Capacity = 256ull * 1024 * 1024;
+    constexpr int LiveCount = 1024;
+
+    RandomUtils::Xoshiro generator(options.Seed);
+    std::vector<std::uint64_t> sizes(options.HeapOperationCount + LiveCount);
+    for (std::uint64_t& size : sizes)
+        size = static_cast<std::uint64_t>(std::exp2(generator.Randf(8.0f, 20.0f)));
+    std::vector<int> victims(options.HeapOperationCount);
+    for (int& victim : victims)
+        victim = generator.Rand(0, LiveCount - 1);
+
+    TlsfAllocator allocator(Capacity, granularity);
+    std::vector<TlsfAllocator::Allocation> live(LiveCount);
+    std::uint64_t failureCount = 0;
+    for (int i = 0; i < LiveCount; i++)
+        live[i] = allocator.Allocate(sizes[i]);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.HeapOperationCount; i++)
+    {
+        TlsfAllocator::Allocation& allocation = live[victims[i]];
+        if (allocation.IsValid())
+            allocator.Free(allocation.Handle);
+        allocation = allocator.Allocate(sizes[LiveCount + i]);
+        failureCount += !allocation.IsValid();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    bool valid = allocator.Validate();
+    const TlsfAllocator::Stats before = allocator.GetStats();
+
+    // Après le tassement, chaque allocation doit avoir reçu un seul déplacement vers le bas par appel à move.
+    std::vector<std::uint64_t> offsets(LiveCount);
+    std::map<std::uint32_t, int> slots;
+    for (int i = 0; i < LiveCount; i++)
+    {
+        if (live[i].IsValid())
+            slots[live[i].Handle] = i;
+    }
+    const std::uint32_t movedCount = allocator.Defragment([&](std::uint32_t handle, std::uint64_t oldOffset, std::uint64_t newOffset, std::uint64_t)
+    {
+        TlsfAllocator::Allocation& allocation = live[slots[handle]];
+        valid &= allocation.Offset == oldOffset && newOffset < oldOffset;
+        allocation.Offset = newOffset;
+    });
+    valid &= allocator.Validate();
+    for (const TlsfAllocator::Allocation& allocation : live)
+        valid &= !allocation.IsValid() || allocator.Offset(allocation.Handle) == allocation.Offset;
+    const TlsfAllocator::Stats after = allocator.GetStats();
+
+    std::printf("%11" PRIu64 " %10d %10.1f %8" PRIu64 " %10.1f %10.1f %8.3f %8" PRIu64 " %8u %8.3f %s\n", granularity, options.HeapOperationCount,
+        2.0 * options.HeapOperationCount / seconds * 1e-6, before.AllocationCount, static_cast<double>(before.UsedBytes) / (1024.0 * 1024.0),
+        static_cast<double>(before.LargestFreeBlock) / (1024.0 * 1024.0), before.Fragmentation, failureCount, movedCount, after.Fragmentation, valid ? "ok" : "!");
+    return valid;
+}
+
+// Évaluations successives de l'océan, espacées d'une frame à 60 Hz, puis écriture des sommets dans un buffer de la taille du vertex buffer.
+// La dernière colonne doit reprendre la première (motif sans couture), sinon la mesure est marquée invalide.
+static bool RunOcean(int fftSize, const Options& options)
+{
+    Ocean ocean(fftSize, 256.0f, XMFLOAT2(24.0f, 10.0f), 1e-7f, 1.2f, options.Seed);
+    std::vector<Vertex> vertices(ocean.VertexCount());
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.OceanEvaluationCount; i++)
+        ocean.Update(1.0f / 60.0f);
+    const double evaluateSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto writeStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.OceanEvaluationCount; i++)
+        ocean.WriteVertices(vertices.data(), { sizeof(Vertex), offsetof(Vertex, Pos), offsetof(Vertex, Normal) });
+    const double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - writeStart).count();
+
+    bool valid = true;
+    float peakHeight = 0.0f;
+    for (int r = 0; r < ocean.RowCount(); r++)
+    {
+        const int first = r * ocean.ColumnCount();
+        valid &= vertices[first].Pos.y == vertices[first + fftSize].Pos.y;
+        for (int c = 0; c <= fftSize; c++)
+            peakHeight = DirectXMathUtils::Max(peakHeight, std::abs(vertices[first + c].Pos.y));
+    }
+    valid &= std::isfinite(peakHeight);
+
+    std::printf("%6d %10d %12.3f %12.3f %10.3f %s\n", fftSize, ocean.VertexCount(), evaluateSeconds * 1e3 / options.OceanEvaluationCount,
+        writeSeconds * 1e3 / options.OceanEvaluationCount, peakHeight, valid ? "ok" : "!");
+    return valid;
+}
+
+static std::map<std::string, std::uint64_t> LoadReference(const std::string& path)
+{
+    std::map<std::string, std::uint64_t> checksums;
+    std::ifstream file(path);
+    std::string key;
+    std::string checksum;
+    while (file >> key >> checksum)
+        checksums[key] = std::strtoull(checksum.c_str(), nullptr, 16);
+    return checksums;
+}
+
+// Balayage des tailles de grille, des nombres de threads et des formats de stockage. Renvoie le code de sortie : 1 pour un script illisible,
+// 2 pour une somme de contrôle différente de la référence ou un écart au-delà de la tolérance d'un format 16 bits.
+static int RunSweep(const Options& options)
+{
+    std::vector<ScriptedDisturbance> script;
+    if (!options.ReplayPath.empty())
+    {
+        if (!LoadScript(options.ReplayPath, script))
+        {
+            std::fprintf(stderr, "Impossible de lire %s\n", options.ReplayPath.c_str());
+            return 1;
+        }
+    }
+    else
+    {
+        script = GenerateScript(options);
+    }
+
+    if (!options.RecordPath.empty() && !SaveScript(options.RecordPath, script))
+    {
+        std::fprintf(stderr, "Impossible d'écrire %s\n", options.RecordPath.c_str());
+        return 1;
+    }
+
+    std::map<int, double> streamBandwidth;
+    for (int threadCount : options.ThreadCounts)
+    {
+        ParallelUtils::SetThreadCount(threadCount);
+        streamBandwidth[threadCount] = MeasureStreamBandwidth();
+    }
+
+    // Sans fichier de référence existant, les sommes de contrôle de cette exécution le deviennent.
+    const std::map<std::string, std::uint64_t> checksumReference = options.ReferencePath.empty() ? std::map<std::string, std::uint64_t>() : LoadReference(options.ReferencePath);
+    std::map<std::string, std::uint64_t> checksums;
+    bool mismatch = false;
+
+    std::printf("%6s %8s %4s %9s %13s %7s %8s %8s %8s %17s %s\n", "size", "storage", "thr", "ms/step", "ns/cell/step", "active", "GB/s", "%stream", "scaling", "checksum", "error vs float32");
+    bool inaccurate = false;
+    const bool compareToFloat32 = std::any_of(options.Precisions.begin(), options.Precisions.end(),
+        [](Waves::StoragePrecision precision) { return precision != Waves::StoragePrecision::Float32; });
+    for (int size : options.Sizes)
+    {
+        // Les hauteurs finales en float32 servent de référence à l'analyse d'erreur des formats 16 bits, et leur pic à la hauteur maximale du Fixed16.
+        // Sans float32 parmi les formats mesurés, le passage de référence est fait à part, sans affichage.
+        RunResult reference;
+        if (compareToFloat32 && options.Precisions.front() != Waves::StoragePrecision::Float32)
+            reference = RunWaves(size, Waves::StoragePrecision::Float32, 0.0f, true, options, script);
+
+        for (Waves::StoragePrecision precision : options.Precisions)
+        {
+            const float heightRange = options.HeightRange > 0.0f ? options.HeightRange : DirectXMathUtils::Max(HeightRangeHeadroom * reference.PeakHeight, 1.0f);
+            double baseSeconds = 0.0;
+            int baseThreadCount = 0;
+            std::uint64_t baseChecksum = 0;
+            for (int threadCount : options.ThreadCounts)
+            {
+                ParallelUtils::SetThreadCount(threadCount);
+                const bool measurePeak = compareToFloat32 && precision == Waves::StoragePrecision::Float32 && baseThreadCount == 0;
+                const RunResult result = RunWaves(size, precision, heightRange, measurePeak, options, script);
+                if (measurePeak)
+                    reference = result;
+
+                if (baseThreadCount == 0)
+                {
+                    baseSeconds = result.Seconds;
+                    baseThreadCount = threadCount;
+                    baseChecksum = result.Checksum;
+                }
+
+                // Lectures et écritures d'une cellule active par étape : hauteur courante, précédente lue puis écrite, puis les deux relues pour l'activité.
+                const double heightByteSize = precision == Waves::StoragePrecision::Float32 ? 4.0 : 2.0;
+                const double bandwidth = 5.0 * heightByteSize * result.ActiveCellSteps / result.Seconds * 1e-9;
+                const double scaling = baseSeconds * baseThreadCount / (result.Seconds * threadCount);
+                const double gridCellSteps = static_cast<double>(size) * size * options.Steps;
+
+                const std::string key = std::to_string(size) + "/" + PrecisionName(precision);
+                const auto expected = checksumReference.find(key);
+                const bool wrong = result.Checksum != baseChecksum || (expected != checksumReference.end() && expected->second != result.Checksum);
+                mismatch |= wrong;
+                checksums[key] = result.Checksum;
+
+                char error[80] = "";
+                if (precision != Waves::StoragePrecision::Float32)
+                {
+                    double maxError = 0.0;
+                    double squaredError = 0.0;
+                    for (size_t i = 0; i < result.Heights.size(); i++)
+                    {
+                        const double e = std::abs(static_cast<double>(result.Heights[i]) - reference.Heights[i]);
+                        maxError = DirectXMathUtils::Max(maxError, e);
+                        squaredError += e * e;
+                    }
+                    const bool tooLarge = maxError > MaxRelativeError(precision) * reference.PeakHeight;
+                    inaccurate |= tooLarge;
+                    std::snprintf(error, sizeof(error), "max %.2e rms %.2e%s", maxError, std::sqrt(squaredError / result.Heights.size()), tooLarge ? " !" : "");
+                }
+
+                std::printf("%6d %8s %4d %9.3f %13.3f %6.0f%% %8.2f %7.0f%% %7.0f%% %016" PRIx64 "%s %s\n", size, PrecisionName(precision), threadCount,
+                    result.Seconds * 1e3 / options.Steps, result.Seconds * 1e9 / gridCellSteps, 100.0 * result.ActiveCellSteps / gridCellSteps,
+                    bandwidth, 100.0 * bandwidth / streamBandwidth[threadCount], 100.0 * scaling, result.Checksum, wrong ? "!" : " ", error);
+            }
+        }
+    }
+
+    std::printf("STREAM triad :");
+    for (const auto& [threadCount, bandwidth] : streamBandwidth)
+        std::printf(" %d thr %.1f GB/s", threadCount, bandwidth);
+    std::printf("\n");
+
+    if (!options.ReferencePath.empty() && checksumReference.empty())
+    {
+        std::ofstream file(options.ReferencePath);
+        for (const auto& [key, checksum] : checksums)
+        {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016" PRIx64, checksum);
+            file << key << ' ' << text << '\n';
+        }
+    }
+
+    if (mismatch)
+        std::fprintf(stderr, "Sommes de contrôle différentes de la référence (marquées par !)\n");
+    if (inaccurate)
+        std::fprintf(stderr, "Écart avec float32 au-delà de la tolérance du format (marqué par !)\n");
+    return mismatch || inaccurate ? 2 : 0;
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+        return 1;
+
+    // Le balayage est long : il ne tourne avec une mesure particulière (--kernels, --frames, --heap, --ocean) que si --sweep est aussi donné.
+    const bool sweep = options.Sweep || (options.KernelElementCount == 0 && options.FrameCount == 0 && options.HeapOperationCount == 0 && options.OceanEvaluationCount == 0);
+    const int sweepResult = sweep ? RunSweep(options) : 0;
+    if (sweepResult == 1)
+        return 1;
+
+    if (options.KernelElementCount > 0)
+        RunKernels(options);
+
+    bool invalidFrames = false;
+    if (options.FrameCount > 0)
+    {
+        // La simulation utilise tous les threads, comme dans l'application.
+        ParallelUtils::SetThreadCount(0);
+        std::printf("\nBoucle de frame sans GPU, %d frames, %.2f ms GPU par frame, %.2f ms de latence GPU, %d frames en vol au plus, latence visée %.2f ms, ms/frame\n",
+            options.FrameCount, options.GpuFrameMilliseconds, options.GpuLatencyMilliseconds, options.FramesInFlight, options.LatencyTargetMilliseconds);
+        std::printf("%6s %8s %10s %10s %10s %10s %8s %10s %9s %6s %8s\n", "size", "vertices", "cpu", "wait", "update", "record", "draws", "commands", "conflicts", "depth", "latency");
+        for (int size : options.Sizes)
+        {
+            if (!RunFrames(size, options))
+            {
+                std::fprintf(stderr, "Frames soumises incorrectes pour la taille %d (marquées par !)\n", size);
+                invalidFrames = true;
+            }
+        }
+    }
+
+    bool invalidHeap = false;
+    if (options.HeapOperationCount > 0)
+    {
+        std::printf("\nTlsfAllocator de 256 Mo, 1024 allocations vivantes de 256 octets à 1 Mo, Mops/s : libérations et allocations par seconde\n");
+        std::printf("%11s %10s %10s %8s %10s %10s %8s %8s %8s %8s\n", "granularity", "pairs", "Mops/s", "live", "used MB", "largest MB", "frag", "failures", "moved", "defrag");
+        for (std::uint64_t granularity : { 256ull, 64ull * 1024 })
+        {
+            if (!RunHeap(granularity, options))
+            {
+                std::fprintf(stderr, "TlsfAllocator incohérent (marqué par !)\n");
+                invalidHeap = true;
+            }
+        }
+    }
+
+    bool invalidOcean = false;
+    if (options.OceanEvaluationCount > 0)
+    {
+        // Comme dans l'application, les FFT de lignes et de colonnes utilisent tous les threads.
+        ParallelUtils::SetThreadCount(0);
+        std::printf("\nOcéan spectral, %d évaluations, ms par évaluation et par écriture des sommets\n", options.OceanEvaluationCount);
+        std::printf("%6s %10s %12s %12s %10s\n", "fft", "vertices", "evaluate", "write", "peak");
+        for (int fftSize : { 64, 128, 256, 512 })
+        {
+            if (!RunOcean(fftSize, options))
+            {
+                std::fprintf(stderr, "Océan incorrect pour la taille %d (marqué par !)\n", fftSize);
+                invalidOcean = true;
+            }
+        }
+    }
+
+    return sweepResult != 0 || invalidFrames || invalidHeap || invalidOcean ? 2 : 0;
+}
\ No newline at end of file